@@ -0,0 +1,1609 @@
+/**@file   bench_mochila.c
+ * @brief  micro benchmarks for the routines of the mochila program that do not need to solve the problem
+ *
+ * Usage:
+ *    bin/bench_mochila <benchmark> [instance files...]
+ *
+ * If no instance file is given, all *.mochila files in data/ are used.
+ *
+ * Benchmarks:
+ *    loader   throughput (MB/s and items/s) of loadInstanceText() compared with the former fscanf() reader
+ *    cache    time to load each instance from the text file and from its binary cache (.mochilab)
+ *    scan     greedy constructions per second when the candidates are scanned in the items array (itemType),
+ *             in the arrays of itemArraysT, or walked in the precomputed value/weight order
+ *             (e.g. bin/bench_mochila scan data/t200-5-10000-*.mochila)
+ *    model    time and SCIPgetMemUsed() to build the model with SCIPprobdataCreate(), with and without names
+ *    cons     solves each instance with linear rows and with knapsack/set-packing rows (--model_cons 0 and 1),
+ *             limited to SOLVE_TIME_LIMIT sec, and reports nodes/s and solving time per instance family (tN-M-R-K-x)
+ *    relax    same as cons, comparing the LP bound, the LP plus the Dantzig relaxator and the relaxator alone
+ *             (--relax_dantzig 0, 1 and 2), e.g. bin/bench_mochila relax data/t100-10-50-*.mochila data/t200-5-10000-*.mochila
+ *    lagr     Lagrangian bound and repaired solution of the engine in lagrangian.c (LAGR_ITERATIONS iterations, one thread
+ *             per processor) compared with the LP bound (Dantzig bound of the aggregated capacity)
+ *    dw       root bound, solving time and final gap of each instance with the assignment and the Dantzig-Wolfe
+ *             formulation (--formulation 0 and 1); the time is the time to optimality when the gap is 0,
+ *             e.g. bin/bench_mochila dw data/t60-10-100-*.mochila data/t100-10-50-*.mochila
+ *    kernels  time per call of the subset-sum and of the knapsack DP kernels (kernels.c) with the scalar code and with
+ *             AVX2, for capacities from 10^3 to 10^6 and random items (KERNEL_ITEMS of them); no instance is read
+ *    grasp    best value, gap to the LP bound and constructions per second of the GRASP (grasp.c, alpha GRASP_ALPHA) with
+ *             1, 10, 100 and 1000 iterations, e.g. bin/bench_mochila grasp data/t200-5-10000-*.mochila
+ *    graspmt  time of GRASP_SCALING_ITER iterations of the GRASP with 1, 2, 4, ... threads up to one per processor; the
+ *             best value must not change with the number of threads (e.g. bin/bench_mochila graspmt data/t200-*.mochila)
+ *    ls       moves evaluated per second by the local search (localsearch.c) and the gap to the LP bound closed at the
+ *             root, from LS_STARTS random (alpha 0) and greedy (alpha 1) constructions of the GRASP
+ *    pr       path relinking (pathrelinking.c) of PR_STARTS GRASP solutions with an elite pool of PR_POOLSIZE members:
+ *             best value of the GRASP alone and with the relinking, paths per second and paths better than both ends
+ *    tabu     best value and gap to the LP bound of the GRASP (alpha GRASP_ALPHA) and of the tabu search (tabu.c, from the
+ *             greedy by value/weight) with the same time budgets TABU_TIMES, and the mean gap of each one per budget
+ *    ga       generations per second and gap to the LP bound of the memetic GA (ga.c) after GA_GENERATIONS generations with a
+ *             population of GA_POPSIZE, with 1 thread and with one per processor (at least 2); the best value must not change
+ *             with the number of threads
+ *    rounding time per call of the rounding of myrounding (rounding.c: one sort and one pass) and of the former scans
+ *             (the best feasible candidate selected by scanning all the candidates and, for each one, the solution), on a
+ *             fractional point with every item split between two random knapsacks; both must give the same value
+ *    allocs   heap allocations (malloc, calloc and realloc calls) made by ALLOC_CALLS calls of the per-call work of
+ *             grasp (graspRun() on a thread pool), aleatoria (local search of improveSolution()) and myrounding
+ *             (roundingRun()), after one warm-up call; each count must be 0. It counts by replacing malloc() with a
+ *             wrapper of the glibc allocator (__libc_malloc()), so it needs glibc
+ *    root     root node (limits/nodes = 1) without primal heuristics, with myrounding, with mydiving and with both: the
+ *             time to the first solution within ROOT_GOOD_GAP of the root bound, the best value and the root time
+ *    ks       plain SCIP and SCIP with the kernel search (heur_kernelsearch.c, KS_BUCKETS buckets, KS_SUBMIP_TIME sec per
+ *             sub-MIP) with the same wall time SOLVE_TIME_LIMIT: best value, time of the best solution and final gap
+ *    stream   time and peak RSS of the core of STREAM_CORE_SIZE items (core.c) built from the whole instance in memory
+ *             (loadInstanceText()) and by the streaming reader (coreStream()), each one in a child process. Without
+ *             instance files, uncorrelated instances with 10^5, 10^6 and 10^7 items are written in STREAM_DIR (and
+ *             removed at the end)
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <assert.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "scip/scipdefplugins.h"
+#include "problem.h"
+#include "probdata_mochila.h"
+#include "relax_dantzig.h"
+#include "lagrangian.h"
+#include "kernels.h"
+#include "grasp.h"
+#include "localsearch.h"
+#include "pathrelinking.h"
+#include "tabu.h"
+#include "ga.h"
+#include "rounding.h"
+#include "rng.h"
+#include "pricer_mochila.h"
+#include "cons_samediff.h"
+#include "branch_ryanfoster.h"
+#include "parameters_mochila.h"
+#include "heur_myrounding.h"
+#include "heur_mydiving.h"
+#include "heur_kernelsearch.h"
+#include "core.h"
+
+/* settings read by the heuristic plugins (set by setParameters() in the mochila program) */
+parametersT param;
+
+#define DATA_DIR "data"
+#define MAXFILES 1024
+#define MIN_BENCH_TIME 0.2   /* each file is loaded repeatedly during at least this time (in sec) */
+#define SOLVE_TIME_LIMIT 60  /* time limit (in sec) of each solve in the cons, relax and dw benchmarks */
+#define LAGR_ITERATIONS 200  /* subgradient iterations in the lagr benchmark */
+#define KERNEL_ITEMS 100     /* items of the random knapsacks of the kernels benchmark */
+#define GRASP_ALPHA 0.7      /* RCL threshold in the grasp benchmark */
+#define LS_STARTS 100        /* constructions improved by the local search in the ls benchmark */
+#define GRASP_SCALING_ITER 2000 /* iterations of the GRASP in the graspmt benchmark */
+#define BENCH_SEED 1         /* seed of the random streams of the GRASP */
+#define PR_STARTS 200        /* GRASP solutions relinked with the pool in the pr benchmark */
+#define TABU_NTIMES 3        /* time budgets (in sec) of the tabu benchmark: 0.01, 0.1 and 1 */
+#define GA_POPSIZE 30        /* population of the ga benchmark */
+#define GA_GENERATIONS 200   /* generations of the ga benchmark */
+#define KS_BUCKETS 10        /* buckets of the kernel search in the ks benchmark */
+#define KS_SUBMIP_TIME 5.0   /* time limit (in sec) of each sub-MIP of the kernel search in the ks benchmark */
+#define STREAM_CORE_SIZE 1000 /* items of the core in the stream benchmark */
+#define STREAM_DIR "/tmp"    /* synthetic instances of the stream benchmark */
+#define STREAM_KNAPSACKS 10  /* knapsacks of the synthetic instances */
+#define STREAM_MAX_ITEMS 10000000 /* items of the largest synthetic instance */
+#define PR_POOLSIZE 10       /* members of the elite pool in the pr benchmark */
+#define ROOT_GOOD_GAP 0.01   /* a solution within this fraction of the root bound is good in the root benchmark */
+#define ROUND_MAX_SCAN_TIME 2.0 /* the former rounding is not timed (again) after a call longer than this (in sec) */
+#define ALLOC_CALLS 1000     /* calls of each engine counted in the allocs benchmark */
+#define ALLOC_GRASP_ITER 10  /* GRASP iterations per call in the allocs benchmark */
+
+/* allocation counter of the allocs benchmark: malloc(), calloc() and realloc() of every thread go through these
+ * wrappers of the glibc allocator and are counted while countallocs is set */
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t n, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+static atomic_int countallocs;
+static atomic_llong nallocs;
+
+void* malloc(size_t size)
+{
+   if(atomic_load_explicit(&countallocs, memory_order_relaxed))
+      atomic_fetch_add(&nallocs, 1);
+   return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size)
+{
+   if(atomic_load_explicit(&countallocs, memory_order_relaxed))
+      atomic_fetch_add(&nallocs, 1);
+   return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+   if(atomic_load_explicit(&countallocs, memory_order_relaxed))
+      atomic_fetch_add(&nallocs, 1);
+   return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+   __libc_free(ptr);
+}
+
+static double wallclock(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static int cmpstr(const void* a, const void* b)
+{
+   return strcmp(*(char* const*) a, *(char* const*) b);
+}
+
+/** collect all *.mochila files of the data folder (sorted by name) */
+static int listInstances(char** files, int maxfiles)
+{
+   DIR* dir;
+   struct dirent* ent;
+   size_t len;
+   int nfiles = 0;
+
+   dir = opendir(DATA_DIR);
+   if(!dir){
+      printf("\nProblem to open folder %s\n", DATA_DIR);
+      return 0;
+   }
+   while((ent = readdir(dir)) != NULL && nfiles < maxfiles){
+      len = strlen(ent->d_name);
+      if(len > 8 && !strcmp(ent->d_name + len - 8, ".mochila")){
+         files[nfiles] = (char*) malloc(strlen(DATA_DIR) + len + 2);
+         sprintf(files[nfiles], "%s/%s", DATA_DIR, ent->d_name);
+         nfiles++;
+      }
+   }
+   closedir(dir);
+   qsort(files, nfiles, sizeof(char*), cmpstr);
+   return nfiles;
+}
+
+/** the reader used before loadInstance() was memory-mapped; kept here as reference */
+static int loadInstanceScanf(char* filename, instanceT** I)
+{
+   FILE* fin;
+   int n, m, i;
+   fin = fopen(filename, "r");
+   if(!fin)
+      return 0;
+   if(fscanf(fin,"%d %d\n", &n, &m) != 2 || n <= 0 || m <= 0){
+      fclose(fin);
+      return 0;
+   }
+   createInstance(I, n, m);
+   for(i=0; i<m; i++)
+      if(fscanf(fin, "%d\n", &((*I)->C[i])) != 1)
+         break;
+   for(i=0; i<n; i++)
+      if(fscanf(fin, "%d %d %d\n", &((*I)->item[i].label), &((*I)->item[i].weight), &((*I)->item[i].value)) != 3)
+         break;
+   fclose(fin);
+   return 1;
+}
+
+/** loads the file repeatedly and returns the time of one load (in sec) */
+static double timeLoader(int (*loader)(char*, instanceT**), char* filename, int* nitems)
+{
+   instanceT* I;
+   double start, elapsed;
+   int reps = 0;
+
+   *nitems = 0;
+   start = wallclock();
+   do{
+      if(!loader(filename, &I))
+         return -1.0;
+      *nitems = I->n;
+      freeInstance(I);
+      reps++;
+      elapsed = wallclock() - start;
+   }while(elapsed < MIN_BENCH_TIME);
+   return elapsed / reps;
+}
+
+static int benchLoader(char** files, int nfiles)
+{
+   struct stat st;
+   double tmmap, tscanf, totmmap = 0, totscanf = 0, totbytes = 0, totitems = 0;
+   int f, nitems;
+
+   printf("%-40s %10s %9s %12s %12s %14s %8s\n", "instance", "bytes", "items", "MB/s", "MB/s(scanf)", "items/s", "speedup");
+   for(f = 0; f < nfiles; f++){
+      if(stat(files[f], &st) < 0)
+         continue;
+      tmmap = timeLoader(loadInstanceText, files[f], &nitems);
+      if(tmmap < 0){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      tscanf = timeLoader(loadInstanceScanf, files[f], &nitems);
+      printf("%-40s %10lld %9d %12.1lf %12.1lf %14.0lf %8.2lf\n", files[f], (long long) st.st_size, nitems,
+         st.st_size/tmmap/1e6, st.st_size/tscanf/1e6, nitems/tmmap, tscanf/tmmap);
+      totmmap += tmmap;
+      totscanf += tscanf;
+      totbytes += st.st_size;
+      totitems += nitems;
+   }
+   if(totmmap > 0){
+      printf("%-40s %10.0lf %9.0lf %12.1lf %12.1lf %14.0lf %8.2lf\n", "total", totbytes, totitems,
+         totbytes/totmmap/1e6, totbytes/totscanf/1e6, totitems/totmmap, totscanf/totmmap);
+   }
+   return 1;
+}
+
+static int loadBinary(char* filename, instanceT** I)
+{
+   return loadInstanceBinary(filename, I, -1, -1);
+}
+
+static int benchCache(char** files, int nfiles)
+{
+   char binname[SCIP_MAXSTRLEN];
+   instanceT* I;
+   long long srcsize, srcmtime;
+   double ttext, tbin, tottext = 0, totbin = 0;
+   int f, nitems;
+
+   printf("%-40s %9s %14s %14s %8s\n", "instance", "items", "text (us)", "binary (us)", "speedup");
+   for(f = 0; f < nfiles; f++){
+      if(!instanceFileStamp(files[f], &srcsize, &srcmtime) || !loadInstanceText(files[f], &I)){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      binaryInstanceName(files[f], binname, SCIP_MAXSTRLEN);
+      if(!saveInstanceBinary(binname, I, srcsize, srcmtime)){
+         printf("%-40s skipped (cache not written)\n", files[f]);
+         freeInstance(I);
+         continue;
+      }
+      freeInstance(I);
+      ttext = timeLoader(loadInstanceText, files[f], &nitems);
+      tbin = timeLoader(loadBinary, binname, &nitems);
+      printf("%-40s %9d %14.1lf %14.1lf %8.2lf\n", files[f], nitems, ttext*1e6, tbin*1e6, ttext/tbin);
+      tottext += ttext;
+      totbin += tbin;
+   }
+   if(totbin > 0)
+      printf("%-40s %9s %14.1lf %14.1lf %8.2lf\n", "total", "", tottext*1e6, totbin*1e6, tottext/totbin);
+   return 1;
+}
+
+/** greedy fill, picking at each step the best value/weight candidate by scanning the itemType array */
+static long long greedyAoS(instanceT* I, int* covered, int* residual)
+{
+   long long total = 0;
+   int j, i, best;
+
+   for(j = 0; j < I->m; j++){
+      residual[j] = I->C[j];
+      for(;;){
+         best = -1;
+         for(i = 0; i < I->n; i++){
+            if(!covered[i] && I->item[i].weight <= residual[j]
+               && (best < 0 || (long long) I->item[i].value * I->item[best].weight > (long long) I->item[best].value * I->item[i].weight))
+               best = i;
+         }
+         if(best < 0)
+            break;
+         covered[best] = 1;
+         residual[j] -= I->item[best].weight;
+         total += I->item[best].value;
+      }
+   }
+   return total;
+}
+
+/** same as greedyAoS(), scanning the weight[] and value[] arrays */
+static long long greedySoA(itemArraysT* A, instanceT* I, int* covered, int* residual)
+{
+   const int *weight = A->weight, *value = A->value;
+   long long total = 0;
+   int j, i, best;
+
+   for(j = 0; j < I->m; j++){
+      residual[j] = I->C[j];
+      for(;;){
+         best = -1;
+         for(i = 0; i < A->n; i++){
+            if(!covered[i] && weight[i] <= residual[j]
+               && (best < 0 || (long long) value[i] * weight[best] > (long long) value[best] * weight[i]))
+               best = i;
+         }
+         if(best < 0)
+            break;
+         covered[best] = 1;
+         residual[j] -= weight[best];
+         total += value[best];
+      }
+   }
+   return total;
+}
+
+/** same greedy, walking the items once per knapsack in the precomputed value/weight order */
+static long long greedySorted(itemArraysT* A, instanceT* I, int* covered, int* residual)
+{
+   const int *weight = A->weight, *value = A->value, *order = A->byRatio;
+   long long total = 0;
+   int j, k, i;
+
+   for(j = 0; j < I->m; j++){
+      residual[j] = I->C[j];
+      for(k = 0; k < A->n; k++){
+         i = order[k];
+         if(!covered[i] && weight[i] <= residual[j]){
+            covered[i] = 1;
+            residual[j] -= weight[i];
+            total += value[i];
+         }
+      }
+   }
+   return total;
+}
+
+static int benchScan(char** files, int nfiles)
+{
+   instanceT* I;
+   itemArraysT* A;
+   int *covered, *residual;
+   double start, t[3];
+   long long total[3];
+   int f, v, reps;
+
+   printf("%-40s %9s %14s %14s %14s %8s %8s\n", "instance", "items", "AoS (c/s)", "SoA (c/s)", "sorted (c/s)", "SoA", "sorted");
+   for(f = 0; f < nfiles; f++){
+      if(!loadInstanceText(files[f], &I)){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      A = createItemArrays(I);
+      covered = (int*) malloc(sizeof(int)*I->n);
+      residual = (int*) malloc(sizeof(int)*I->m);
+      for(v = 0; v < 3; v++){
+         reps = 0;
+         start = wallclock();
+         do{
+            memset(covered, 0, sizeof(int)*I->n);
+            total[v] = v == 0 ? greedyAoS(I, covered, residual) : v == 1 ? greedySoA(A, I, covered, residual) : greedySorted(A, I, covered, residual);
+            reps++;
+            t[v] = wallclock() - start;
+         }while(t[v] < MIN_BENCH_TIME);
+         t[v] /= reps;
+      }
+      // the three variants build the same solution
+      if(total[0] != total[1] || total[0] != total[2])
+         printf("%-40s different solutions: %lld %lld %lld\n", files[f], total[0], total[1], total[2]);
+      printf("%-40s %9d %14.0lf %14.0lf %14.0lf %8.2lf %8.2lf\n", files[f], I->n, 1/t[0], 1/t[1], 1/t[2], t[0]/t[1], t[0]/t[2]);
+      free(covered);
+      free(residual);
+      freeItemArrays(A);
+      freeInstance(I);
+   }
+   return 1;
+}
+
+/** builds the model of I in a new SCIP; returns the build time (in sec) and the memory used by SCIP after it */
+static double timeModel(instanceT* I, char* probname, int usenames, long long* memused)
+{
+   SCIP* scip;
+   double start, elapsed;
+
+   *memused = -1;
+   if(SCIPcreate(&scip) != SCIP_OKAY)
+      return -1.0;
+   if(SCIPincludeDefaultPlugins(scip) != SCIP_OKAY){
+      (void) SCIPfree(&scip);
+      return -1.0;
+   }
+   start = wallclock();
+   if(!loadProblem(scip, probname, I, usenames, 1, FORMULATION_ASSIGNMENT)){
+      (void) SCIPfree(&scip);
+      return -1.0;
+   }
+   elapsed = wallclock() - start;
+   *memused = SCIPgetMemUsed(scip);
+   // the instance is owned by the problem data now
+   (void) SCIPfree(&scip);
+   return elapsed;
+}
+
+static int benchModel(char** files, int nfiles)
+{
+   instanceT* I;
+   long long mem[2];
+   double t[2];
+   int f, names, nitems = 0, nknaps = 0;
+
+   printf("%-40s %9s %4s %12s %14s %12s %14s\n", "instance", "items", "m", "named (ms)", "named (MB)", "plain (ms)", "plain (MB)");
+   for(f = 0; f < nfiles; f++){
+      for(names = 1; names >= 0; names--){
+         t[names] = -1.0;
+         if(!loadInstanceText(files[f], &I))
+            break;
+         nitems = I->n;
+         nknaps = I->m;
+         t[names] = timeModel(I, files[f], names, &mem[names]);
+      }
+      if(t[0] < 0 || t[1] < 0){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      printf("%-40s %9d %4d %12.1lf %14.1lf %12.1lf %14.1lf\n", files[f], nitems, nknaps, t[1]*1e3, mem[1]/1e6, t[0]*1e3, mem[0]/1e6);
+   }
+   return 1;
+}
+
+/** settings of a solve in the cons, relax and dw benchmarks */
+typedef struct{
+   const char* name;
+   int nativecons;   /* --model_cons */
+   int relax;        /* --relax_dantzig */
+   int formulation;  /* --formulation */
+} solveVariantT;
+
+/** includes the plugins of the branch-and-price of the Dantzig-Wolfe formulation (as configScip() in cmain.c) */
+static SCIP_RETCODE includeBranchAndPrice(SCIP* scip)
+{
+   SCIP_CALL( SCIPsetIntParam(scip, "presolving/maxrestarts", 0) );
+   SCIP_CALL( SCIPsetPresolving(scip, SCIP_PARAMSETTING_OFF, TRUE) );
+   SCIP_CALL( SCIPsetSeparating(scip, SCIP_PARAMSETTING_OFF, TRUE) );
+   SCIP_CALL( SCIPincludeConshdlrSamediff(scip) );
+   SCIP_CALL( SCIPincludePricerMochila(scip) );
+   SCIP_CALL( SCIPincludeBranchruleRyanFoster(scip) );
+   return SCIP_OKAY;
+}
+
+/** solves the instance with the given settings; returns 0 if it could not be solved */
+static int solveModel(char* filename, const solveVariantT* variant, long long* nodes, double* time, double* root,
+   double* gap)
+{
+   SCIP* scip;
+   instanceT* I;
+   int ok = 0;
+
+   if(!loadInstanceText(filename, &I))
+      return 0;
+   if(SCIPcreate(&scip) != SCIP_OKAY){
+      freeInstance(I);
+      return 0;
+   }
+   if(SCIPincludeDefaultPlugins(scip) == SCIP_OKAY
+      && SCIPsetIntParam(scip, "display/verblevel", 0) == SCIP_OKAY
+      && SCIPsetRealParam(scip, "limits/time", SOLVE_TIME_LIMIT) == SCIP_OKAY
+      && (!variant->relax || SCIPincludeRelaxDantzig(scip) == SCIP_OKAY)
+      && (variant->relax != 2 || SCIPsetIntParam(scip, "lp/solvefreq", -1) == SCIP_OKAY)
+      && (variant->formulation != FORMULATION_PACKING || includeBranchAndPrice(scip) == SCIP_OKAY)){
+      if(loadProblem(scip, filename, I, 0, variant->nativecons, variant->formulation)){
+         if(SCIPsolve(scip) == SCIP_OKAY){
+            *nodes = SCIPgetNTotalNodes(scip);
+            *time = SCIPgetSolvingTime(scip);
+            *root = SCIPgetDualboundRoot(scip);
+            *gap = SCIPgetGap(scip);
+            ok = 1;
+         }
+      }
+      else
+         freeInstance(I);
+   }
+   else
+      freeInstance(I);
+   (void) SCIPfree(&scip);
+   return ok;
+}
+
+/** instance family: the file name without folder and without the final -seed.mochila */
+static void instanceFamily(const char* filename, char* family, int size)
+{
+   const char *base, *end;
+   int len;
+
+   base = strrchr(filename, '/');
+   base = base ? base + 1 : filename;
+   end = strrchr(base, '-');
+   len = end ? (int) (end - base) : (int) strlen(base);
+   if(len >= size)
+      len = size - 1;
+   memcpy(family, base, len);
+   family[len] = '\0';
+}
+
+static void printFamily(const char* family, int count, int nvariants, long long* nodes, double* time)
+{
+   int v;
+
+   printf("%-30s %6d", family, count);
+   for(v = 0; v < nvariants; v++)
+      printf(" %12lld %12.1lf %12.1lf", nodes[v], time[v], time[v] > 0 ? nodes[v]/time[v] : 0.0);
+   for(v = 1; v < nvariants; v++)
+      printf(" %8.2lf", time[v] > 0 ? time[0]/time[v] : 0.0);
+   printf("\n");
+}
+
+#define MAXVARIANTS 3
+
+/** solves each instance with each variant and prints the totals of nodes and time per instance family */
+static int benchSolve(char** files, int nfiles, const solveVariantT* variants, int nvariants)
+{
+   char family[SCIP_MAXSTRLEN], current[SCIP_MAXSTRLEN];
+   long long nodes[MAXVARIANTS], totnodes[MAXVARIANTS];
+   double time[MAXVARIANTS], tottime[MAXVARIANTS], root, gap;
+   int f, v, solved, count = 0;
+
+   assert(nvariants <= MAXVARIANTS);
+   current[0] = '\0';
+   printf("%-30s %6s", "family", "inst");
+   for(v = 0; v < nvariants; v++)
+      printf(" %7s nodes %7s time %12s", variants[v].name, variants[v].name, "nodes/s");
+   for(v = 1; v < nvariants; v++)
+      printf(" %8s", variants[v].name);
+   printf("\n");
+   for(f = 0; f < nfiles; f++){
+      solved = 1;
+      for(v = 0; v < nvariants && solved; v++)
+         solved = solveModel(files[f], &variants[v], &nodes[v], &time[v], &root, &gap);
+      if(!solved){
+         printf("%-30s skipped %s (not an instance)\n", "", files[f]);
+         continue;
+      }
+      // the files are sorted by name, so the instances of a family are consecutive
+      instanceFamily(files[f], family, SCIP_MAXSTRLEN);
+      if(strcmp(family, current)){
+         if(count > 0)
+            printFamily(current, count, nvariants, totnodes, tottime);
+         strcpy(current, family);
+         count = 0;
+         for(v = 0; v < nvariants; v++){
+            totnodes[v] = 0;
+            tottime[v] = 0;
+         }
+      }
+      for(v = 0; v < nvariants; v++){
+         totnodes[v] += nodes[v];
+         tottime[v] += time[v];
+      }
+      count++;
+   }
+   if(count > 0)
+      printFamily(current, count, nvariants, totnodes, tottime);
+   return 1;
+}
+
+static int benchCons(char** files, int nfiles)
+{
+   const solveVariantT variants[] = {{"linear", 0, 0, 0}, {"native", 1, 0, 0}};
+
+   return benchSolve(files, nfiles, variants, 2);
+}
+
+static int benchRelax(char** files, int nfiles)
+{
+   const solveVariantT variants[] = {{"lp", 1, 0, 0}, {"lp+dz", 1, 1, 0}, {"dantzig", 1, 2, 0}};
+
+   return benchSolve(files, nfiles, variants, 3);
+}
+
+/** root bound, nodes and time of each instance with the assignment and the Dantzig-Wolfe formulations */
+static int benchFormulation(char** files, int nfiles)
+{
+   const solveVariantT variants[] = {{"assign", 1, 0, FORMULATION_ASSIGNMENT}, {"dw", 1, 0, FORMULATION_PACKING}};
+   long long nodes[2];
+   double time[2], root[2], gap[2];
+   int f, v, solved;
+
+   // the time is the time to optimality only if the gap is 0 (otherwise SOLVE_TIME_LIMIT was reached)
+   printf("%-40s", "instance");
+   for(v = 0; v < 2; v++)
+      printf(" %8s root %8s nodes %7s time %6s gap", variants[v].name, variants[v].name, variants[v].name, variants[v].name);
+   printf("\n");
+   for(f = 0; f < nfiles; f++){
+      solved = 1;
+      for(v = 0; v < 2 && solved; v++)
+         solved = solveModel(files[f], &variants[v], &nodes[v], &time[v], &root[v], &gap[v]);
+      if(!solved){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      printf("%-40s", files[f]);
+      for(v = 0; v < 2; v++)
+         printf(" %13.1lf %14lld %12.2lf %10.4lf", root[v], nodes[v], time[v], gap[v]);
+      printf("\n");
+   }
+   return 1;
+}
+
+static int benchLagrangian(char** files, int nfiles)
+{
+   instanceT* I;
+   itemArraysT* A;
+   lagrangianT* L;
+   threadpoolT* pool;
+   unsigned char* available;
+   long long capacity;
+   double lpbound, bound, start, tlp, tlagr;
+   int f, i, j, maxC;
+
+   pool = createThreadpool(0);
+   printf("threads: %d\n", threadpoolSize(pool));
+   printf("%-40s %6s %4s %12s %12s %12s %6s %10s %10s\n", "instance", "items", "m", "LP bound", "Lagr bound", "primal", "iter", "LP (ms)", "Lagr (ms)");
+   for(f = 0; f < nfiles; f++){
+      if(!loadInstanceText(files[f], &I)){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      A = createItemArrays(I);
+      available = (unsigned char*) malloc(I->n);
+      start = wallclock();
+      capacity = 0;
+      maxC = 0;
+      for(j = 0; j < I->m; j++){
+         capacity += I->C[j];
+         maxC = I->C[j] > maxC ? I->C[j] : maxC;
+      }
+      for(i = 0; i < I->n; i++)
+         available[i] = A->weight[i] <= maxC;
+      lpbound = dantzigBound(A, available, capacity);
+      tlp = wallclock() - start;
+
+      start = wallclock();
+      L = createLagrangian(I, A, pool);
+      bound = L ? runLagrangian(L, LAGR_ITERATIONS, 0, -1) : -1;
+      tlagr = wallclock() - start;
+      printf("%-40s %6d %4d %12.1lf %12.1lf %12lld %6d %10.3lf %10.1lf\n", files[f], I->n, I->m, lpbound, bound,
+         L ? L->primal : -1, L ? L->iterations : 0, tlp*1e3, tlagr*1e3);
+      freeLagrangian(L);
+      free(available);
+      freeItemArrays(A);
+      freeInstance(I);
+   }
+   freeThreadpool(pool);
+   return 1;
+}
+
+/** time per call (in sec) of the subset-sum (dp == 0) or knapsack DP kernel with the given instruction set */
+static double timeKernel(int dp, kernelIsaT isa, const int* weight, const double* profit, int n, int capacity,
+   unsigned char* chosen, double* result)
+{
+   double start, elapsed;
+   int reps = 0;
+
+   kernelUseIsa(isa);
+   start = wallclock();
+   do{
+      *result = dp ? kernelKnapsack(weight, profit, n, capacity, chosen) : kernelSubsetSum(weight, n, capacity);
+      reps++;
+      elapsed = wallclock() - start;
+   }while(elapsed < MIN_BENCH_TIME);
+   return elapsed/reps;
+}
+
+static int benchKernels(char** files, int nfiles)
+{
+   const int capacities[] = {1000, 10000, 100000, 1000000};
+   kernelIsaT best = kernelBestIsa();
+   unsigned char* chosen;
+   unsigned int seed = 1;
+   double profit[KERNEL_ITEMS], t[2], r[2];
+   int weight[KERNEL_ITEMS], c, i, dp, capacity, ok = 1;
+
+   (void) files;
+   (void) nfiles;
+   chosen = (unsigned char*) malloc(KERNEL_ITEMS);
+   printf("best instruction set: %s\n", kernelIsaName(best));
+   printf("%-10s %10s %14s %14s %8s\n", "kernel", "capacity", "scalar (ms)", "avx2 (ms)", "speedup");
+   for(dp = 0; dp <= 1; dp++){
+      for(c = 0; c < (int) (sizeof(capacities)/sizeof(capacities[0])); c++){
+         capacity = capacities[c];
+         // even weights and an odd capacity: the subset-sum never stops early
+         for(i = 0; i < KERNEL_ITEMS; i++){
+            seed = seed*1103515245u + 12345u;
+            weight[i] = 2*(1 + (int) ((seed >> 8) % (unsigned int) (capacity/20)));
+            profit[i] = weight[i] + (double) ((seed >> 4) % 100);
+         }
+         capacity++;
+         t[0] = timeKernel(dp, KERNEL_SCALAR, weight, profit, KERNEL_ITEMS, capacity, chosen, &r[0]);
+         if(best == KERNEL_AVX2){
+            t[1] = timeKernel(dp, KERNEL_AVX2, weight, profit, KERNEL_ITEMS, capacity, chosen, &r[1]);
+            if(r[0] != r[1]){
+               printf("\nError: %s kernel with capacity %d: scalar %.1lf, avx2 %.1lf\n", dp ? "knapsack" : "subsetsum",
+                  capacity, r[0], r[1]);
+               ok = 0;
+            }
+            printf("%-10s %10d %14.3lf %14.3lf %8.2lf\n", dp ? "knapsack" : "subsetsum", capacity, t[0]*1e3, t[1]*1e3,
+               t[0]/t[1]);
+         }
+         else
+            printf("%-10s %10d %14.3lf %14s %8s\n", dp ? "knapsack" : "subsetsum", capacity, t[0]*1e3, "-", "-");
+      }
+   }
+   kernelUseIsa(best);
+   free(chosen);
+   return ok;
+}
+
+static int benchGrasp(char** files, int nfiles)
+{
+   const int iterations[] = {1, 10, 100, 1000};
+   instanceT* I;
+   itemArraysT* A;
+   graspT* G;
+   unsigned char* available;
+   long long capacity, value;
+   double lpbound, start, elapsed;
+   int f, i, j, k, maxC;
+
+   printf("%-40s %6s %4s %12s %6s %12s %8s %10s %12s\n", "instance", "items", "m", "LP bound", "iter", "best", "gap (%)",
+      "time (ms)", "constr/s");
+   for(f = 0; f < nfiles; f++){
+      if(!loadInstanceText(files[f], &I)){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      A = createItemArrays(I);
+      available = (unsigned char*) malloc(I->n);
+      capacity = 0;
+      maxC = 0;
+      for(j = 0; j < I->m; j++){
+         capacity += I->C[j];
+         maxC = I->C[j] > maxC ? I->C[j] : maxC;
+      }
+      for(i = 0; i < I->n; i++)
+         available[i] = A->weight[i] <= maxC;
+      lpbound = dantzigBound(A, available, capacity);
+      G = createGrasp(I, A, GRASP_ALPHA, NULL, BENCH_SEED);
+      for(k = 0; G && k < (int) (sizeof(iterations)/sizeof(iterations[0])); k++){
+         // the same streams for every number of iterations
+         G->nstreams = 0;
+         start = wallclock();
+         value = graspRun(G, iterations[k], -1);
+         elapsed = wallclock() - start;
+         printf("%-40s %6d %4d %12.1lf %6d %12lld %8.3lf %10.2lf %12.0lf\n", files[f], I->n, I->m, lpbound, iterations[k],
+            value, 100.0*(lpbound - value)/lpbound, elapsed*1e3, G->iterations/elapsed);
+      }
+      freeGrasp(G);
+      free(available);
+      freeItemArrays(A);
+      freeInstance(I);
+   }
+   return 1;
+}
+
+static int benchLocalSearch(char** files, int nfiles)
+{
+   const double alphas[] = {0.0, 1.0};
+   instanceT* I;
+   itemArraysT* A;
+   graspT* G;
+   localSearchT* L;
+   unsigned char* available;
+   long long capacity, before, after;
+   double lpbound, start, elapsed, gapbefore, gapafter;
+   int f, i, j, a, s, maxC, ok = 1;
+
+   printf("%-40s %5s %12s %12s %12s %9s %9s %8s %12s %s\n", "instance", "alpha", "LP bound", "constructed", "improved",
+      "gap0 (%)", "gap1 (%)", "closed", "evals/s", "moves applied");
+   for(f = 0; f < nfiles; f++){
+      if(!loadInstanceText(files[f], &I)){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      A = createItemArrays(I);
+      available = (unsigned char*) malloc(I->n);
+      capacity = 0;
+      maxC = 0;
+      for(j = 0; j < I->m; j++){
+         capacity += I->C[j];
+         maxC = I->C[j] > maxC ? I->C[j] : maxC;
+      }
+      for(i = 0; i < I->n; i++)
+         available[i] = A->weight[i] <= maxC;
+      lpbound = dantzigBound(A, available, capacity);
+      G = createGrasp(I, A, 0.0, NULL, BENCH_SEED);
+      L = createLocalSearch(I, A, NULL, NULL);
+      for(a = 0; G && L && a < (int) (sizeof(alphas)/sizeof(alphas[0])); a++){
+         G->alpha = alphas[a];
+         localSearchResetStats(L);
+         before = after = 0;
+         elapsed = 0.0;
+         for(s = 0; s < LS_STARTS; s++){
+            before += graspConstruct(G, 0, s);
+            start = wallclock();
+            localSearchLoad(L, G->W[0].assign);
+            after += localSearchRun(L);
+            elapsed += wallclock() - start;
+         }
+         gapbefore = 100.0*(lpbound - (double) before/LS_STARTS)/lpbound;
+         gapafter = 100.0*(lpbound - (double) after/LS_STARTS)/lpbound;
+         printf("%-40s %5.1lf %12.1lf %12.1lf %12.1lf %9.3lf %9.3lf %7.1lf%% %12.0lf", files[f], alphas[a], lpbound,
+            (double) before/LS_STARTS, (double) after/LS_STARTS, gapbefore, gapafter,
+            gapbefore > 0 ? 100.0*(gapbefore - gapafter)/gapbefore : 0.0, L->nevals/elapsed);
+         for(i = 0; i < LS_NMOVES; i++)
+            printf(" %s %lld", localSearchMoveName((lsMoveT) i), L->napplied[i]);
+         printf("\n");
+         if(after < before){
+            printf("\nError: the local search made the solutions worse\n");
+            ok = 0;
+         }
+      }
+      freeLocalSearch(L);
+      freeGrasp(G);
+      free(available);
+      freeItemArrays(A);
+      freeInstance(I);
+   }
+   return ok;
+}
+
+static int benchGraspThreads(char** files, int nfiles)
+{
+   instanceT* I;
+   itemArraysT* A;
+   graspT* G;
+   threadpoolT* pool;
+   long long value, value1 = -1;
+   double elapsed, t1 = 0.0, start;
+   int f, t, nprocs, ok = 1;
+
+   pool = createThreadpool(0);
+   nprocs = threadpoolSize(pool);
+   freeThreadpool(pool);
+   printf("processors: %d, %d iterations\n", nprocs, GRASP_SCALING_ITER);
+   printf("%-40s %7s %12s %10s %12s %8s\n", "instance", "threads", "best", "time (ms)", "constr/s", "speedup");
+   for(f = 0; f < nfiles; f++){
+      if(!loadInstanceText(files[f], &I)){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      A = createItemArrays(I);
+      for(t = 1; t <= nprocs; t = (t < nprocs && 2*t > nprocs) ? nprocs : 2*t){
+         pool = createThreadpool(t);
+         G = createGrasp(I, A, GRASP_ALPHA, pool, BENCH_SEED);
+         if(G){
+            start = wallclock();
+            value = graspRun(G, GRASP_SCALING_ITER, -1);
+            elapsed = wallclock() - start;
+            if(t == 1){
+               value1 = value;
+               t1 = elapsed;
+            }
+            printf("%-40s %7d %12lld %10.1lf %12.0lf %8.2lf\n", files[f], threadpoolSize(pool), value, elapsed*1e3,
+               G->iterations/elapsed, t1/elapsed);
+            if(value != value1){
+               printf("\nError: %d threads found %lld, 1 thread %lld\n", t, value, value1);
+               ok = 0;
+            }
+         }
+         freeGrasp(G);
+         freeThreadpool(pool);
+      }
+      freeItemArrays(A);
+      freeInstance(I);
+   }
+   return ok;
+}
+
+static int benchPathRelinking(char** files, int nfiles)
+{
+   instanceT* I;
+   itemArraysT* A;
+   graspT* G;
+   elitePoolT* P;
+   relinkT* R;
+   localSearchT* check;
+   long long value, relinked, bestgrasp, bestpr, npaths, nimproved;
+   double start, elapsed;
+   int f, s, g, guide[2], nguides, ok = 1;
+
+   printf("%-40s %12s %12s %8s %10s %10s %8s %8s\n", "instance", "GRASP", "GRASP+PR", "paths", "paths/s", "improved",
+      "added", "rejected");
+   for(f = 0; f < nfiles; f++){
+      if(!loadInstanceText(files[f], &I)){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      A = createItemArrays(I);
+      G = createGrasp(I, A, GRASP_ALPHA, NULL, BENCH_SEED);
+      P = createElitePool(I->n, PR_POOLSIZE, (int) (0.05*I->n + 0.5));
+      R = createRelink(I, A);
+      check = createLocalSearch(I, A, NULL, NULL);
+      bestgrasp = bestpr = -1;
+      npaths = nimproved = 0;
+      elapsed = 0.0;
+      for(s = 0; G && P && R && check && s < PR_STARTS; s++){
+         value = graspImprove(G, 0, graspConstruct(G, 0, s));
+         bestgrasp = value > bestgrasp ? value : bestgrasp;
+         bestpr = value > bestpr ? value : bestpr;
+         nguides = 0;
+         if(P->nsols > 0){
+            guide[nguides++] = elitePoolBest(P);
+            if((g = elitePoolFarthest(P, G->W[0].assign, guide[0])) >= 0)
+               guide[nguides++] = g;
+         }
+         for(g = 0; g < nguides; g++){
+            start = wallclock();
+            relinked = relinkPath(R, G->W[0].assign, P->sols + (size_t) guide[g]*I->n);
+            elapsed += wallclock() - start;
+            npaths++;
+            if(relinked < 0)
+               continue;
+            if(localSearchLoad(check, R->best) != relinked){
+               printf("\nError: infeasible path solution or wrong value (%lld)\n", relinked);
+               ok = 0;
+            }
+            nimproved += relinked > value && relinked > P->values[guide[g]];
+            bestpr = relinked > bestpr ? relinked : bestpr;
+            elitePoolAdd(P, R->best, relinked);
+         }
+         elitePoolAdd(P, G->W[0].assign, value);
+      }
+      printf("%-40s %12lld %12lld %8lld %10.0lf %10lld %8lld %8lld\n", files[f], bestgrasp, bestpr, npaths,
+         elapsed > 0 ? npaths/elapsed : 0.0, nimproved, P ? P->nadded : 0LL, P ? P->nrejected : 0LL);
+      freeLocalSearch(check);
+      freeRelink(R);
+      freeElitePool(P);
+      freeGrasp(G);
+      freeItemArrays(A);
+      freeInstance(I);
+   }
+   return ok;
+}
+
+static int benchTabu(char** files, int nfiles)
+{
+   const double times[TABU_NTIMES] = {0.01, 0.1, 1.0};
+   instanceT* I;
+   itemArraysT* A;
+   graspT* G;
+   tabuT* T;
+   localSearchT* check;
+   unsigned char* available;
+   long long capacity, gvalue, tvalue;
+   double lpbound, gapsum[2][TABU_NTIMES];
+   int f, i, j, t, maxC, ninstances = 0, ok = 1;
+
+   memset(gapsum, 0, sizeof(gapsum));
+   printf("%-40s %12s %8s %12s %8s %12s %8s %12s\n", "instance", "LP bound", "time (s)", "GRASP", "gap (%)", "tabu",
+      "gap (%)", "tabu iter/s");
+   for(f = 0; f < nfiles; f++){
+      if(!loadInstanceText(files[f], &I)){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      A = createItemArrays(I);
+      available = (unsigned char*) malloc(I->n);
+      capacity = 0;
+      maxC = 0;
+      for(j = 0; j < I->m; j++){
+         capacity += I->C[j];
+         maxC = I->C[j] > maxC ? I->C[j] : maxC;
+      }
+      for(i = 0; i < I->n; i++)
+         available[i] = A->weight[i] <= maxC;
+      lpbound = dantzigBound(A, available, capacity);
+      G = createGrasp(I, A, GRASP_ALPHA, NULL, BENCH_SEED);
+      T = createTabu(I, A, NULL, NULL, BENCH_SEED);
+      check = createLocalSearch(I, A, NULL, NULL);
+      for(t = 0; G && T && check && t < TABU_NTIMES; t++){
+         // both engines start over with the same streams for every budget
+         G->nstreams = 0;
+         gvalue = graspRun(G, INT_MAX, times[t]);
+         T->nstreams = 0;
+         T->iterations = 0;
+         tabuGreedy(T);
+         tvalue = tabuRun(T, LLONG_MAX, times[t]);
+         if(localSearchLoad(check, T->best) != tvalue){
+            printf("\nError: infeasible tabu solution or wrong value (%lld)\n", tvalue);
+            ok = 0;
+         }
+         gapsum[0][t] += 100.0*(lpbound - gvalue)/lpbound;
+         gapsum[1][t] += 100.0*(lpbound - tvalue)/lpbound;
+         printf("%-40s %12.1lf %8.2lf %12lld %8.3lf %12lld %8.3lf %12.0lf\n", files[f], lpbound, times[t], gvalue,
+            100.0*(lpbound - gvalue)/lpbound, tvalue, 100.0*(lpbound - tvalue)/lpbound, T->iterations/times[t]);
+      }
+      ninstances++;
+      freeLocalSearch(check);
+      freeTabu(T);
+      freeGrasp(G);
+      free(available);
+      freeItemArrays(A);
+      freeInstance(I);
+   }
+   for(t = 0; ninstances > 0 && t < TABU_NTIMES; t++)
+      printf("mean gap with %.2lf s over %d instances: GRASP %.3lf%%, tabu %.3lf%%\n", times[t], ninstances,
+         gapsum[0][t]/ninstances, gapsum[1][t]/ninstances);
+   return ok;
+}
+
+static int benchGA(char** files, int nfiles)
+{
+   instanceT* I;
+   itemArraysT* A;
+   threadpoolT* pool;
+   gaT* G;
+   localSearchT* check;
+   unsigned char* available;
+   long long capacity, value, value1 = -1;
+   double lpbound, start, elapsed;
+   int f, i, j, t, nt, maxC, nprocs, ok = 1;
+
+   pool = createThreadpool(0);
+   nprocs = threadpoolSize(pool);
+   freeThreadpool(pool);
+   printf("processors: %d, population %d, %d generations\n", nprocs, GA_POPSIZE, GA_GENERATIONS);
+   printf("%-40s %7s %12s %12s %8s %10s %10s %10s\n", "instance", "threads", "LP bound", "best", "gap (%)", "time (ms)",
+      "gen/s", "replaced");
+   for(f = 0; f < nfiles; f++){
+      if(!loadInstanceText(files[f], &I)){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      A = createItemArrays(I);
+      available = (unsigned char*) malloc(I->n);
+      capacity = 0;
+      maxC = 0;
+      for(j = 0; j < I->m; j++){
+         capacity += I->C[j];
+         maxC = I->C[j] > maxC ? I->C[j] : maxC;
+      }
+      for(i = 0; i < I->n; i++)
+         available[i] = A->weight[i] <= maxC;
+      lpbound = dantzigBound(A, available, capacity);
+      check = createLocalSearch(I, A, NULL, NULL);
+      // with a single processor, 2 threads still check that the result does not depend on them
+      for(t = 0; t < 2; t++){
+         nt = t == 0 ? 1 : (nprocs > 1 ? nprocs : 2);
+         pool = createThreadpool(nt);
+         G = createGA(I, A, GA_POPSIZE, pool, BENCH_SEED);
+         if(G && check){
+            start = wallclock();
+            value = gaRun(G, GA_GENERATIONS, -1);
+            elapsed = wallclock() - start;
+            if(t == 0)
+               value1 = value;
+            printf("%-40s %7d %12.1lf %12lld %8.3lf %10.1lf %10.1lf %10lld\n", files[f], nt, lpbound, value,
+               100.0*(lpbound - value)/lpbound, elapsed*1e3, G->generations/elapsed, G->nreplaced);
+            if(localSearchLoad(check, G->best) != value){
+               printf("\nError: infeasible GA solution or wrong value (%lld)\n", value);
+               ok = 0;
+            }
+            if(value != value1){
+               printf("\nError: %d threads found %lld, 1 thread %lld\n", nt, value, value1);
+               ok = 0;
+            }
+         }
+         freeGA(G);
+         freeThreadpool(pool);
+      }
+      freeLocalSearch(check);
+      free(available);
+      freeItemArrays(A);
+      freeInstance(I);
+   }
+   return ok;
+}
+
+/** the former rounding of myrounding (selectCand() and isFeasibleColumn()): the best feasible candidate is found by
+ *  scanning all the candidates, and the load of its knapsack by scanning the solution, until no candidate is left */
+static long long roundingScan(const roundCandT* cand, int ncands, instanceT* I, itemArraysT* A, int* covered,
+   int* solitem, int* solknap)
+{
+   long long value = 0;
+   int c, s, best, load, nsol = 0;
+
+   memset(covered, 0, sizeof(int)*I->n);
+   for(;;){
+      best = -1;
+      for(c = 0; c < ncands; c++){
+         if(covered[cand[c].item])
+            continue;
+         load = 0;
+         for(s = 0; s < nsol; s++)
+            if(solknap[s] == cand[c].knapsack)
+               load += A->weight[solitem[s]];
+         if(load + A->weight[cand[c].item] <= I->C[cand[c].knapsack]
+            && (best < 0 || cand[c].solval > cand[best].solval))
+            best = c;
+      }
+      if(best < 0)
+         break;
+      covered[cand[best].item] = 1;
+      solitem[nsol] = cand[best].item;
+      solknap[nsol++] = cand[best].knapsack;
+      value += A->value[cand[best].item];
+   }
+   return value;
+}
+
+static int benchRounding(char** files, int nfiles)
+{
+   instanceT* I;
+   itemArraysT* A;
+   roundingT* R;
+   roundCandT* cand;
+   rngT rng;
+   int *covered, *solitem, *solknap;
+   long long calls, value, valuescan;
+   double start, elapsed, tnew, tscan;
+   int f, i, k, l, ncands, ok = 1;
+   double u;
+
+   printf("%-40s %6s %4s %6s %12s %12s %12s %12s %8s\n", "instance", "items", "m", "cands", "value", "value scan",
+      "sort (us)", "scan (us)", "speedup");
+   for(f = 0; f < nfiles; f++){
+      if(!loadInstanceText(files[f], &I)){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      A = createItemArrays(I);
+      cand = (roundCandT*) malloc(sizeof(roundCandT)*2*I->n);
+      covered = (int*) malloc(sizeof(int)*I->n);
+      solitem = (int*) malloc(sizeof(int)*I->n);
+      solknap = (int*) malloc(sizeof(int)*I->n);
+      R = createRounding(I, A, 2*I->n);
+      // every item split between two knapsacks
+      rngInit(&rng, BENCH_SEED, f);
+      ncands = 0;
+      for(i = 0; i < I->n; i++){
+         k = rngInt(&rng, I->m);
+         l = I->m > 1 ? (k + 1 + rngInt(&rng, I->m - 1)) % I->m : k;
+         u = 0.05 + 0.9*rngDouble(&rng);
+         cand[ncands].item = i;
+         cand[ncands].knapsack = k;
+         cand[ncands].value = A->value[i];
+         cand[ncands++].solval = u*(1.0 - 0.1*rngDouble(&rng));
+         if(l != k){
+            cand[ncands].item = i;
+            cand[ncands].knapsack = l;
+            cand[ncands].value = A->value[i];
+            cand[ncands++].solval = (1.0 - u)*(1.0 - 0.1*rngDouble(&rng));
+         }
+      }
+      value = -1;
+      calls = 0;
+      start = wallclock();
+      do{
+         roundingReset(R);
+         for(i = 0; i < ncands; i++)
+            roundingAddCand(R, cand[i].item, cand[i].knapsack, cand[i].solval);
+         roundingRun(R);
+         value = R->value;
+         calls++;
+         elapsed = wallclock() - start;
+      }while(elapsed < MIN_BENCH_TIME);
+      tnew = elapsed/calls;
+      calls = 0;
+      start = wallclock();
+      do{
+         valuescan = roundingScan(cand, ncands, I, A, covered, solitem, solknap);
+         calls++;
+         elapsed = wallclock() - start;
+      }while(elapsed < MIN_BENCH_TIME && elapsed < ROUND_MAX_SCAN_TIME);
+      tscan = elapsed/calls;
+      printf("%-40s %6d %4d %6d %12lld %12lld %12.1lf %12.1lf %8.1lf\n", files[f], I->n, I->m, ncands, value, valuescan,
+         tnew*1e6, tscan*1e6, tscan/tnew);
+      if(value != valuescan){
+         printf("\nError: the rounding found %lld, the scans %lld\n", value, valuescan);
+         ok = 0;
+      }
+      freeRounding(R);
+      free(solknap);
+      free(solitem);
+      free(covered);
+      free(cand);
+      freeItemArrays(A);
+      freeInstance(I);
+   }
+   return ok;
+}
+
+/** allocations of ALLOC_CALLS calls of the work done by each call of grasp, aleatoria and myrounding, on a fractional
+ *  point with every item in a random knapsack for the rounding */
+static int benchAllocs(char** files, int nfiles)
+{
+   instanceT* I;
+   itemArraysT* A;
+   threadpoolT* pool;
+   graspT* G;
+   localSearchT* L;
+   roundingT* R;
+   rngT rng;
+   int *assign, *cand;
+   double* solval;
+   long long agrasp, als, around;
+   int f, i, c, ok = 1;
+
+   pool = createThreadpool(0);
+   printf("threads: %d, %d calls after one warm-up call\n", threadpoolSize(pool), ALLOC_CALLS);
+   printf("%-40s %6s %4s %14s %14s %14s\n", "instance", "items", "m", "allocs grasp", "allocs ls", "allocs rounding");
+   for(f = 0; f < nfiles; f++){
+      if(!loadInstanceText(files[f], &I)){
+         printf("%-40s skipped (not an instance)\n", files[f]);
+         continue;
+      }
+      A = createItemArrays(I);
+      assign = (int*) malloc(sizeof(int)*I->n);
+      cand = (int*) malloc(sizeof(int)*I->n);
+      solval = (double*) malloc(sizeof(double)*I->n);
+      G = createGrasp(I, A, GRASP_ALPHA, pool, BENCH_SEED);
+      L = createLocalSearch(I, A, NULL, NULL);
+      R = createRounding(I, A, I->n);
+      if(!assign || !cand || !solval || !G || !L || !R){
+         printf("%-40s out of memory\n", files[f]);
+         ok = 0;
+      }
+      else{
+         rngInit(&rng, BENCH_SEED, f);
+         for(i = 0; i < I->n; i++){
+            cand[i] = rngInt(&rng, I->m);
+            solval[i] = rngDouble(&rng);
+         }
+         agrasp = als = around = 0;
+         // the first call of each engine is not counted
+         for(c = 0; c <= ALLOC_CALLS; c++){
+            atomic_store(&nallocs, 0);
+            atomic_store(&countallocs, c > 0);
+            graspRun(G, ALLOC_GRASP_ITER, -1);
+            agrasp += atomic_load(&nallocs);
+            atomic_store(&nallocs, 0);
+            if(G->bestvalue >= 0 && localSearchLoad(L, G->best) >= 0){
+               localSearchRun(L);
+               localSearchStore(L, assign, NULL);
+            }
+            als += atomic_load(&nallocs);
+            atomic_store(&nallocs, 0);
+            roundingReset(R);
+            for(i = 0; i < I->n; i++)
+               roundingAddCand(R, i, cand[i], solval[i]);
+            roundingRun(R);
+            around += atomic_load(&nallocs);
+            atomic_store(&countallocs, 0);
+         }
+         printf("%-40s %6d %4d %14lld %14lld %14lld\n", files[f], I->n, I->m, agrasp, als, around);
+         if(agrasp || als || around){
+            printf("\nError: the per-call work of the heuristics allocated memory\n");
+            ok = 0;
+         }
+      }
+      freeRounding(R);
+      freeLocalSearch(L);
+      freeGrasp(G);
+      free(solval);
+      free(cand);
+      free(assign);
+      freeItemArrays(A);
+      freeInstance(I);
+   }
+   freeThreadpool(pool);
+   return ok;
+}
+
+/** solves the root node with the given primal heuristics (as configScip() in cmain.c); returns 0 if it could not be
+ *  solved. good is the time of the first solution within ROOT_GOOD_GAP of the root bound (-1: none) */
+static int solveRoot(char* filename, int rounding, int diving, double* good, double* best, double* bound, double* time)
+{
+   SCIP* scip;
+   SCIP_SOL** sols;
+   instanceT* I;
+   int s, nsols, ok = 0;
+
+   if(!loadInstanceText(filename, &I))
+      return 0;
+   if(SCIPcreate(&scip) != SCIP_OKAY){
+      freeInstance(I);
+      return 0;
+   }
+   param.heur_round_freq = param.heur_div_freq = 1;
+   param.heur_round_freqofs = param.heur_div_freqofs = 0;
+   param.heur_round_maxdepth = param.heur_div_maxdepth = -1;
+   param.local_search = 0;
+   if(SCIPincludeDefaultPlugins(scip) == SCIP_OKAY
+      && SCIPsetIntParam(scip, "display/verblevel", 0) == SCIP_OKAY
+      && SCIPsetRealParam(scip, "limits/time", SOLVE_TIME_LIMIT) == SCIP_OKAY
+      && SCIPsetLongintParam(scip, "limits/nodes", 1) == SCIP_OKAY
+      && SCIPsetPresolving(scip, SCIP_PARAMSETTING_OFF, TRUE) == SCIP_OKAY
+      && SCIPsetSeparating(scip, SCIP_PARAMSETTING_OFF, TRUE) == SCIP_OKAY
+      && SCIPsetHeuristics(scip, SCIP_PARAMSETTING_OFF, TRUE) == SCIP_OKAY
+      && (!rounding || SCIPincludeHeurMyRounding(scip) == SCIP_OKAY)
+      && (!diving || SCIPincludeHeurMyDiving(scip) == SCIP_OKAY)){
+      if(loadProblem(scip, filename, I, 0, 1, FORMULATION_ASSIGNMENT)){
+         if(SCIPsolve(scip) == SCIP_OKAY){
+            *bound = SCIPgetDualbound(scip);
+            *best = SCIPgetNSols(scip) > 0 ? SCIPgetPrimalbound(scip) : -1.0;
+            *time = SCIPgetSolvingTime(scip);
+            *good = -1.0;
+            sols = SCIPgetSols(scip);
+            nsols = SCIPgetNSols(scip);
+            for(s = 0; s < nsols; s++)
+               if(SCIPgetSolOrigObj(scip, sols[s]) >= (1.0 - ROOT_GOOD_GAP)*(*bound)
+                  && (*good < 0 || SCIPsolGetTime(sols[s]) < *good))
+                  *good = SCIPsolGetTime(sols[s]);
+            ok = 1;
+         }
+      }
+      else
+         freeInstance(I);
+   }
+   else
+      freeInstance(I);
+   (void) SCIPfree(&scip);
+   return ok;
+}
+
+static int benchRoot(char** files, int nfiles)
+{
+   const char* names[] = {"none", "rounding", "diving", "rnd+div"};
+   double good, best, bound, time;
+   int f, v, solved;
+
+   printf("%-40s %-9s %12s %12s %10s %10s\n", "instance", "heur", "root bound", "best", "good (s)", "root (s)");
+   for(f = 0; f < nfiles; f++){
+      for(v = 0, solved = 1; v < 4 && solved; v++){
+         solved = solveRoot(files[f], v & 1, v >> 1, &good, &best, &bound, &time);
+         if(!solved)
+            printf("%-40s skipped (not an instance)\n", files[f]);
+         else if(good < 0)
+            printf("%-40s %-9s %12.1lf %12.1lf %10s %10.2lf\n", files[f], names[v], bound, best, "-", time);
+         else
+            printf("%-40s %-9s %12.1lf %12.1lf %10.2lf %10.2lf\n", files[f], names[v], bound, best, good, time);
+      }
+   }
+   return 1;
+}
+
+/** solves the instance for SOLVE_TIME_LIMIT sec (as configScip() in cmain.c), with or without the kernel search; returns
+ *  0 if it could not be solved. besttime is the time of the best solution (-1: none) */
+static int solveKernelSearch(char* filename, int kernelsearch, double* best, double* besttime, double* gap)
+{
+   SCIP* scip;
+   instanceT* I;
+   int ok = 0;
+
+   if(!loadInstanceText(filename, &I))
+      return 0;
+   if(SCIPcreate(&scip) != SCIP_OKAY){
+      freeInstance(I);
+      return 0;
+   }
+   param.model_cons = 1;
+   if(SCIPincludeDefaultPlugins(scip) == SCIP_OKAY
+      && SCIPsetIntParam(scip, "display/verblevel", 0) == SCIP_OKAY
+      && SCIPsetRealParam(scip, "limits/time", SOLVE_TIME_LIMIT) == SCIP_OKAY
+      && SCIPsetIntParam(scip, "presolving/maxrestarts", 0) == SCIP_OKAY
+      && SCIPsetPresolving(scip, SCIP_PARAMSETTING_OFF, TRUE) == SCIP_OKAY
+      && (!kernelsearch || (SCIPincludeHeurKernelsearch(scip) == SCIP_OKAY
+            && SCIPsetIntParam(scip, "heuristics/kernelsearch/buckets", KS_BUCKETS) == SCIP_OKAY
+            && SCIPsetRealParam(scip, "heuristics/kernelsearch/maxtime", KS_SUBMIP_TIME) == SCIP_OKAY))){
+      if(loadProblem(scip, filename, I, 0, 1, FORMULATION_ASSIGNMENT)){
+         if(SCIPsolve(scip) == SCIP_OKAY){
+            *best = SCIPgetNSols(scip) > 0 ? SCIPgetPrimalbound(scip) : -1.0;
+            *besttime = SCIPgetNSols(scip) > 0 ? SCIPsolGetTime(SCIPgetBestSol(scip)) : -1.0;
+            *gap = SCIPgetGap(scip);
+            ok = 1;
+         }
+      }
+      else
+         freeInstance(I);
+   }
+   else
+      freeInstance(I);
+   (void) SCIPfree(&scip);
+   return ok;
+}
+
+static int benchKernelSearch(char** files, int nfiles)
+{
+   const char* names[] = {"scip", "kernel"};
+   double best, besttime, gap, sumgap[2] = {0.0, 0.0};
+   int f, v, solved, nsolved = 0;
+
+   printf("%-40s %-7s %12s %10s %10s\n", "instance", "heur", "best", "best (s)", "gap (%)");
+   for(f = 0; f < nfiles; f++){
+      for(v = 0, solved = 1; v < 2 && solved; v++){
+         solved = solveKernelSearch(files[f], v, &best, &besttime, &gap);
+         if(!solved)
+            printf("%-40s skipped (not an instance)\n", files[f]);
+         else{
+            printf("%-40s %-7s %12.1lf %10.2lf %10.3lf\n", files[f], names[v], best, besttime, 100.0*gap);
+            sumgap[v] += 100.0*gap;
+         }
+      }
+      nsolved += solved;
+   }
+   if(nsolved > 0)
+      printf("\nmean gap (%%) in %d sec: scip %.3lf, kernel %.3lf\n", SOLVE_TIME_LIMIT, sumgap[0]/nsolved, sumgap[1]/nsolved);
+   return 1;
+}
+
+/** writes an uncorrelated instance with n items (weights and values in [10, 1000]) and capacities of half of the total
+ *  weight over STREAM_KNAPSACKS knapsacks */
+static int writeSynthetic(const char* filename, int n)
+{
+   FILE* f;
+   rngT rng;
+   long long total = 0;
+   int i, k, w;
+
+   f = fopen(filename, "w");
+   if(!f)
+      return 0;
+   rngInit(&rng, BENCH_SEED, (unsigned long long) n);
+   for(i = 0; i < n; i++)
+      total += 10 + rngInt(&rng, 991);
+   fprintf(f, "%d %d\n", n, STREAM_KNAPSACKS);
+   for(k = 0; k < STREAM_KNAPSACKS; k++)
+      fprintf(f, "%lld\n", total/(2*STREAM_KNAPSACKS));
+   // the same stream again: the same weights
+   rngInit(&rng, BENCH_SEED, (unsigned long long) n);
+   for(i = 0; i < n; i++){
+      w = 10 + rngInt(&rng, 991);
+      fprintf(f, "%d %d %d\n", i + 1, w, 10 + rngInt(&rng, 991));
+   }
+   return fclose(f) == 0;
+}
+
+/** the core of the file with the whole instance in memory (streaming = 0) or with the streaming reader, in a child
+ *  process that prints its time and peak RSS; returns 0 if the child failed */
+static int streamChild(char* filename, int streaming)
+{
+   struct rusage usage;
+   instanceT *I, *R = NULL;
+   itemArraysT* A;
+   coreT* K;
+   coreStreamT S;
+   double start;
+   pid_t pid;
+   int status, n = 0;
+
+   fflush(stdout);
+   pid = fork();
+   if(pid < 0)
+      return 0;
+   if(pid > 0)
+      return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+   start = wallclock();
+   if(streaming){
+      R = coreStream(filename, STREAM_CORE_SIZE, NULL, &S);
+      n = S.n;
+      freeCoreStream(&S);
+   }
+   else if(loadInstanceText(filename, &I)){
+      n = I->n;
+      A = createItemArrays(I);
+      K = A ? createCore(I, A) : NULL;
+      R = K ? coreReduce(K, STREAM_CORE_SIZE) : NULL;
+   }
+   if(!R)
+      _exit(1);
+   getrusage(RUSAGE_SELF, &usage);
+   printf("%-40s %-9s %10d %6d %10.3lf %12.1lf\n", filename, streaming ? "stream" : "memory", n, R->n,
+      wallclock() - start, usage.ru_maxrss/1024.0);
+   fflush(stdout);
+   _exit(0);
+}
+
+static int benchStream(char** files, int nfiles, int synthetic)
+{
+   char* names[8];
+   char name[256];
+   int f, n, nnames = 0, ok = 1;
+
+   if(synthetic){
+      for(n = 100000; n <= STREAM_MAX_ITEMS; n *= 10){
+         snprintf(name, sizeof(name), "%s/bench_stream_%d.mochila", STREAM_DIR, n);
+         if(!writeSynthetic(name, n)){
+            printf("\nProblem to write %s\n", name);
+            ok = 0;
+            break;
+         }
+         names[nnames++] = strdup(name);
+      }
+      files = names;
+      nfiles = nnames;
+   }
+   printf("%-40s %-9s %10s %6s %10s %12s\n", "instance", "reader", "items", "core", "time (s)", "peak RSS (MB)");
+   for(f = 0; f < nfiles; f++)
+      if(!streamChild(files[f], 0) || !streamChild(files[f], 1))
+         printf("%-40s skipped (not an instance)\n", files[f]);
+   for(f = 0; f < nnames; f++){
+      remove(names[f]);
+      free(names[f]);
+   }
+   return ok;
+}
+
+int main(int argc, char** argv)
+{
+   char* files[MAXFILES];
+   int nfiles, f, ok;
+
+   if(argc < 2){
+      printf("\nSintaxe: %s <benchmark> [instance files...]\n\tbenchmarks: loader cache scan model cons relax lagr dw kernels grasp graspmt ls pr tabu ga rounding allocs root ks stream\n", argv[0]);
+      return 1;
+   }
+   if(argc > 2){
+      nfiles = 0;
+      for(f = 2; f < argc && nfiles < MAXFILES; f++)
+         files[nfiles++] = strdup(argv[f]);
+   }
+   else
+      nfiles = listInstances(files, MAXFILES);
+
+   if(!strcmp(argv[1], "loader"))
+      ok = benchLoader(files, nfiles);
+   else if(!strcmp(argv[1], "cache"))
+      ok = benchCache(files, nfiles);
+   else if(!strcmp(argv[1], "scan"))
+      ok = benchScan(files, nfiles);
+   else if(!strcmp(argv[1], "model"))
+      ok = benchModel(files, nfiles);
+   else if(!strcmp(argv[1], "cons"))
+      ok = benchCons(files, nfiles);
+   else if(!strcmp(argv[1], "relax"))
+      ok = benchRelax(files, nfiles);
+   else if(!strcmp(argv[1], "lagr"))
+      ok = benchLagrangian(files, nfiles);
+   else if(!strcmp(argv[1], "dw"))
+      ok = benchFormulation(files, nfiles);
+   else if(!strcmp(argv[1], "kernels"))
+      ok = benchKernels(files, nfiles);
+   else if(!strcmp(argv[1], "grasp"))
+      ok = benchGrasp(files, nfiles);
+   else if(!strcmp(argv[1], "graspmt"))
+      ok = benchGraspThreads(files, nfiles);
+   else if(!strcmp(argv[1], "ls"))
+      ok = benchLocalSearch(files, nfiles);
+   else if(!strcmp(argv[1], "pr"))
+      ok = benchPathRelinking(files, nfiles);
+   else if(!strcmp(argv[1], "tabu"))
+      ok = benchTabu(files, nfiles);
+   else if(!strcmp(argv[1], "ga"))
+      ok = benchGA(files, nfiles);
+   else if(!strcmp(argv[1], "rounding"))
+      ok = benchRounding(files, nfiles);
+   else if(!strcmp(argv[1], "allocs"))
+      ok = benchAllocs(files, nfiles);
+   else if(!strcmp(argv[1], "root"))
+      ok = benchRoot(files, nfiles);
+   else if(!strcmp(argv[1], "ks"))
+      ok = benchKernelSearch(files, nfiles);
+   else if(!strcmp(argv[1], "stream"))
+      ok = benchStream(files, nfiles, argc == 2);
+   else{
+      printf("\nUnknown benchmark: %s\n", argv[1]);
+      ok = 0;
+   }
+   for(f = 0; f < nfiles; f++)
+      free(files[f]);
+   return !ok;
+}
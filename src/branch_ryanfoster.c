@@ -0,0 +1,215 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   branch_ryanfoster.c
+ * @brief  Ryan-Foster branching on pairs of rows of the Dantzig-Wolfe formulation
+ *
+ * The rows of the Dantzig-Wolfe formulation (see probdata_mochila.c) are set partitioning rows with explicit slacks,
+ * so the theorem of Ryan and Foster applies: a fractional LP solution has two rows r1 and r2 such that the sum of
+ * the variables covering both rows is fractional. The rows are knapsacks and items; a pair of knapsacks is never
+ * covered by the same packing, so the pairs are (item, item), whose sum is the fraction of the packings with both
+ * items, and (knapsack j, item i), whose sum is the value of x_i_j in the assignment formulation.
+ *
+ * The pair with the sum closest to 0.5 is chosen and two children are created with a samediff constraint each
+ * (see cons_samediff.c): in the first one, every packing covers both rows or none of them (the items are packed
+ * together, or the item is packed in the knapsack); in the second one, no packing covers both rows.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+
+#include "branch_ryanfoster.h"
+#include "cons_samediff.h"
+#include "probdata_mochila.h"
+#include "vardata_mochila.h"
+
+/**@name Branching rule properties
+ *
+ * @{
+ */
+
+#define BRANCHRULE_NAME            "RyanFoster"
+#define BRANCHRULE_DESC            "Ryan/Foster branching rule on pairs of rows of the packings"
+#define BRANCHRULE_PRIORITY        2000000  /* above branching/pscost/priority set in configScip() */
+#define BRANCHRULE_MAXDEPTH        -1
+#define BRANCHRULE_MAXBOUNDDIST    1.0
+
+/**@} */
+
+/**@name Callback methods
+ *
+ * @{
+ */
+
+/** branching execution method for fractional LP solutions */
+static
+SCIP_DECL_BRANCHEXECLP(branchExeclpRyanFoster)
+{  /*lint --e{715}*/
+   SCIP_PROBDATA* probdata;
+   SCIP_Real** pairweights;
+   SCIP_VAR** lpcands;
+   SCIP_Real* lpcandssol;
+   SCIP_NODE* childsame;
+   SCIP_NODE* childdiffer;
+   SCIP_CONS* conssame;
+   SCIP_CONS* consdiffer;
+   SCIP_Real value;
+   SCIP_Real bestvalue;
+   const int* items;
+   int nitems;
+   int nlpcands;
+   int nknaps;
+   int nrows;
+   int knapsack;
+   int row1;
+   int row2;
+   int a, b, r, v;
+   char name[SCIP_MAXSTRLEN];
+
+   assert(scip != NULL);
+   assert(branchrule != NULL);
+   assert(strcmp(SCIPbranchruleGetName(branchrule), BRANCHRULE_NAME) == 0);
+   assert(result != NULL);
+
+   SCIPdebugMessage("start branching at node %"SCIP_LONGINT_FORMAT", depth %d\n", SCIPgetNNodes(scip), SCIPgetDepth(scip));
+
+   *result = SCIP_DIDNOTRUN;
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+
+   nknaps = SCIPprobdataGetInstance(probdata)->m;
+   nrows = nknaps + SCIPprobdataGetInstance(probdata)->n;
+
+   /* allocate memory for triangle matrix */
+   SCIP_CALL( SCIPallocBufferArray(scip, &pairweights, nrows) );
+   for( r = 0; r < nrows; ++r )
+   {
+      SCIP_CALL( SCIPallocBufferArray(scip, &pairweights[r], r+1) ); /*lint !e866 */
+      BMSclearMemoryArray(pairweights[r], r+1); /*lint !e866 */
+   }
+
+   /* get fractional LP candidates */
+   SCIP_CALL( SCIPgetLPBranchCands(scip, &lpcands, &lpcandssol, NULL, &nlpcands, NULL, NULL) );
+   assert(nlpcands > 0);
+
+   /* compute weights for each pair of rows (row j < m: knapsack j; row m+i: item i) */
+   for( v = 0; v < nlpcands; ++v )
+   {
+      assert(lpcands[v] != NULL);
+
+      knapsack = varGetKnapsack(lpcands[v]);
+      /* the slack of an item covers a single row */
+      if( knapsack < 0 )
+         continue;
+
+      items = varGetItems(lpcands[v], &nitems);
+      for( a = 0; a < nitems; ++a )
+      {
+         pairweights[nknaps + items[a]][knapsack] += lpcandssol[v];
+         for( b = 0; b < a; ++b )
+            pairweights[nknaps + items[a]][nknaps + items[b]] += lpcandssol[v];
+      }
+   }
+
+   /* select the pair of rows whose weight is closest to 0.5 */
+   bestvalue = 0.0;
+   row1 = -1;
+   row2 = -1;
+   for( a = nknaps; a < nrows; ++a )
+   {
+      for( b = 0; b < a; ++b )
+      {
+         value = MIN(pairweights[a][b], 1.0 - pairweights[a][b]);
+         if( value > bestvalue && SCIPisFeasPositive(scip, value) )
+         {
+            bestvalue = value;
+            row1 = b;
+            row2 = a;
+         }
+      }
+   }
+
+   for( r = nrows - 1; r >= 0; --r )
+   {
+      SCIPfreeBufferArray(scip, &pairweights[r]);
+   }
+   SCIPfreeBufferArray(scip, &pairweights);
+
+   /* only possible with two equal packings in the LP: let the next branching rule do it */
+   if( row1 < 0 )
+   {
+      SCIPdebugMessage("no fractional pair of rows in the LP solution\n");
+      return SCIP_OKAY;
+   }
+
+   SCIPdebugMessage("branch on rows <%d> and <%d> (weight %g)\n", row1, row2, bestvalue);
+
+   /* create the branch-and-bound tree child nodes of the current node */
+   SCIP_CALL( SCIPcreateChild(scip, &childsame, 0.0, SCIPgetLocalTransEstimate(scip)) );
+   SCIP_CALL( SCIPcreateChild(scip, &childdiffer, 0.0, SCIPgetLocalTransEstimate(scip)) );
+
+   /* create corresponding constraints */
+   (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "same_%d_%d", row1, row2);
+   SCIP_CALL( SCIPcreateConsSamediff(scip, &conssame, name, row1, row2, SAME, childsame, TRUE) );
+   (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "differ_%d_%d", row1, row2);
+   SCIP_CALL( SCIPcreateConsSamediff(scip, &consdiffer, name, row1, row2, DIFFER, childdiffer, TRUE) );
+
+   /* add constraints to nodes */
+   SCIP_CALL( SCIPaddConsNode(scip, childsame, conssame, NULL) );
+   SCIP_CALL( SCIPaddConsNode(scip, childdiffer, consdiffer, NULL) );
+
+   /* release constraints */
+   SCIP_CALL( SCIPreleaseCons(scip, &conssame) );
+   SCIP_CALL( SCIPreleaseCons(scip, &consdiffer) );
+
+   *result = SCIP_BRANCHED;
+
+   return SCIP_OKAY;
+}
+
+/**@} */
+
+/**@name Interface methods
+ *
+ * @{
+ */
+
+/** creates the ryan foster branching rule and includes it in SCIP */
+SCIP_RETCODE SCIPincludeBranchruleRyanFoster(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_BRANCHRULEDATA* branchruledata;
+   SCIP_BRANCHRULE* branchrule;
+
+   /* create ryan foster branching rule data */
+   branchruledata = NULL;
+   branchrule = NULL;
+
+   /* include branching rule */
+   SCIP_CALL( SCIPincludeBranchruleBasic(scip, &branchrule, BRANCHRULE_NAME, BRANCHRULE_DESC, BRANCHRULE_PRIORITY,
+         BRANCHRULE_MAXDEPTH, BRANCHRULE_MAXBOUNDDIST, branchruledata) );
+   assert(branchrule != NULL);
+
+   SCIP_CALL( SCIPsetBranchruleExecLp(scip, branchrule, branchExeclpRyanFoster) );
+
+   return SCIP_OKAY;
+}
+
+/**@} */
@@ -26,6 +26,7 @@
  **/ 
 
 /*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+#define _POSIX_C_SOURCE 200809L
 #include<stdio.h>
 #include<time.h>
 #include<string.h>
@@ -33,16 +34,35 @@
 #include "scip/scip.h"
 #include "scip/scipdefplugins.h"
 #include "problem.h"
+#include "core.h"
 #include "probdata_mochila.h"
+#include "vardata_mochila.h"
 #include "parameters_mochila.h"
 #include "heur_myrounding.h"
 #include "heur_aleatoria.h"
 #include "heur_grasp.h"
+#include "heur_pathrelinking.h"
+#include "heur_lns.h"
+#include "heur_kernelsearch.h"
+#include "heur_tabu.h"
+#include "heur_genetic.h"
+#include "heur_mydiving.h"
+#include "presol_mochila.h"
+#include "relax_dantzig.h"
+#include "relax_lagrangian.h"
+#include "pricer_mochila.h"
+#include "cons_samediff.h"
+#include "branch_ryanfoster.h"
 
 const char* output_path;
 const char* current_path = ".";
 //
 parametersT param;
+// core mode (--core): the core of the last model solved and its fixings not proven
+coreT* core = NULL;
+// streaming core (--core_stream): the instance is never loaded whole
+coreStreamT stream;
+long long core_nwrong = 0;
 //
 void removePath(char* fullfilename, char** filename);
 void configOutputName(char* name, char* instance_filename, char* program);
@@ -50,6 +70,24 @@ SCIP_RETCODE printStatistic(SCIP* scip, double time, char* outputname);
 void printSol(SCIP* scip, char* outputname);
 SCIP_RETCODE configScip(SCIP** pscip);
 //
+static double wallclock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+/* gap between the bounds as SCIPgetGap() computes it */
+static SCIP_Real computeGap(SCIP* scip, SCIP_Real primalbound, SCIP_Real dualbound)
+{
+  if(SCIPisEQ(scip, primalbound, dualbound))
+    return 0.0;
+  if(SCIPisZero(scip, primalbound) || SCIPisZero(scip, dualbound) || SCIPisInfinity(scip, REALABS(primalbound))
+     || SCIPisInfinity(scip, REALABS(dualbound)) || primalbound * dualbound < 0.0)
+    return SCIPinfinity(scip);
+  return REALABS((primalbound - dualbound)/MIN(REALABS(dualbound), REALABS(primalbound)));
+}
+
 SCIP_RETCODE printStatistic(SCIP* scip, double time, char* outputname)
 {
   SCIP_Bool outputorigsol = TRUE;
@@ -57,6 +95,9 @@ SCIP_RETCODE printStatistic(SCIP* scip, double time, char* outputname)
   char filename[SCIP_MAXSTRLEN];
   FILE* fout;
   SCIP_HEUR* heur_hdlr;
+  SCIP_RELAX* relax_hdlr;
+  SCIP_Real dualbound, rootbound, fullbound;
+  SCIP_STATUS status;
 
   sprintf(filename, "%s.out", outputname);
   fout = fopen(filename,"w");
@@ -87,8 +128,20 @@ SCIP_RETCODE printStatistic(SCIP* scip, double time, char* outputname)
   SCIPinfoMessage(scip, NULL, "\nStatistics\n");
   SCIPinfoMessage(scip, NULL, "==========\n\n");
   SCIP_CALL( SCIPprintStatistics(scip, NULL) );
+  dualbound = SCIPgetDualbound(scip);
+  rootbound = SCIPgetDualboundRoot(scip);
+  status = SCIPgetStatus(scip);
+  // core mode: the bounds of SCIP are of the reduced model. They bound the full instance only if no fixing may cut a
+  // better solution; otherwise the dual bound is the one of the full instance. The full instance is never proven optimal
+  if(param.core){
+    fullbound = param.core_stream ? stream.bound : core->dantzig;
+    dualbound = core_nwrong == 0 ? MIN(dualbound, fullbound) : fullbound;
+    rootbound = core_nwrong == 0 ? MIN(rootbound, fullbound) : fullbound;
+    if(status == SCIP_STATUS_OPTIMAL)
+      status = time >= param.time_limit ? SCIP_STATUS_TIMELIMIT : SCIP_STATUS_UNKNOWN;
+  }
   if(fout!=NULL){
-    fprintf(fout,"%s;%lli;%lf;%lf;%lf;%lf;%lf;%lli;%d;%lf;%lf;%lli;%d;%d", SCIPgetProbName(scip),SCIPgetNRootLPIterations(scip), time, SCIPgetDualbound(scip), SCIPgetPrimalbound(scip), SCIPgetGap(scip), SCIPgetDualboundRoot(scip), SCIPgetNTotalNodes(scip), SCIPgetNNodesLeft(scip), SCIPgetSolvingTime(scip),SCIPgetTotalTime(scip),SCIPgetMemUsed(scip),SCIPgetNLPCols(scip),SCIPgetStatus(scip));
+    fprintf(fout,"%s;%lli;%lf;%lf;%lf;%lf;%lf;%lli;%d;%lf;%lf;%lli;%d;%d", SCIPgetProbName(scip),SCIPgetNRootLPIterations(scip), time, dualbound, SCIPgetPrimalbound(scip), param.core ? computeGap(scip, SCIPgetPrimalbound(scip), dualbound) : SCIPgetGap(scip), rootbound, SCIPgetNTotalNodes(scip), SCIPgetNNodesLeft(scip), SCIPgetSolvingTime(scip),SCIPgetTotalTime(scip),SCIPgetMemUsed(scip),SCIPgetNLPCols(scip),status);
     if(bestSolution!=NULL){
       fprintf(fout, ";bestsol in %lld;%lf;%d;%s", SCIPsolGetNodenum(bestSolution), SCIPsolGetTime(bestSolution), SCIPsolGetDepth(bestSolution), SCIPsolGetHeur(bestSolution) != NULL ? SCIPheurGetName(SCIPsolGetHeur(bestSolution)) : (SCIPsolGetRunnum(bestSolution) == 0 ? "initial" : "relaxation"));
     }
@@ -100,14 +153,53 @@ SCIP_RETCODE printStatistic(SCIP* scip, double time, char* outputname)
        heur_hdlr = SCIPfindHeur(scip, "aleatoria");
        fprintf(fout, ";%lf;%lld;%lld;%lld;%s",SCIPheurGetTime(heur_hdlr),SCIPheurGetNCalls(heur_hdlr), SCIPheurGetNSolsFound(heur_hdlr), SCIPheurGetNBestSolsFound(heur_hdlr), SCIPheurGetName(heur_hdlr));
     }
+    if(param.heur_diving){
+       heur_hdlr = SCIPfindHeur(scip, "mydiving");
+       fprintf(fout, ";%lf;%lld;%lld;%lld;%s",SCIPheurGetTime(heur_hdlr),SCIPheurGetNCalls(heur_hdlr), SCIPheurGetNSolsFound(heur_hdlr), SCIPheurGetNBestSolsFound(heur_hdlr), SCIPheurGetName(heur_hdlr));
+    }
 
     // incluindo a heurista do grasp para mochila multipla
     if(param.heur_grasp){
       heur_hdlr = SCIPfindHeur(scip, "grasp");
       fprintf(fout, ";%lf;%lld;%lld;%lld;%s",SCIPheurGetTime(heur_hdlr),SCIPheurGetNCalls(heur_hdlr), SCIPheurGetNSolsFound(heur_hdlr), SCIPheurGetNBestSolsFound(heur_hdlr), SCIPheurGetName(heur_hdlr));
     }
+    if(param.heur_pathrelinking){
+      heur_hdlr = SCIPfindHeur(scip, "pathrelinking");
+      fprintf(fout, ";%lf;%lld;%lld;%lld;%s",SCIPheurGetTime(heur_hdlr),SCIPheurGetNCalls(heur_hdlr), SCIPheurGetNSolsFound(heur_hdlr), SCIPheurGetNBestSolsFound(heur_hdlr), SCIPheurGetName(heur_hdlr));
+    }
+    if(param.heur_lns){
+      heur_hdlr = SCIPfindHeur(scip, "lns");
+      fprintf(fout, ";%lf;%lld;%lld;%lld;%s",SCIPheurGetTime(heur_hdlr),SCIPheurGetNCalls(heur_hdlr), SCIPheurGetNSolsFound(heur_hdlr), SCIPheurGetNBestSolsFound(heur_hdlr), SCIPheurGetName(heur_hdlr));
+    }
+    if(param.heur_tabu){
+      heur_hdlr = SCIPfindHeur(scip, "tabu");
+      fprintf(fout, ";%lf;%lld;%lld;%lld;%s",SCIPheurGetTime(heur_hdlr),SCIPheurGetNCalls(heur_hdlr), SCIPheurGetNSolsFound(heur_hdlr), SCIPheurGetNBestSolsFound(heur_hdlr), SCIPheurGetName(heur_hdlr));
+    }
+    if(param.heur_genetic){
+      heur_hdlr = SCIPfindHeur(scip, "genetic");
+      fprintf(fout, ";%lf;%lld;%lld;%lld;%s",SCIPheurGetTime(heur_hdlr),SCIPheurGetNCalls(heur_hdlr), SCIPheurGetNSolsFound(heur_hdlr), SCIPheurGetNBestSolsFound(heur_hdlr), SCIPheurGetName(heur_hdlr));
+    }
+    if(param.heur_kernelsearch){
+      heur_hdlr = SCIPfindHeur(scip, "kernelsearch");
+      fprintf(fout, ";%lf;%lld;%lld;%lld;%s",SCIPheurGetTime(heur_hdlr),SCIPheurGetNCalls(heur_hdlr), SCIPheurGetNSolsFound(heur_hdlr), SCIPheurGetNBestSolsFound(heur_hdlr), SCIPheurGetName(heur_hdlr));
+    }
+    if(param.relax_dantzig){
+      relax_hdlr = SCIPfindRelax(scip, "dantzig");
+      fprintf(fout, ";%lf;%lld;%s", SCIPrelaxGetTime(relax_hdlr), SCIPrelaxGetNCalls(relax_hdlr), SCIPrelaxGetName(relax_hdlr));
+    }
+    if(param.relax_lagrangian){
+      relax_hdlr = SCIPfindRelax(scip, "lagrangian");
+      fprintf(fout, ";%lf;%lld;%s", SCIPrelaxGetTime(relax_hdlr), SCIPrelaxGetNCalls(relax_hdlr), SCIPrelaxGetName(relax_hdlr));
+    }
     
+    if(param.core_stream)
+      fprintf(fout, ";core;%d;%d;%lld", stream.size, stream.nabove + stream.nbelow, core_nwrong);
+    else if(param.core)
+      fprintf(fout, ";core;%d;%d;%lld", core->last - core->first, core->ncore, core_nwrong);
     fprintf(fout, ";%s\n", param.parameter_stamp);
+    // one line per sub-MIP of the kernel search, after the line of the instance
+    if(param.heur_kernelsearch)
+      SCIPkernelsearchPrintProgress(scip, fout);
   }
   fclose(fout);
   return SCIP_OKAY;
@@ -129,6 +221,32 @@ SCIP_RETCODE configScip(
    SCIP_CALL( SCIPsetIntParam(scip,"presolving/maxrestarts",0) ); 
    /* disable presolving */
    SCIP_CALL( SCIPsetPresolving(scip, SCIP_PARAMSETTING_OFF, TRUE) ); // turn off
+   /* branch-and-price of the Dantzig-Wolfe formulation: the other plugins work on the variables x_i_j */
+   if(param.formulation == FORMULATION_PACKING){
+     if(param.presol_mochila || param.relax_dantzig || param.relax_lagrangian || param.heur_rounding || param.heur_diving || param.heur_aleatoria || param.heur_grasp || param.heur_pathrelinking || param.heur_lns || param.heur_tabu || param.heur_genetic || param.heur_kernelsearch)
+       printf("\nWarning: presolver, relaxators and heuristics are turned off in the Dantzig-Wolfe formulation\n");
+     param.presol_mochila = param.relax_dantzig = param.relax_lagrangian = 0;
+     param.heur_rounding = param.heur_diving = param.heur_aleatoria = param.heur_grasp = param.heur_pathrelinking = param.heur_lns = param.heur_tabu = param.heur_genetic = param.heur_kernelsearch = 0;
+     /* the pricer does not know the duals of cuts, so no separation on the columns */
+     SCIP_CALL( SCIPsetSeparating(scip, SCIP_PARAMSETTING_OFF, TRUE) );
+     SCIP_CALL( SCIPincludeConshdlrSamediff(scip) );
+     SCIP_CALL( SCIPincludePricerMochila(scip) );
+     SCIP_CALL( SCIPincludeBranchruleRyanFoster(scip) );
+   }
+   /* only the problem specific presolver (included after the setting above, so it keeps its own maxrounds) */
+   if(param.presol_mochila){
+     SCIP_CALL( SCIPincludePresolMochila(scip) );
+     SCIP_CALL( SCIPsetIntParam(scip, "presolving/maxrounds", -1) );
+   }
+   /* Dantzig bound at each node: 1 = together with the LP, 2 = instead of the LP */
+   if(param.relax_dantzig){
+     SCIP_CALL( SCIPincludeRelaxDantzig(scip) );
+     if(param.relax_dantzig == 2)
+       SCIP_CALL( SCIPsetIntParam(scip, "lp/solvefreq", -1) );
+   }
+   /* Lagrangian bound at the root, with the m knapsacks solved in parallel */
+   if(param.relax_lagrangian)
+     SCIP_CALL( SCIPincludeRelaxLagrangian(scip) );
    /* turn off all separation algorithms */
    SCIP_CALL( SCIPsetSeparating(scip, SCIP_PARAMSETTING_OFF, TRUE) ); // turn off
    /* disable heuristics */
@@ -143,12 +261,51 @@ SCIP_RETCODE configScip(
    // active heuristic of rounding
    if(param.heur_rounding)
      SCIP_CALL( SCIPincludeHeurMyRounding(scip) );
+   // active heuristic of diving (the LP iteration quota and the score are parameters of the plugin)
+   if(param.heur_diving){
+     SCIP_CALL( SCIPincludeHeurMyDiving(scip) );
+     SCIP_CALL( SCIPsetRealParam(scip, "heuristics/mydiving/maxlpiterquot", param.heur_div_lpquot) );
+     SCIP_CALL( SCIPsetIntParam(scip, "heuristics/mydiving/score", param.heur_div_score) );
+   }
    // active heuristic aleatoria
    if(param.heur_aleatoria)
      SCIP_CALL( SCIPincludeHeurAleatoria(scip) );
     // ativa a heuristica do grasp
     if(param.heur_grasp){
       SCIP_CALL( SCIPincludeHeurGrasp(scip) );
+      SCIP_CALL( SCIPsetRealParam(scip, "heuristics/grasp/alpha", param.grasp_alpha) );
+      SCIP_CALL( SCIPsetIntParam(scip, "heuristics/grasp/iterations", param.grasp_iter) );
+      SCIP_CALL( SCIPsetRealParam(scip, "heuristics/grasp/maxtime", param.grasp_time) );
+    }
+    // path relinking of the solutions of grasp and aleatoria
+    if(param.heur_pathrelinking){
+      SCIP_CALL( SCIPincludeHeurPathrelinking(scip) );
+      SCIP_CALL( SCIPsetIntParam(scip, "heuristics/pathrelinking/poolsize", param.pr_poolsize) );
+    }
+    // LNS: sub-MIPs in the neighbourhood of the incumbent
+    if(param.heur_lns){
+      SCIP_CALL( SCIPincludeHeurLns(scip) );
+      SCIP_CALL( SCIPsetRealParam(scip, "heuristics/lns/targettime", param.lns_time) );
+      SCIP_CALL( SCIPsetIntParam(scip, "heuristics/lns/nodes", param.lns_nodes) );
+    }
+    // tabu search at the root
+    if(param.heur_tabu){
+      SCIP_CALL( SCIPincludeHeurTabu(scip) );
+      SCIP_CALL( SCIPsetIntParam(scip, "heuristics/tabu/iterations", param.tabu_iter) );
+      SCIP_CALL( SCIPsetRealParam(scip, "heuristics/tabu/maxtime", param.tabu_time) );
+    }
+    // memetic GA at the root, seeded by the LP rounding and the solutions of the heuristics above
+    if(param.heur_genetic){
+      SCIP_CALL( SCIPincludeHeurGenetic(scip) );
+      SCIP_CALL( SCIPsetIntParam(scip, "heuristics/genetic/popsize", param.ga_popsize) );
+      SCIP_CALL( SCIPsetIntParam(scip, "heuristics/genetic/generations", param.ga_gen) );
+      SCIP_CALL( SCIPsetRealParam(scip, "heuristics/genetic/maxtime", param.ga_time) );
+    }
+    // kernel search: sub-MIPs on the kernel of the root LP plus one bucket at a time
+    if(param.heur_kernelsearch){
+      SCIP_CALL( SCIPincludeHeurKernelsearch(scip) );
+      SCIP_CALL( SCIPsetIntParam(scip, "heuristics/kernelsearch/buckets", param.ks_buckets) );
+      SCIP_CALL( SCIPsetRealParam(scip, "heuristics/kernelsearch/maxtime", param.ks_time) );
     }
    
    *pscip = scip;
@@ -172,7 +329,7 @@ int setParameters(int argc, char** argv, parametersT* pparam)
     double ddefault;    
   } settingsT;
 
-  enum {time_limit,display_freq,nodes_limit,param_stamp, param_output_path, heur_rounding, heur_round_freq, heur_round_depth, heur_round_freqofs, heur_aleatoria, heur_grasp, total_parameters};
+  enum {time_limit,display_freq,nodes_limit,param_stamp, param_output_path, heur_rounding, heur_round_freq, heur_round_depth, heur_round_freqofs, heur_diving, heur_div_freq, heur_div_depth, heur_div_freqofs, heur_div_lpquot, heur_div_score, heur_aleatoria, heur_grasp, grasp_alpha, grasp_iter, grasp_time, heur_pathrelinking, pr_poolsize, heur_lns, lns_freq, lns_time, lns_nodes, heur_tabu, tabu_iter, tabu_time, heur_genetic, ga_popsize, ga_gen, ga_time, heur_kernelsearch, ks_buckets, ks_time, local_search, seed, instance_cache, write_lp, model_cons, presol_mochila, relax_dantzig, relax_lagrangian, lagr_iter, threads, formulation, core_mode, core_size, core_stream, total_parameters};
 
   settingsT parameters[]={
             {"time limit", "--time", &(param.time_limit), INT, 0, 7200, 0,0,1800,0},
@@ -184,8 +341,47 @@ int setParameters(int argc, char** argv, parametersT* pparam)
             {"heur round freq", "--heur_round_freq", &(param.heur_round_freq), INT, 0,MAXINT,0,0,1,0},
             {"heur round maxdepth", "--heur_round_depth", &(param.heur_round_maxdepth), INT, -1,MAXINT,0,0,-1,0},
             {"heur round freqofs", "--heur_round_freqofs", &(param.heur_round_freqofs), INT, 0,MAXINT,0,0,0,0},
+            {"heur diving", "--heur_diving", &(param.heur_diving), INT, 0,1,0,0,0,0},
+            {"heur diving freq", "--heur_div_freq", &(param.heur_div_freq), INT, 0,MAXINT,0,0,1,0},
+            {"heur diving maxdepth", "--heur_div_depth", &(param.heur_div_maxdepth), INT, -1,MAXINT,0,0,-1,0},
+            {"heur diving freqofs", "--heur_div_freqofs", &(param.heur_div_freqofs), INT, 0,MAXINT,0,0,0,0},
+            {"heur diving LP iterations quota", "--heur_div_lpquot", &(param.heur_div_lpquot), DOUBLE, 0,0,0.0,1.0,0,0.05},
+            {"heur diving score (0: LP value, 1: LP value x value/weight)", "--heur_div_score", &(param.heur_div_score), INT, 0,1,0,0,0,0},
             {"heur aleatoria", "--heur_aleatoria", &(param.heur_aleatoria), INT, 0,1,0,0,0,0},
-            {"heur grasp", "--heur_grasp", &(param.heur_grasp), INT, 0,1,0,0,0,0}   // eu quem adicionei essa linha
+            {"heur grasp", "--heur_grasp", &(param.heur_grasp), INT, 0,1,0,0,0,0},   // eu quem adicionei essa linha
+            {"grasp alpha", "--grasp_alpha", &(param.grasp_alpha), DOUBLE, 0,0,0.0,1.0,0,0.7},
+            {"grasp iterations", "--grasp_iter", &(param.grasp_iter), INT, 1,100000000,0,0,10,0},
+            {"grasp time per call", "--grasp_time", &(param.grasp_time), DOUBLE, 0,0,0.0,3600.0,0,1.0},
+            {"heur path relinking", "--heur_pathrelinking", &(param.heur_pathrelinking), INT, 0,1,0,0,0,0},
+            {"path relinking pool size", "--pr_poolsize", &(param.pr_poolsize), INT, 1,100000,0,0,10,0},
+            {"heur LNS", "--heur_lns", &(param.heur_lns), INT, 0,1,0,0,0,0},
+            {"heur LNS freq", "--lns_freq", &(param.lns_freq), INT, 0,MAXINT,0,0,10,0},
+            {"LNS target time per sub-MIP", "--lns_time", &(param.lns_time), DOUBLE, 0,0,0.0,3600.0,0,1.0},
+            {"LNS node limit per sub-MIP", "--lns_nodes", &(param.lns_nodes), INT, 1,100000000,0,0,500,0},
+            {"heur tabu search", "--heur_tabu", &(param.heur_tabu), INT, 0,1,0,0,0,0},
+            {"tabu iterations per call", "--tabu_iter", &(param.tabu_iter), INT, 1,100000000,0,0,100000,0},
+            {"tabu time per call", "--tabu_time", &(param.tabu_time), DOUBLE, 0,0,0.0,3600.0,0,1.0},
+            {"heur genetic", "--heur_genetic", &(param.heur_genetic), INT, 0,1,0,0,0,0},
+            {"genetic population size", "--ga_popsize", &(param.ga_popsize), INT, 2,100000,0,0,30,0},
+            {"genetic generations per call", "--ga_gen", &(param.ga_gen), INT, 1,100000000,0,0,200,0},
+            {"genetic time per call", "--ga_time", &(param.ga_time), DOUBLE, 0,0,0.0,3600.0,0,1.0},
+            {"heur kernel search", "--heur_kernelsearch", &(param.heur_kernelsearch), INT, 0,1,0,0,0,0},
+            {"kernel search buckets", "--ks_buckets", &(param.ks_buckets), INT, 0,100000000,0,0,10,0},
+            {"kernel search time per sub-MIP", "--ks_time", &(param.ks_time), DOUBLE, 0,0,0.0,3600.0,0,10.0},
+            {"local search in the heuristics", "--local_search", &(param.local_search), INT, 0,1,0,0,1,0},
+            {"random seed of the heuristics", "--seed", &(param.seed), INT, 0,2147483647,0,0,1,0},
+            {"instance binary cache", "--instance_cache", &(param.instance_cache), INT, 0,1,0,0,1,0},
+            {"write lp file", "--write_lp", &(param.write_lp), INT, 0,1,0,0,0,0},
+            {"model constraints", "--model_cons", &(param.model_cons), INT, 0,1,0,0,1,0},
+            {"presolver mochila", "--presol_mochila", &(param.presol_mochila), INT, 0,1,0,0,0,0},
+            {"relaxator dantzig", "--relax_dantzig", &(param.relax_dantzig), INT, 0,2,0,0,0,0},
+            {"relaxator lagrangian", "--relax_lagrangian", &(param.relax_lagrangian), INT, 0,1,0,0,0,0},
+            {"lagrangian iterations", "--lagr_iter", &(param.lagr_iter), INT, 1,100000000,0,0,100,0},
+            {"threads", "--threads", &(param.threads), INT, 0,256,0,0,0,0},
+            {"formulation", "--formulation", &(param.formulation), INT, 0,1,0,0,0,0},
+            {"core problem", "--core", &(param.core), INT, 0,1,0,0,0,0},
+            {"core size", "--core_size", &(param.core_size), INT, 1,100000000,0,0,1000,0},
+            {"streaming core (the instance is never loaded whole)", "--core_stream", &(param.core_stream), INT, 0,1,0,0,0,0}
 
   };
   int i, j, ivalue, error;
@@ -398,7 +594,8 @@ void printSol(SCIP* scip, char* outputname)
    SCIP_VAR** vars;
    SCIP_Real solval;
    FILE *file;
-   int v, nvars;
+   const int* items;
+   int v, k, nvars, nitems;
    instanceT* I;
    char filename[SCIP_MAXSTRLEN];
    struct tm * ct;
@@ -427,11 +624,22 @@ void printSol(SCIP* scip, char* outputname)
    for( v=0; v< nvars; v++ )
      {
        solval = SCIPgetSolVal(scip, bestSolution, vars[v]);
-       if( solval > EPSILON )
+       // x_i_j or packing of a knapsack (the slacks of the items have no knapsack)
+       if( solval > EPSILON && varGetKnapsack(vars[v]) >= 0 )
 	 {
-	   fprintf(file, "%d ", I->item[v].label);
+	   items = varGetItems(vars[v], &nitems);
+	   for( k = 0; k < nitems; k++ )
+	     fprintf(file, "%d ", I->item[items[k]].label);
 	 }
      }
+   // items fixed in a knapsack out of the model (core mode)
+   if( core != NULL )
+     for( v = 0; v < core->n; v++ )
+       if( core->state[v] >= 0 )
+         fprintf(file, "%d ", core->I->item[v].label);
+   // the streaming core does not keep them: they are in the .fixed file (label knapsack)
+   if( param.core_stream )
+     fprintf(file, "\nFixed items: %lld (value %lld) in %s.fixed", stream.nin, stream.fixedvalue, outputname);
 
    fprintf(file, "\n");
    //
@@ -468,38 +676,117 @@ void configOutputName(char* name, char* instance_filename, char* program)
 int main(int argc, char **argv)
 {
   SCIP* scip;
-  instanceT* in;
+  instanceT *in, *model;
+  itemArraysT* items = NULL;
   clock_t start, end;
-  char outputname[SCIP_MAXSTRLEN];
-  srand(time(NULL));  // semente para o numero aleatorio
+  double elapsed, wallstart;
+  int size;
+  SCIP_Longint memstart;
+  char outputname[SCIP_MAXSTRLEN], filename[SCIP_MAXSTRLEN];
+  FILE* fixedfile = NULL;
 
   // set default+user parameters
   if(!setParameters(argc, argv, &param))
      return 0;
+  // the streaming core is a core mode
+  if(param.core_stream)
+    param.core = 1;
 
-  // load instance file
-  if(!loadInstance(argv[1], &in)){
+  // config output filename
+  configOutputName(outputname, argv[1], argv[0]);
+  // load instance file (using its binary cache .mochilab, if enabled); the streaming core reads it at each core
+  if(param.core_stream)
+    in = NULL;
+  else if(!(param.instance_cache ? loadInstance(argv[1], &in) : loadInstanceText(argv[1], &in))){
     printf("\nProblem to read instance file %s\n", argv[1]);
     return 1;
   }
   //  printInstance(in);
-  // create scip and set scip configurations
-  configScip(&scip);
-  // load problem into scip
-  if(!loadProblem(scip,argv[1],in)){
-    printf("\nProblem to load instance problem\n");
-    return 1;
+  // core mode: the model only has the items around the break item (core.c)
+  if(param.core && !param.core_stream){
+    items = createItemArrays(in);
+    core = items ? createCore(in, items) : NULL;
+    if(!core){
+      printf("\nProblem to create the core of the instance\n");
+      return 1;
+    }
+  }
+  size = param.core_size;
+  elapsed = 0.0;
+  // the time limit of the core mode is in wall time, counted from here
+  wallstart = wallclock();
+  for(;;){
+    // create scip and set scip configurations
+    configScip(&scip);
+    model = in;
+    if(param.core_stream){
+      (void) SCIPsnprintf(filename, SCIP_MAXSTRLEN, "%s.fixed", outputname);
+      fixedfile = fopen(filename, "w");
+      freeCoreStream(&stream);
+      start = clock();
+      model = coreStream(argv[1], size, fixedfile, &stream);
+      end = clock();
+      if(fixedfile)
+        fclose(fixedfile);
+      if(!model){
+        printf("\nProblem to read instance file %s\n", argv[1]);
+        return 1;
+      }
+      printf("\nInstance streamed in %.3lf sec: %d items, %d in the core\n", ((double) (end-start))/CLOCKS_PER_SEC, stream.n, model->n);
+    }
+    else if(core){
+      model = coreReduce(core, size);
+      if(!model){
+        printf("\nProblem to create the core of the instance\n");
+        return 1;
+      }
+    }
+    if(param.core)
+      SCIP_CALL( SCIPsetRealParam(scip, "limits/time", param.time_limit - elapsed) );
+    // load problem into scip (names of vars and constraints are only needed to write the LP file)
+    memstart = SCIPgetMemUsed(scip);
+    start=clock();
+    if(!loadProblem(scip,argv[1],model,param.write_lp,param.model_cons,param.formulation)){
+      printf("\nProblem to load instance problem\n");
+      return 1;
+    }
+    // the items fixed in the knapsacks are a constant of the objective
+    if(param.core)
+      SCIP_CALL( SCIPaddOrigObjoffset(scip, (SCIP_Real) (param.core_stream ? stream.fixedvalue : core->fixedvalue)) );
+    end = clock();
+    printf("\nModel built in %.3lf sec. Memory used: %lld -> %lld bytes\n", ((double) (end-start))/CLOCKS_PER_SEC, (long long) memstart, (long long) SCIPgetMemUsed(scip));
+    // print problem
+    if(param.write_lp){
+       SCIP_CALL( SCIPwriteOrigProblem(scip, "knapsack.lp", "lp", FALSE) );
+    }
+    // solve scip problem
+    start=clock();
+    SCIP_CALL( SCIPsolve(scip) );
+    end = clock();
+    elapsed = param.core ? wallclock() - wallstart : ((double) (end-start))/CLOCKS_PER_SEC;
+    if(!param.core)
+      break;
+    // the core grows while a fixing may cut a better solution, if the core was solved to optimality within the time limit
+    if(param.core_stream){
+      core_nwrong = SCIPgetNSols(scip) > 0 ? coreStreamCheck(&stream, (long long) (SCIPgetPrimalbound(scip) + 0.5)) : stream.n;
+      printf("\nStreaming core of %d items (multiplier %lf): %lld fixed in (value %lld), %lld fixed out, primal bound %.0lf, %lld fixings not proven\n",
+             model->n, stream.ratio, stream.nin, stream.fixedvalue, stream.nout + stream.nunplaced, SCIPgetPrimalbound(scip), core_nwrong);
+      if(core_nwrong == 0 || model->n < size || SCIPgetStatus(scip) != SCIP_STATUS_OPTIMAL || elapsed >= param.time_limit)
+        break;
+      SCIP_CALL( SCIPfree(&scip) );
+      size = size > stream.n/2 ? stream.n : 2*size;
+      continue;
+    }
+    core_nwrong = SCIPgetNSols(scip) > 0 ? coreCheck(core, (long long) (SCIPgetPrimalbound(scip) + 0.5)) : core->n;
+    printf("\nCore of %d items around the break item (position %d): %d items in the model, %d fixed in (value %lld), primal bound %.0lf, %lld fixings not proven\n",
+           core->last - core->first, core->breakpos, core->ncore, core->last - core->ncore, core->fixedvalue, SCIPgetPrimalbound(scip), core_nwrong);
+    if(core_nwrong == 0 || core->ncore >= core->n || SCIPgetStatus(scip) != SCIP_STATUS_OPTIMAL || elapsed >= param.time_limit)
+      break;
+    SCIP_CALL( SCIPfree(&scip) );
+    size = size > core->n/2 ? core->n : 2*size;
   }
-  // print problem
-   SCIP_CALL( SCIPwriteOrigProblem(scip, "knapsack.lp", "lp", FALSE) );  
-  // solve scip problem
-  start=clock();
-  SCIP_CALL( SCIPsolve(scip) );
-  end = clock();
-  // config output filename
-  configOutputName(outputname, argv[1], argv[0]);
   // print statistics and print resume in output file
-  printStatistic(scip,((double) (end-start))/CLOCKS_PER_SEC, outputname);
+  printStatistic(scip, elapsed, outputname);
   // write the best solution in a file
   printSol(scip, outputname);
   //SCIP_CALL( SCIPfree(&scip) ); 
@@ -0,0 +1,539 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   cons_samediff.c
+ * @brief  constraint handler stores the local branching decision of the Ryan-Foster branching
+ *
+ * A samediff constraint on two rows of the Dantzig-Wolfe formulation (see probdata_mochila.c) is valid in the subtree
+ * of a node. SAME means that every variable covers both rows or none of them; DIFFER means that no variable covers
+ * both rows. The slacks are variables too: a SAME constraint on two items forbids their slacks, so both items are
+ * packed in the same knapsack; a SAME constraint on knapsack j and item i puts the item in the knapsack.
+ *
+ * The constraint fixes to 0 the variables that violate it when its node is processed, and again for the variables
+ * created since the last propagation when the node is activated. The pricer (pricer_mochila.c) only generates
+ * packings that respect the active constraints, so the constraints themselves are always feasible.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <string.h>
+
+#include "cons_samediff.h"
+#include "probdata_mochila.h"
+#include "vardata_mochila.h"
+
+
+/**@name Constraint handler properties
+ *
+ * @{
+ */
+
+#define CONSHDLR_NAME          "samediff"
+#define CONSHDLR_DESC          "stores the local branching decisions"
+#define CONSHDLR_ENFOPRIORITY         0 /**< priority of the constraint handler for constraint enforcing */
+#define CONSHDLR_CHECKPRIORITY  9999999 /**< priority of the constraint handler for checking feasibility */
+#define CONSHDLR_PROPFREQ             1 /**< frequency for propagating domains; zero means only preprocessing propagation */
+#define CONSHDLR_EAGERFREQ            1 /**< frequency for using all instead of only the useful constraints in separation,
+                                         *   propagation and enforcement, -1 for no eager evaluations, 0 for first only */
+#define CONSHDLR_DELAYPROP        FALSE /**< should propagation method be delayed, if other propagators found reductions? */
+#define CONSHDLR_NEEDSCONS         TRUE /**< should the constraint handler be skipped, if no constraints are available? */
+
+#define CONSHDLR_PROP_TIMING       SCIP_PROPTIMING_BEFORELP
+
+/**@} */
+
+/*
+ * Data structures
+ */
+
+/** Constraint data for samediff constraints */
+struct SCIP_ConsData
+{
+   int                   row1;               /**< first row */
+   int                   row2;               /**< second row */
+   CONSTYPE              type;               /**< stores whether the rows have to be in the SAME or DIFFER packing */
+   int                   npropagatedvars;    /**< number of variables that existed, the last time, the related node was
+                                              *   propagated, used to determine whether the constraint should be
+                                              *   repropagated */
+   int                   npropagations;      /**< stores the number propagations runs of this constraint */
+   unsigned int          propagated:1;       /**< is constraint already propagated? */
+   SCIP_NODE*            node;               /**< the node in the B&B-tree at which the cons is sticking */
+};
+
+/**@name Local methods
+ *
+ * @{
+ */
+
+/** create constraint data */
+static
+SCIP_RETCODE consdataCreate(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONSDATA**       consdata,           /**< pointer to store the constraint data */
+   int                   row1,               /**< first row */
+   int                   row2,               /**< second row */
+   CONSTYPE              type,               /**< stores whether the rows have to be in the SAME or DIFFER packing */
+   SCIP_NODE*            node                /**< the node in the B&B-tree at which the cons is sticking */
+   )
+{
+   assert(scip != NULL);
+   assert(consdata != NULL);
+   assert(row1 < row2);
+   assert(type == SAME || type == DIFFER);
+
+   SCIP_CALL( SCIPallocBlockMemory(scip, consdata) );
+
+   (*consdata)->row1 = row1;
+   (*consdata)->row2 = row2;
+   (*consdata)->type = type;
+   (*consdata)->npropagatedvars = 0;
+   (*consdata)->npropagations = 0;
+   (*consdata)->propagated = FALSE;
+   (*consdata)->node = node;
+
+   return SCIP_OKAY;
+}
+
+/** display constraint information */
+static
+void consdataPrint(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONSDATA*        consdata,           /**< constraint data */
+   FILE*                 file                /**< file stream */
+   )
+{
+   SCIPinfoMessage(scip, file, "%s(%d,%d) at node %lld\n",
+      consdata->type == SAME ? "same" : "diff", consdata->row1, consdata->row2, SCIPnodeGetNumber(consdata->node) );
+}
+
+/** returns TRUE if the variable covers the row (row j < m: knapsack j; row m+i: item i) */
+static
+SCIP_Bool varCoversRow(
+   SCIP_VAR*             var,                /**< variable of the Dantzig-Wolfe formulation */
+   int                   row,                /**< row */
+   int                   nknaps              /**< number of knapsacks */
+   )
+{
+   if( row < nknaps )
+      return varGetKnapsack(var) == row;
+   return varContainsItem(var, row - nknaps);
+}
+
+/** fixes a variable to zero if the corresponding packing is not valid for this constraint/node (due to branching) */
+static
+SCIP_RETCODE checkVariable(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONSDATA*        consdata,           /**< constraint data */
+   SCIP_VAR*             var,                /**< variable to check */
+   int                   nknaps,             /**< number of knapsacks */
+   int*                  nfixedvars,         /**< pointer to store the number fixed variables */
+   SCIP_Bool*            cutoff              /**< pointer to store if a cutoff was detected */
+   )
+{
+   SCIP_Bool covers1;
+   SCIP_Bool covers2;
+
+   assert(scip != NULL);
+   assert(consdata != NULL);
+   assert(var != NULL);
+   assert(nfixedvars != NULL);
+   assert(cutoff != NULL);
+
+   /* if variables is locally fixed to zero continue */
+   if( SCIPvarGetUbLocal(var) < 0.5 )
+      return SCIP_OKAY;
+
+   covers1 = varCoversRow(var, consdata->row1, nknaps);
+   covers2 = varCoversRow(var, consdata->row2, nknaps);
+
+   /* check if the packing which corresponds to the variable is feasible for this constraint */
+   if( (consdata->type == SAME && covers1 != covers2) || (consdata->type == DIFFER && covers1 && covers2) )
+   {
+      /* the variable can only be fixed locally */
+      if( SCIPvarGetLbLocal(var) > 0.5 )
+      {
+         *cutoff = TRUE;
+         return SCIP_OKAY;
+      }
+      SCIP_CALL( SCIPchgVarUb(scip, var, 0.0) );
+      (*nfixedvars)++;
+   }
+
+   return SCIP_OKAY;
+}
+
+/** fixes variables to zero if the corresponding packings are not valid for this constraint/node (due to branching) */
+static
+SCIP_RETCODE consdataFixVariables(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONSDATA*        consdata,           /**< constraint data */
+   SCIP_VAR**            vars,               /**< generated variables */
+   int                   nvars,              /**< number of generated variables */
+   int                   nknaps,             /**< number of knapsacks */
+   SCIP_RESULT*          result              /**< pointer to store the result of the fixing */
+   )
+{
+   SCIP_Bool cutoff;
+   int nfixedvars;
+   int v;
+
+   nfixedvars = 0;
+   cutoff = FALSE;
+
+   SCIPdebugMessage("check variables %d to %d\n", consdata->npropagatedvars, nvars);
+
+   for( v = consdata->npropagatedvars; v < nvars && !cutoff; ++v )
+   {
+      SCIP_CALL( checkVariable(scip, consdata, vars[v], nknaps, &nfixedvars, &cutoff) );
+   }
+
+   SCIPdebugMessage("fixed %d variables locally\n", nfixedvars);
+
+   if( cutoff )
+      *result = SCIP_CUTOFF;
+   else if( nfixedvars > 0 )
+      *result = SCIP_REDUCEDDOM;
+
+   return SCIP_OKAY;
+}
+
+/**@} */
+
+
+/**@name Callback methods
+ *
+ * @{
+ */
+
+/** frees specific constraint data */
+static
+SCIP_DECL_CONSDELETE(consDeleteSamediff)
+{  /*lint --e{715}*/
+   assert(consdata != NULL);
+
+   SCIPfreeBlockMemory(scip, consdata);
+
+   return SCIP_OKAY;
+}
+
+/** transforms constraint data into data belonging to the transformed problem */
+static
+SCIP_DECL_CONSTRANS(consTransSamediff)
+{  /*lint --e{715}*/
+   SCIP_CONSDATA* sourcedata;
+   SCIP_CONSDATA* targetdata;
+
+   assert(conshdlr != NULL);
+   assert(SCIPgetStage(scip) == SCIP_STAGE_TRANSFORMING);
+   assert(sourcecons != NULL);
+   assert(targetcons != NULL);
+
+   sourcedata = SCIPconsGetData(sourcecons);
+   assert(sourcedata != NULL);
+
+   /* create constraint data for target constraint */
+   SCIP_CALL( consdataCreate(scip, &targetdata, sourcedata->row1, sourcedata->row2, sourcedata->type, sourcedata->node) );
+
+   /* create target constraint */
+   SCIP_CALL( SCIPcreateCons(scip, targetcons, SCIPconsGetName(sourcecons), conshdlr, targetdata,
+         SCIPconsIsInitial(sourcecons), SCIPconsIsSeparated(sourcecons), SCIPconsIsEnforced(sourcecons),
+         SCIPconsIsChecked(sourcecons), SCIPconsIsPropagated(sourcecons),
+         SCIPconsIsLocal(sourcecons), SCIPconsIsModifiable(sourcecons),
+         SCIPconsIsDynamic(sourcecons), SCIPconsIsRemovable(sourcecons), SCIPconsIsStickingAtNode(sourcecons)) );
+
+   return SCIP_OKAY;
+}
+
+/** constraint enforcing method of constraint handler for LP solutions (the constraints are enforced by propagation) */
+static
+SCIP_DECL_CONSENFOLP(consEnfolpSamediff)
+{  /*lint --e{715}*/
+   *result = SCIP_FEASIBLE;
+
+   return SCIP_OKAY;
+}
+
+/** constraint enforcing method of constraint handler for pseudo solutions */
+static
+SCIP_DECL_CONSENFOPS(consEnfopsSamediff)
+{  /*lint --e{715}*/
+   *result = SCIP_FEASIBLE;
+
+   return SCIP_OKAY;
+}
+
+/** feasibility check method of constraint handler for integral solutions */
+static
+SCIP_DECL_CONSCHECK(consCheckSamediff)
+{  /*lint --e{715}*/
+   *result = SCIP_FEASIBLE;
+
+   return SCIP_OKAY;
+}
+
+/** domain propagation method of constraint handler */
+static
+SCIP_DECL_CONSPROP(consPropSamediff)
+{  /*lint --e{715}*/
+   SCIP_PROBDATA* probdata;
+   SCIP_CONSDATA* consdata;
+   SCIP_VAR** vars;
+   int nvars;
+   int c;
+
+   assert(scip != NULL);
+   assert(strcmp(SCIPconshdlrGetName(conshdlr), CONSHDLR_NAME) == 0);
+   assert(result != NULL);
+
+   SCIPdebugMessage("propagation constraints of constraint handler <"CONSHDLR_NAME">\n");
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+
+   vars = SCIPprobdataGetVars(probdata);
+   nvars = SCIPprobdataGetNVars(probdata);
+
+   *result = SCIP_DIDNOTFIND;
+
+   for( c = 0; c < nconss; ++c )
+   {
+      consdata = SCIPconsGetData(conss[c]);
+
+      /* check if all previously generated variables are valid for this constraint */
+      assert( consdata->npropagatedvars <= nvars );
+
+      if( !consdata->propagated )
+      {
+         SCIPdebug( consdataPrint(scip, consdata, NULL) );
+
+         SCIP_CALL( consdataFixVariables(scip, consdata, vars, nvars, SCIPprobdataGetInstance(probdata)->m, result) );
+         consdata->npropagations++;
+
+         if( *result != SCIP_CUTOFF )
+         {
+            consdata->propagated = TRUE;
+            consdata->npropagatedvars = nvars;
+         }
+         else
+            break;
+      }
+
+      /* check if constraint is completely propagated */
+      assert( consdata->npropagatedvars == nvars || *result == SCIP_CUTOFF );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** variable rounding lock method of constraint handler (the constraints only fix variables to zero) */
+static
+SCIP_DECL_CONSLOCK(consLockSamediff)
+{  /*lint --e{715}*/
+   return SCIP_OKAY;
+}
+
+/** constraint activation notification method of constraint handler */
+static
+SCIP_DECL_CONSACTIVE(consActiveSamediff)
+{  /*lint --e{715}*/
+   SCIP_CONSDATA* consdata;
+   SCIP_PROBDATA* probdata;
+
+   assert(scip != NULL);
+   assert(strcmp(SCIPconshdlrGetName(conshdlr), CONSHDLR_NAME) == 0);
+   assert(cons != NULL);
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+
+   consdata = SCIPconsGetData(cons);
+   assert(consdata != NULL);
+   assert(consdata->npropagatedvars <= SCIPprobdataGetNVars(probdata));
+
+   SCIPdebugMessage("activate constraint <%s> at node <%"SCIP_LONGINT_FORMAT"> in depth <%d>: ",
+      SCIPconsGetName(cons), SCIPnodeGetNumber(consdata->node), SCIPnodeGetDepth(consdata->node));
+   SCIPdebug( consdataPrint(scip, consdata, NULL) );
+
+   if( consdata->npropagatedvars != SCIPprobdataGetNVars(probdata) )
+   {
+      SCIPdebugMessage("-> mark constraint to be repropagated\n");
+      consdata->propagated = FALSE;
+      SCIP_CALL( SCIPrepropagateNode(scip, consdata->node) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** constraint deactivation notification method of constraint handler */
+static
+SCIP_DECL_CONSDEACTIVE(consDeactiveSamediff)
+{  /*lint --e{715}*/
+   SCIP_CONSDATA* consdata;
+   SCIP_PROBDATA* probdata;
+
+   assert(scip != NULL);
+   assert(strcmp(SCIPconshdlrGetName(conshdlr), CONSHDLR_NAME) == 0);
+   assert(cons != NULL);
+
+   consdata = SCIPconsGetData(cons);
+   assert(consdata != NULL);
+   assert(consdata->propagated || SCIPgetNChildren(scip) == 0);
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+
+   SCIPdebugMessage("deactivate constraint <%s> at node <%"SCIP_LONGINT_FORMAT"> in depth <%d>: ",
+      SCIPconsGetName(cons), SCIPnodeGetNumber(consdata->node), SCIPnodeGetDepth(consdata->node));
+   SCIPdebug( consdataPrint(scip, consdata, NULL) );
+
+   /* set the number of propagated variables to current number of variables is SCIP */
+   consdata->npropagatedvars = SCIPprobdataGetNVars(probdata);
+
+   return SCIP_OKAY;
+}
+
+/** constraint display method of constraint handler */
+static
+SCIP_DECL_CONSPRINT(consPrintSamediff)
+{  /*lint --e{715}*/
+   SCIP_CONSDATA*  consdata;
+
+   consdata = SCIPconsGetData(cons);
+   assert(consdata != NULL);
+
+   consdataPrint(scip, consdata, file);
+
+   return SCIP_OKAY;
+}
+
+/**@} */
+
+/**@name Interface methods
+ *
+ * @{
+ */
+
+/** creates the handler for samediff constraints and includes it in SCIP */
+SCIP_RETCODE SCIPincludeConshdlrSamediff(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_CONSHDLRDATA* conshdlrdata = NULL;
+   SCIP_CONSHDLR* conshdlr = NULL;
+
+   /* include constraint handler */
+   SCIP_CALL( SCIPincludeConshdlrBasic(scip, &conshdlr, CONSHDLR_NAME, CONSHDLR_DESC,
+         CONSHDLR_ENFOPRIORITY, CONSHDLR_CHECKPRIORITY, CONSHDLR_EAGERFREQ, CONSHDLR_NEEDSCONS,
+         consEnfolpSamediff, consEnfopsSamediff, consCheckSamediff, consLockSamediff,
+         conshdlrdata) );
+   assert(conshdlr != NULL);
+
+   SCIP_CALL( SCIPsetConshdlrDelete(scip, conshdlr, consDeleteSamediff) );
+   SCIP_CALL( SCIPsetConshdlrTrans(scip, conshdlr, consTransSamediff) );
+   SCIP_CALL( SCIPsetConshdlrProp(scip, conshdlr, consPropSamediff, CONSHDLR_PROPFREQ, CONSHDLR_DELAYPROP,
+         CONSHDLR_PROP_TIMING) );
+   SCIP_CALL( SCIPsetConshdlrActive(scip, conshdlr, consActiveSamediff) );
+   SCIP_CALL( SCIPsetConshdlrDeactive(scip, conshdlr, consDeactiveSamediff) );
+   SCIP_CALL( SCIPsetConshdlrPrint(scip, conshdlr, consPrintSamediff) );
+
+   return SCIP_OKAY;
+}
+
+/** creates and captures a samediff constraint on the rows row1 < row2 of the Dantzig-Wolfe formulation */
+SCIP_RETCODE SCIPcreateConsSamediff(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONS**           cons,               /**< pointer to hold the created constraint */
+   const char*           name,               /**< name of constraint */
+   int                   row1,               /**< first row */
+   int                   row2,               /**< second row */
+   CONSTYPE              type,               /**< stores whether the rows have to be in the SAME or DIFFER packing */
+   SCIP_NODE*            node,               /**< the node in the B&B-tree at which the cons is sticking */
+   SCIP_Bool             local               /**< is constraint only valid locally? */
+   )
+{
+   SCIP_CONSHDLR* conshdlr;
+   SCIP_CONSDATA* consdata;
+
+   /* find the samediff constraint handler */
+   conshdlr = SCIPfindConshdlr(scip, CONSHDLR_NAME);
+   if( conshdlr == NULL )
+   {
+      SCIPerrorMessage("samediff constraint handler not found\n");
+      return SCIP_PLUGINNOTFOUND;
+   }
+
+   /* create the constraint specific data */
+   SCIP_CALL( consdataCreate(scip, &consdata, row1, row2, type, node) );
+
+   /* create constraint */
+   SCIP_CALL( SCIPcreateCons(scip, cons, name, conshdlr, consdata, FALSE, FALSE, FALSE, FALSE, TRUE,
+         local, FALSE, FALSE, FALSE, TRUE) );
+
+   SCIPdebugMessage("created constraint: ");
+   SCIPdebug( consdataPrint(scip, consdata, NULL) );
+
+   return SCIP_OKAY;
+}
+
+/** returns the first row of the samediff constraint */
+int SCIPgetRow1Samediff(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONS*            cons                /**< samediff constraint */
+   )
+{
+   SCIP_CONSDATA* consdata;
+
+   assert(cons != NULL);
+
+   consdata = SCIPconsGetData(cons);
+   assert(consdata != NULL);
+
+   return consdata->row1;
+}
+
+/** returns the second row of the samediff constraint */
+int SCIPgetRow2Samediff(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONS*            cons                /**< samediff constraint */
+   )
+{
+   SCIP_CONSDATA* consdata;
+
+   assert(cons != NULL);
+
+   consdata = SCIPconsGetData(cons);
+   assert(consdata != NULL);
+
+   return consdata->row2;
+}
+
+/** return constraint type SAME or DIFFER */
+CONSTYPE SCIPgetTypeSamediff(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONS*            cons                /**< samediff constraint */
+   )
+{
+   SCIP_CONSDATA* consdata;
+
+   assert(cons != NULL);
+
+   consdata = SCIPconsGetData(cons);
+   assert(consdata != NULL);
+
+   return consdata->type;
+}
+
+/**@} */
@@ -0,0 +1,82 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   cons_samediff.h
+ * @brief  constraint handler stores the local branching decision of the Ryan-Foster branching
+ *
+ * template file for constraint handler plugins
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_CONS_SAMEDIFF_H__
+#define __SCIP_CONS_SAMEDIFF_H__
+
+
+#include "scip/scip.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* type of constraint: differ or same */
+enum ConsType
+{
+   DIFFER = 0,                               /**< no variable covers both rows */
+   SAME   = 1                                /**< each variable covers both rows or none of them */
+};
+typedef enum ConsType CONSTYPE;
+
+/** creates the handler for samediff constraints and includes it in SCIP */
+SCIP_RETCODE SCIPincludeConshdlrSamediff(
+   SCIP*                 scip                /**< SCIP data structure */
+   );
+
+/** creates and captures a samediff constraint on the rows row1 < row2 of the Dantzig-Wolfe formulation (row j < m:
+ *  knapsack j; row m+i: item i) */
+SCIP_RETCODE SCIPcreateConsSamediff(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONS**           cons,               /**< pointer to hold the created constraint */
+   const char*           name,               /**< name of constraint */
+   int                   row1,               /**< first row */
+   int                   row2,               /**< second row */
+   CONSTYPE              type,               /**< stores whether the rows have to be in the SAME or DIFFER packing */
+   SCIP_NODE*            node,               /**< the node in the B&B-tree at which the cons is sticking */
+   SCIP_Bool             local               /**< is constraint only valid locally? */
+   );
+
+/** returns the first row of the samediff constraint */
+int SCIPgetRow1Samediff(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONS*            cons                /**< samediff constraint */
+   );
+
+/** returns the second row of the samediff constraint */
+int SCIPgetRow2Samediff(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONS*            cons                /**< samediff constraint */
+   );
+
+/** return constraint type SAME or DIFFER */
+CONSTYPE SCIPgetTypeSamediff(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONS*            cons                /**< samediff constraint */
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,408 @@
+/**@file   core.c
+ * @brief  core problem of the multiple knapsack problem (no SCIP calls)
+ *
+ * The break item and the Dantzig bound do not depend on the core and are computed once by createCore(); a core costs
+ * O(n*m) for the knapsacks of the items fixed in and O(n) for the check. The streaming core (coreStream()) only keeps the
+ * heaps of the core, the capacities and the histograms (of fixed size) in memory, whatever n.
+ **/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "core.h"
+
+coreT* createCore(instanceT* I, const itemArraysT* A)
+{
+  coreT* K;
+  long long residual;
+  int p, i, k;
+
+  K = (coreT*) calloc(1, sizeof(coreT));
+  if(!K)
+    return NULL;
+  K->n = I->n;
+  K->m = I->m;
+  K->I = I;
+  K->A = A;
+  K->state = (int*) malloc(sizeof(int)*I->n);
+  K->items = (int*) malloc(sizeof(int)*I->n);
+  K->residual = (int*) malloc(sizeof(int)*I->m);
+  if(!K->state || !K->items || !K->residual){
+    freeCore(K);
+    return NULL;
+  }
+  for(k = 0; k < I->m; k++){
+    K->capacity += I->C[k];
+    if(I->C[k] > K->maxweight)
+      K->maxweight = I->C[k];
+  }
+  // break item of the aggregated capacity (the items that fit no knapsack are left out)
+  residual = K->capacity;
+  K->breakpos = I->n;
+  for(p = 0; p < I->n; p++){
+    i = A->byRatio[p];
+    if(A->weight[i] > K->maxweight)
+      continue;
+    if(A->weight[i] > residual){
+      K->breakpos = p;
+      K->ratio = A->weight[i] > 0 ? (double) A->value[i]/A->weight[i] : 0.0;
+      K->dantzig += K->ratio*residual;
+      break;
+    }
+    residual -= A->weight[i];
+    K->dantzig += A->value[i];
+  }
+  return K;
+}
+
+void freeCore(coreT* K)
+{
+  if(!K)
+    return;
+  free(K->state);
+  free(K->items);
+  free(K->residual);
+  free(K);
+}
+
+instanceT* coreReduce(coreT* K, int size)
+{
+  const itemArraysT* A = K->A;
+  instanceT* R;
+  int p, i, k, largest, c;
+
+  // window around the break item
+  if(size > K->n)
+    size = K->n;
+  K->first = K->breakpos - size/2;
+  if(K->first < 0)
+    K->first = 0;
+  K->last = K->first + size;
+  if(K->last > K->n){
+    K->last = K->n;
+    K->first = K->n - size;
+  }
+  // the items before the window in the knapsack of largest residual capacity, the items after it out
+  memcpy(K->residual, K->I->C, sizeof(int)*K->m);
+  K->fixedvalue = 0;
+  K->ncore = 0;
+  for(p = 0; p < K->n; p++){
+    i = A->byRatio[p];
+    if(p >= K->last)
+      K->state[i] = CORE_OUT;
+    else if(p >= K->first)
+      K->state[i] = CORE_FREE;
+    else{
+      largest = 0;
+      for(k = 1; k < K->m; k++)
+        if(K->residual[k] > K->residual[largest])
+          largest = k;
+      if(A->weight[i] <= K->residual[largest]){
+        K->state[i] = largest;
+        K->residual[largest] -= A->weight[i];
+        K->fixedvalue += A->value[i];
+      }
+      else
+        K->state[i] = CORE_FREE;
+    }
+  }
+  // reduced instance: the core items in their order in I
+  for(i = 0; i < K->n; i++)
+    if(K->state[i] == CORE_FREE)
+      K->items[K->ncore++] = i;
+  createInstance(&R, K->ncore, K->m);
+  if(!R)
+    return NULL;
+  memcpy(R->C, K->residual, sizeof(int)*K->m);
+  for(c = 0; c < K->ncore; c++)
+    R->item[c] = K->I->item[K->items[c]];
+  return R;
+}
+
+int coreCheck(const coreT* K, long long value)
+{
+  const itemArraysT* A = K->A;
+  double bound;
+  int i, nwrong = 0;
+
+  for(i = 0; i < K->n; i++){
+    if(K->state[i] == CORE_FREE || (K->state[i] == CORE_OUT && A->weight[i] > K->maxweight))
+      continue;
+    // Dembo-Hammer bound of the opposite state (the objective is integral)
+    bound = K->dantzig - fabs(A->value[i] - K->ratio*A->weight[i]);
+    if(floor(bound + 1e-6) > value)
+      nwrong++;
+  }
+  return nwrong;
+}
+
+/*
+ * streaming core
+ */
+#define HIST_SCALE   (CORE_HIST_BUCKETS/64)
+#define MARGIN_SCALE (CORE_MARGIN_BUCKETS/64)
+
+/** bucket of log2(value/weight) */
+static int histBucket(int value, int weight)
+{
+  double b;
+
+  if(value <= 0)
+    return 0;
+  if(weight <= 0)
+    return CORE_HIST_BUCKETS - 1;
+  b = floor((log2((double) value) - log2((double) weight) + 32.0)*HIST_SCALE);
+  return b < 0 ? 0 : b >= CORE_HIST_BUCKETS ? CORE_HIST_BUCKETS - 1 : (int) b;
+}
+
+/** bucket of log2 |v - ratio*w| (0: less than 1) */
+static int marginBucket(const coreStreamT* S, int value, int weight)
+{
+  double d = fabs(value - S->ratio*weight), b;
+
+  if(d < 1.0)
+    return 0;
+  b = 1.0 + floor(log2(d)*MARGIN_SCALE);
+  return b >= CORE_MARGIN_BUCKETS ? CORE_MARGIN_BUCKETS - 1 : (int) b;
+}
+
+/** 1 if a comes before b in the order by value/weight (non-increasing, ties by index), as A->byRatio */
+static int before(const coreItemT* a, const coreItemT* b)
+{
+  long long l = (long long) a->value*b->weight, r = (long long) b->value*a->weight;
+
+  return l > r || (l == r && a->index < b->index);
+}
+
+/** heap order: the root of the heap of the items above comes first in the order by value/weight, the root of the heap
+ *  of the items below comes last */
+static int higher(const coreItemT* a, const coreItemT* b, int above)
+{
+  return above ? before(a, b) : before(b, a);
+}
+
+static void siftUp(coreItemT* h, int c, int above)
+{
+  coreItemT x = h[c];
+  int p;
+
+  for(; c > 0 && higher(&x, &h[p = (c - 1)/2], above); c = p)
+    h[c] = h[p];
+  h[c] = x;
+}
+
+static void siftDown(coreItemT* h, int n, int above)
+{
+  coreItemT x = h[0];
+  int c = 0, s;
+
+  while((s = 2*c + 1) < n){
+    if(s + 1 < n && higher(&h[s + 1], &h[s], above))
+      s++;
+    if(!higher(&h[s], &x, above))
+      break;
+    h[c] = h[s];
+    c = s;
+  }
+  h[c] = x;
+}
+
+/** the item x goes to the knapsack of largest residual capacity, or out if it fits none */
+static void fixIn(coreStreamT* S, const coreItemT* x)
+{
+  int k, largest = 0;
+
+  for(k = 1; k < S->m; k++)
+    if(S->residual[k] > S->residual[largest])
+      largest = k;
+  if(x->weight > S->residual[largest]){
+    S->nunplaced++;
+    return;
+  }
+  S->residual[largest] -= x->weight;
+  S->nin++;
+  S->fixedvalue += x->value;
+  S->margin[marginBucket(S, x->value, x->weight)]++;
+  if(S->fixedfile)
+    fprintf(S->fixedfile, "%d %d\n", x->label, largest);
+}
+
+static void fixOut(coreStreamT* S, const coreItemT* x)
+{
+  S->nout++;
+  S->margin[marginBucket(S, x->value, x->weight)]++;
+}
+
+/** the item x enters the heap of its side; the item that leaves the heap (x itself or the root) is fixed */
+static void streamCore(coreStreamT* S, const coreItemT* x)
+{
+  int above = x->value >= S->ratio*x->weight;
+  coreItemT* h = above ? S->above : S->below;
+  int* n = above ? &S->nabove : &S->nbelow;
+  int max = above ? S->maxabove : S->maxbelow;
+  coreItemT out;
+
+  if(*n < max){
+    h[*n] = *x;
+    siftUp(h, (*n)++, above);
+    return;
+  }
+  if(max == 0 || higher(x, &h[0], above))
+    out = *x;
+  else{
+    out = h[0];
+    h[0] = *x;
+    siftDown(h, *n, above);
+  }
+  if(above)
+    fixIn(S, &out);
+  else
+    fixOut(S, &out);
+}
+
+static int streamHeader(void* ctx, int n, int m, const int* C)
+{
+  coreStreamT* S = (coreStreamT*) ctx;
+  int k;
+
+  if(S->pass == 2)
+    return n == S->n && m == S->m;
+  S->n = n;
+  S->m = m;
+  S->residual = (int*) malloc(sizeof(int)*m);
+  if(!S->residual)
+    return 0;
+  for(k = 0; k < m; k++){
+    S->residual[k] = C[k];
+    S->capacity += C[k];
+    if(C[k] > S->maxweight)
+      S->maxweight = C[k];
+  }
+  return 1;
+}
+
+static void streamItem(void* ctx, int i, int label, int weight, int value)
+{
+  coreStreamT* S = (coreStreamT*) ctx;
+  coreItemT x;
+  int b;
+
+  // an item heavier than every knapsack is out of the relaxation and of the core
+  if(weight > S->maxweight){
+    if(S->pass == 2)
+      S->nout++;
+    return;
+  }
+  if(S->pass == 1){
+    b = histBucket(value, weight);
+    S->histcount[b]++;
+    S->histweight[b] += weight;
+    return;
+  }
+  if(value > S->ratio*weight)
+    S->bound += value - S->ratio*weight;
+  x.index = i;
+  x.label = label;
+  x.weight = weight;
+  x.value = value;
+  streamCore(S, &x);
+}
+
+static int cmpIndex(const void* a, const void* b)
+{
+  return ((const coreItemT*) a)->index - ((const coreItemT*) b)->index;
+}
+
+instanceT* coreStream(char* filename, int size, FILE* fixedfile, coreStreamT* S)
+{
+  instanceT* R;
+  coreItemT* items;
+  long long cum;
+  double f;
+  int b, c;
+
+  memset(S, 0, sizeof(coreStreamT));
+  S->size = size;
+  S->fixedfile = fixedfile;
+  S->histcount = (long long*) calloc(CORE_HIST_BUCKETS, sizeof(long long));
+  S->histweight = (long long*) calloc(CORE_HIST_BUCKETS, sizeof(long long));
+  S->margin = (long long*) calloc(CORE_MARGIN_BUCKETS, sizeof(long long));
+  S->maxabove = size/2;
+  S->maxbelow = size - size/2;
+  S->above = (coreItemT*) malloc(sizeof(coreItemT)*(S->maxabove + 1));
+  S->below = (coreItemT*) malloc(sizeof(coreItemT)*(S->maxbelow + 1));
+  if(!S->histcount || !S->histweight || !S->margin || !S->above || !S->below)
+    return NULL;
+
+  // pass 1: the multiplier, in the bucket of the break item (0 if every item fits the aggregated capacity)
+  S->pass = 1;
+  if(!streamInstance(filename, streamHeader, streamItem, S))
+    return NULL;
+  S->ratio = 0.0;
+  cum = 0;
+  for(b = CORE_HIST_BUCKETS - 1; b >= 0; b--){
+    if(cum + S->histweight[b] > S->capacity){
+      f = (double) (S->capacity - cum)/S->histweight[b];
+      S->ratio = exp2((b + 1.0 - f)/HIST_SCALE - 32.0);
+      break;
+    }
+    cum += S->histweight[b];
+  }
+  // the histogram is not needed in pass 2
+  free(S->histcount);
+  free(S->histweight);
+  S->histcount = S->histweight = NULL;
+
+  // pass 2: the core and the fixings
+  S->pass = 2;
+  S->bound = S->ratio*S->capacity;
+  if(!streamInstance(filename, streamHeader, streamItem, S))
+    return NULL;
+
+  // reduced instance: the core items in their order in the file
+  items = (coreItemT*) malloc(sizeof(coreItemT)*(S->nabove + S->nbelow + 1));
+  if(!items)
+    return NULL;
+  memcpy(items, S->above, sizeof(coreItemT)*S->nabove);
+  memcpy(items + S->nabove, S->below, sizeof(coreItemT)*S->nbelow);
+  qsort(items, S->nabove + S->nbelow, sizeof(coreItemT), cmpIndex);
+  createInstance(&R, S->nabove + S->nbelow, S->m);
+  if(R){
+    memcpy(R->C, S->residual, sizeof(int)*S->m);
+    for(c = 0; c < R->n; c++){
+      R->item[c].label = items[c].label;
+      R->item[c].weight = items[c].weight;
+      R->item[c].value = items[c].value;
+    }
+  }
+  free(items);
+  return R;
+}
+
+void freeCoreStream(coreStreamT* S)
+{
+  free(S->histcount);
+  free(S->histweight);
+  free(S->margin);
+  free(S->above);
+  free(S->below);
+  free(S->residual);
+  S->histcount = S->histweight = S->margin = NULL;
+  S->above = S->below = NULL;
+  S->residual = NULL;
+}
+
+long long coreStreamCheck(const coreStreamT* S, long long value)
+{
+  long long nwrong = S->nunplaced;
+  double low;
+  int b;
+
+  for(b = 0; b < CORE_MARGIN_BUCKETS; b++){
+    low = b == 0 ? 0.0 : exp2((b - 1.0)/MARGIN_SCALE);
+    if(floor(S->bound - low + 1e-6) > value)
+      nwrong += S->margin[b];
+  }
+  return nwrong;
+}
@@ -0,0 +1,108 @@
+/**@file   core.h
+ * @brief  core problem of the multiple knapsack problem (no SCIP calls)
+ *
+ * As in the core algorithms of Pisinger for the knapsack problem, the items are taken by value/weight (A->byRatio) and
+ * the break item is the first one that does not fit the aggregated capacity (sum of the capacities). Only a window of
+ * items around the break item (the core) is left to the model: the items before it are fixed in a knapsack (each one in
+ * the knapsack of largest residual capacity; an item that fits no knapsack joins the core) and the items after it are
+ * fixed out. The reduced instance has the core items and the residual capacities, so the model has (core size)*m
+ * columns instead of n*m.
+ *
+ * A fixing is checked by the bound of Dembo and Hammer on the aggregated capacity: with the value/weight r of the break
+ * item as multiplier, an item j in the opposite state gives at most dantzig - |v_j - r*w_j|. If this bound is not
+ * larger than the value of a solution, no better solution has j in the opposite state. The check covers the in/out
+ * state of the fixed items, not the knapsack chosen for the items fixed in.
+ **/
+#ifndef __MOCHILA_CORE_H__
+#define __MOCHILA_CORE_H__
+
+#include "problem.h"
+
+#define CORE_OUT  -1   /**< state of an item fixed out of the knapsacks */
+#define CORE_FREE -2   /**< state of an item of the core */
+
+typedef struct{
+   int n;                  /**< quant de itens */
+   int m;                  /**< quant de mochilas */
+   instanceT* I;           /**< full instance (not owned) */
+   const itemArraysT* A;   /**< items of the full instance (not owned) */
+   long long capacity;     /**< aggregated capacity */
+   int breakpos;           /**< position in A->byRatio of the break item (n: every item fits) */
+   double dantzig;         /**< Dantzig bound of the aggregated capacity */
+   double ratio;           /**< value/weight of the break item (0 if there is none) */
+   int maxweight;          /**< largest capacity: an item heavier than it can not be packed */
+   // current core
+   int first, last;        /**< window [first, last) of positions in A->byRatio */
+   int* state;             /**< state[i] = knapsack where the item i is fixed, CORE_OUT or CORE_FREE */
+   int* items;             /**< items[c] = item of the full instance of the item c of the reduced instance */
+   int ncore;              /**< items in the core (the window plus the items that fit no knapsack) */
+   int* residual;          /**< residual capacities left by the items fixed in */
+   long long fixedvalue;   /**< value of the items fixed in */
+} coreT;
+
+// break item and Dantzig bound of the instance; NULL if out of memory
+coreT* createCore(instanceT* I, const itemArraysT* A);
+void freeCore(coreT* K);
+// core of size items around the break item (the whole instance if size >= n). Returns the reduced instance, with the
+// labels of the items of I (the caller owns it, e.g. SCIPprobdataCreate()), or NULL if out of memory
+instanceT* coreReduce(coreT* K, int size);
+// number of fixed items whose Dembo-Hammer bound in the opposite state is larger than value, the value of a solution
+// of the full instance (fixed items plus reduced instance): 0 means that no better solution changes a fixing
+int coreCheck(const coreT* K, long long value);
+
+/*
+ * streaming core (coreStream()): the instance is read twice by streamInstance() and never kept whole in memory
+ *
+ *    pass 1  histogram of log2(value/weight) (CORE_HIST_BUCKETS buckets): the bucket of the break item of the aggregated
+ *            capacity gives the multiplier, an estimate of the value/weight of the break item
+ *    pass 2  the core is the size/2 items after the multiplier (a heap of the lowest ones above it) and the others before
+ *            it (a heap of the highest ones below it); the items that leave a heap are fixed (in the knapsack of largest
+ *            residual capacity or out) at once, so the memory does not depend on n
+ *
+ * The Lagrangian bound of the aggregated capacity with the multiplier and the histogram of the margins |v_j - r*w_j| of
+ * the fixed items are accumulated in pass 2, so the Dembo-Hammer check of coreStreamCheck() needs no other pass. As the
+ * margins are bucketed, the check counts a whole bucket as not proven if its lower end is.
+ */
+#define CORE_HIST_BUCKETS   65536  /**< buckets of log2(value/weight) in [-32, 32) */
+#define CORE_MARGIN_BUCKETS 4096   /**< buckets of log2(margin) in [0, 64) (bucket 0: margin < 1) */
+
+/** item of a heap of the streaming core */
+typedef struct{
+   int index;              /**< position in the file */
+   int label;
+   int weight;
+   int value;
+} coreItemT;
+
+typedef struct{
+   int n;                  /**< quant de itens */
+   int m;                  /**< quant de mochilas */
+   long long capacity;     /**< aggregated capacity */
+   int maxweight;          /**< largest capacity */
+   int size;               /**< items asked for the core */
+   int pass;               /**< pass of the reading (1 or 2) */
+   double ratio;           /**< multiplier: estimate of the value/weight of the break item */
+   double bound;           /**< Lagrangian bound of the aggregated capacity with the multiplier */
+   long long* histcount;   /**< items of each bucket of log2(value/weight) */
+   long long* histweight;  /**< weight of each bucket */
+   long long* margin;      /**< fixed items of each bucket of log2 |v_j - ratio*w_j| */
+   coreItemT* above;       /**< max-heap (by value/weight) of the core items above the multiplier */
+   int nabove, maxabove;
+   coreItemT* below;       /**< min-heap (by value/weight) of the core items below the multiplier */
+   int nbelow, maxbelow;
+   int* residual;          /**< residual capacities left by the items fixed in */
+   long long nin;          /**< items fixed in a knapsack */
+   long long nout;         /**< items fixed out */
+   long long nunplaced;    /**< items above the multiplier fixed out because they fit no knapsack */
+   long long fixedvalue;   /**< value of the items fixed in */
+   FILE* fixedfile;        /**< if not NULL, gets a line "label knapsack" for each item fixed in */
+} coreStreamT;
+
+// reads the instance file in two streaming passes and returns the reduced instance with a core of size items (the
+// caller owns it, e.g. SCIPprobdataCreate()), or NULL if the file can not be read or out of memory. S keeps the summary
+// of the fixed items; fixedfile (may be NULL) gets the items fixed in
+instanceT* coreStream(char* filename, int size, FILE* fixedfile, coreStreamT* S);
+void freeCoreStream(coreStreamT* S);
+// as coreCheck(): number of fixings (at most, see above) whose Dembo-Hammer bound is larger than value
+long long coreStreamCheck(const coreStreamT* S, long long value);
+#endif
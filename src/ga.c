@@ -0,0 +1,331 @@
+/**@file   ga.c
+ * @brief  memetic genetic algorithm for the multiple knapsack problem (no SCIP calls)
+ *
+ * The crossover costs O(n + m): each knapsack gets its parent and its rank in the random order, and each item goes to
+ * its knapsack in the parent of that knapsack; an item wanted by both parents goes to the knapsack of lower rank. The
+ * repair walks A->byRatio backwards once, so it costs O(n) whatever the number of overloaded knapsacks.
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ga.h"
+
+#define ALLOWED(G, i, k) ((G)->allowed[(size_t) (i)*(G)->m + (k)])
+#define DEFAULT_MUTATIONS 2
+#define RNG_STREAM_TOURNAMENT (~0ULL)
+
+static double wallclock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+gaT* createGA(instanceT* I, const itemArraysT* A, int popsize, threadpoolT* pool, unsigned long long seed)
+{
+  gaT* G;
+  gaWorkerT* W;
+  int w, ok;
+
+  G = (gaT*) calloc(1, sizeof(gaT));
+  if(!G)
+    return NULL;
+  G->n = I->n;
+  G->m = I->m;
+  G->A = A;
+  G->C = I->C;
+  G->popsize = popsize < 2 ? 2 : popsize;
+  G->noffspring = G->popsize;
+  G->nmutations = DEFAULT_MUTATIONS;
+  G->memetic = 1;
+  G->seed = seed;
+  rngInit(&G->rng, seed, RNG_STREAM_TOURNAMENT);
+  G->pool = pool;
+  G->nworkers = threadpoolSize(pool);
+  G->fixed = (int*) malloc(sizeof(int)*I->n);
+  G->allowed = (unsigned char*) malloc((size_t) I->n*I->m);
+  G->pop = (short*) malloc(sizeof(short)*(size_t) I->n*G->popsize);
+  G->values = (long long*) malloc(sizeof(long long)*G->popsize);
+  G->child = (short*) malloc(sizeof(short)*(size_t) I->n*G->popsize);
+  G->childvalue = (long long*) malloc(sizeof(long long)*G->popsize);
+  G->parents = (int*) malloc(sizeof(int)*2*G->popsize);
+  G->best = (int*) malloc(sizeof(int)*I->n);
+  G->W = (gaWorkerT*) calloc(G->nworkers, sizeof(gaWorkerT));
+  ok = G->fixed && G->allowed && G->pop && G->values && G->child && G->childvalue && G->parents && G->best && G->W;
+  for(w = 0; ok && w < G->nworkers; w++){
+    W = &G->W[w];
+    W->assign = (int*) malloc(sizeof(int)*I->n);
+    W->residual = (int*) malloc(sizeof(int)*I->m);
+    W->order = (int*) malloc(sizeof(int)*2*I->m);
+    W->LS = createLocalSearch(I, A, G->fixed, G->allowed);
+    ok = W->assign && W->residual && W->order && W->LS;
+  }
+  if(!ok){
+    freeGA(G);
+    return NULL;
+  }
+  gaResetNode(G);
+  return G;
+}
+
+void freeGA(gaT* G)
+{
+  int w;
+
+  if(!G)
+    return;
+  for(w = 0; G->W && w < G->nworkers; w++){
+    free(G->W[w].assign);
+    free(G->W[w].residual);
+    free(G->W[w].order);
+    freeLocalSearch(G->W[w].LS);
+  }
+  free(G->W);
+  free(G->fixed);
+  free(G->allowed);
+  free(G->pop);
+  free(G->values);
+  free(G->child);
+  free(G->childvalue);
+  free(G->parents);
+  free(G->best);
+  free(G);
+}
+
+void gaResetNode(gaT* G)
+{
+  int i;
+
+  for(i = 0; i < G->n; i++)
+    G->fixed[i] = -1;
+  memset(G->allowed, 1, (size_t) G->n*G->m);
+  G->npop = 0;
+  G->bestvalue = -1;
+}
+
+/** repair, fill and improvement of W->assign, whose residual capacities may be negative; returns its value, or -1 if
+ *  the fixed items violate a capacity */
+static long long finish(gaT* G, gaWorkerT* W)
+{
+  const int *weight = G->A->weight, *byRatio = G->A->byRatio;
+  int *assign = W->assign, *residual = W->residual;
+  int p, i, k, tight;
+  long long value = 0;
+
+  // repair: the worst items by value/weight leave the overloaded knapsacks
+  for(p = G->n - 1; p >= 0; p--){
+    i = byRatio[p];
+    k = assign[i];
+    if(k >= 0 && G->fixed[i] < 0 && residual[k] < 0){
+      assign[i] = -1;
+      residual[k] += weight[i];
+    }
+  }
+  for(k = 0; k < G->m; k++)
+    if(residual[k] < 0)
+      return -1;
+  // fill by value/weight, each item in the tightest knapsack where it fits
+  for(p = 0; p < G->n; p++){
+    i = byRatio[p];
+    if(assign[i] >= 0){
+      value += G->A->value[i];
+      continue;
+    }
+    tight = -1;
+    for(k = 0; k < G->m; k++)
+      if(weight[i] <= residual[k] && ALLOWED(G, i, k) && (tight < 0 || residual[k] < residual[tight]))
+        tight = k;
+    if(tight >= 0){
+      assign[i] = tight;
+      residual[tight] -= weight[i];
+      value += G->A->value[i];
+    }
+  }
+  if(G->memetic && localSearchLoad(W->LS, assign) >= 0){
+    value = localSearchRun(W->LS);
+    localSearchStore(W->LS, assign, residual);
+  }
+  return value;
+}
+
+/** the fixed items in W->assign and the residual capacities they leave */
+static void startChild(gaT* G, gaWorkerT* W)
+{
+  int i;
+
+  memcpy(W->assign, G->fixed, sizeof(int)*G->n);
+  memcpy(W->residual, G->C, sizeof(int)*G->m);
+  for(i = 0; i < G->n; i++)
+    if(G->fixed[i] >= 0)
+      W->residual[G->fixed[i]] -= G->A->weight[i];
+}
+
+/** the item i (not fixed) goes to the knapsack k (-1: out), even if it does not fit */
+static void place(gaT* G, gaWorkerT* W, int i, int k)
+{
+  if(W->assign[i] >= 0)
+    W->residual[W->assign[i]] += G->A->weight[i];
+  W->assign[i] = k;
+  if(k >= 0)
+    W->residual[k] -= G->A->weight[i];
+}
+
+/** the child c in G->child, made by the worker w */
+static void makeChild(gaT* G, int w, int c)
+{
+  gaWorkerT* W = &G->W[w];
+  const short *pa, *pb;
+  int *src = W->order, *rank = W->order + G->m;
+  int i, k, t, r, ka, kb, fromA, fromB;
+  rngT rng;
+
+  rngInit(&rng, G->seed, G->nstreams + c);
+  startChild(G, W);
+  if(G->parents[2*c] < 0){
+    // random child
+    for(i = 0; i < G->n; i++){
+      k = rngInt(&rng, G->m + 1) - 1;
+      if(G->fixed[i] < 0 && k >= 0 && ALLOWED(G, i, k))
+        place(G, W, i, k);
+    }
+  }
+  else{
+    pa = G->pop + (size_t) G->parents[2*c]*G->n;
+    pb = G->pop + (size_t) G->parents[2*c + 1]*G->n;
+    // parent (0: a, 1: b) and rank of each knapsack: rank is a random permutation (Fisher-Yates)
+    for(k = 0; k < G->m; k++){
+      src[k] = rngInt(&rng, 2);
+      rank[k] = k;
+    }
+    for(k = G->m - 1; k > 0; k--){
+      r = rngInt(&rng, k + 1);
+      t = rank[k];
+      rank[k] = rank[r];
+      rank[r] = t;
+    }
+    for(i = 0; i < G->n; i++){
+      if(G->fixed[i] >= 0)
+        continue;
+      ka = pa[i];
+      kb = pb[i];
+      fromA = ka >= 0 && src[ka] == 0 && ALLOWED(G, i, ka);
+      fromB = kb >= 0 && src[kb] == 1 && ALLOWED(G, i, kb);
+      if(fromA && (!fromB || rank[ka] < rank[kb]))
+        place(G, W, i, ka);
+      else if(fromB)
+        place(G, W, i, kb);
+    }
+    // mutation
+    for(t = 0; t < G->nmutations; t++){
+      i = rngInt(&rng, G->n);
+      k = rngInt(&rng, G->m + 1) - 1;
+      if(G->fixed[i] < 0 && (k < 0 || ALLOWED(G, i, k)))
+        place(G, W, i, k);
+    }
+  }
+  G->childvalue[c] = finish(G, W);
+  for(i = 0; i < G->n; i++)
+    G->child[(size_t) c*G->n + i] = (short) W->assign[i];
+  W->nchildren++;
+}
+
+/** task w of the thread pool: children taken from G->next */
+static void gaTask(void* arg, int w)
+{
+  gaT* G = (gaT*) arg;
+  int c;
+
+  while((c = atomic_fetch_add(&G->next, 1)) < G->nchild)
+    makeChild(G, w, c);
+}
+
+/** the solution sol of the given value enters the population if it is not there and the population is not full or it
+ *  is better than the worst member, which it replaces; returns 1 if it entered */
+static int insert(gaT* G, const short* sol, long long value)
+{
+  int s, target, i;
+
+  if(value < 0)
+    return 0;
+  for(s = 0; s < G->npop; s++)
+    if(G->values[s] == value && !memcmp(G->pop + (size_t) s*G->n, sol, sizeof(short)*G->n))
+      return 0;
+  if(G->npop < G->popsize)
+    target = G->npop++;
+  else{
+    target = 0;
+    for(s = 1; s < G->npop; s++)
+      if(G->values[s] < G->values[target])
+        target = s;
+    if(G->values[target] >= value)
+      return 0;
+  }
+  memcpy(G->pop + (size_t) target*G->n, sol, sizeof(short)*G->n);
+  G->values[target] = value;
+  if(value > G->bestvalue){
+    G->bestvalue = value;
+    for(i = 0; i < G->n; i++)
+      G->best[i] = sol[i];
+  }
+  return 1;
+}
+
+long long gaAdd(gaT* G, const int* assign)
+{
+  gaWorkerT* W = &G->W[0];
+  long long value;
+  int i;
+
+  startChild(G, W);
+  for(i = 0; i < G->n; i++)
+    if(G->fixed[i] < 0 && assign[i] >= 0 && ALLOWED(G, i, assign[i]))
+      place(G, W, i, assign[i]);
+  value = finish(G, W);
+  if(value >= 0){
+    // the first child slot as buffer (the children of a generation do not outlive gaRun())
+    for(i = 0; i < G->n; i++)
+      G->child[i] = (short) W->assign[i];
+    insert(G, G->child, value);
+  }
+  return value;
+}
+
+/** binary tournament: the better of two random members */
+static int tournament(gaT* G)
+{
+  int a = rngInt(&G->rng, G->npop), b = rngInt(&G->rng, G->npop);
+
+  return G->values[a] >= G->values[b] ? a : b;
+}
+
+long long gaRun(gaT* G, int maxgen, double timelimit)
+{
+  double start = wallclock();
+  int g, c;
+
+  for(g = 0; g < (maxgen < 1 ? 1 : maxgen); g++){
+    if(g > 0 && timelimit > 0 && wallclock() - start >= timelimit)
+      break;
+    // random children while the population is not full
+    G->nchild = G->npop < G->popsize ? G->popsize - G->npop : G->noffspring;
+    for(c = 0; c < G->nchild; c++){
+      if(G->npop < G->popsize)
+        G->parents[2*c] = G->parents[2*c + 1] = -1;
+      else{
+        G->parents[2*c] = tournament(G);
+        G->parents[2*c + 1] = tournament(G);
+      }
+    }
+    atomic_store(&G->next, 0);
+    threadpoolRun(G->pool, G->nworkers, gaTask, G);
+    G->nstreams += G->nchild;
+    G->nchildren += G->nchild;
+    for(c = 0; c < G->nchild; c++)
+      G->nreplaced += insert(G, G->child + (size_t) c*G->n, G->childvalue[c]);
+    G->generations++;
+  }
+  return G->bestvalue;
+}
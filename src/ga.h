@@ -0,0 +1,94 @@
+/**@file   ga.h
+ * @brief  memetic genetic algorithm for the multiple knapsack problem (no SCIP calls)
+ *
+ * An individual is a compact assignment vector, one short per item (its knapsack, -1 if not packed), as in the elite
+ * pool of pathrelinking.h. Each generation makes noffspring children, each one by
+ *
+ *    crossover  the knapsacks are taken in random order and each one gets the whole packing of the same knapsack in
+ *               one of the two parents (drawn at random), without the items already placed, so every knapsack of the
+ *               child is a subset of a packing of a parent
+ *    mutation   a few items move to a random knapsack or out of the knapsacks
+ *    repair     the items of the overloaded knapsacks leave them by increasing value/weight until they fit
+ *    fill       the free items are packed by value/weight (A->byRatio), each one in the tightest knapsack where it fits
+ *    improve    local search of localsearch.c (memetic), if G->memetic
+ *
+ * The parents are chosen by binary tournaments. A child replaces the worst member of the population if it is better
+ * and not already in it. While the population is not full the children are random assignments repaired and filled.
+ *
+ * The children of a generation are made on the threads of a pool, each thread with its own work arrays and local
+ * search. The child c draws from the stream nstreams + c of the seed, the parents are chosen before and the children
+ * enter the population after the parallel part, in their order, so the result does not depend on the number of threads.
+ *
+ * The caller restricts the search to a node of the B&B through fixed[] and allowed[] (createGA() sets them for the
+ * root). The solutions given by gaAdd() are repaired to the restrictions.
+ **/
+#ifndef __MOCHILA_GA_H__
+#define __MOCHILA_GA_H__
+
+#include <stdatomic.h>
+
+#include "problem.h"
+#include "localsearch.h"
+#include "threadpool.h"
+#include "rng.h"
+
+/** work arrays of one thread */
+typedef struct{
+   int* assign;            /**< child being made */
+   int* residual;          /**< residual capacities of assign */
+   int* order;             /**< random order of the knapsacks in the crossover */
+   localSearchT* LS;       /**< improvement of the children */
+   long long nchildren;    /**< children made by the thread */
+} gaWorkerT;
+
+typedef struct{
+   int n;                  /**< quant de itens */
+   int m;                  /**< quant de mochilas */
+   const itemArraysT* A;   /**< items of the instance */
+   const int* C;           /**< capacities */
+   // settings
+   int popsize;            /**< members of the population */
+   int noffspring;         /**< children per generation (<= popsize) */
+   int nmutations;         /**< items moved at random in each child */
+   int memetic;            /**< improve the children by local search */
+   // restrictions of the current node, set by the caller
+   int* fixed;             /**< fixed[i] = knapsack of the item i fixed in it (-1: free) */
+   unsigned char* allowed; /**< allowed[i*m+k] = 1 if the free item i may go to knapsack k */
+   // population
+   short* pop;             /**< pop[s*n+i] = knapsack of the item i in the member s (-1: not packed) */
+   long long* values;      /**< value of each member */
+   int npop;               /**< members in the population */
+   // children of the current generation
+   short* child;           /**< child[c*n+i], as pop */
+   long long* childvalue;
+   int* parents;           /**< parents[2c], parents[2c+1]: members crossed in the child c (-1: random child) */
+   // result
+   int* best;              /**< best solution: best[i] = knapsack of item i (-1: not packed) */
+   long long bestvalue;    /**< value of best (-1: none) */
+   long long generations;  /**< generations done (accumulated) */
+   long long nchildren;    /**< children made (accumulated) */
+   long long nreplaced;    /**< children that entered the population (accumulated) */
+   // random streams and threads
+   unsigned long long seed;     /**< seed of the streams of the children */
+   unsigned long long nstreams; /**< streams used by the previous generations */
+   rngT rng;               /**< tournaments (stream ~0 of the seed) */
+   threadpoolT* pool;      /**< threads (not owned; NULL: the caller only) */
+   int nworkers;           /**< one per thread of the pool */
+   gaWorkerT* W;
+   atomic_int next;        /**< next child to be made in the current generation */
+   int nchild;             /**< children of the current generation */
+} gaT;
+
+// create the engine for the instance with a population of popsize members, with the work arrays of each thread of the
+// pool (pool may be NULL); NULL if out of memory
+gaT* createGA(instanceT* I, const itemArraysT* A, int popsize, threadpoolT* pool, unsigned long long seed);
+void freeGA(gaT* G);
+// restrictions of the root node: nothing fixed and every item allowed in every knapsack; empties the population
+void gaResetNode(gaT* G);
+// offers the solution assign (repaired to the restrictions of the node and filled) to the population. Returns its
+// value after the repair, or -1 if the fixed items violate a capacity
+long long gaAdd(gaT* G, const int* assign);
+// at most maxgen generations and timelimit sec (<= 0: no limit), at least one. Returns the best value, also kept with
+// its solution in G->bestvalue and G->best
+long long gaRun(gaT* G, int maxgen, double timelimit);
+#endif
@@ -0,0 +1,276 @@
+/**@file   generator.c
+ * @brief  generates instances (.mochila) of the families of data/ from their names
+ *
+ * Usage:
+ *    bin/generator [-t <type>] [-o <dir>] <names...>
+ *
+ * A name tN-M-R-K-C-S (e.g. t200-5-10000-3-d-10, optionally with a directory and the .mochila extension) gives N items,
+ * M knapsacks, weights in [10, R], the type K of the values, the class C of the capacities and the seed S. The same
+ * name always gives the same instance, for any N and M (e.g. t1000000-500-10000-2-s-1). The types are those of the
+ * families of data/ (Pisinger):
+ *
+ *    1  uncorrelated            value in [10, R]
+ *    2  weakly correlated       value in [w - R/10, w + R/10] (at least 1)
+ *    3  strongly correlated     value = w + 10
+ *    4  subset sum              value = w
+ *
+ * and the capacities sum half of the total weight:
+ *
+ *    s  similar                 M capacities in [0.4, 0.6]*(total weight)/M, scaled to the sum
+ *    d  dissimilar              each capacity in [min w, half of what is left], the last one completes the sum; sorted
+ *
+ * The capacities are drawn again (up to MAX_TRIES times) until max w <= max c, min w <= min c and max c < total weight,
+ * the conditions of Pisinger; the name is an error if no draw meets them (too few items per knapsack). A similar
+ * capacity is at most 1.5 times the mean (total weight)/(2M), so the error comes before any draw if the heaviest item
+ * is larger than that. -t changes the type of the values (1..4, or uncorrelated, weakly, strongly, subsetsum),
+ * and the K of the name of the file written; the options apply to the names after them. The weights do not depend on
+ * the type nor on the class, so the instances of a family only differ by the values or the capacities.
+ *
+ * The file <dir>/tN-M-R-K-C-S.mochila (dir = . by default) is written in the format read by loadInstance(): "n m",
+ * one capacity per line and one line "label weight value" per item.
+ **/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "rng.h"
+
+#define MIN_WEIGHT 10
+#define MAX_TRIES  100
+
+/** family of a name */
+typedef struct{
+   int n;
+   int m;
+   int range;
+   int type;
+   char cclass;
+   int seed;
+} familyT;
+
+static const char* typeNames[] = {"uncorrelated", "weakly", "strongly", "subsetsum"};
+
+/** reads tN-M-R-K-C-S, without the directory and the extension; returns 0 if the name is not of a family */
+static int parseName(const char* name, familyT* F)
+{
+   const char* base = strrchr(name, '/');
+   char buf[256], *ext;
+   int len = 0;
+
+   base = base ? base + 1 : name;
+   if(strlen(base) >= sizeof(buf))
+      return 0;
+   strcpy(buf, base);
+   ext = strstr(buf, ".mochila");
+   if(ext && ext[8] == '\0')
+      *ext = '\0';
+   if(sscanf(buf, "t%d-%d-%d-%d-%c-%d%n", &F->n, &F->m, &F->range, &F->type, &F->cclass, &F->seed, &len) != 6
+      || buf[len] != '\0')
+      return 0;
+   return F->n > 0 && F->m > 0 && F->range >= MIN_WEIGHT && F->type >= 1 && F->type <= 4
+      && (F->cclass == 's' || F->cclass == 'd') && F->seed >= 0;
+}
+
+/** type given to -t: 1..4 or its name */
+static int parseType(const char* arg)
+{
+   int t;
+
+   if(arg[0] >= '1' && arg[0] <= '4' && arg[1] == '\0')
+      return arg[0] - '0';
+   for(t = 0; t < 4; t++)
+      if(!strcmp(arg, typeNames[t]))
+         return t + 1;
+   return 0;
+}
+
+static int cmpInt(const void* a, const void* b)
+{
+   int x = *(const int*) a, y = *(const int*) b;
+
+   return x < y ? -1 : x > y;
+}
+
+/** uniform integer in [lo, hi] (lo <= hi) */
+static long long uniform(rngT* rng, long long lo, long long hi)
+{
+   return lo + (long long) (rngDouble(rng)*(hi - lo + 1));
+}
+
+/** capacities of the class of F, summing half of total; returns 1 if they meet the conditions of Pisinger */
+static int drawCapacities(const familyT* F, rngT* rng, long long total, int minw, int maxw, long long* C)
+{
+   long long left = total/2, maxc = 0, minc = LLONG_MAX, hi, sum = 0;
+   int k;
+
+   if(F->cclass == 's'){
+      // all similar: scaled to the sum, so no capacity takes the rounding of the others
+      for(k = 0; k < F->m; k++){
+         C[k] = uniform(rng, (long long) (0.4*total/F->m), (long long) (0.6*total/F->m));
+         sum += C[k];
+      }
+      for(k = 0; k < F->m; k++){
+         C[k] = sum > 0 ? (long long) ((double) C[k]*(total/2)/sum) : (total/2)/F->m;
+         left -= C[k];
+      }
+      // what the truncation left, one unit per knapsack (left < m)
+      for(k = 0; left > 0; k = (k + 1) % F->m, left--)
+         C[k]++;
+   }
+   else{
+      for(k = 0; k < F->m - 1; k++){
+         hi = (left - (long long) (F->m - 1 - k)*minw)/2;
+         C[k] = uniform(rng, minw, hi > minw ? hi : minw);
+         left -= C[k];
+      }
+      C[F->m - 1] = left;
+   }
+   for(k = 0; k < F->m; k++){
+      if(C[k] > maxc)
+         maxc = C[k];
+      if(C[k] < minc)
+         minc = C[k];
+   }
+   return maxw <= maxc && minw <= minc && maxc < total;
+}
+
+/** writes the instance of F in dir; returns 1 if it is written */
+static int generate(const familyT* F, const char* dir)
+{
+   char filename[512];
+   rngT rng;
+   FILE* f;
+   int *weight, *value, *cap;
+   long long *C, total = 0;
+   uint64_t family;
+   int i, k, tries, minw = INT_MAX, maxw = 0, ok = 1, met, d;
+
+   weight = (int*) malloc(sizeof(int)*F->n);
+   value = (int*) malloc(sizeof(int)*F->n);
+   C = (long long*) malloc(sizeof(long long)*F->m);
+   cap = (int*) malloc(sizeof(int)*F->m);
+   if(!weight || !value || !C || !cap){
+      printf("\nProblem to allocate the instance with n=%d m=%d\n", F->n, F->m);
+      ok = 0;
+      goto TERMINATE;
+   }
+   // streams of the seed: the weights only depend on N, M and R; the values also on K; the capacities also on C
+   family = ((uint64_t) F->n*1000003ULL + (uint64_t) F->m)*1000003ULL + (uint64_t) F->range;
+   rngInit(&rng, (uint64_t) F->seed, 4*family);
+   for(i = 0; i < F->n; i++){
+      weight[i] = (int) uniform(&rng, MIN_WEIGHT, F->range);
+      total += weight[i];
+      if(weight[i] < minw)
+         minw = weight[i];
+      if(weight[i] > maxw)
+         maxw = weight[i];
+   }
+   rngInit(&rng, (uint64_t) F->seed, 4*family + (uint64_t) F->type);
+   d = F->range/10;
+   for(i = 0; i < F->n; i++){
+      switch(F->type){
+      case 1:
+         value[i] = (int) uniform(&rng, MIN_WEIGHT, F->range);
+         break;
+      case 2:
+         value[i] = (int) uniform(&rng, weight[i] - d, weight[i] + d);
+         if(value[i] < 1)
+            value[i] = 1;
+         break;
+      case 3:
+         value[i] = weight[i] + 10;
+         break;
+      default:
+         value[i] = weight[i];
+      }
+   }
+   if(F->cclass == 's' && maxw > 1.5*(total/2)/F->m){
+      printf("\nt%d-%d-%d-%d-%c-%d: the heaviest item (%d) does not fit a similar capacity (mean %lld), use more items "
+         "per knapsack\n", F->n, F->m, F->range, F->type, F->cclass, F->seed, maxw, (total/2)/F->m);
+      ok = 0;
+      goto TERMINATE;
+   }
+   rngInit(&rng, (uint64_t) F->seed, ((4*family) ^ RNG_GAMMA) + (uint64_t) F->cclass);
+   met = 0;
+   for(tries = 0; !met && tries < MAX_TRIES; tries++)
+      met = drawCapacities(F, &rng, total, minw, maxw, C);
+   if(!met){
+      printf("\nt%d-%d-%d-%d-%c-%d: %d draws of the capacities do not meet max w <= max c, min w <= min c and "
+         "max c < sum w, use more items per knapsack\n", F->n, F->m, F->range, F->type, F->cclass, F->seed, MAX_TRIES);
+      ok = 0;
+      goto TERMINATE;
+   }
+   for(k = 0; k < F->m; k++){
+      if(C[k] > INT_MAX || C[k] < 0){
+         printf("\nCapacity %lld out of range: the weights sum %lld in %d knapsacks\n", C[k], total, F->m);
+         ok = 0;
+         goto TERMINATE;
+      }
+      cap[k] = (int) C[k];
+   }
+   if(F->cclass == 'd')
+      qsort(cap, F->m, sizeof(int), cmpInt);
+
+   snprintf(filename, sizeof(filename), "%s/t%d-%d-%d-%d-%c-%d.mochila", dir, F->n, F->m, F->range, F->type, F->cclass,
+      F->seed);
+   f = fopen(filename, "w");
+   if(!f){
+      printf("\nProblem to create file %s\n", filename);
+      ok = 0;
+      goto TERMINATE;
+   }
+   fprintf(f, "%d %d\n", F->n, F->m);
+   for(k = 0; k < F->m; k++)
+      fprintf(f, "%d\n", cap[k]);
+   for(i = 0; i < F->n; i++)
+      fprintf(f, "%d %d %d\n", i + 1, weight[i], value[i]);
+   if(fclose(f) != 0){
+      printf("\nProblem to write file %s\n", filename);
+      ok = 0;
+      goto TERMINATE;
+   }
+   printf("%s (n=%d m=%d, %s, sum of the weights %lld)\n", filename, F->n, F->m, typeNames[F->type - 1], total);
+
+TERMINATE:
+   free(weight);
+   free(value);
+   free(C);
+   free(cap);
+   return ok;
+}
+
+int main(int argc, char** argv)
+{
+   const char* dir = ".";
+   familyT F;
+   int a, type = 0, nerrors = 0, nnames = 0;
+
+   for(a = 1; a < argc; a++){
+      if(!strcmp(argv[a], "-t") && a + 1 < argc){
+         type = parseType(argv[++a]);
+         if(!type){
+            printf("\nUnknown type: %s\n", argv[a]);
+            return 1;
+         }
+      }
+      else if(!strcmp(argv[a], "-o") && a + 1 < argc)
+         dir = argv[++a];
+      else{
+         nnames++;
+         if(!parseName(argv[a], &F)){
+            printf("\n%s: not a name tN-M-R-K-{s,d}-seed (N, M > 0, R >= %d, K in 1..4)\n", argv[a], MIN_WEIGHT);
+            nerrors++;
+            continue;
+         }
+         if(type)
+            F.type = type;
+         nerrors += !generate(&F, dir);
+      }
+   }
+   if(nnames == 0){
+      printf("\nSintaxe: %s [-t <type>] [-o <dir>] <tN-M-R-K-{s,d}-seed...>\n\ttypes: 1 uncorrelated, 2 weakly, 3 strongly, 4 subsetsum\n", argv[0]);
+      return 1;
+   }
+   return nerrors > 0;
+}
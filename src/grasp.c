@@ -0,0 +1,245 @@
+/**@file   grasp.c
+ * @brief  multi-start GRASP for the multiple knapsack problem (no SCIP calls)
+ *
+ * The construction keeps, for the knapsack being filled, the list of the free items that still fit it; after each
+ * pick the items that no longer fit are dropped from the list, so a knapsack costs O(n) per item packed.
+ *
+ * The threads take the construction numbers from an atomic counter; each one keeps its best solution, and graspRun()
+ * reduces them once all threads are done.
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "grasp.h"
+#include "rng.h"
+
+static double wallclock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static int numero_aleatorio(rngT* rng, int n_cand)
+{
+  return rngInt(rng, n_cand);
+}
+
+/** menor e maior valor dos candidatos */
+static void min_max(const int* candidatos, const itemArraysT* items, int n, int* max, int* min)
+{
+  const int* value = items->value;
+  int i;
+
+  *max = *min = value[candidatos[0]];
+  for(i = 1; i < n; i++){
+    if(value[candidatos[i]] > *max)
+      *max = value[candidatos[i]];
+    if(value[candidatos[i]] < *min)
+      *min = value[candidatos[i]];
+  }
+}
+
+/** posicoes em candidatos dos itens com valor >= minimo + alpha*(maximo - minimo); returns their number */
+static int cria_RCL(const itemArraysT* items, const int* candidatos, int* RCL, int minimo, int maximo, double alpha, int n)
+{
+  double limite = minimo + alpha*(maximo - minimo);
+  int i, n_RCL = 0;
+
+  for(i = 0; i < n; i++)
+    if(items->value[candidatos[i]] >= limite - 1e-9)
+      RCL[n_RCL++] = i;
+  return n_RCL;
+}
+
+/** tira o candidato da posicao escolhida e os que nao cabem mais na capacidade atual; returns the new number */
+static int atualiza_candidatos(const itemArraysT* items, int* candidatos, int escolhido, int n_cand, int capacidade_atual)
+{
+  const int* weight = items->weight;
+  int i, k = 0;
+
+  candidatos[escolhido] = candidatos[--n_cand];
+  for(i = 0; i < n_cand; i++)
+    if(weight[candidatos[i]] <= capacidade_atual)
+      candidatos[k++] = candidatos[i];
+  return k;
+}
+
+graspT* createGrasp(instanceT* I, const itemArraysT* A, double alpha, threadpoolT* pool, unsigned long long seed)
+{
+  graspT* G;
+  graspWorkerT* W;
+  int w, ok;
+
+  G = (graspT*) calloc(1, sizeof(graspT));
+  if(!G)
+    return NULL;
+  G->n = I->n;
+  G->m = I->m;
+  G->A = A;
+  G->C = I->C;
+  G->alpha = alpha;
+  G->seed = seed;
+  G->pool = pool;
+  G->nworkers = threadpoolSize(pool);
+  G->capacity = (int*) malloc(sizeof(int)*I->m);
+  G->fixed = (int*) malloc(sizeof(int)*I->n);
+  G->allowed = (unsigned char*) malloc((size_t) I->n*I->m);
+  G->best = (int*) malloc(sizeof(int)*I->n);
+  G->W = (graspWorkerT*) calloc(G->nworkers, sizeof(graspWorkerT));
+  ok = G->capacity && G->fixed && G->allowed && G->best && G->W;
+  for(w = 0; ok && w < G->nworkers; w++){
+    W = &G->W[w];
+    W->assign = (int*) malloc(sizeof(int)*I->n);
+    W->residual = (int*) malloc(sizeof(int)*I->m);
+    W->cand = (int*) malloc(sizeof(int)*I->n);
+    W->RCL = (int*) malloc(sizeof(int)*I->n);
+    W->best = (int*) malloc(sizeof(int)*I->n);
+    W->LS = createLocalSearch(I, A, G->fixed, G->allowed);
+    ok = W->assign && W->residual && W->cand && W->RCL && W->best && W->LS;
+  }
+  if(!ok){
+    freeGrasp(G);
+    return NULL;
+  }
+  graspResetNode(G);
+  G->bestvalue = -1;
+  return G;
+}
+
+void freeGrasp(graspT* G)
+{
+  int w;
+
+  if(!G)
+    return;
+  for(w = 0; G->W && w < G->nworkers; w++){
+    free(G->W[w].assign);
+    free(G->W[w].residual);
+    free(G->W[w].cand);
+    free(G->W[w].RCL);
+    free(G->W[w].best);
+    freeLocalSearch(G->W[w].LS);
+  }
+  free(G->W);
+  free(G->capacity);
+  free(G->fixed);
+  free(G->allowed);
+  free(G->best);
+  free(G);
+}
+
+void graspResetNode(graspT* G)
+{
+  int i;
+
+  memcpy(G->capacity, G->C, sizeof(int)*G->m);
+  for(i = 0; i < G->n; i++)
+    G->fixed[i] = -1;
+  memset(G->allowed, 1, (size_t) G->n*G->m);
+  G->fixedvalue = 0;
+}
+
+long long graspConstruct(graspT* G, int w, unsigned long long stream)
+{
+  const itemArraysT* items = G->A;
+  const int n = G->n, m = G->m;
+  graspWorkerT* W = &G->W[w];
+  int *assign = W->assign, *residual = W->residual, *cand = W->cand;
+  int j, k, item, nCands, n_RCL, maximo, minimo, pos;
+  long long custo = G->fixedvalue;
+  rngT rng;
+
+  rngInit(&rng, G->seed, stream);
+  memcpy(assign, G->fixed, sizeof(int)*n);
+  memcpy(residual, G->capacity, sizeof(int)*m);
+  // quantidade de iteracoes = quantidade de mochilas
+  for(k = 0; k < m; k++){
+    // candidatos: itens livres que cabem na mochila k
+    nCands = 0;
+    for(j = 0; j < n; j++)
+      if(assign[j] < 0 && items->weight[j] <= residual[k] && G->allowed[(size_t) j*m + k])
+        cand[nCands++] = j;
+    while(nCands > 0){
+      min_max(cand, items, nCands, &maximo, &minimo);
+      n_RCL = cria_RCL(items, cand, W->RCL, minimo, maximo, G->alpha, nCands);
+      pos = W->RCL[numero_aleatorio(&rng, n_RCL)];
+      item = cand[pos];
+      // o item escolhido vai para a mochila k
+      assign[item] = k;
+      residual[k] -= items->weight[item];
+      custo += items->value[item];
+      nCands = atualiza_candidatos(items, cand, pos, nCands, residual[k]);
+    }
+  }
+  return custo;
+}
+
+long long graspImprove(graspT* G, int w, long long value)
+{
+  graspWorkerT* W = &G->W[w];
+
+  if(localSearchLoad(W->LS, W->assign) < 0)
+    return value;
+  value = localSearchRun(W->LS);
+  localSearchStore(W->LS, W->assign, W->residual);
+  return value;
+}
+
+/** task w of the thread pool: constructions taken from G->next until maxiter or the time limit */
+static void graspTask(void* arg, int w)
+{
+  graspT* G = (graspT*) arg;
+  graspWorkerT* W = &G->W[w];
+  long long value;
+  int c;
+
+  W->bestvalue = -1;
+  W->bestiter = -1;
+  W->iterations = 0;
+  for(;;){
+    c = atomic_fetch_add(&G->next, 1);
+    // the construction 0 is always done
+    if(c >= G->maxiter || (c > 0 && G->timelimit > 0 && wallclock() - G->start >= G->timelimit))
+      break;
+    value = graspConstruct(G, w, G->nstreams + c);
+    value = graspImprove(G, w, value);
+    W->iterations++;
+    if(value > W->bestvalue || (value == W->bestvalue && c < W->bestiter)){
+      W->bestvalue = value;
+      W->bestiter = c;
+      memcpy(W->best, W->assign, sizeof(int)*G->n);
+    }
+  }
+}
+
+long long graspRun(graspT* G, int maxiter, double timelimit)
+{
+  graspWorkerT *W, *best = NULL;
+  int w, taken;
+
+  G->maxiter = maxiter < 1 ? 1 : maxiter;
+  G->timelimit = timelimit;
+  G->start = wallclock();
+  atomic_store(&G->next, 0);
+  threadpoolRun(G->pool, G->nworkers, graspTask, G);
+
+  // best of the threads; ties to the lowest construction number
+  G->iterations = 0;
+  for(w = 0; w < G->nworkers; w++){
+    W = &G->W[w];
+    G->iterations += W->iterations;
+    if(W->bestvalue >= 0 && (!best || W->bestvalue > best->bestvalue
+                             || (W->bestvalue == best->bestvalue && W->bestiter < best->bestiter)))
+      best = W;
+  }
+  G->bestvalue = best ? best->bestvalue : -1;
+  if(best)
+    memcpy(G->best, best->best, sizeof(int)*G->n);
+  taken = atomic_load(&G->next);
+  G->nstreams += taken < G->maxiter ? taken : G->maxiter;
+  return G->bestvalue;
+}
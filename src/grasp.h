@@ -0,0 +1,83 @@
+/**@file   grasp.h
+ * @brief  multi-start GRASP for the multiple knapsack problem (no SCIP calls)
+ *
+ * Each iteration builds a randomized solution and improves it by local search; graspRun() keeps the best one. The
+ * construction fills the knapsacks one at a time: while some candidate fits the residual capacity, an item is drawn
+ * from the restricted candidate list (RCL) of the candidates with value >= min + alpha*(max - min), so alpha = 1 is
+ * the greedy by value and alpha = 0 is a purely random choice. The improvement is the local search of localsearch.c
+ * (insert, exchange, 2-for-1, shift and swap moves).
+ *
+ * The iterations run on the threads of a pool, each thread with its own work arrays and local search (the instance and
+ * the restrictions of the node are shared, read only). The construction number c draws its numbers from the stream c
+ * of the seed (rng.h), and the best solution is reduced at the end, the ties going to the lowest construction number,
+ * so without a time limit the result does not depend on the number of threads. The stream numbers go on from one call
+ * of graspRun() to the next.
+ *
+ * The caller restricts the search to a node of the B&B through fixed[], allowed[] and capacity[] (createGrasp() sets
+ * them for the root: nothing fixed, everything allowed). The local searches of the threads read the same fixed[] and
+ * allowed[], so the restrictions hold in both phases.
+ **/
+#ifndef __MOCHILA_GRASP_H__
+#define __MOCHILA_GRASP_H__
+
+#include <stdatomic.h>
+
+#include "problem.h"
+#include "localsearch.h"
+#include "threadpool.h"
+
+/** work arrays and result of one thread */
+typedef struct{
+   int* assign;            /**< solution of the current iteration */
+   int* residual;          /**< residual capacities of assign */
+   int* cand;              /**< candidates of the current knapsack */
+   int* RCL;               /**< positions in cand of the restricted candidate list */
+   localSearchT* LS;       /**< improvement phase */
+   int* best;              /**< best solution of the thread in the last graspRun() */
+   long long bestvalue;    /**< value of best (-1: none) */
+   long long bestiter;     /**< construction number of best */
+   long long iterations;   /**< iterations done by the thread */
+} graspWorkerT;
+
+typedef struct{
+   int n;                  /**< quant de itens */
+   int m;                  /**< quant de mochilas */
+   const itemArraysT* A;   /**< items of the instance */
+   const int* C;           /**< capacities */
+   double alpha;           /**< RCL threshold in [0,1] (1: greedy, 0: random) */
+   // restrictions of the current node, set by the caller
+   int* capacity;          /**< capacity of each knapsack minus the weight of its fixed items */
+   int* fixed;             /**< fixed[i] = knapsack of the item i fixed in it (-1: free) */
+   unsigned char* allowed; /**< allowed[i*m+k] = 1 if the free item i may go to knapsack k */
+   long long fixedvalue;   /**< value of the fixed items */
+   // result of the last graspRun()
+   int* best;              /**< best solution: best[i] = knapsack of item i (-1: not packed) */
+   long long bestvalue;    /**< value of best (-1: none) */
+   long long iterations;   /**< iterations done */
+   // random streams and threads
+   unsigned long long seed;     /**< seed of the streams of the constructions */
+   unsigned long long nstreams; /**< streams used by the previous calls of graspRun() */
+   threadpoolT* pool;      /**< threads (not owned; NULL: the caller only) */
+   int nworkers;           /**< one per thread of the pool */
+   graspWorkerT* W;
+   // current graspRun()
+   atomic_int next;        /**< next construction to be taken */
+   int maxiter;
+   double timelimit;
+   double start;
+} graspT;
+
+// create the engine for the instance, with the work arrays of each thread of the pool (pool may be NULL); NULL if out
+// of memory
+graspT* createGrasp(instanceT* I, const itemArraysT* A, double alpha, threadpoolT* pool, unsigned long long seed);
+void freeGrasp(graspT* G);
+// restrictions of the root node: nothing fixed and every item allowed in every knapsack
+void graspResetNode(graspT* G);
+// one randomized construction in G->W[w].assign with the stream number stream of the seed; returns its value
+long long graspConstruct(graspT* G, int w, unsigned long long stream);
+// local search on G->W[w].assign (and residual), whose value is given; returns the improved value
+long long graspImprove(graspT* G, int w, long long value);
+// at most maxiter iterations of construction + improvement and timelimit sec (<= 0: no limit), at least one.
+// Returns the best value, also kept with its solution in G->bestvalue and G->best
+long long graspRun(graspT* G, int maxiter, double timelimit);
+#endif
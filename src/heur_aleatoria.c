@@ -22,13 +22,17 @@
 
 #include <assert.h>
 #include <time.h>
+#include <string.h>
 
 #include "probdata_mochila.h"
 #include "parameters_mochila.h"
 #include "heur_aleatoria.h"
+#include "heur_pathrelinking.h"
 #include "heur_problem.h"
+#include "vardata_mochila.h"
 
 //#define DEBUG_ALEATORIA 1
+#define RNG_STREAM            (~0ULL) /* stream of --seed used here (the GRASP uses the streams 0, 1, ...) */
 /* configuracao da heuristica */
 #define HEUR_NAME             "aleatoria"
 #define HEUR_DESC             "primal heuristic template"
@@ -50,13 +54,25 @@
  * Data structures
  */
 
-/* TODO: fill in the necessary primal heuristic data */
-
-/** primal heuristic data */
-/*struct SCIP_HeurData
+/** primal heuristic data: scratch buffers sized once per solve, so a call does no heap allocation */
+struct SCIP_HeurData
 {
+   SCIP_SOL*             sol;                /**< working solution, cleared and reused by every call */
+   SCIP_VAR**            solution;           /**< vars of the solution being built */
+   int*                  covered;            /**< covered[i] = 1 if item i is in the solution */
+   int*                  cand;               /**< cand[k*n..k*n+nCands[k]-1] = candidates of knapsack k */
+   int*                  nCands;             /**< number of candidates of each knapsack */
+   int*                  residual;           /**< residual capacity of each knapsack */
+   int*                  assign;             /**< knapsack of each item (see improveSolution() and the path relinking) */
+   localSearchT*         LS;                 /**< local search on the solutions found (NULL: --local_search 0) */
+   rngT                  rng;                /**< random stream of the heuristic */
+   int                   nitems;             /**< number of items */
+   int                   nknaps;             /**< number of knapsacks */
+   SCIP_Longint          ncalls;             /**< number of calls */
+   SCIP_Longint          nsols;              /**< number of solutions stored */
+   SCIP_Longint          nmemcalls;          /**< calls that stored no solution but left SCIP using more memory */
+   SCIP_Longint          memgrowth;          /**< bytes left by those calls */
 };
-*/
 
 /*
  * Local methods
@@ -82,6 +98,13 @@ SCIP_DECL_HEURCOPY(heurCopyAleatoria)
 static
 SCIP_DECL_HEURFREE(heurFreeAleatoria)
 {  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   SCIPfreeBlockMemory(scip, &heurdata);
+   SCIPheurSetData(heur, NULL);
 
    return SCIP_OKAY;
 }
@@ -110,6 +133,33 @@ SCIP_DECL_HEUREXIT(heurExitAleatoria)
 static
 SCIP_DECL_HEURINITSOL(heurInitsolAleatoria)
 {  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   instanceT* I;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   I = SCIPprobdataGetInstance(SCIPgetProbData(scip));
+   heurdata->nitems = I->n;
+   heurdata->nknaps = I->m;
+   heurdata->ncalls = 0;
+   heurdata->nsols = 0;
+   heurdata->nmemcalls = 0;
+   heurdata->memgrowth = 0;
+   rngInit(&heurdata->rng, (unsigned long long) param.seed, RNG_STREAM);
+   SCIP_CALL( SCIPcreateSol(scip, &heurdata->sol, heur) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->solution, I->n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->covered, I->n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->cand, I->m * I->n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->nCands, I->m) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->residual, I->m) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->assign, I->n) );
+   if( param.local_search )
+   {
+      heurdata->LS = createLocalSearch(I, SCIPprobdataGetItems(SCIPgetProbData(scip)), NULL, NULL);
+      if( heurdata->LS == NULL )
+         return SCIP_NOMEMORY;
+   }
 
    return SCIP_OKAY;
 }
@@ -119,12 +169,41 @@ SCIP_DECL_HEURINITSOL(heurInitsolAleatoria)
 static
 SCIP_DECL_HEUREXITSOL(heurExitsolAleatoria)
 {  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+#ifdef DEBUG_ALEATORIA
+   printf("\nHeuristic %s: %lld calls, %lld solutions stored\n", HEUR_NAME,
+      (long long) heurdata->ncalls, (long long) heurdata->nsols);
+   printf("Heuristic %s: %lld calls stored no solution but left SCIP using more memory (%lld bytes)\n", HEUR_NAME,
+      (long long) heurdata->nmemcalls, (long long) heurdata->memgrowth);
+#endif
+   if( heurdata->LS != NULL )
+   {
+#ifdef DEBUG_ALEATORIA
+      printf("Heuristic %s: local search evaluated %lld moves\n", HEUR_NAME, heurdata->LS->nevals);
+#endif
+      freeLocalSearch(heurdata->LS);
+      heurdata->LS = NULL;
+   }
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->assign, heurdata->nitems);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->residual, heurdata->nknaps);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->nCands, heurdata->nknaps);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->cand, heurdata->nknaps * heurdata->nitems);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->covered, heurdata->nitems);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->solution, heurdata->nitems);
+   if( heurdata->sol != NULL )
+   {
+      SCIP_CALL( SCIPfreeSol(scip, &heurdata->sol) );
+   }
 
    return SCIP_OKAY;
 }
 
-static int numero_aleatorio(int n_cand){
-   return rand() % n_cand;
+static int numero_aleatorio(rngT* rng, int n_cand){
+   return rngInt(rng, n_cand);
 }
 
 
@@ -142,13 +221,15 @@ int aleatoria(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
    int found, infeasible, nInSolution;
    unsigned int stored;
    int nvars;
-   int *covered, n, m, nCovered = 0, custo, **cand, *nCands, s;
+   int *covered, n, m, nCovered = 0, custo, *cand, *nCands, s;
    SCIP_VAR *var, **solution, **varlist;
    //  SCIP* scip_cp;
    SCIP_Real valor, bestUb;
    SCIP_PROBDATA* probdata;
-   int i, *residual;
+   SCIP_HEURDATA* heurdata;
+   int i, *residual, item, k;
    instanceT* I;
+   itemArraysT* items;
    
    found = 0;
    infeasible = 0;
@@ -160,12 +241,16 @@ int aleatoria(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
    /* recupera os dados do problema original*/
    probdata=SCIPgetProbData(scip);
    assert(probdata != NULL);
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
 
    nvars = SCIPprobdataGetNVars(probdata);
    varlist = SCIPprobdataGetVars(probdata);
    I = SCIPprobdataGetInstance(probdata);
+   items = SCIPprobdataGetItems(probdata);
    n = I->n;
    m = I->m;
+   heurdata->ncalls++;
 
    // // print ordered items
    // printf("\nGULOSA: Ordered items by value/weight\n");
@@ -175,21 +260,17 @@ int aleatoria(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
    //   printf("\n%f\n", SCIPvarGetLbLocal(varlist[i]));
    // }
    
-    
-   solution = (SCIP_VAR**) malloc(sizeof(SCIP_VAR*)*n);
-   covered = (int*) calloc(n,sizeof(int));
-   cand = (int**) malloc(m*sizeof(int*));
-
-   for(int k = 0; k < m; k++){
-      cand[k] = (int *) malloc(n*sizeof(int));
-   }
-
-   residual = (int *) malloc(m*sizeof(int));
-   nCands = (int *) calloc(m,sizeof(int));  // inicializa todas as posicoes com 0
-
+   // buffers of the heurdata: nothing is allocated here
+   solution = heurdata->solution;
+   covered = heurdata->covered;
+   cand = heurdata->cand;     // candidatos da mochila k em cand[k*n..]
+   nCands = heurdata->nCands;
+   residual = heurdata->residual;
+   memset(covered, 0, n*sizeof(int));
 
    for(int k = 0; k < m; k++){
       residual[k] = I->C[k];
+      nCands[k] = 0;
    }
 
    nInSolution = 0;
@@ -200,31 +281,29 @@ int aleatoria(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
       var = varlist[i];
       
       if(SCIPvarGetLbLocal(var) > 1.0 - EPSILON){ // var >= 1.0
-         printf("\n\nTESTEEEEEEEEEEEEEEEEEEEEEEEE\n");
         solution[nInSolution++]=var;
-        //exit(0);
-        residual[i%m] -= I->item[i].weight;
-        covered[i%n]=1;
+        // x_item_k: o item e a mochila da variavel
+        item = varGetItem(var);
+        k = varGetKnapsack(var);
+        residual[k] -= items->weight[item];
+        covered[item]=1;
         nCovered++;
-        custo += I->item[i].value;
-        infeasible = residual < 0?1:0;
+        custo += items->value[item];
+        infeasible = infeasible || residual[k] < 0;
 #ifdef DEBUG_ALEATORIA
-        printf("\nSelected fixed var= %s. TotalItems=%d value=%d residual=%d infeasible=%d", SCIPvarGetName(var), nInSolution, custo, residual, infeasible);
+        printf("\nSelected fixed var= %s. TotalItems=%d value=%d residual=%d infeasible=%d", SCIPvarGetName(var), nInSolution, custo, residual[k], infeasible);
 #endif
       }
       else{ // discard items fixed in 0.0
         if(SCIPvarGetUbLocal(var) < EPSILON){ // var fixed in 0.0
         }
 
-        else{
-          if (i < n){ // include item i in cand list
-            for(int k = 0; k < m; k++){
-
-               if(I->item[i].weight <= residual[k] && !covered[i%n]){
-                  cand[k][nCands[k]] = i;
-                  nCands[k] += 1;
-               }
-            }
+        else{ // include item of x_item_k in the cand list of knapsack k
+          item = varGetItem(var);
+          k = varGetKnapsack(var);
+          if(items->weight[item] <= residual[k] && !covered[item]){
+             cand[k*n + nCands[k]] = item;
+             nCands[k] += 1;
           }
         }
       }
@@ -235,64 +314,62 @@ int aleatoria(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
    for(i=0; i < m && nCovered < n; i++){
       // enquanto a capacidade atual da mochila i for > 0 E a mochila i ainda estiver itens candidatos
       while(residual[i] > 0 && nCands[i] > 0){
-         printf("\nLISTA DOS ITENS COBERTOS:\n");
-         for(int k = 0; k < n; k++){
-            printf("%d ", covered[k]);
-         }
-         s = numero_aleatorio(nCands[i]);
-         int aux = cand[i][s];
-         printf("\n\nNUMERO ESCOLHIDO DA MOCHILA %d: %d\n", i, s);
-         printf("AUXILIAR: %d\n", aux);
-         printf("\nLISTA DE CANDIDATOS DA MOCHILA %d:\n", i);
-         for(int j = 0; j < nCands[i]; j++){
-            printf("%d ", cand[i][j]);
-         }
-        
-         cand[i][s] = cand[i][nCands[i]-1];
+         s = numero_aleatorio(&heurdata->rng, nCands[i]);
+         int aux = cand[i*n + s];
+#ifdef DEBUG_ALEATORIA
+         printf("\n\nNUMERO ESCOLHIDO DA MOCHILA %d: %d (item %d)\n", i, s, aux);
+#endif
+         cand[i*n + s] = cand[i*n + nCands[i]-1];
          nCands[i] -= 1;
 
-         printf("\nLISTA DE CANDIDATOS DA MOCHILA %d DEPOIS DO ITEM ESCOLHIDO:\n", i);
-         for(int j = 0; j < nCands[i]; j++){
-            printf("%d ", cand[i][j]);
-         }
-
-         
-         if(!covered[aux] && I->item[aux].weight <= residual[i]){
-            printf("\nITEM %d COLODADO NA MOCHILA: %d\n", aux, i);
-            valor = I->item[aux].value;
-            var = varlist[aux];
+         if(!covered[aux] && items->weight[aux] <= residual[i]){
+            valor = items->value[aux];
+            var = SCIPprobdataGetVar(probdata, aux, i);
 
             solution[nInSolution++] = var;
 
-            residual[i] -= I->item[aux].weight;
+            residual[i] -= items->weight[aux];
             covered[aux] = 1;
             nCovered++;
             custo += valor;
-            infeasible = residual<0?1:0;
+            infeasible = infeasible || residual[i] < 0;
             #ifdef DEBUG_ALEATORIA
-               printf("\n\nSelected var= %s. TotalItems=%d value item=%d value = %d residual=%d infeasible=%d\n", SCIPvarGetName(var), nInSolution, valor, custo, residual, infeasible);
+               printf("\n\nSelected var= %s. TotalItems=%d value item=%lf value = %d residual=%d infeasible=%d\n", SCIPvarGetName(var), nInSolution, valor, custo, residual[i], infeasible);
             #endif
          }
          else{// desconsidere o item
             #ifdef DEBUG_ALEATORIA
-               printf("\n\nNOT selected var= %s. TotalItems=%d value item=%d value=%d residual=%d infeasible=%d\n", SCIPvarGetName(varlist[selected]), nInSolution, valor, custo, residual, infeasible);
+               printf("\n\nNOT selected item %d. TotalItems=%d value=%d residual=%d infeasible=%d\n", aux, nInSolution, custo, residual[i], infeasible);
             #endif
          }
       }
    }
+   // local search on the solution built
+   if(!infeasible && heurdata->LS != NULL){
+      valor = improveSolution(scip, heurdata->LS, solution, &nInSolution, covered, heurdata->assign);
+      if(valor >= 0)
+         custo = (int) valor;
+   }
    if(!infeasible){
-      /* create SCIP solution structure sol */
-      SCIP_CALL( SCIPcreateSol(scip, sol, heur) );
+      /* the working solution of the heurdata gets the found solution */
+      *sol = heurdata->sol;
+      SCIP_CALL( SCIPclearSol(scip, *sol) );
       // save found solution in sol
       for(i=0;i<nInSolution;i++){
          var = solution[i];
          SCIP_CALL( SCIPsetSolVal(scip, *sol, var, 1.0) );
       }
-      bestUb = SCIPgetPrimalbound(scip);
+      // offered to the path relinking (nothing is done if it is not included)
+      for(i=0;i<heurdata->nitems;i++)
+         heurdata->assign[i] = -1;
+      for(i=0;i<nInSolution;i++)
+         heurdata->assign[varGetItem(solution[i])] = varGetKnapsack(solution[i]);
+      SCIPpathrelinkingAddSolution(scip, heurdata->assign, custo);
+      bestUb = SCIPgetPrimalboundMine(scip);
 #ifdef DEBUG_ALEATORIA
       printf("\nFound solution...\n");
       //      SCIP_CALL( SCIPprintSol(scip, *sol, NULL, FALSE) );
-      printf("\ninfeasible=%d value = %lf > bestUb = %lf? %d\n\n", infeasible, valor, bestUb, valor > bestUb + EPSILON);
+      printf("\ninfeasible=%d value = %d > bestUb = %lf? %d\n\n", infeasible, custo, bestUb, custo > bestUb + EPSILON);
 #endif
       if(!infeasible && custo > bestUb + EPSILON){
 #ifdef DEBUG_ALEATORIA
@@ -300,7 +377,7 @@ int aleatoria(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
          SCIP_CALL( SCIPprintSol(scip, *sol, NULL, FALSE) );
 #endif
          
-         /* verificar se a solucao eh viavel e armazena */
+         /* verificar se a solucao eh viavel e armazena (SCIPtrySol copia a solucao) */
          SCIP_CALL( SCIPtrySolMine(scip, *sol, TRUE, TRUE, FALSE, TRUE, &stored) );
          if( stored )
          {
@@ -309,6 +386,7 @@ int aleatoria(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
             SCIPdebugMessage("found feasible aleatoria solution:\n");
             SCIP_CALL( SCIPprintSol(scip, *sol, NULL, FALSE) );
 #endif
+            heurdata->nsols++;
             found = 1;
          }
          else{
@@ -322,10 +400,6 @@ int aleatoria(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
 #ifdef DEBUG_ALEATORIA
    getchar();
 #endif
-   free(varlist);
-   free(solution);
-   free(covered);
-   free(cand);
    return found;
 }
 
@@ -334,6 +408,8 @@ static
 SCIP_DECL_HEUREXEC(heurExecAleatoria)
 {  /*lint --e{715}*/
    SCIP_SOL*             sol;                /**< solution to round */
+   SCIP_HEURDATA*        heurdata;
+   SCIP_Longint          memused, nsols;
    int nlpcands;
 
    assert(result != NULL);
@@ -359,6 +435,9 @@ SCIP_DECL_HEUREXEC(heurExecAleatoria)
      return SCIP_OKAY;
 
    /* solve aleatoria */
+   heurdata = SCIPheurGetData(heur);
+   memused = SCIPgetMemUsed(scip);
+   nsols = heurdata->nsols;
    if(aleatoria(scip, &sol, heur)){
      *result = SCIP_FOUNDSOL;
    }
@@ -367,6 +446,13 @@ SCIP_DECL_HEUREXEC(heurExecAleatoria)
      printf("\nAleatoria could not find feasible solution!");      
 #endif
    }
+   // the call works on buffers sized at initsol: unless it stored a solution, SCIP must use no more memory than before
+   // (the first call may still size the working solution)
+   if( heurdata->nsols == nsols && heurdata->ncalls > 1 && SCIPgetMemUsed(scip) > memused )
+   {
+      heurdata->nmemcalls++;
+      heurdata->memgrowth += SCIPgetMemUsed(scip) - memused;
+   }
    return SCIP_OKAY;
 }
 
@@ -384,7 +470,21 @@ SCIP_RETCODE SCIPincludeHeurAleatoria(
    SCIP_HEUR* heur;
 
    /* create aleatoria primal heuristic data */
-   heurdata = NULL;
+   SCIP_CALL( SCIPallocBlockMemory(scip, &heurdata) );
+   heurdata->sol = NULL;
+   heurdata->solution = NULL;
+   heurdata->covered = NULL;
+   heurdata->cand = NULL;
+   heurdata->nCands = NULL;
+   heurdata->residual = NULL;
+   heurdata->assign = NULL;
+   heurdata->LS = NULL;
+   heurdata->nitems = 0;
+   heurdata->nknaps = 0;
+   heurdata->ncalls = 0;
+   heurdata->nsols = 0;
+   heurdata->nmemcalls = 0;
+   heurdata->memgrowth = 0;
 
    heur = NULL;
 
@@ -35,7 +35,7 @@ extern "C" {
   
 //int printVarLpSol(SCIP* scip);
 //int incluiCandidatoB(candidatoT* candidatos, int total, int *nCands, int c, SCIP_Real solval);
-//int randomIntegerB (int low, int high);
+//int randomIntegerB (rngT* rng, int low, int high);
 //int updateSolution(SCIP_VAR* var, int n, int* covered, int *nCovered, int *custo);
 //SCIP_Real createSolution(SCIP* scip, SCIP_SOL* sol, SCIP_VAR** solution, int nSolution, int *infeasible);
 //SCIP_RETCODE selectCand(SCIP* scip, SCIP_VAR** solution, int nInSolution, int custo, SCIP_VAR** pvar, SCIP_VAR** varlist, int n1, int nfracimplvars, int* covered);
@@ -0,0 +1,408 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   heur_genetic.c
+ * @brief  genetic primal heuristic
+ * @author Edna Hoshino (based on template provided by Tobias Achterberg)
+ *
+ * Memetic GA of ga.c at the root node. The population starts with the rounding of the LP solution of the root
+ * (rounding.c) and with the solutions already stored by SCIP, which at this point come from the heuristics of higher
+ * priority (myrounding, grasp, aleatoria); the rest is filled with random assignments. Then up to
+ * heuristics/genetic/generations generations run within heuristics/genetic/maxtime sec, on --threads threads with
+ * random streams of --seed, and the best solution is submitted to SCIP and offered to the path relinking.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <string.h>
+#include <limits.h>
+
+#include "probdata_mochila.h"
+#include "parameters_mochila.h"
+#include "heur_genetic.h"
+#include "heur_pathrelinking.h"
+#include "heur_problem.h"
+#include "vardata_mochila.h"
+#include "rounding.h"
+#include "ga.h"
+
+//#define DEBUG_GENETIC 1
+/* configuracao da heuristica */
+#define HEUR_NAME             "genetic"
+#define HEUR_DESC             "memetic genetic algorithm seeded by the LP rounding and the stored solutions"
+#define HEUR_DISPCHAR         'G'
+#define HEUR_PRIORITY         0 /* depois de myrounding, grasp e aleatoria, cujas solucoes entram na populacao */
+#define HEUR_FREQ             1 /* a cada 1 nivel da arvore de B&B */
+#define HEUR_FREQOFS          0 /* comecando do nivel 0 */
+#define HEUR_MAXDEPTH         0 /* so na raiz */
+#define HEUR_TIMING           SCIP_HEURTIMING_AFTERNODE
+#define HEUR_USESSUBSCIP      FALSE  /**< does the heuristic use a secondary SCIP instance? */
+
+#define DEFAULT_POPSIZE       30     /**< members of the population */
+#define DEFAULT_GENERATIONS   200    /**< generations per call */
+#define DEFAULT_MAXTIME       1.0    /**< time budget (in sec) per call */
+
+/*
+ * Data structures
+ */
+
+/** primal heuristic data: the engines keep the buffers, sized once per solve */
+struct SCIP_HeurData
+{
+   SCIP_SOL*             sol;                /**< working solution, cleared and reused by every call */
+   gaT*                  G;                  /**< GA engine */
+   roundingT*            R;                  /**< rounding of the LP solution (first member of the population) */
+   threadpoolT*          pool;               /**< threads of the GA */
+   int*                  assign;             /**< stored solution as an assignment vector */
+   int                   nitems;             /**< size of assign */
+   int                   popsize;            /**< members of the population */
+   int                   generations;        /**< generations per call */
+   SCIP_Real             maxtime;            /**< time budget (in sec) per call */
+   SCIP_Longint          ncalls;             /**< number of calls */
+   SCIP_Longint          nseeds;             /**< solutions given to the population */
+   SCIP_Longint          nsols;              /**< number of solutions stored */
+   SCIP_Real             time;               /**< time spent in the engine */
+};
+
+/*
+ * Local methods
+ */
+
+/** the rounding of the LP solution and the solutions stored by SCIP go to the population */
+static
+void seedPopulation(SCIP* scip, SCIP_HEURDATA* heurdata, SCIP_PROBDATA* probdata, instanceT* I)
+{
+   SCIP_SOL** sols;
+   SCIP_Real solval;
+   roundingT* R = heurdata->R;
+   int s, nsols, i, k;
+
+   if( SCIPgetLPSolstat(scip) == SCIP_LPSOLSTAT_OPTIMAL )
+   {
+      roundingReset(R);
+      for( i = 0; i < I->n; i++ )
+      {
+         for( k = 0; k < I->m; k++ )
+         {
+            solval = SCIPgetVarSol(scip, SCIPprobdataGetVar(probdata, i, k));
+            if( solval > 1.0 - EPSILON )
+               roundingFix(R, i, k);
+            else if( solval > EPSILON )
+               roundingAddCand(R, i, k, solval);
+         }
+      }
+      roundingRun(R);
+      if( !R->infeasible && gaAdd(heurdata->G, R->assign) >= 0 )
+         heurdata->nseeds++;
+   }
+   sols = SCIPgetSols(scip);
+   nsols = SCIPgetNSols(scip);
+   for( s = 0; s < nsols; s++ )
+   {
+      for( i = 0; i < I->n; i++ )
+      {
+         heurdata->assign[i] = -1;
+         for( k = 0; k < I->m; k++ )
+            if( SCIPgetSolVal(scip, sols[s], SCIPprobdataGetVar(probdata, i, k)) > 0.5 )
+               heurdata->assign[i] = k;
+      }
+      if( gaAdd(heurdata->G, heurdata->assign) >= 0 )
+         heurdata->nseeds++;
+   }
+}
+
+/**
+ * @brief Core of the genetic heuristic: GA restricted to the current node, seeded by the LP rounding and the stored
+ * solutions. The best solution is submitted to SCIP if it improves the incumbent.
+ *
+ * @param scip problem
+ * @param heur pointer to the genetic heuristic handle (to contabilize statistics)
+ * @param found set to 1 if a solution is stored
+ */
+static
+SCIP_RETCODE genetic(SCIP* scip, SCIP_HEUR* heur, int* found)
+{
+   SCIP_PROBDATA* probdata;
+   SCIP_HEURDATA* heurdata;
+   SCIP_VAR* var;
+   SCIP_Real timelimit, limit, start;
+   unsigned int stored;
+   instanceT* I;
+   gaT* G;
+   int i, k, infeasible = 0;
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+   G = heurdata->G;
+   assert(G != NULL);
+   I = SCIPprobdataGetInstance(probdata);
+   *found = 0;
+
+   // the budget of the call, within the time limit of SCIP
+   timelimit = heurdata->maxtime;
+   SCIP_CALL( SCIPgetRealParam(scip, "limits/time", &limit) );
+   if( !SCIPisInfinity(scip, limit) && limit - SCIPgetSolvingTime(scip) < timelimit )
+      timelimit = limit - SCIPgetSolvingTime(scip);
+   if( timelimit <= 0.0 )
+      return SCIP_OKAY;
+
+   // restrictions of the node: items fixed in 1.0 stay in their knapsacks, vars fixed in 0.0 are not used
+   gaResetNode(G);
+   for( i = 0; i < I->n; i++ )
+   {
+      for( k = 0; k < I->m; k++ )
+      {
+         var = SCIPprobdataGetVar(probdata, i, k);
+         G->allowed[i*I->m + k] = SCIPvarGetUbLocal(var) > 1.0 - EPSILON;
+         if( SCIPvarGetLbLocal(var) > 1.0 - EPSILON )
+         {
+            infeasible = infeasible || G->fixed[i] >= 0;
+            G->fixed[i] = k;
+         }
+      }
+   }
+   if( infeasible )
+      return SCIP_OKAY;
+
+   heurdata->ncalls++;
+   start = SCIPgetSolvingTime(scip);
+   seedPopulation(scip, heurdata, probdata, I);
+   gaRun(G, heurdata->generations, timelimit);
+   heurdata->time += SCIPgetSolvingTime(scip) - start;
+   if( G->bestvalue < 0 )
+      return SCIP_OKAY;
+   SCIPpathrelinkingAddSolution(scip, G->best, G->bestvalue);
+#ifdef DEBUG_GENETIC
+   printf("\ngenetic: best value = %lld after %lld generations (%lld children entered the population)\n",
+      G->bestvalue, G->generations, G->nreplaced);
+#endif
+
+   if( G->bestvalue > SCIPgetPrimalboundMine(scip) + EPSILON )
+   {
+      SCIP_CALL( SCIPclearSol(scip, heurdata->sol) );
+      for( i = 0; i < I->n; i++ )
+      {
+         if( G->best[i] >= 0 )
+         {
+            SCIP_CALL( SCIPsetSolVal(scip, heurdata->sol, SCIPprobdataGetVar(probdata, i, G->best[i]), 1.0) );
+         }
+      }
+      /* verificar se a solucao eh viavel e armazena (SCIPtrySol copia a solucao) */
+      SCIP_CALL( SCIPtrySolMine(scip, heurdata->sol, TRUE, TRUE, FALSE, TRUE, &stored) );
+      if( stored )
+      {
+         heurdata->nsols++;
+         *found = 1;
+      }
+   }
+
+   return SCIP_OKAY;
+}
+
+/*
+ * Callback methods of primal heuristic
+ */
+
+/** copy method for primal heuristic plugins (called when SCIP copies plugins) */
+static
+SCIP_DECL_HEURCOPY(heurCopyGenetic)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+/** destructor of primal heuristic to free user data (called when SCIP is exiting) */
+static
+SCIP_DECL_HEURFREE(heurFreeGenetic)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   SCIPfreeBlockMemory(scip, &heurdata);
+   SCIPheurSetData(heur, NULL);
+
+   return SCIP_OKAY;
+}
+
+
+/** initialization method of primal heuristic (called after problem was transformed) */
+static
+SCIP_DECL_HEURINIT(heurInitGenetic)
+{  /*lint --e{715}*/
+
+
+   return SCIP_OKAY;
+}
+
+
+/** deinitialization method of primal heuristic (called before transformed problem is freed) */
+static
+SCIP_DECL_HEUREXIT(heurExitGenetic)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process initialization method of primal heuristic (called when branch and bound process is about to begin) */
+static
+SCIP_DECL_HEURINITSOL(heurInitsolGenetic)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   SCIP_PROBDATA* probdata;
+   itemArraysT* items;
+   instanceT* I;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   probdata = SCIPgetProbData(scip);
+   I = SCIPprobdataGetInstance(probdata);
+   items = SCIPprobdataGetItems(probdata);
+   heurdata->ncalls = 0;
+   heurdata->nseeds = 0;
+   heurdata->nsols = 0;
+   heurdata->time = 0.0;
+   heurdata->nitems = I->n;
+   SCIP_CALL( SCIPcreateSol(scip, &heurdata->sol, heur) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->assign, I->n) );
+   heurdata->pool = createThreadpool(param.threads);
+   heurdata->G = createGA(I, items, heurdata->popsize, heurdata->pool, (unsigned long long) param.seed);
+   heurdata->R = createRounding(I, items, I->n*I->m);
+   if( heurdata->G == NULL || heurdata->R == NULL )
+      return SCIP_NOMEMORY;
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process deinitialization method of primal heuristic (called before branch and bound process data is freed) */
+static
+SCIP_DECL_HEUREXITSOL(heurExitsolGenetic)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+#ifdef DEBUG_GENETIC
+   if( heurdata->G != NULL )
+      printf("\nHeuristic %s: %lld calls, %lld generations (%.1lf/s, %d threads), %lld seeds, %lld children (%lld entered the population), %lld solutions stored\n",
+         HEUR_NAME, (long long) heurdata->ncalls, heurdata->G->generations,
+         heurdata->time > 0.0 ? heurdata->G->generations / heurdata->time : 0.0, threadpoolSize(heurdata->pool),
+         (long long) heurdata->nseeds, heurdata->G->nchildren, heurdata->G->nreplaced, (long long) heurdata->nsols);
+#endif
+   freeGA(heurdata->G);
+   heurdata->G = NULL;
+   freeRounding(heurdata->R);
+   heurdata->R = NULL;
+   freeThreadpool(heurdata->pool);
+   heurdata->pool = NULL;
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->assign, heurdata->nitems);
+   if( heurdata->sol != NULL )
+   {
+      SCIP_CALL( SCIPfreeSol(scip, &heurdata->sol) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** execution method of primal heuristic */
+static
+SCIP_DECL_HEUREXEC(heurExecGenetic)
+{  /*lint --e{715}*/
+   int found;
+
+   assert(result != NULL);
+
+   *result = SCIP_DIDNOTRUN;
+
+   /* continue only if the LP is finished */
+   if ( SCIPgetLPSolstat(scip) != SCIP_LPSOLSTAT_OPTIMAL )
+      return SCIP_OKAY;
+
+   /* continue only of the LP value is less than the cutoff bound */
+   if( SCIPisGE(scip, SCIPgetLPObjval(scip), SCIPgetCutoffbound(scip)) )
+      return SCIP_OKAY;
+
+   *result = SCIP_DIDNOTFIND;
+   SCIP_CALL( genetic(scip, heur, &found) );
+   if( found )
+      *result = SCIP_FOUNDSOL;
+
+   return SCIP_OKAY;
+}
+
+
+/*
+ * primal heuristic specific interface methods
+ */
+
+/** creates the genetic primal heuristic and includes it in SCIP */
+SCIP_RETCODE SCIPincludeHeurGenetic(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_HEURDATA* heurdata;
+   SCIP_HEUR* heur;
+
+   /* create genetic primal heuristic data */
+   SCIP_CALL( SCIPallocBlockMemory(scip, &heurdata) );
+   heurdata->sol = NULL;
+   heurdata->G = NULL;
+   heurdata->R = NULL;
+   heurdata->pool = NULL;
+   heurdata->assign = NULL;
+   heurdata->nitems = 0;
+   heurdata->ncalls = 0;
+   heurdata->nseeds = 0;
+   heurdata->nsols = 0;
+   heurdata->time = 0.0;
+
+   heur = NULL;
+
+   /* include primal heuristic */
+   SCIP_CALL( SCIPincludeHeurBasic(scip, &heur,
+         HEUR_NAME, HEUR_DESC, HEUR_DISPCHAR, HEUR_PRIORITY, HEUR_FREQ, HEUR_FREQOFS,
+         HEUR_MAXDEPTH, HEUR_TIMING, HEUR_USESSUBSCIP, heurExecGenetic, heurdata) );
+
+   assert(heur != NULL);
+
+   /* set non fundamental callbacks via setter functions */
+   SCIP_CALL( SCIPsetHeurCopy(scip, heur, heurCopyGenetic) );
+   SCIP_CALL( SCIPsetHeurFree(scip, heur, heurFreeGenetic) );
+   SCIP_CALL( SCIPsetHeurInit(scip, heur, heurInitGenetic) );
+   SCIP_CALL( SCIPsetHeurExit(scip, heur, heurExitGenetic) );
+   SCIP_CALL( SCIPsetHeurInitsol(scip, heur, heurInitsolGenetic) );
+   SCIP_CALL( SCIPsetHeurExitsol(scip, heur, heurExitsolGenetic) );
+
+   /* add genetic primal heuristic parameters */
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/popsize",
+         "members of the population",
+         &heurdata->popsize, FALSE, DEFAULT_POPSIZE, 2, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/generations",
+         "generations per call",
+         &heurdata->generations, FALSE, DEFAULT_GENERATIONS, 1, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip, "heuristics/" HEUR_NAME "/maxtime",
+         "time budget (in sec) per call",
+         &heurdata->maxtime, FALSE, DEFAULT_MAXTIME, 0.0, SCIP_REAL_MAX, NULL, NULL) );
+
+   return SCIP_OKAY;
+}
@@ -16,17 +16,27 @@
 /**@file   heur_grasp.c
  * @brief  grasp primal heuristic
  * @author Edna Hoshino (based on template provided by Tobias Achterberg)
+ *
+ * Multi-start GRASP at the B&B nodes: the items fixed in 1.0 stay in their knapsacks, the variables fixed in 0.0 are
+ * not used, and the engine of grasp.c runs up to heuristics/grasp/iterations constructions with local search within
+ * heuristics/grasp/maxtime sec per call, on --threads threads with random streams of --seed. Only the best solution
+ * of the call is submitted to SCIP.
  */
 
 /*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
 
 #include <assert.h>
 #include <time.h> 
+#include <string.h>
+#include <limits.h>
 
 #include "probdata_mochila.h"
 #include "parameters_mochila.h"
 #include "heur_grasp.h"
+#include "heur_pathrelinking.h"
 #include "heur_problem.h"
+#include "vardata_mochila.h"
+#include "grasp.h"
 //#include "problem.h"   // eu que inclui isso.
 
 //#define DEBUG_GRASP 1
@@ -41,6 +51,10 @@
 #define HEUR_TIMING           SCIP_HEURTIMING_AFTERNODE //SCIP_HEURTIMING_DURINGLPLOOP // SCIP_HEURTIMING_AFTERNODE /* chamado depois que o LP resolvido */
 #define HEUR_USESSUBSCIP      FALSE  /**< does the heuristic use a secondary SCIP instance? */
 
+#define DEFAULT_ALPHA         0.7    /**< RCL threshold (1: greedy by value, 0: random) */
+#define DEFAULT_ITERATIONS    10     /**< constructions + local search per call */
+#define DEFAULT_MAXTIME       1.0    /**< time budget (in sec) per call */
+
 #ifdef DEBUG
    #define PRINTF(...) printf(__VA_ARGS__)
 #else
@@ -51,13 +65,24 @@
  * Data structures
  */
 
-/* TODO: fill in the necessary primal heuristic data */
-
-/** primal heuristic data */
-/*struct SCIP_HeurData
+/** primal heuristic data: the engine keeps the scratch buffers, sized once per solve, so a call does no heap
+ *  allocation
+ */
+struct SCIP_HeurData
 {
+   SCIP_SOL*             sol;                /**< working solution, cleared and reused by every call */
+   graspT*               G;                  /**< GRASP engine */
+   threadpoolT*          pool;               /**< threads of the GRASP */
+   SCIP_Real             alpha;              /**< RCL threshold (1: greedy by value, 0: random) */
+   int                   iterations;         /**< constructions + local search per call */
+   SCIP_Real             maxtime;            /**< time budget (in sec) per call */
+   SCIP_Longint          ncalls;             /**< number of calls */
+   SCIP_Longint          niterations;        /**< total of constructions */
+   SCIP_Longint          nsols;              /**< number of solutions stored */
+   SCIP_Longint          nmemcalls;          /**< calls that stored no solution but left SCIP using more memory */
+   SCIP_Longint          memgrowth;          /**< bytes left by those calls */
+   SCIP_Real             time;               /**< time spent in the engine */
 };
-*/
 
 /*
  * Local methods
@@ -83,6 +108,13 @@ SCIP_DECL_HEURCOPY(heurCopyGrasp)
 static
 SCIP_DECL_HEURFREE(heurFreeGrasp)
 {  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   SCIPfreeBlockMemory(scip, &heurdata);
+   SCIPheurSetData(heur, NULL);
 
    return SCIP_OKAY;
 }
@@ -111,6 +143,27 @@ SCIP_DECL_HEUREXIT(heurExitGrasp)
 static
 SCIP_DECL_HEURINITSOL(heurInitsolGrasp)
 {  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   SCIP_PROBDATA* probdata;
+   instanceT* I;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   probdata = SCIPgetProbData(scip);
+   I = SCIPprobdataGetInstance(probdata);
+   heurdata->ncalls = 0;
+   heurdata->niterations = 0;
+   heurdata->nsols = 0;
+   heurdata->nmemcalls = 0;
+   heurdata->memgrowth = 0;
+   heurdata->time = 0.0;
+   SCIP_CALL( SCIPcreateSol(scip, &heurdata->sol, heur) );
+   heurdata->pool = createThreadpool(param.threads);
+   heurdata->G = createGrasp(I, SCIPprobdataGetItems(probdata), heurdata->alpha, heurdata->pool,
+      (unsigned long long) param.seed);
+   if( heurdata->G == NULL )
+      return SCIP_NOMEMORY;
 
    return SCIP_OKAY;
 }
@@ -120,22 +173,34 @@ SCIP_DECL_HEURINITSOL(heurInitsolGrasp)
 static
 SCIP_DECL_HEUREXITSOL(heurExitsolGrasp)
 {  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
 
-   return SCIP_OKAY;
-}
-
-void min_max(int *candidatos, instanceT* I, int n, int *max, int *min);
-
-void cria_RCL(instanceT* I,int *candidatos, int *RCL, int minimo, int maximo, int alpha, int n, int *n_RCL);
-
-static int numero_aleatorio(int n_cand);
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
 
-void atualiza_candidatos(instanceT* I, int *candidatos, int rotulo, int *n_cand, int capacidade_atual);
+#ifdef DEBUG_GRASP
+   printf("\nHeuristic %s: %lld calls, %lld constructions (%.0lf/s, %d threads), %lld solutions stored\n",
+      HEUR_NAME, (long long) heurdata->ncalls, (long long) heurdata->niterations,
+      heurdata->time > 0.0 ? heurdata->niterations / heurdata->time : 0.0, threadpoolSize(heurdata->pool),
+      (long long) heurdata->nsols);
+   printf("Heuristic %s: %lld calls stored no solution but left SCIP using more memory (%lld bytes)\n", HEUR_NAME,
+      (long long) heurdata->nmemcalls, (long long) heurdata->memgrowth);
+#endif
+   freeGrasp(heurdata->G);
+   heurdata->G = NULL;
+   freeThreadpool(heurdata->pool);
+   heurdata->pool = NULL;
+   if( heurdata->sol != NULL )
+   {
+      SCIP_CALL( SCIPfreeSol(scip, &heurdata->sol) );
+   }
 
-int verifica_solucao(int *covered, int label);
+   return SCIP_OKAY;
+}
 
 /**
- * @brief Core of the grasp heuristic: it builds one solution for the problem by grasp procedure.
+ * @brief Core of the grasp heuristic: multi-start GRASP restricted to the current node. The best solution of the
+ * iterations is submitted to SCIP if it improves the incumbent.
  *
  * @param scip problem
  * @param sol pointer to the solution structure where the solution wil be saved
@@ -144,22 +209,18 @@ int verifica_solucao(int *covered, int label);
  */
 int grasp(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
 {
-   int found = 0, infeasible = 0, nInSolution = 0;
+   int found = 0, infeasible = 0;
    unsigned int stored;
-   int nvars;
-   int *covered, n, m, custo = 0, **cand, *nCands;
-   SCIP_VAR *var, **solution, **varlist;
-   //  SCIP* scip_cp;
-   SCIP_Real valor, bestUb;
+   int n, m;
+   SCIP_VAR *var;
+   SCIP_Real bestUb, timelimit, limit, start;
    SCIP_PROBDATA* probdata;
-   int i, *residual;
-   int *RCL;
+   SCIP_HEURDATA* heurdata;
+   int i, k, item;
    instanceT* I;
+   itemArraysT* items;
+   graspT* G;
 
-   int max_iteracoes, maximo, minimo, alpha = 0.7;
-   int posicao_item_escolhido, n_RCL = 0;
-   
-   
 #ifdef DEBUG_GRASP
    printf("\n============== New grasp heur at node: %lld\n", SCIPnodeGetNumber(SCIPgetCurrentNode(scip)));
 #endif
@@ -167,180 +228,99 @@ int grasp(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
    /* recupera os dados do problema original*/
    probdata=SCIPgetProbData(scip);
    assert(probdata != NULL);
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+   G = heurdata->G;
+   assert(G != NULL);
 
-   nvars = SCIPprobdataGetNVars(probdata);
-   varlist = SCIPprobdataGetVars(probdata);
    I = SCIPprobdataGetInstance(probdata);
+   items = SCIPprobdataGetItems(probdata);
    n = I->n;
    m = I->m;
-   int flag = 0;
-    
-   solution = (SCIP_VAR**) malloc(sizeof(SCIP_VAR*)*n);
-   covered = (int*) calloc(n,sizeof(int));
-   cand = (int**) malloc(m*sizeof(int*));  // sao m mochilas, ent eh uma lista de candidatos para cada uma
-
-   for(i = 0; i < m; i++){
-      cand[i] = (int *) malloc(n*sizeof(int));
-   }
-
-   residual = (int*) malloc(m*sizeof(int));
-   nCands = (int *) calloc(m,sizeof(int));  // agr eu preciso diferenciar o numero de candidatos para cada mochila
-
-   for(int k = 0; k < m; k++){
-      residual[k] = I->C[k];
-   }
+   heurdata->ncalls++;
 
-   // first, select all variables already fixed in 1.0
-   // esse for aqui percorre todas as n*m variaveis do problema, certo?
-   for(i=0;i<nvars;i++){
-
-      var = varlist[i];  // o que isso aqui faz exatamente??? pega as variaveis da linha i do sistema de equacoes?
-
-      if(SCIPvarGetLbLocal(var) > 1.0 - EPSILON){
-         solution[nInSolution++] = var;
-         // atualiza a capacidade atual da mochila na qual o item foi colocado
-         residual[i%m] -= I->item[i].weight;
-
-         // marca aquele item como coberto
-         covered[i%n] = 1;
-
-         // atualiza o custo
-         custo += I->item[i].value;
-         flag++;
-         infeasible = residual < 0?1:0;
-#ifdef DEBUG_GRASP
-         printf("\nSelected fixed var= %s. TotalItems=%d value=%d residual=%d infeasible=%d", SCIPvarGetName(var), nInSolution, custo, residual, infeasible);
- #endif
-      }
-      else{// discard items fixed in 0.0
-         if(SCIPvarGetUbLocal(var) < EPSILON){ // var fixed in 0.0
-         }
-         else{
-            // aqui ele (item ou variavel?) esta fracionario??
-           if (i < n){ // include item i in cand list
-            for(int k = 0; k < m; k++){
-               // verificando se o item i cabe na mochila k
-               if(I->item[i].weight <= residual[k]){
-                  cand[k][nCands[k]] = i;
-                  nCands[k] += 1;
-               }
-           }
+   // restrictions of the node: items fixed in 1.0 stay in their knapsacks, vars fixed in 0.0 are not used
+   memcpy(G->capacity, I->C, m*sizeof(int));
+   G->fixedvalue = 0;
+   for( item = 0; item < n; item++ )
+   {
+      G->fixed[item] = -1;
+      for( k = 0; k < m; k++ )
+      {
+         var = SCIPprobdataGetVar(probdata, item, k);
+         G->allowed[item*m + k] = SCIPvarGetUbLocal(var) > 1.0 - EPSILON;
+         if( SCIPvarGetLbLocal(var) > 1.0 - EPSILON )
+         {
+            infeasible = infeasible || G->fixed[item] >= 0;
+            G->fixed[item] = k;
+            G->capacity[k] -= items->weight[item];
+            G->fixedvalue += items->value[item];
+            infeasible = infeasible || G->capacity[k] < 0;
          }
       }
    }
-}
+   if( infeasible )
+      return 0;
 
-   max_iteracoes = m;
-   // quantidade de iteracoes = quantidade de mochilas q eu tenho
-   for( i = 0; i < max_iteracoes; i++){
+   // the budget of the call, within the time limit of SCIP
+   timelimit = heurdata->maxtime;
+   SCIP_CALL( SCIPgetRealParam(scip, "limits/time", &limit) );
+   if( !SCIPisInfinity(scip, limit) && limit - SCIPgetSolvingTime(scip) < timelimit )
+      timelimit = limit - SCIPgetSolvingTime(scip);
+   if( timelimit <= 0.0 )
+      return 0;
 
-      for (int j = 0; j < n; j++){
-         // colocando no vetor candidatos todos os itens que tem peso <= capacidade da mochila i E que nao foram colocados ainda na solucao
-         if (I->item[j].weight <= I->C[i] && (verifica_solucao(covered, I->item[j].label) == 0))
-         {
-            cand[i][nCands[i]] = I->item[j].label;
-            /*candidatos[n_cand].label = I->item[j].label; // assim?
-            candidatos[n_cand].weight = I->item[j].weight;
-            candidatos[n_cand].value = I->item[j].value;
-            n_cand++;*/
-            nCands[i] += 1;
-         }
-      }
+   G->alpha = heurdata->alpha;
+   start = SCIPgetSolvingTime(scip);
+   graspRun(G, heurdata->iterations, timelimit);
+   heurdata->time += SCIPgetSolvingTime(scip) - start;
+   heurdata->niterations += G->iterations;
+   if( G->bestvalue >= 0 )
+      SCIPpathrelinkingAddSolution(scip, G->best, G->bestvalue);
 
-      // a partir daqui, candidatos possui todos os itens com peso <= capacidade da mochila i
-
-      int capacidade_atual = I->C[i];
-      int j = 0;
-      while(capacidade_atual > 0.0 && nCands[i] >= 1){
-         // passa a lista de candidatos da mochila i, o numero de candidatos que ela tem
-         min_max(cand[i],I, nCands[i], &maximo, &minimo);
-         RCL = (int*) malloc(sizeof(int)*nCands[i]);
-         n_RCL = 0;
-         cria_RCL(I, cand[i], RCL, minimo, maximo, alpha, nCands[i], &n_RCL);
-
-         posicao_item_escolhido = numero_aleatorio(n_RCL); // 0 ate n-1
-
-         // atualzia o custo e diminui a capacidade atual da mochila
-         valor = I->item[RCL[posicao_item_escolhido]].value;
-         custo += valor;
-         capacidade_atual -= I->item[RCL[posicao_item_escolhido]].weight;
-
-         var = varlist[posicao_item_escolhido]; 
-         solution[nInSolution++] = var;
-         covered[posicao_item_escolhido] = 1;
-
-         infeasible = capacidade_atual <0?1:0;
-         
-
-         atualiza_candidatos(I, cand[i], posicao_item_escolhido, &nCands[i], capacidade_atual);
-         
-         // se ao final, a RCL nao estiver vazia, eu "reseto" ela novamente para a proxima iteracao
-         if(n_RCL != 0){
-            free(RCL);
-            RCL = NULL;
+   bestUb = SCIPgetPrimalboundMine(scip);
+#ifdef DEBUG_GRASP
+   printf("\n%lld iterations: best value = %lld > bestUb = %lf? %d\n", G->iterations, G->bestvalue, bestUb,
+      G->bestvalue > bestUb + EPSILON);
+#endif
+   if( G->bestvalue > bestUb + EPSILON )
+   {
+      /* the working solution of the heurdata gets the best solution */
+      *sol = heurdata->sol;
+      SCIP_CALL( SCIPclearSol(scip, *sol) );
+      for( i = 0; i < n; i++ )
+      {
+         if( G->best[i] >= 0 )
+         {
+            SCIP_CALL( SCIPsetSolVal(scip, *sol, SCIPprobdataGetVar(probdata, i, G->best[i]), 1.0) );
          }
-         
-         
-         
-         j++;
-      }
-
-      free(cand[i]);
-
       }
-
-
-   if(!infeasible){
-      /* create SCIP solution structure sol */
-      SCIP_CALL( SCIPcreateSol(scip, sol, heur) );
-      // save found solution in sol
-      for(i=0;i<nInSolution;i++){
-         var = solution[i];
-         SCIP_CALL( SCIPsetSolVal(scip, *sol, var, 1.0) );
-      }
-      bestUb = SCIPgetPrimalbound(scip);
 #ifdef DEBUG_GRASP
-      printf("\nFound solution...\n");
-      //      SCIP_CALL( SCIPprintSol(scip, *sol, NULL, FALSE) );
-      printf("\ninfeasible=%d value = %lf > bestUb = %lf? %d\n\n", infeasible, valor, bestUb, valor > bestUb + EPSILON);
+      printf("\nBest solution found...\n");
+      SCIP_CALL( SCIPprintSol(scip, *sol, NULL, FALSE) );
 #endif
-      if(!infeasible && custo > bestUb + EPSILON){
-#ifdef DEBUG_GRASP
-         printf("\nBest solution found...\n");
-         SCIP_CALL( SCIPprintSol(scip, *sol, NULL, FALSE) );
-#endif
-         
-         /* verificar se a solucao eh viavel e armazena */
-         SCIP_CALL( SCIPtrySolMine(scip, *sol, TRUE, TRUE, FALSE, TRUE, &stored) );
-         if( stored )
-         {
+      /* verificar se a solucao eh viavel e armazena (SCIPtrySol copia a solucao) */
+      SCIP_CALL( SCIPtrySolMine(scip, *sol, TRUE, TRUE, FALSE, TRUE, &stored) );
+      if( stored )
+      {
 #ifdef DEBUG_PRIMAL
-            printf("\nSolution is feasible and was saved! Total of items = %d", nInSolution);
-            SCIPdebugMessage("found feasible GRASP solution:\n");
-            SCIP_CALL( SCIPprintSol(scip, *sol, NULL, FALSE) );
+         printf("\nSolution is feasible and was saved! Value = %lld", G->bestvalue);
+         SCIPdebugMessage("found feasible GRASP solution:\n");
+         SCIP_CALL( SCIPprintSol(scip, *sol, NULL, FALSE) );
 #endif
-            found = 1;
-         }
-         else{
-           found = 0;
+         heurdata->nsols++;
+         found = 1;
+      }
 #ifdef DEBUG_GRASP
-           printf("\nCould not found\n. BestUb=%lf", bestUb);
+      else
+         printf("\nCould not found\n. BestUb=%lf", bestUb);
 #endif
-         }
-      }
    }
 #ifdef DEBUG_GRASP
    getchar();
 #endif
 
-   free(varlist);
-   free(solution);
-   free(covered);
-   free(cand);
    return found;
-
-
-   // =============== FIM DA FUNCAO DA HEURISTICA
 }
 
 /** execution method of primal heuristic */
@@ -348,6 +328,8 @@ static
 SCIP_DECL_HEUREXEC(heurExecGrasp)
 {  /*lint --e{715}*/
    SCIP_SOL*             sol;                /**< solution to round */
+   SCIP_HEURDATA*        heurdata;
+   SCIP_Longint          memused, nsols;
    int nlpcands;
 
    assert(result != NULL);
@@ -373,6 +355,9 @@ SCIP_DECL_HEUREXEC(heurExecGrasp)
      return SCIP_OKAY;
 
    /* solve grasp */
+   heurdata = SCIPheurGetData(heur);
+   memused = SCIPgetMemUsed(scip);
+   nsols = heurdata->nsols;
    if(grasp(scip, &sol, heur)){
      *result = SCIP_FOUNDSOL;
    }
@@ -381,6 +366,13 @@ SCIP_DECL_HEUREXEC(heurExecGrasp)
      printf("\nGrasp could not find feasible solution!");      
 #endif
    }
+   // the call works on buffers sized at initsol: unless it stored a solution, SCIP must use no more memory than before
+   // (the first call may still size the working solution)
+   if( heurdata->nsols == nsols && heurdata->ncalls > 1 && SCIPgetMemUsed(scip) > memused )
+   {
+      heurdata->nmemcalls++;
+      heurdata->memgrowth += SCIPgetMemUsed(scip) - memused;
+   }
    return SCIP_OKAY;
 }
 
@@ -397,7 +389,16 @@ SCIP_RETCODE SCIPincludeHeurGrasp(
    SCIP_HEUR* heur;
 
    /* create grasp primal heuristic data */
-   heurdata = NULL;
+   SCIP_CALL( SCIPallocBlockMemory(scip, &heurdata) );
+   heurdata->sol = NULL;
+   heurdata->G = NULL;
+   heurdata->pool = NULL;
+   heurdata->ncalls = 0;
+   heurdata->niterations = 0;
+   heurdata->nsols = 0;
+   heurdata->nmemcalls = 0;
+   heurdata->memgrowth = 0;
+   heurdata->time = 0.0;
 
    heur = NULL;
 
@@ -430,87 +431,15 @@ SCIP_RETCODE SCIPincludeHeurGrasp(
 #endif
 
    /* add grasp primal heuristic parameters */
-   /* TODO: (optional) add primal heuristic specific parameters with SCIPaddTypeParam() here */
+   SCIP_CALL( SCIPaddRealParam(scip, "heuristics/" HEUR_NAME "/alpha",
+         "RCL threshold: candidates with value >= min + alpha*(max-min) (1: greedy by value, 0: random)",
+         &heurdata->alpha, FALSE, DEFAULT_ALPHA, 0.0, 1.0, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/iterations",
+         "number of constructions + local search per call (the best solution is submitted)",
+         &heurdata->iterations, FALSE, DEFAULT_ITERATIONS, 1, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip, "heuristics/" HEUR_NAME "/maxtime",
+         "time budget (in sec) per call",
+         &heurdata->maxtime, FALSE, DEFAULT_MAXTIME, 0.0, SCIP_REAL_MAX, NULL, NULL) );
 
    return SCIP_OKAY;
 }
-
-void min_max(int *candidatos, instanceT* I , int n, int *max, int *min)
-{
-   *max = I->item[candidatos[0]].value;
-   *min = I->item[candidatos[0]].value;
-
-   for (int i = 1; i < n; i++)
-   {
-      if (I->item[candidatos[i]].value >= *max)
-      {
-         *max = I->item[candidatos[i]].value;
-      }
-
-      if (I->item[candidatos[i]].value <= *min)
-      {
-         
-         *min = I->item[candidatos[i]].value;
-      }
-   }
-
-}
-
-void cria_RCL(instanceT* I, int *candidatos, int *RCL, int minimo, int maximo, int alpha, int n, int *n_RCL)
-{
-
-   for (int i = 0; i < n; i++)
-   {
-      if (I->item[candidatos[i]].value >= minimo + alpha * (maximo - minimo))
-      {
-         RCL[*n_RCL] = I->item[candidatos[i]].label-1;
-         (*n_RCL) += 1;
-      }
-   }
-}
-
-int numero_aleatorio(int n_cand){
-   return rand() % n_cand;
-}
-
-void atualiza_candidatos(instanceT* I, int *candidatos, int rotulo, int *n_cand, int capacidade_atual)
-{
-
-   for(int i = 0; i < *n_cand; i++){
-      if(candidatos[i] == rotulo-1){
-         candidatos[i] = candidatos[--(*n_cand)];
-      }
-   }
-
-   for (int i = 0; i < *n_cand; i++)
-   {
-
-      // se isso acontecer, eu preciso remover esse item
-      if (I->item[candidatos[i]].weight > capacidade_atual)
-      {
-
-         while (I->item[candidatos[(*n_cand) - 1]].weight > capacidade_atual && *n_cand > i)
-         {
-            (*n_cand) -= 1;
-         }
-
-         if (*n_cand > i)
-         {
-            candidatos[i] = candidatos[--(*n_cand)];
-         }
-      }
-   }
-
-}
-
-int verifica_solucao(int *covered, int label){
-
-   if(covered[label] == 1){
-      // item ja foi colocado em alguma mochila
-      return 1;
-   }else{
-      // esse item n foi colocado em nenhuma mochila
-      return 0;
-   }
-
-}
\ No newline at end of file
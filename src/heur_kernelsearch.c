@@ -0,0 +1,520 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   heur_kernelsearch.c
+ * @brief  kernel search primal heuristic
+ * @author Edna Hoshino (based on template provided by Tobias Achterberg)
+ *
+ * Kernel search (Angelelli, Mansini and Speranza) at the root, once, after the LP: the vars x_i_j are sorted by their
+ * value in the LP solution and then by their reduced cost (both decreasing), the kernel gets the vars with positive LP
+ * value and the others are split in buckets of consecutive vars of that order. A sequence of restricted sub-MIPs is
+ * solved on the sub-SCIP (SCIPprobdataCreate() on a copy of the instance, whose vars are indexed as the vars of
+ * probdata): the first one on the kernel alone and each of the next ones on the kernel plus one bucket, with the
+ * incumbent value as objective limit. The vars of the bucket that are 1 in an improving solution enter the kernel.
+ *
+ * Each sub-MIP gives a line of progress (step, vars of the sub-MIP, time, nodes, status, primal bound), printed at the
+ * end of the heuristic and written in the .out file by SCIPkernelsearchPrintProgress().
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "scip/scipdefplugins.h"
+#include "probdata_mochila.h"
+#include "parameters_mochila.h"
+#include "heur_kernelsearch.h"
+#include "heur_problem.h"
+
+//#define DEBUG_KS 1
+/* configuracao da heuristica */
+#define HEUR_NAME             "kernelsearch"
+#define HEUR_DESC             "kernel search: sub-MIPs on the kernel of the root LP plus one bucket of vars at a time"
+#define HEUR_DISPCHAR         'K'
+#define HEUR_PRIORITY         -2 /* depois das heuristicas de raiz, que dao o incumbente */
+#define HEUR_FREQ             1
+#define HEUR_FREQOFS          0 /* comecando do nivel 0 */
+#define HEUR_MAXDEPTH         0 /* so na raiz */
+#define HEUR_TIMING           SCIP_HEURTIMING_AFTERLPNODE
+#define HEUR_USESSUBSCIP      TRUE   /**< does the heuristic use a secondary SCIP instance? */
+
+#define DEFAULT_BUCKETS       10     /**< buckets of the vars out of the initial kernel */
+#define DEFAULT_MAXTIME       10.0   /**< time limit (in sec) of a sub-MIP */
+#define DEFAULT_NODES         5000   /**< node limit of a sub-MIP */
+
+/*
+ * Data structures
+ */
+
+/** progress of one sub-MIP */
+typedef struct
+{
+   int                   step;               /**< 0: kernel alone, b > 0: kernel plus the bucket b */
+   int                   nvars;              /**< vars not fixed to 0 in the sub-MIP */
+   SCIP_Real             time;               /**< solving time of SCIP at the end of the sub-MIP */
+   SCIP_Longint          nodes;              /**< nodes of the sub-MIP */
+   int                   status;             /**< SCIP_STATUS of the sub-MIP */
+   SCIP_Real             primalbound;        /**< primal bound of SCIP after the sub-MIP */
+} ksStepT;
+
+/** var of the ordering: index in the array of vars of probdata and its LP value and reduced cost */
+typedef struct
+{
+   int                   idx;
+   SCIP_Real             solval;
+   SCIP_Real             redcost;
+} ksVarT;
+
+/** primal heuristic data */
+struct SCIP_HeurData
+{
+   SCIP_SOL*             sol;                /**< working solution */
+   ksStepT*              steps;              /**< progress of the sub-MIPs */
+   int                   nsteps;             /**< sub-MIPs solved */
+   int                   maxsteps;           /**< size of steps */
+   int                   done;               /**< the heuristic already ran in this solve */
+   int                   nbuckets;           /**< buckets of the vars out of the initial kernel */
+   SCIP_Real             maxtime;            /**< time limit (in sec) of a sub-MIP */
+   int                   nodes;              /**< node limit of a sub-MIP */
+   int                   kernelsize;         /**< size of the kernel at the end */
+   SCIP_Longint          nsols;              /**< number of solutions stored */
+   SCIP_Real             subtime;            /**< time spent in the sub-MIPs */
+};
+
+/*
+ * Local methods
+ */
+
+/** LP value decreasing, then reduced cost decreasing (ties to the lowest index) */
+static
+int compareVars(const void* a, const void* b)
+{
+   const ksVarT* u = (const ksVarT*) a;
+   const ksVarT* v = (const ksVarT*) b;
+
+   if( u->solval > v->solval + EPSILON )
+      return -1;
+   if( u->solval < v->solval - EPSILON )
+      return 1;
+   if( u->redcost > v->redcost + EPSILON )
+      return -1;
+   if( u->redcost < v->redcost - EPSILON )
+      return 1;
+   return u->idx - v->idx;
+}
+
+/** creates the sub-SCIP with the model of a copy of the instance */
+static
+SCIP_RETCODE createSubscip(SCIP* scip, SCIP** subscip, instanceT* I)
+{
+   instanceT* copy;
+
+   copyInstance(&copy, I);
+   if( copy == NULL )
+      return SCIP_NOMEMORY;
+   SCIP_CALL( SCIPcreate(subscip) );
+   SCIP_CALL( SCIPincludeDefaultPlugins(*subscip) );
+   SCIP_CALL( SCIPsetIntParam(*subscip, "display/verblevel", 0) );
+   SCIP_CALL( SCIPsetBoolParam(*subscip, "misc/catchctrlc", FALSE) );
+   // the sub-SCIP owns the copy (it is freed with its problem)
+   SCIP_CALL( SCIPprobdataCreate(*subscip, "kernelsearch", copy, FALSE, param.model_cons ? TRUE : FALSE,
+         FORMULATION_ASSIGNMENT) );
+   // the value of the items fixed out of the model (core mode), so the objectives of both SCIPs compare
+   SCIP_CALL( SCIPaddOrigObjoffset(*subscip, SCIPgetOrigObjoffset(scip)) );
+
+   return SCIP_OKAY;
+}
+
+/** one restricted sub-MIP: the vars of the kernel and of the bucket [first, last) of the order keep their global bounds,
+ *  the others are fixed to 0; the vars of the bucket that are 1 in an improving solution enter the kernel */
+static
+SCIP_RETCODE solveStep(SCIP* scip, SCIP_HEURDATA* heurdata, SCIP* subscip, ksVarT* order, unsigned char* inkernel,
+   int nvars, int first, int last, int step, SCIP_Real timelimit, SCIP_Real memorylimit, int* found)
+{
+   SCIP_VAR **vars, **subvars;
+   SCIP_SOL* subsol;
+   SCIP_Real lb, ub;
+   SCIP_RETCODE retcode;
+   unsigned int stored;
+   ksStepT* entry;
+   int p, v, nfree;
+
+   vars = SCIPprobdataGetVars(SCIPgetProbData(scip));
+   subvars = SCIPprobdataGetVars(SCIPgetProbData(subscip));
+
+   SCIP_CALL( SCIPfreeTransform(subscip) );
+   nfree = 0;
+   for( v = 0; v < nvars; v++ )
+   {
+      ub = inkernel[v] ? SCIPvarGetUbGlobal(vars[v]) : 0.0;
+      lb = MIN(SCIPvarGetLbGlobal(vars[v]), ub);
+      nfree += ub > 0.5;
+      SCIP_CALL( SCIPchgVarLb(subscip, subvars[v], 0.0) );
+      SCIP_CALL( SCIPchgVarUb(subscip, subvars[v], ub) );
+      SCIP_CALL( SCIPchgVarLb(subscip, subvars[v], lb) );
+   }
+   for( p = first; p < last; p++ )
+   {
+      v = order[p].idx;
+      ub = SCIPvarGetUbGlobal(vars[v]);
+      nfree += ub > 0.5;
+      SCIP_CALL( SCIPchgVarUb(subscip, subvars[v], ub) );
+   }
+   // only solutions better than the incumbent (the objective is integral)
+   if( SCIPgetNSols(scip) > 0 )
+   {
+      SCIP_CALL( SCIPsetObjlimit(subscip, SCIPgetPrimalbound(scip) + 0.5) );
+   }
+   SCIP_CALL( SCIPsetRealParam(subscip, "limits/time", timelimit) );
+   SCIP_CALL( SCIPsetLongintParam(subscip, "limits/nodes", (SCIP_Longint) heurdata->nodes) );
+   SCIP_CALL( SCIPsetRealParam(subscip, "limits/memory", memorylimit) );
+
+   // an error in the sub-MIP does not stop the main run, but it is reported
+   retcode = SCIPsolve(subscip);
+   if( retcode != SCIP_OKAY )
+   {
+      SCIPwarningMessage(scip, "kernel search: error while solving the sub-MIP of step %d, retcode <%d>\n", step,
+         (int) retcode);
+      return SCIP_OKAY;
+   }
+   heurdata->subtime += SCIPgetSolvingTime(subscip);
+
+   if( SCIPgetNSols(subscip) > 0 )
+   {
+      subsol = SCIPgetBestSol(subscip);
+      if( SCIPgetNSols(scip) == 0 || SCIPgetSolOrigObj(subscip, subsol) > SCIPgetPrimalbound(scip) + EPSILON )
+      {
+         SCIP_CALL( SCIPclearSol(scip, heurdata->sol) );
+         for( v = 0; v < nvars; v++ )
+         {
+            if( SCIPgetSolVal(subscip, subsol, subvars[v]) > 0.5 )
+            {
+               SCIP_CALL( SCIPsetSolVal(scip, heurdata->sol, vars[v], 1.0) );
+            }
+         }
+         SCIP_CALL( SCIPtrySolMine(scip, heurdata->sol, FALSE, TRUE, FALSE, TRUE, &stored) );
+         if( stored )
+         {
+            heurdata->nsols++;
+            *found = 1;
+         }
+         for( p = first; p < last; p++ )
+            if( SCIPgetSolVal(subscip, subsol, subvars[order[p].idx]) > 0.5 )
+               inkernel[order[p].idx] = 1;
+      }
+   }
+
+   if( heurdata->nsteps < heurdata->maxsteps )
+   {
+      entry = &heurdata->steps[heurdata->nsteps++];
+      entry->step = step;
+      entry->nvars = nfree;
+      entry->time = SCIPgetSolvingTime(scip);
+      entry->nodes = SCIPgetNNodes(subscip);
+      entry->status = (int) SCIPgetStatus(subscip);
+      entry->primalbound = SCIPgetNSols(scip) > 0 ? SCIPgetPrimalbound(scip) : 0.0;
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Core of the kernel search: the ordering of the vars by the root LP and the sequence of sub-MIPs.
+ *
+ * @param scip problem
+ * @param heur pointer to the kernel search heuristic handle (to contabilize statistics)
+ * @param found set to 1 if a solution is stored
+ */
+static
+SCIP_RETCODE kernelsearch(SCIP* scip, SCIP_HEUR* heur, int* found)
+{
+   SCIP_PROBDATA* probdata;
+   SCIP_HEURDATA* heurdata;
+   SCIP_VAR** vars;
+   SCIP* subscip;
+   SCIP_Real limit, timelimit, memorylimit;
+   ksVarT* order;
+   unsigned char* inkernel;
+   instanceT* I;
+   int v, nvars, nkernel, bucketsize, first, b;
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+   I = SCIPprobdataGetInstance(probdata);
+   vars = SCIPprobdataGetVars(probdata);
+   nvars = I->n*I->m;
+   *found = 0;
+
+   // ordering of the vars by the root LP; the kernel gets the vars with positive LP value
+   SCIP_CALL( SCIPallocBufferArray(scip, &order, nvars) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &inkernel, nvars) );
+   for( v = 0; v < nvars; v++ )
+   {
+      order[v].idx = v;
+      order[v].solval = SCIPgetVarSol(scip, vars[v]);
+      order[v].redcost = SCIPgetVarRedcost(scip, vars[v]);
+   }
+   qsort(order, nvars, sizeof(ksVarT), compareVars);
+   memset(inkernel, 0, nvars);
+   for( nkernel = 0; nkernel < nvars && order[nkernel].solval > EPSILON; nkernel++ )
+      inkernel[order[nkernel].idx] = 1;
+   bucketsize = heurdata->nbuckets > 0 ? (nvars - nkernel + heurdata->nbuckets - 1)/heurdata->nbuckets : 0;
+
+   SCIP_CALL( createSubscip(scip, &subscip, I) );
+   first = nkernel;
+   for( b = 0; b == 0 || (bucketsize > 0 && first < nvars); b++ )
+   {
+      // the budget of the sub-MIP, within the time limit of SCIP
+      timelimit = heurdata->maxtime;
+      SCIP_CALL( SCIPgetRealParam(scip, "limits/time", &limit) );
+      if( !SCIPisInfinity(scip, limit) && limit - SCIPgetSolvingTime(scip) < timelimit )
+         timelimit = limit - SCIPgetSolvingTime(scip);
+      if( timelimit <= 0.0 || SCIPisStopped(scip) )
+         break;
+      // the memory left by the main run; stop if it is too little for the sub-MIP
+      SCIP_CALL( SCIPgetSubscipMemlimitMine(scip, &memorylimit) );
+      if( memorylimit <= 2.0*SCIPgetMemExternEstim(scip)/1048576.0 )
+         break;
+      if( b == 0 )
+      {
+         SCIP_CALL( solveStep(scip, heurdata, subscip, order, inkernel, nvars, first, first, b, timelimit, memorylimit,
+               found) );
+      }
+      else
+      {
+         SCIP_CALL( solveStep(scip, heurdata, subscip, order, inkernel, nvars, first, MIN(first + bucketsize, nvars), b,
+               timelimit, memorylimit, found) );
+         first += bucketsize;
+      }
+   }
+   heurdata->kernelsize = 0;
+   for( v = 0; v < nvars; v++ )
+      heurdata->kernelsize += inkernel[v];
+   SCIP_CALL( SCIPfree(&subscip) );
+
+   SCIPfreeBufferArray(scip, &inkernel);
+   SCIPfreeBufferArray(scip, &order);
+
+   return SCIP_OKAY;
+}
+
+/*
+ * Callback methods of primal heuristic
+ */
+
+/** copy method for primal heuristic plugins (called when SCIP copies plugins) */
+static
+SCIP_DECL_HEURCOPY(heurCopyKernelsearch)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+/** destructor of primal heuristic to free user data (called when SCIP is exiting) */
+static
+SCIP_DECL_HEURFREE(heurFreeKernelsearch)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->steps, heurdata->maxsteps);
+   SCIPfreeBlockMemory(scip, &heurdata);
+   SCIPheurSetData(heur, NULL);
+
+   return SCIP_OKAY;
+}
+
+
+/** initialization method of primal heuristic (called after problem was transformed) */
+static
+SCIP_DECL_HEURINIT(heurInitKernelsearch)
+{  /*lint --e{715}*/
+
+
+   return SCIP_OKAY;
+}
+
+
+/** deinitialization method of primal heuristic (called before transformed problem is freed) */
+static
+SCIP_DECL_HEUREXIT(heurExitKernelsearch)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process initialization method of primal heuristic (called when branch and bound process is about to begin) */
+static
+SCIP_DECL_HEURINITSOL(heurInitsolKernelsearch)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   heurdata->done = 0;
+   heurdata->nsols = 0;
+   heurdata->subtime = 0.0;
+   heurdata->kernelsize = 0;
+   // the progress of the previous solve is dropped (it is kept until SCIPfree() for the .out file)
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->steps, heurdata->maxsteps);
+   heurdata->nsteps = 0;
+   heurdata->maxsteps = heurdata->nbuckets + 1;
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->steps, heurdata->maxsteps) );
+   SCIP_CALL( SCIPcreateSol(scip, &heurdata->sol, heur) );
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process deinitialization method of primal heuristic (called before branch and bound process data is freed) */
+static
+SCIP_DECL_HEUREXITSOL(heurExitsolKernelsearch)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   if( heurdata->sol != NULL )
+   {
+      SCIP_CALL( SCIPfreeSol(scip, &heurdata->sol) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** execution method of primal heuristic */
+static
+SCIP_DECL_HEUREXEC(heurExecKernelsearch)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   int found;
+#ifdef DEBUG_KS
+   int s;
+#endif
+
+   assert(result != NULL);
+
+   *result = SCIP_DIDNOTRUN;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   /* once, with the LP solution of the root */
+   if( heurdata->done || SCIPgetLPSolstat(scip) != SCIP_LPSOLSTAT_OPTIMAL )
+      return SCIP_OKAY;
+   heurdata->done = 1;
+
+   *result = SCIP_DIDNOTFIND;
+   SCIP_CALL( kernelsearch(scip, heur, &found) );
+   if( found )
+      *result = SCIP_FOUNDSOL;
+
+#ifdef DEBUG_KS
+   printf("\nHeuristic %s: %d sub-MIPs (%.2lf s), %lld solutions stored, kernel with %d vars\n", HEUR_NAME,
+      heurdata->nsteps, heurdata->subtime, (long long) heurdata->nsols, heurdata->kernelsize);
+   for( s = 0; s < heurdata->nsteps; s++ )
+      printf("   step %d: %d vars, %.2lf s, %lld nodes, status %d, primal bound %.0lf\n", heurdata->steps[s].step,
+         heurdata->steps[s].nvars, heurdata->steps[s].time, (long long) heurdata->steps[s].nodes,
+         heurdata->steps[s].status, heurdata->steps[s].primalbound);
+#endif
+
+   return SCIP_OKAY;
+}
+
+
+/*
+ * primal heuristic specific interface methods
+ */
+
+/** creates the kernel search primal heuristic and includes it in SCIP */
+SCIP_RETCODE SCIPincludeHeurKernelsearch(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_HEURDATA* heurdata;
+   SCIP_HEUR* heur;
+
+   /* create kernel search primal heuristic data */
+   SCIP_CALL( SCIPallocBlockMemory(scip, &heurdata) );
+   heurdata->sol = NULL;
+   heurdata->steps = NULL;
+   heurdata->nsteps = 0;
+   heurdata->maxsteps = 0;
+   heurdata->done = 0;
+   heurdata->kernelsize = 0;
+   heurdata->nsols = 0;
+   heurdata->subtime = 0.0;
+
+   heur = NULL;
+
+   /* include primal heuristic */
+   SCIP_CALL( SCIPincludeHeurBasic(scip, &heur,
+         HEUR_NAME, HEUR_DESC, HEUR_DISPCHAR, HEUR_PRIORITY, HEUR_FREQ, HEUR_FREQOFS,
+         HEUR_MAXDEPTH, HEUR_TIMING, HEUR_USESSUBSCIP, heurExecKernelsearch, heurdata) );
+
+   assert(heur != NULL);
+
+   /* set non fundamental callbacks via setter functions */
+   SCIP_CALL( SCIPsetHeurCopy(scip, heur, heurCopyKernelsearch) );
+   SCIP_CALL( SCIPsetHeurFree(scip, heur, heurFreeKernelsearch) );
+   SCIP_CALL( SCIPsetHeurInit(scip, heur, heurInitKernelsearch) );
+   SCIP_CALL( SCIPsetHeurExit(scip, heur, heurExitKernelsearch) );
+   SCIP_CALL( SCIPsetHeurInitsol(scip, heur, heurInitsolKernelsearch) );
+   SCIP_CALL( SCIPsetHeurExitsol(scip, heur, heurExitsolKernelsearch) );
+
+   /* add kernel search primal heuristic parameters */
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/buckets",
+         "buckets of the vars out of the initial kernel (0: the kernel alone)",
+         &heurdata->nbuckets, FALSE, DEFAULT_BUCKETS, 0, INT_MAX - 1, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip, "heuristics/" HEUR_NAME "/maxtime",
+         "time limit (in sec) of a sub-MIP",
+         &heurdata->maxtime, FALSE, DEFAULT_MAXTIME, 0.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/nodes",
+         "node limit of a sub-MIP",
+         &heurdata->nodes, FALSE, DEFAULT_NODES, 1, INT_MAX, NULL, NULL) );
+
+   return SCIP_OKAY;
+}
+
+/** writes one line per sub-MIP solved by the kernel search (kernelsearch;step;vars;time;nodes;status;primal bound) */
+void SCIPkernelsearchPrintProgress(
+   SCIP*                 scip,               /**< SCIP data structure */
+   FILE*                 fout                /**< output file (the .out file of the instance) */
+   )
+{
+   SCIP_HEUR* heur;
+   SCIP_HEURDATA* heurdata;
+   int s;
+
+   heur = SCIPfindHeur(scip, HEUR_NAME);
+   if( heur == NULL || fout == NULL )
+      return;
+   heurdata = SCIPheurGetData(heur);
+   for( s = 0; heurdata != NULL && s < heurdata->nsteps; s++ )
+      fprintf(fout, "%s;%d;%d;%lf;%lld;%d;%lf\n", HEUR_NAME, heurdata->steps[s].step, heurdata->steps[s].nvars,
+         heurdata->steps[s].time, (long long) heurdata->steps[s].nodes, heurdata->steps[s].status,
+         heurdata->steps[s].primalbound);
+}
@@ -0,0 +1,53 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   heur_kernelsearch.h
+ * @ingroup PRIMALHEURISTICS
+ * @brief  kernel search primal heuristic
+ * @author Edna Hoshino (based on template provided by Tobias Achterberg)
+ *
+ * template file for primal heuristic plugins
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_HEUR_KERNELSEARCH_H__
+#define __SCIP_HEUR_KERNELSEARCH_H__
+
+
+#include "scip/scip.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  
+/** creates the kernel search primal heuristic and includes it in SCIP */
+
+SCIP_RETCODE SCIPincludeHeurKernelsearch(
+   SCIP*                 scip                /**< SCIP data structure */
+   );
+
+/** writes one line per sub-MIP solved by the kernel search (kernelsearch;step;vars;time;nodes;status;primal bound) */
+void SCIPkernelsearchPrintProgress(
+   SCIP*                 scip,               /**< SCIP data structure */
+   FILE*                 fout                /**< output file (the .out file of the instance) */
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,500 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   heur_lns.c
+ * @brief  LNS primal heuristic
+ * @author Edna Hoshino (based on template provided by Tobias Achterberg)
+ *
+ * Large neighbourhood search around the incumbent: k knapsacks are freed and the rest of the incumbent is fixed, so the
+ * sub-MIP only decides the items of the k knapsacks and the items out of the incumbent, in those k knapsacks. The
+ * sub-SCIP is created once per solve (SCIPprobdataCreate() on a copy of the instance) and each call only changes the
+ * bounds of its vars, with the incumbent value as objective limit and limits on nodes and time.
+ *
+ * The neighbourhood rotates from one call to the next:
+ *
+ *    0   k random knapsacks
+ *    1   the k most loaded knapsacks (load/capacity)
+ *    2   the k knapsacks where the LP solution of the node disagrees most with the incumbent (sum of |x_i_k - incumbent|);
+ *        random knapsacks if there is no LP solution
+ *
+ * k adapts to the solving time of the sub-MIP: it grows when the sub-MIP was solved to optimality in less than half of
+ * heuristics/lns/targettime and shrinks when it took longer than the target time.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <string.h>
+#include <limits.h>
+
+#include "scip/scipdefplugins.h"
+#include "probdata_mochila.h"
+#include "parameters_mochila.h"
+#include "heur_lns.h"
+#include "heur_problem.h"
+#include "vardata_mochila.h"
+#include "rng.h"
+
+//#define DEBUG_LNS 1
+/* configuracao da heuristica */
+#define HEUR_NAME             "lns"
+#define HEUR_DESC             "sub-MIP on k free knapsacks, the rest of the incumbent fixed"
+#define HEUR_DISPCHAR         'L'
+#define HEUR_PRIORITY         -1 /* depois das heuristicas de construcao, que dao o incumbente */
+#define HEUR_FREQOFS          0 /* comecando do nivel 0 */
+#define HEUR_MAXDEPTH         -1 /* nivel max para chamar a heuristica. -1 = sem limites */
+#define HEUR_TIMING           SCIP_HEURTIMING_AFTERNODE
+#define HEUR_USESSUBSCIP      TRUE   /**< does the heuristic use a secondary SCIP instance? */
+
+#define DEFAULT_TARGETTIME    1.0    /**< target solving time (in sec) of a sub-MIP */
+#define DEFAULT_NODES         500    /**< node limit of a sub-MIP */
+#define DEFAULT_MINFREE       2      /**< initial number of free knapsacks */
+#define LNS_NEIGHBORHOODS     3      /**< random, most loaded, LP disagreement */
+#define RNG_STREAM            (~0ULL - 1) /**< stream of the seed of the random neighbourhoods */
+
+/*
+ * Data structures
+ */
+
+/** primal heuristic data: the sub-SCIP and the buffers live for the whole solve */
+struct SCIP_HeurData
+{
+   SCIP_SOL*             sol;                /**< working solution, cleared and reused by every call */
+   SCIP*                 subscip;            /**< sub-SCIP with the same model */
+   SCIP_VAR**            subvars;            /**< original vars of the sub-SCIP: subvars[i*m+k] = x_i_k */
+   int*                  incumbent;          /**< knapsack of each item in the incumbent (-1: not packed) */
+   SCIP_Real*            score;              /**< score of each knapsack in the neighbourhood */
+   int*                  freeknap;           /**< freeknap[k] = 1 if the knapsack k is free in the sub-MIP */
+   rngT                  rng;                /**< random neighbourhoods */
+   int                   nitems;             /**< size of incumbent */
+   int                   nknaps;             /**< size of score and freeknap */
+   int                   k;                  /**< current number of free knapsacks */
+   SCIP_Real             targettime;         /**< target solving time (in sec) of a sub-MIP */
+   int                   nodes;              /**< node limit of a sub-MIP */
+   SCIP_Longint          ncalls;             /**< number of calls */
+   SCIP_Longint          nsols;              /**< number of solutions stored */
+   SCIP_Longint          nbhcalls[LNS_NEIGHBORHOODS]; /**< sub-MIPs of each neighbourhood */
+   SCIP_Longint          nbhsols[LNS_NEIGHBORHOODS];  /**< improving solutions of each neighbourhood */
+   SCIP_Real             subtime;            /**< time spent in the sub-MIPs */
+};
+
+/*
+ * Local methods
+ */
+
+/** frees the k knapsacks of largest score (ties to the lowest index) */
+static
+void selectKnapsacks(SCIP_HEURDATA* heurdata, int m, int k)
+{
+   int j, l, best;
+
+   memset(heurdata->freeknap, 0, m*sizeof(int));
+   for( l = 0; l < k && l < m; l++ )
+   {
+      best = -1;
+      for( j = 0; j < m; j++ )
+         if( !heurdata->freeknap[j] && (best < 0 || heurdata->score[j] > heurdata->score[best]) )
+            best = j;
+      heurdata->freeknap[best] = 1;
+   }
+}
+
+/** scores of the knapsacks in the neighbourhood nbh; returns the neighbourhood used (2 falls back to 0 without LP) */
+static
+int scoreKnapsacks(SCIP* scip, SCIP_HEURDATA* heurdata, SCIP_PROBDATA* probdata, int nbh)
+{
+   instanceT* I;
+   itemArraysT* items;
+   SCIP_Real solval;
+   int i, j;
+
+   I = SCIPprobdataGetInstance(probdata);
+   items = SCIPprobdataGetItems(probdata);
+   if( nbh == 2 && SCIPgetLPSolstat(scip) != SCIP_LPSOLSTAT_OPTIMAL )
+      nbh = 0;
+   for( j = 0; j < I->m; j++ )
+      heurdata->score[j] = nbh == 0 ? rngDouble(&heurdata->rng) : 0.0;
+   if( nbh == 1 )
+   {
+      for( i = 0; i < I->n; i++ )
+         if( heurdata->incumbent[i] >= 0 )
+            heurdata->score[heurdata->incumbent[i]] += items->weight[i];
+      for( j = 0; j < I->m; j++ )
+         heurdata->score[j] /= I->C[j] > 0 ? I->C[j] : 1;
+   }
+   else if( nbh == 2 )
+   {
+      for( i = 0; i < I->n; i++ )
+      {
+         for( j = 0; j < I->m; j++ )
+         {
+            solval = SCIPgetVarSol(scip, SCIPprobdataGetVar(probdata, i, j));
+            heurdata->score[j] += heurdata->incumbent[i] == j ? 1.0 - solval : solval;
+         }
+      }
+   }
+   return nbh;
+}
+
+/** creates the sub-SCIP with the model of a copy of the instance */
+static
+SCIP_RETCODE createSubscip(SCIP* scip, SCIP_HEURDATA* heurdata, instanceT* I)
+{
+   instanceT* copy;
+
+   copyInstance(&copy, I);
+   if( copy == NULL )
+      return SCIP_NOMEMORY;
+   SCIP_CALL( SCIPcreate(&heurdata->subscip) );
+   SCIP_CALL( SCIPincludeDefaultPlugins(heurdata->subscip) );
+   SCIP_CALL( SCIPsetIntParam(heurdata->subscip, "display/verblevel", 0) );
+   SCIP_CALL( SCIPsetBoolParam(heurdata->subscip, "misc/catchctrlc", FALSE) );
+   // the sub-SCIP owns the copy (it is freed with its problem)
+   SCIP_CALL( SCIPprobdataCreate(heurdata->subscip, "lns", copy, FALSE, param.model_cons ? TRUE : FALSE,
+         FORMULATION_ASSIGNMENT) );
+   // the value of the items fixed out of the model (core mode), so the objectives of both SCIPs compare
+   SCIP_CALL( SCIPaddOrigObjoffset(heurdata->subscip, SCIPgetOrigObjoffset(scip)) );
+   heurdata->subvars = SCIPprobdataGetVars(SCIPgetProbData(heurdata->subscip));
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Core of the LNS heuristic: one sub-MIP in the neighbourhood of the incumbent.
+ *
+ * @param scip problem
+ * @param heur pointer to the LNS heuristic handle (to contabilize statistics)
+ * @param found set to 1 if a solution is stored
+ */
+static
+SCIP_RETCODE lns(SCIP* scip, SCIP_HEUR* heur, int* found)
+{
+   SCIP_PROBDATA* probdata;
+   SCIP_HEURDATA* heurdata;
+   SCIP* subscip;
+   SCIP_SOL *bestsol, *subsol;
+   SCIP_VAR *var, *subvar;
+   SCIP_Real incvalue, limit, timelimit, memorylimit, lb, ub, time;
+   SCIP_RETCODE retcode;
+   unsigned int stored;
+   instanceT* I;
+   int i, j, m, nbh;
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+   subscip = heurdata->subscip;
+   I = SCIPprobdataGetInstance(probdata);
+   m = I->m;
+   *found = 0;
+
+   bestsol = SCIPgetBestSol(scip);
+   if( bestsol == NULL )
+      return SCIP_OKAY;
+   incvalue = SCIPgetSolOrigObj(scip, bestsol);
+
+   // the budget of the call, within the time limit of SCIP
+   timelimit = 2.0 * heurdata->targettime;
+   SCIP_CALL( SCIPgetRealParam(scip, "limits/time", &limit) );
+   if( !SCIPisInfinity(scip, limit) && limit - SCIPgetSolvingTime(scip) < timelimit )
+      timelimit = limit - SCIPgetSolvingTime(scip);
+   if( timelimit <= 0.0 )
+      return SCIP_OKAY;
+   // the memory left by the main run; skip the call if it is too little for the sub-MIP
+   SCIP_CALL( SCIPgetSubscipMemlimitMine(scip, &memorylimit) );
+   if( memorylimit <= 2.0*SCIPgetMemExternEstim(scip)/1048576.0 )
+      return SCIP_OKAY;
+
+   heurdata->ncalls++;
+   for( i = 0; i < I->n; i++ )
+   {
+      heurdata->incumbent[i] = -1;
+      for( j = 0; j < m; j++ )
+         if( SCIPgetSolVal(scip, bestsol, SCIPprobdataGetVar(probdata, i, j)) > 0.5 )
+            heurdata->incumbent[i] = j;
+   }
+   nbh = scoreKnapsacks(scip, heurdata, probdata, (int) ((heurdata->ncalls - 1) % LNS_NEIGHBORHOODS));
+   selectKnapsacks(heurdata, m, heurdata->k);
+   heurdata->nbhcalls[nbh]++;
+
+   // bounds of the sub-MIP: the items of the fixed knapsacks stay there, the others may go to the free knapsacks
+   SCIP_CALL( SCIPfreeTransform(subscip) );
+   for( i = 0; i < I->n; i++ )
+   {
+      for( j = 0; j < m; j++ )
+      {
+         var = SCIPprobdataGetVar(probdata, i, j);
+         subvar = heurdata->subvars[i*m + j];
+         if( heurdata->incumbent[i] >= 0 && !heurdata->freeknap[heurdata->incumbent[i]] )
+            lb = ub = heurdata->incumbent[i] == j ? 1.0 : 0.0;
+         else
+         {
+            lb = 0.0;
+            ub = heurdata->freeknap[j] ? 1.0 : 0.0;
+         }
+         ub = MIN(ub, SCIPvarGetUbGlobal(var));
+         lb = MIN(MAX(lb, SCIPvarGetLbGlobal(var)), ub);
+         SCIP_CALL( SCIPchgVarLb(subscip, subvar, 0.0) );
+         SCIP_CALL( SCIPchgVarUb(subscip, subvar, ub) );
+         SCIP_CALL( SCIPchgVarLb(subscip, subvar, lb) );
+      }
+   }
+   // only solutions better than the incumbent (the objective is integral)
+   SCIP_CALL( SCIPsetObjlimit(subscip, incvalue + 0.5) );
+   SCIP_CALL( SCIPsetRealParam(subscip, "limits/time", timelimit) );
+   SCIP_CALL( SCIPsetLongintParam(subscip, "limits/nodes", (SCIP_Longint) heurdata->nodes) );
+   SCIP_CALL( SCIPsetRealParam(subscip, "limits/memory", memorylimit) );
+
+   // an error in the sub-MIP does not stop the main run, but it is reported
+   retcode = SCIPsolve(subscip);
+   if( retcode != SCIP_OKAY )
+   {
+      SCIPwarningMessage(scip, "LNS: error while solving the sub-MIP, retcode <%d>\n", (int) retcode);
+      return SCIP_OKAY;
+   }
+   time = SCIPgetSolvingTime(subscip);
+   heurdata->subtime += time;
+#ifdef DEBUG_LNS
+   printf("\nLNS neighbourhood %d, k = %d: %lld nodes, %.2lf s, status %d, %d solutions\n", nbh, heurdata->k,
+      (long long) SCIPgetNNodes(subscip), time, (int) SCIPgetStatus(subscip), SCIPgetNSols(subscip));
+#endif
+
+   // adaptive k: about targettime per sub-MIP
+   if( SCIPgetStatus(subscip) == SCIP_STATUS_OPTIMAL && time < 0.5 * heurdata->targettime && heurdata->k < m )
+      heurdata->k++;
+   else if( time > heurdata->targettime && heurdata->k > 1 )
+      heurdata->k--;
+
+   if( SCIPgetNSols(subscip) > 0 )
+   {
+      subsol = SCIPgetBestSol(subscip);
+      if( SCIPgetSolOrigObj(subscip, subsol) > SCIPgetPrimalbound(scip) + EPSILON )
+      {
+         SCIP_CALL( SCIPclearSol(scip, heurdata->sol) );
+         for( i = 0; i < I->n; i++ )
+         {
+            for( j = 0; j < m; j++ )
+            {
+               if( SCIPgetSolVal(subscip, subsol, heurdata->subvars[i*m + j]) > 0.5 )
+               {
+                  SCIP_CALL( SCIPsetSolVal(scip, heurdata->sol, SCIPprobdataGetVar(probdata, i, j), 1.0) );
+               }
+            }
+         }
+         SCIP_CALL( SCIPtrySolMine(scip, heurdata->sol, FALSE, TRUE, FALSE, TRUE, &stored) );
+         if( stored )
+         {
+            heurdata->nsols++;
+            heurdata->nbhsols[nbh]++;
+            *found = 1;
+         }
+      }
+   }
+
+   return SCIP_OKAY;
+}
+
+/*
+ * Callback methods of primal heuristic
+ */
+
+/** copy method for primal heuristic plugins (called when SCIP copies plugins) */
+static
+SCIP_DECL_HEURCOPY(heurCopyLns)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+/** destructor of primal heuristic to free user data (called when SCIP is exiting) */
+static
+SCIP_DECL_HEURFREE(heurFreeLns)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   SCIPfreeBlockMemory(scip, &heurdata);
+   SCIPheurSetData(heur, NULL);
+
+   return SCIP_OKAY;
+}
+
+
+/** initialization method of primal heuristic (called after problem was transformed) */
+static
+SCIP_DECL_HEURINIT(heurInitLns)
+{  /*lint --e{715}*/
+
+
+   return SCIP_OKAY;
+}
+
+
+/** deinitialization method of primal heuristic (called before transformed problem is freed) */
+static
+SCIP_DECL_HEUREXIT(heurExitLns)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process initialization method of primal heuristic (called when branch and bound process is about to begin) */
+static
+SCIP_DECL_HEURINITSOL(heurInitsolLns)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   instanceT* I;
+   int nbh;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   I = SCIPprobdataGetInstance(SCIPgetProbData(scip));
+   heurdata->nitems = I->n;
+   heurdata->nknaps = I->m;
+   heurdata->k = MIN(DEFAULT_MINFREE, I->m);
+   heurdata->ncalls = 0;
+   heurdata->nsols = 0;
+   heurdata->subtime = 0.0;
+   for( nbh = 0; nbh < LNS_NEIGHBORHOODS; nbh++ )
+      heurdata->nbhcalls[nbh] = heurdata->nbhsols[nbh] = 0;
+   rngInit(&heurdata->rng, (unsigned long long) param.seed, RNG_STREAM);
+   SCIP_CALL( SCIPcreateSol(scip, &heurdata->sol, heur) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->incumbent, I->n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->score, I->m) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->freeknap, I->m) );
+   SCIP_CALL( createSubscip(scip, heurdata, I) );
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process deinitialization method of primal heuristic (called before branch and bound process data is freed) */
+static
+SCIP_DECL_HEUREXITSOL(heurExitsolLns)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+#ifdef DEBUG_LNS
+   printf("\nHeuristic %s: %lld sub-MIPs (%.2lf s), %lld solutions stored, k = %d; random %lld/%lld, loaded %lld/%lld, "
+      "LP %lld/%lld (solutions/sub-MIPs)\n", HEUR_NAME, (long long) heurdata->ncalls, heurdata->subtime,
+      (long long) heurdata->nsols, heurdata->k, (long long) heurdata->nbhsols[0], (long long) heurdata->nbhcalls[0],
+      (long long) heurdata->nbhsols[1], (long long) heurdata->nbhcalls[1], (long long) heurdata->nbhsols[2],
+      (long long) heurdata->nbhcalls[2]);
+#endif
+   if( heurdata->subscip != NULL )
+   {
+      SCIP_CALL( SCIPfree(&heurdata->subscip) );
+   }
+   heurdata->subvars = NULL;
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->freeknap, heurdata->nknaps);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->score, heurdata->nknaps);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->incumbent, heurdata->nitems);
+   if( heurdata->sol != NULL )
+   {
+      SCIP_CALL( SCIPfreeSol(scip, &heurdata->sol) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** execution method of primal heuristic */
+static
+SCIP_DECL_HEUREXEC(heurExecLns)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   int found;
+
+   assert(result != NULL);
+
+   *result = SCIP_DIDNOTRUN;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   /* an incumbent is needed */
+   if( heurdata->subscip == NULL || SCIPgetNSols(scip) == 0 )
+      return SCIP_OKAY;
+
+   *result = SCIP_DIDNOTFIND;
+   SCIP_CALL( lns(scip, heur, &found) );
+   if( found )
+      *result = SCIP_FOUNDSOL;
+
+   return SCIP_OKAY;
+}
+
+
+/*
+ * primal heuristic specific interface methods
+ */
+
+/** creates the LNS primal heuristic and includes it in SCIP */
+SCIP_RETCODE SCIPincludeHeurLns(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_HEURDATA* heurdata;
+   SCIP_HEUR* heur;
+
+   /* create LNS primal heuristic data */
+   SCIP_CALL( SCIPallocBlockMemory(scip, &heurdata) );
+   heurdata->sol = NULL;
+   heurdata->subscip = NULL;
+   heurdata->subvars = NULL;
+   heurdata->incumbent = NULL;
+   heurdata->score = NULL;
+   heurdata->freeknap = NULL;
+   heurdata->nitems = 0;
+   heurdata->nknaps = 0;
+   heurdata->k = DEFAULT_MINFREE;
+   heurdata->ncalls = 0;
+   heurdata->nsols = 0;
+   heurdata->subtime = 0.0;
+
+   heur = NULL;
+
+   /* include primal heuristic */
+   SCIP_CALL( SCIPincludeHeurBasic(scip, &heur,
+         HEUR_NAME, HEUR_DESC, HEUR_DISPCHAR, HEUR_PRIORITY, param.lns_freq, HEUR_FREQOFS,
+         HEUR_MAXDEPTH, HEUR_TIMING, HEUR_USESSUBSCIP, heurExecLns, heurdata) );
+
+   assert(heur != NULL);
+
+   /* set non fundamental callbacks via setter functions */
+   SCIP_CALL( SCIPsetHeurCopy(scip, heur, heurCopyLns) );
+   SCIP_CALL( SCIPsetHeurFree(scip, heur, heurFreeLns) );
+   SCIP_CALL( SCIPsetHeurInit(scip, heur, heurInitLns) );
+   SCIP_CALL( SCIPsetHeurExit(scip, heur, heurExitLns) );
+   SCIP_CALL( SCIPsetHeurInitsol(scip, heur, heurInitsolLns) );
+   SCIP_CALL( SCIPsetHeurExitsol(scip, heur, heurExitsolLns) );
+
+   /* add LNS primal heuristic parameters */
+   SCIP_CALL( SCIPaddRealParam(scip, "heuristics/" HEUR_NAME "/targettime",
+         "target solving time (in sec) of a sub-MIP: the number of free knapsacks adapts to it",
+         &heurdata->targettime, FALSE, DEFAULT_TARGETTIME, 0.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/nodes",
+         "node limit of a sub-MIP",
+         &heurdata->nodes, FALSE, DEFAULT_NODES, 1, INT_MAX, NULL, NULL) );
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,518 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   heur_mydiving.c
+ * @brief  diving primal heuristic
+ * @author Edna Hoshino (based on template provided by Tobias Achterberg)
+ *
+ * Fractional diving in probing mode: at each step the fractional x_i_k of largest score is fixed to 1.0 and the LP is
+ * solved again, until the LP solution is integral, the LP is infeasible or a quota is reached. The score is the LP value
+ * (heuristics/mydiving/score = 0) or the LP value times the efficiency value/weight of the item (score = 1); a var whose
+ * item does not fit the residual capacity of its knapsack (capacity minus the items fixed in it) is skipped. When a
+ * fixing makes the LP infeasible (or cut off), the dive backtracks once and fixes that var to 0.0 instead. If the dive
+ * stops at a fractional LP solution, that solution is rounded (rounding.c).
+ *
+ * The quotas: at most heuristics/mydiving/maxdivedepth fixings per dive, and the LP iterations of all the dives at most
+ * maxlpiterquot times the LP iterations of the B&B nodes plus maxlpiterofs.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <string.h>
+#include <limits.h>
+
+#include "probdata_mochila.h"
+#include "parameters_mochila.h"
+#include "heur_mydiving.h"
+#include "heur_problem.h"
+#include "vardata_mochila.h"
+#include "rounding.h"
+
+//#define DEBUG_DIVING 1
+/* configuracao da heuristica */
+#define HEUR_NAME             "mydiving"
+#define HEUR_DESC             "fractional diving with knapsack-aware var selection"
+#define HEUR_DISPCHAR         'd'
+#define HEUR_PRIORITY         2 /* depois do rounding (o diving e mais caro) */
+#define HEUR_FREQ             1 /* a cada 1 nivel da arvore de B&B */
+#define HEUR_FREQOFS          0 /* comecando do nivel 0 */
+#define HEUR_MAXDEPTH         -1 /* nivel max para chamar a heuristica. -1 = sem limites */
+#define HEUR_TIMING           SCIP_HEURTIMING_AFTERLPNODE /* chamado depois que o LP do no for resolvido */
+#define HEUR_USESSUBSCIP      FALSE  /**< does the heuristic use a secondary SCIP instance? */
+
+#define DEFAULT_MAXDIVEDEPTH  -1     /**< maximum number of fixings per dive (-1: no limit) */
+#define DEFAULT_MAXLPITERQUOT 0.05   /**< maximal fraction of the LP iterations of the B&B spent in the dives */
+#define DEFAULT_MAXLPITEROFS  1000   /**< additional number of LP iterations allowed */
+#define DEFAULT_SCORE         0      /**< 0: LP value, 1: LP value times value/weight of the item */
+#define MINLPITER             100    /**< LP iteration limit of each probing LP when the quota is almost reached */
+
+/*
+ * Data structures
+ */
+
+/** primal heuristic data: scratch buffers sized once per solve, so a call does no heap allocation */
+struct SCIP_HeurData
+{
+   SCIP_SOL*             sol;                /**< working solution, cleared and reused by every call */
+   SCIP_VAR**            varlist;            /**< vars split by their LP value (see getLPsolution()) */
+   int*                  residual;           /**< capacity of each knapsack minus the weight of the items fixed in it */
+   int*                  placed;             /**< placed[i] = 1 if item i is fixed in some knapsack */
+   roundingT*            R;                  /**< rounding of the last LP solution of a dive */
+   int                   nvars;              /**< size of varlist */
+   int                   nitems;             /**< size of placed */
+   int                   nknaps;             /**< size of residual */
+   int                   maxdivedepth;       /**< maximum number of fixings per dive (-1: no limit) */
+   SCIP_Real             maxlpiterquot;      /**< maximal fraction of the LP iterations of the B&B spent in the dives */
+   int                   maxlpiterofs;       /**< additional number of LP iterations allowed */
+   int                   score;              /**< 0: LP value, 1: LP value times value/weight of the item */
+   SCIP_Longint          ncalls;             /**< number of calls */
+   SCIP_Longint          nsols;              /**< number of solutions stored */
+   SCIP_Longint          nlpiterations;      /**< LP iterations of the dives */
+   SCIP_Longint          nfixings;           /**< vars fixed to 1.0 by the dives */
+   SCIP_Longint          nbacktracks;        /**< dives that backtracked */
+};
+
+/*
+ * Local methods
+ */
+
+/** residual capacities and items fixed at the current (probing) node */
+static
+void computeResidual(SCIP* scip, SCIP_HEURDATA* heurdata, SCIP_PROBDATA* probdata)
+{
+   instanceT* I;
+   itemArraysT* items;
+   int i, k;
+
+   I = SCIPprobdataGetInstance(probdata);
+   items = SCIPprobdataGetItems(probdata);
+   memcpy(heurdata->residual, I->C, I->m*sizeof(int));
+   for( i = 0; i < I->n; i++ )
+   {
+      heurdata->placed[i] = 0;
+      for( k = 0; k < I->m; k++ )
+      {
+         if( SCIPvarGetLbLocal(SCIPprobdataGetVar(probdata, i, k)) > 1.0 - EPSILON )
+         {
+            heurdata->placed[i] = 1;
+            heurdata->residual[k] -= items->weight[i];
+         }
+      }
+   }
+}
+
+/** the fractional var of largest score whose item is free and fits its knapsack; NULL if none */
+static
+SCIP_VAR* selectVar(SCIP* scip, SCIP_HEURDATA* heurdata, itemArraysT* items, SCIP_VAR** lpcands, SCIP_Real* lpcandssol,
+   int nlpcands)
+{
+   SCIP_VAR *var, *best;
+   SCIP_Real score, bestscore;
+   int c, i, k;
+
+   best = NULL;
+   bestscore = -1.0;
+   for( c = 0; c < nlpcands; c++ )
+   {
+      var = lpcands[c];
+      i = varGetItem(var);
+      k = varGetKnapsack(var);
+      if( heurdata->placed[i] || items->weight[i] > heurdata->residual[k] )
+         continue;
+      score = lpcandssol[c];
+      if( heurdata->score == 1 )
+         score *= items->value[i] / (SCIP_Real) (items->weight[i] > 0 ? items->weight[i] : 1);
+      if( score > bestscore || (score == bestscore && items->value[i] > items->value[varGetItem(best)]) )
+      {
+         best = var;
+         bestscore = score;
+      }
+   }
+   return best;
+}
+
+/** solves the probing LP within the iteration quota and accounts its iterations */
+static
+SCIP_RETCODE solveDiveLP(SCIP* scip, SCIP_HEURDATA* heurdata, SCIP_Longint maxnlpiterations, SCIP_Bool* lperror,
+   SCIP_Bool* cutoff)
+{
+   SCIP_Longint nlpiterations;
+   int itlim;
+
+   nlpiterations = SCIPgetNLPIterations(scip);
+   itlim = (int) MIN(maxnlpiterations - heurdata->nlpiterations, INT_MAX);
+   SCIP_CALL( SCIPsolveProbingLP(scip, MAX(itlim, MINLPITER), lperror, cutoff) );
+   heurdata->nlpiterations += SCIPgetNLPIterations(scip) - nlpiterations;
+   if( !*lperror && !*cutoff && SCIPgetLPSolstat(scip) != SCIP_LPSOLSTAT_OPTIMAL )
+      *cutoff = SCIPgetLPSolstat(scip) == SCIP_LPSOLSTAT_INFEASIBLE;
+
+   return SCIP_OKAY;
+}
+
+/** submits heurdata->sol; found is set to 1 if it was stored */
+static
+SCIP_RETCODE submitSolution(SCIP* scip, SCIP_HEURDATA* heurdata, int* found)
+{
+   unsigned int stored;
+
+   SCIP_CALL( SCIPtrySolMine(scip, heurdata->sol, FALSE, TRUE, FALSE, TRUE, &stored) );
+   if( stored )
+   {
+      heurdata->nsols++;
+      *found = 1;
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Core of the diving heuristic: one dive from the LP solution of the current node.
+ *
+ * @param scip problem
+ * @param heur pointer to the diving heuristic handle (to contabilize statistics)
+ * @param maxnlpiterations LP iterations allowed to all the dives (including this one)
+ * @param found set to 1 if a solution is stored
+ */
+static
+SCIP_RETCODE dive(SCIP* scip, SCIP_HEUR* heur, SCIP_Longint maxnlpiterations, int* found)
+{
+   SCIP_PROBDATA* probdata;
+   SCIP_HEURDATA* heurdata;
+   itemArraysT* items;
+   roundingT* R;
+   SCIP_VAR **lpcands, *var;
+   SCIP_Real* lpcandssol;
+   SCIP_Bool lperror, cutoff, backtracked;
+   int nlpcands, divedepth, i, k, n1, nfrac, n0;
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+   items = SCIPprobdataGetItems(probdata);
+   *found = 0;
+
+   computeResidual(scip, heurdata, probdata);
+   SCIP_CALL( SCIPgetLPBranchCands(scip, &lpcands, &lpcandssol, NULL, &nlpcands, NULL, NULL) );
+
+   SCIP_CALL( SCIPstartProbing(scip) );
+   lperror = FALSE;
+   cutoff = FALSE;
+   backtracked = FALSE;
+   divedepth = 0;
+   while( !lperror && !cutoff && nlpcands > 0 && (heurdata->maxdivedepth < 0 || divedepth < heurdata->maxdivedepth)
+      && heurdata->nlpiterations < maxnlpiterations )
+   {
+      var = selectVar(scip, heurdata, items, lpcands, lpcandssol, nlpcands);
+      if( var == NULL )
+         break;
+      i = varGetItem(var);
+      k = varGetKnapsack(var);
+      divedepth++;
+      heurdata->nfixings++;
+#ifdef DEBUG_DIVING
+      printf("\nDepth %d: %s (LP %lf) = 1, residual %d\n", divedepth, SCIPvarGetName(var), SCIPgetVarSol(scip, var),
+         heurdata->residual[k] - items->weight[i]);
+#endif
+      SCIP_CALL( SCIPnewProbingNode(scip) );
+      SCIP_CALL( SCIPfixVarProbing(scip, var, 1.0) );
+      heurdata->placed[i] = 1;
+      heurdata->residual[k] -= items->weight[i];
+      SCIP_CALL( SCIPpropagateProbing(scip, -1, &cutoff, NULL) );
+      if( !cutoff )
+      {
+         SCIP_CALL( solveDiveLP(scip, heurdata, maxnlpiterations, &lperror, &cutoff) );
+      }
+      // one backtrack per dive: the var goes to 0.0 instead
+      if( cutoff && !lperror && !backtracked )
+      {
+         backtracked = TRUE;
+         heurdata->nbacktracks++;
+         SCIP_CALL( SCIPbacktrackProbing(scip, SCIPgetProbingDepth(scip) - 1) );
+         heurdata->placed[i] = 0;
+         heurdata->residual[k] += items->weight[i];
+         SCIP_CALL( SCIPnewProbingNode(scip) );
+         SCIP_CALL( SCIPchgVarUbProbing(scip, var, 0.0) );
+         cutoff = FALSE;
+         SCIP_CALL( SCIPpropagateProbing(scip, -1, &cutoff, NULL) );
+         if( !cutoff )
+         {
+            SCIP_CALL( solveDiveLP(scip, heurdata, maxnlpiterations, &lperror, &cutoff) );
+         }
+      }
+      if( lperror || cutoff || SCIPgetLPSolstat(scip) != SCIP_LPSOLSTAT_OPTIMAL )
+         break;
+      SCIP_CALL( SCIPgetLPBranchCands(scip, &lpcands, &lpcandssol, NULL, &nlpcands, NULL, NULL) );
+   }
+
+   if( !lperror && !cutoff && SCIPgetLPSolstat(scip) == SCIP_LPSOLSTAT_OPTIMAL )
+   {
+      if( nlpcands == 0 )
+      {
+         // integral LP solution
+         SCIP_CALL( SCIPlinkLPSol(scip, heurdata->sol) );
+         if( SCIPgetSolOrigObj(scip, heurdata->sol) > SCIPgetPrimalbound(scip) + EPSILON )
+            SCIP_CALL( submitSolution(scip, heurdata, found) );
+      }
+      else if( getLPsolution(scip, heurdata->varlist, &n1, &nfrac, &n0, NULL) )
+      {
+         // rounding of the last LP solution of the dive
+         R = heurdata->R;
+         roundingReset(R);
+         for( i = 0; i < n1; i++ )
+            roundingFix(R, varGetItem(heurdata->varlist[i]), varGetKnapsack(heurdata->varlist[i]));
+         for( i = 0; i < nfrac; i++ )
+         {
+            var = heurdata->varlist[n1+i];
+            roundingAddCand(R, varGetItem(var), varGetKnapsack(var), SCIPgetVarSol(scip, var));
+         }
+         roundingRun(R);
+         if( !R->infeasible && R->value > SCIPgetPrimalboundMine(scip) + EPSILON )
+         {
+            SCIP_CALL( SCIPclearSol(scip, heurdata->sol) );
+            for( i = 0; i < R->n; i++ )
+            {
+               if( R->assign[i] >= 0 )
+               {
+                  SCIP_CALL( SCIPsetSolVal(scip, heurdata->sol, SCIPprobdataGetVar(probdata, i, R->assign[i]), 1.0) );
+               }
+            }
+            SCIP_CALL( submitSolution(scip, heurdata, found) );
+         }
+      }
+   }
+#ifdef DEBUG_DIVING
+   printf("\nDive: depth %d, backtracked %d, lperror %d, cutoff %d, found %d\n", divedepth, backtracked, lperror, cutoff,
+      *found);
+#endif
+   SCIP_CALL( SCIPendProbing(scip) );
+
+   return SCIP_OKAY;
+}
+
+/*
+ * Callback methods of primal heuristic
+ */
+
+/** copy method for primal heuristic plugins (called when SCIP copies plugins) */
+static
+SCIP_DECL_HEURCOPY(heurCopyMyDiving)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+/** destructor of primal heuristic to free user data (called when SCIP is exiting) */
+static
+SCIP_DECL_HEURFREE(heurFreeMyDiving)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   SCIPfreeBlockMemory(scip, &heurdata);
+   SCIPheurSetData(heur, NULL);
+
+   return SCIP_OKAY;
+}
+
+
+/** initialization method of primal heuristic (called after problem was transformed) */
+static
+SCIP_DECL_HEURINIT(heurInitMyDiving)
+{  /*lint --e{715}*/
+
+
+   return SCIP_OKAY;
+}
+
+
+/** deinitialization method of primal heuristic (called before transformed problem is freed) */
+static
+SCIP_DECL_HEUREXIT(heurExitMyDiving)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process initialization method of primal heuristic (called when branch and bound process is about to begin) */
+static
+SCIP_DECL_HEURINITSOL(heurInitsolMyDiving)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   SCIP_PROBDATA* probdata;
+   instanceT* I;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   probdata = SCIPgetProbData(scip);
+   I = SCIPprobdataGetInstance(probdata);
+   heurdata->nvars = SCIPprobdataGetNVars(probdata);
+   heurdata->nitems = I->n;
+   heurdata->nknaps = I->m;
+   heurdata->ncalls = 0;
+   heurdata->nsols = 0;
+   heurdata->nlpiterations = 0;
+   heurdata->nfixings = 0;
+   heurdata->nbacktracks = 0;
+   SCIP_CALL( SCIPcreateSol(scip, &heurdata->sol, heur) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->varlist, heurdata->nvars) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->residual, I->m) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->placed, I->n) );
+   heurdata->R = createRounding(I, SCIPprobdataGetItems(probdata), heurdata->nvars);
+   if( heurdata->R == NULL )
+      return SCIP_NOMEMORY;
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process deinitialization method of primal heuristic (called before branch and bound process data is freed) */
+static
+SCIP_DECL_HEUREXITSOL(heurExitsolMyDiving)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+#ifdef DEBUG_DIVING
+   printf("\nHeuristic %s: %lld calls, %lld fixings, %lld backtracks, %lld LP iterations, %lld solutions stored\n",
+      HEUR_NAME, (long long) heurdata->ncalls, (long long) heurdata->nfixings, (long long) heurdata->nbacktracks,
+      (long long) heurdata->nlpiterations, (long long) heurdata->nsols);
+#endif
+   freeRounding(heurdata->R);
+   heurdata->R = NULL;
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->placed, heurdata->nitems);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->residual, heurdata->nknaps);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->varlist, heurdata->nvars);
+   if( heurdata->sol != NULL )
+   {
+      SCIP_CALL( SCIPfreeSol(scip, &heurdata->sol) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** execution method of primal heuristic */
+static
+SCIP_DECL_HEUREXEC(heurExecMyDiving)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   SCIP_Longint maxnlpiterations;
+   int nlpcands, found;
+
+   assert(result != NULL);
+
+   *result = SCIP_DIDNOTRUN;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   /* continue only if the LP is finished */
+   if ( SCIPgetLPSolstat(scip) != SCIP_LPSOLSTAT_OPTIMAL || SCIPinProbing(scip) )
+      return SCIP_OKAY;
+
+   /* continue only of the LP value is less than the cutoff bound */
+   if( SCIPisGE(scip, SCIPgetLPObjval(scip), SCIPgetCutoffbound(scip)) )
+      return SCIP_OKAY;
+
+   /* check if there exists integer variables with fractionary values in the LP */
+   SCIP_CALL( SCIPgetLPBranchCands(scip, NULL, NULL, NULL, &nlpcands, NULL, NULL) );
+
+   /* stop if the LP solution is already integer   */
+   if ( nlpcands == 0 )
+     return SCIP_OKAY;
+
+   /* LP iteration quota of the dives */
+   maxnlpiterations = (SCIP_Longint) (heurdata->maxlpiterquot * SCIPgetNNodeLPIterations(scip)) + heurdata->maxlpiterofs;
+   if( heurdata->nlpiterations >= maxnlpiterations )
+      return SCIP_OKAY;
+
+   heurdata->ncalls++;
+   *result = SCIP_DIDNOTFIND;
+   SCIP_CALL( dive(scip, heur, maxnlpiterations, &found) );
+   if( found )
+      *result = SCIP_FOUNDSOL;
+
+   return SCIP_OKAY;
+}
+
+
+/*
+ * primal heuristic specific interface methods
+ */
+
+/** creates the diving primal heuristic and includes it in SCIP */
+SCIP_RETCODE SCIPincludeHeurMyDiving(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_HEURDATA* heurdata;
+   SCIP_HEUR* heur;
+
+   /* create diving primal heuristic data */
+   SCIP_CALL( SCIPallocBlockMemory(scip, &heurdata) );
+   heurdata->sol = NULL;
+   heurdata->varlist = NULL;
+   heurdata->residual = NULL;
+   heurdata->placed = NULL;
+   heurdata->R = NULL;
+   heurdata->nvars = 0;
+   heurdata->nitems = 0;
+   heurdata->nknaps = 0;
+   heurdata->ncalls = 0;
+   heurdata->nsols = 0;
+   heurdata->nlpiterations = 0;
+   heurdata->nfixings = 0;
+   heurdata->nbacktracks = 0;
+
+   heur = NULL;
+
+   /* include primal heuristic */
+   SCIP_CALL( SCIPincludeHeurBasic(scip, &heur,
+         HEUR_NAME, HEUR_DESC, HEUR_DISPCHAR, HEUR_PRIORITY, param.heur_div_freq, param.heur_div_freqofs,
+         param.heur_div_maxdepth, HEUR_TIMING, HEUR_USESSUBSCIP, heurExecMyDiving, heurdata) );
+
+   assert(heur != NULL);
+
+   /* set non fundamental callbacks via setter functions */
+   SCIP_CALL( SCIPsetHeurCopy(scip, heur, heurCopyMyDiving) );
+   SCIP_CALL( SCIPsetHeurFree(scip, heur, heurFreeMyDiving) );
+   SCIP_CALL( SCIPsetHeurInit(scip, heur, heurInitMyDiving) );
+   SCIP_CALL( SCIPsetHeurExit(scip, heur, heurExitMyDiving) );
+   SCIP_CALL( SCIPsetHeurInitsol(scip, heur, heurInitsolMyDiving) );
+   SCIP_CALL( SCIPsetHeurExitsol(scip, heur, heurExitsolMyDiving) );
+
+   /* add diving primal heuristic parameters */
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/maxdivedepth",
+         "maximum number of fixings per dive (-1: no limit)",
+         &heurdata->maxdivedepth, FALSE, DEFAULT_MAXDIVEDEPTH, -1, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip, "heuristics/" HEUR_NAME "/maxlpiterquot",
+         "maximal fraction of the LP iterations of the B&B nodes spent in the dives",
+         &heurdata->maxlpiterquot, FALSE, DEFAULT_MAXLPITERQUOT, 0.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/maxlpiterofs",
+         "additional number of LP iterations allowed to the dives",
+         &heurdata->maxlpiterofs, FALSE, DEFAULT_MAXLPITEROFS, 0, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/score",
+         "score of the fractional vars: 0 = LP value, 1 = LP value times value/weight of the item",
+         &heurdata->score, FALSE, DEFAULT_SCORE, 0, 1, NULL, NULL) );
+
+   return SCIP_OKAY;
+}
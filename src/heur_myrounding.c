@@ -16,16 +16,22 @@
 /**@file   heur_myrounding.c
  * @brief  rounding primal heuristic
  * @author Edna Hoshino (based on template provided by Tobias Achterberg)
+ *
+ * The vars x_i_k at 1.0 in the LP are kept and the fractional ones are rounded up by decreasing LP value while the
+ * item is free and fits its knapsack (rounding.c); the solution may then be improved by the local search.
  */
 
 /*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
 
 #include <assert.h>
+#include <string.h>
 
 #include "probdata_mochila.h"
 #include "parameters_mochila.h"
 #include "heur_myrounding.h"
 #include "heur_problem.h"
+#include "vardata_mochila.h"
+#include "rounding.h"
 
 //#define DEBUG_ROUNDING 1
 /* configuracao da heuristica */
@@ -49,13 +55,25 @@
  * Data structures
  */
 
-/* TODO: fill in the necessary primal heuristic data */
-
-/** primal heuristic data */
-/*struct SCIP_HeurData
+/** primal heuristic data: scratch buffers sized once per solve, so a call does no heap allocation */
+struct SCIP_HeurData
 {
+   SCIP_SOL*             sol;                /**< working solution, cleared and reused by every call */
+   SCIP_VAR**            varlist;            /**< vars split by their LP value (see getLPsolution()) */
+   SCIP_VAR**            solution;           /**< vars of the solution being built */
+   int*                  covered;            /**< covered[i] = 1 if item i is in the solution */
+   int*                  load;               /**< load of each knapsack (see createSolution()) */
+   int*                  assign;             /**< knapsack of each item (see improveSolution()) */
+   localSearchT*         LS;                 /**< local search on the solutions found (NULL: --local_search 0) */
+   roundingT*            R;                  /**< greedy rounding of the LP solution */
+   int                   nvars;              /**< size of varlist */
+   int                   nitems;             /**< size of solution and covered */
+   int                   nknaps;             /**< size of load */
+   SCIP_Longint          ncalls;             /**< number of calls */
+   SCIP_Longint          nsols;              /**< number of solutions stored */
+   SCIP_Longint          nmemcalls;          /**< calls that stored no solution but left SCIP using more memory */
+   SCIP_Longint          memgrowth;          /**< bytes left by those calls */
 };
-*/
 
 /*
  * Local methods
@@ -81,6 +99,13 @@ SCIP_DECL_HEURCOPY(heurCopyRounding)
 static
 SCIP_DECL_HEURFREE(heurFreeRounding)
 {  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   SCIPfreeBlockMemory(scip, &heurdata);
+   SCIPheurSetData(heur, NULL);
 
    return SCIP_OKAY;
 }
@@ -109,6 +134,37 @@ SCIP_DECL_HEUREXIT(heurExitRounding)
 static
 SCIP_DECL_HEURINITSOL(heurInitsolRounding)
 {  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   SCIP_PROBDATA* probdata;
+   instanceT* I;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   probdata = SCIPgetProbData(scip);
+   I = SCIPprobdataGetInstance(probdata);
+   heurdata->nvars = SCIPprobdataGetNVars(probdata);
+   heurdata->nitems = I->n;
+   heurdata->nknaps = I->m;
+   heurdata->ncalls = 0;
+   heurdata->nsols = 0;
+   heurdata->nmemcalls = 0;
+   heurdata->memgrowth = 0;
+   SCIP_CALL( SCIPcreateSol(scip, &heurdata->sol, heur) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->varlist, heurdata->nvars) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->solution, I->n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->covered, I->n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->load, I->m) );
+   heurdata->R = createRounding(I, SCIPprobdataGetItems(probdata), heurdata->nvars);
+   if( heurdata->R == NULL )
+      return SCIP_NOMEMORY;
+   if( param.local_search )
+   {
+      SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->assign, I->n) );
+      heurdata->LS = createLocalSearch(I, SCIPprobdataGetItems(probdata), NULL, NULL);
+      if( heurdata->LS == NULL )
+         return SCIP_NOMEMORY;
+   }
 
    return SCIP_OKAY;
 }
@@ -118,6 +174,36 @@ SCIP_DECL_HEURINITSOL(heurInitsolRounding)
 static
 SCIP_DECL_HEUREXITSOL(heurExitsolRounding)
 {  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+#ifdef DEBUG_ROUNDING
+   printf("\nHeuristic %s: %lld calls, %lld solutions stored\n", HEUR_NAME,
+      (long long) heurdata->ncalls, (long long) heurdata->nsols);
+   printf("Heuristic %s: %lld calls stored no solution but left SCIP using more memory (%lld bytes)\n", HEUR_NAME,
+      (long long) heurdata->nmemcalls, (long long) heurdata->memgrowth);
+#endif
+   if( heurdata->LS != NULL )
+   {
+#ifdef DEBUG_ROUNDING
+      printf("Heuristic %s: local search evaluated %lld moves\n", HEUR_NAME, heurdata->LS->nevals);
+#endif
+      freeLocalSearch(heurdata->LS);
+      heurdata->LS = NULL;
+   }
+   freeRounding(heurdata->R);
+   heurdata->R = NULL;
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->assign, heurdata->nitems);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->load, heurdata->nknaps);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->covered, heurdata->nitems);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->solution, heurdata->nitems);
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->varlist, heurdata->nvars);
+   if( heurdata->sol != NULL )
+   {
+      SCIP_CALL( SCIPfreeSol(scip, &heurdata->sol) );
+   }
 
    return SCIP_OKAY;
 }
@@ -135,14 +221,15 @@ int rounding(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
 {
    int found, infeasible, nInSolution;
    unsigned int stored;
-   int nvars, n1, nfrac, n0;
-   int *covered, n, custo, nCovered, nCands;
-   SCIP_VAR *var, **solution, **varlist;//, **subvars;
-   //  SCIP* scip_cp;
+   int n1, nfrac, n0;
+   int *covered, n;
+   SCIP_VAR *var, **solution, **varlist;
    SCIP_Real valor, bestUb;
    SCIP_PROBDATA* probdata;
-   int i, error;
+   SCIP_HEURDATA* heurdata;
+   int i;
    instanceT* I;
+   roundingT* R;
    
    found = 0;
    infeasible = 0;
@@ -154,17 +241,19 @@ int rounding(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
    /* recupera os dados do problema original*/
    probdata=SCIPgetProbData(scip);
    assert(probdata != NULL);
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
 
-   nvars = SCIPprobdataGetNVars(probdata);
    I = SCIPprobdataGetInstance(probdata);
    n = I->n;
-    
-   varlist = (SCIP_VAR**)malloc(sizeof(SCIP_VAR*)*(nvars));
-   solution = (SCIP_VAR**) malloc(sizeof(SCIP_VAR*)*n);
-   covered = (int*) calloc(n,sizeof(int));
-   nInSolution = 0;
-   nCovered = 0;
-   custo = 0;
+   heurdata->ncalls++;
+
+   // buffers of the heurdata: nothing is allocated here
+   varlist = heurdata->varlist;
+   solution = heurdata->solution;
+   covered = heurdata->covered;
+   R = heurdata->R;
+   roundingReset(R);
 
    // get LP solution, by spliting variables in three groups according to its LP value
    getLPsolution(scip, varlist, &n1, &nfrac, &n0, NULL);
@@ -174,45 +263,37 @@ int rounding(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
    // first, select all variables with LP value equal to 1.0
    for(i=0;i<n1;i++){
       var = varlist[i];
-      solution[nInSolution++]=var;
-      // update vertex covered by the current solution
-      infeasible = !updateSolution(var, I, covered, &nCovered, &custo);
-#ifdef DEBUG_ROUNDING
-      printf("\nSelected var= %s. TotalItems=%d weight=%d infeasible=%d", SCIPvarGetName(var), nInSolution, custo, infeasible);
-#endif
+      roundingFix(R, varGetItem(var), varGetKnapsack(var));
    }
-   // complete solution using variables with fractional values
-   error = 0;
-   found = 0;//isCompleteSolution(solution, nInSolution, I->n, covered, nCovered, n);
-   for(i=0;i<nfrac && !found && !error;i++){
+   // complete solution using variables with fractional values: sorted once by LP value and rounded up in one pass
+   // (the item is still free and fits the residual capacity of the knapsack)
+   for(i=0;i<nfrac;i++){
       var = varlist[n1+i];
-      nCands = selectCand(scip, solution, nInSolution, custo, &var, varlist, n1, nfrac, covered);
-      // only select actived var in scip and whose rounding up is valid for the problem
-      if(nCands>0){
-         // include selected var in the solution
-         solution[nInSolution++]=var;
-         // update vertex covered by the current solution
-         infeasible = !updateSolution(var, I, covered, &nCovered, &custo);
-#ifdef DEBUG_ROUNDING
-         printf("\n\nSelected var= %s. TotalItems=%d cost=%d infeasible=%d\n", SCIPvarGetName(var), nInSolution, custo, infeasible);
-#endif
-      }
-      // check if the solution is complete
-      found = isCompleteSolution(solution, nInSolution, I->n, covered, nCovered, n);
-      if(!nCands){
+      roundingAddCand(R, varGetItem(var), varGetKnapsack(var), SCIPgetVarSol(scip, var));
+   }
+   roundingRun(R);
+   infeasible = R->infeasible;
+   nInSolution = 0;
+   for(i=0;i<n;i++){
+      covered[i] = R->assign[i] >= 0;
+      if(covered[i])
+         solution[nInSolution++] = SCIPprobdataGetVar(probdata, i, R->assign[i]);
+   }
 #ifdef DEBUG_ROUNDING
-         printf("Problem has no candidate!\n");
+   printf("\n%d vars at 1.0, %d fractional: TotalItems=%d value=%lld infeasible=%d\n", n1, nfrac, nInSolution, R->value,
+      infeasible);
 #endif
-         found = nInSolution>0;
-         error = !found;
-      }
-   }
+   found = !infeasible && nInSolution > 0;
    if(found){
-      /* create SCIP solution structure sol */
-      SCIP_CALL( SCIPcreateSol(scip, sol, heur) );
+      // local search on the solution built (createSolution() takes the value from covered)
+      if(heurdata->LS != NULL)
+         improveSolution(scip, heurdata->LS, solution, &nInSolution, covered, heurdata->assign);
+      /* the working solution of the heurdata gets the found solution */
+      *sol = heurdata->sol;
+      SCIP_CALL( SCIPclearSol(scip, *sol) );
       // save found solution in sol
-      valor = createSolution(scip, *sol, solution, nInSolution, &infeasible, covered);
-      bestUb = SCIPgetPrimalbound(scip);
+      valor = createSolution(scip, *sol, solution, nInSolution, &infeasible, covered, heurdata->load);
+      bestUb = SCIPgetPrimalboundMine(scip);
 #ifdef DEBUG_ROUNDING
       printf("\nFound solution...\n");
       //      SCIP_CALL( SCIPprintSol(scip, *sol, NULL, FALSE) );
@@ -224,10 +305,11 @@ int rounding(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
          SCIP_CALL( SCIPprintSol(scip, *sol, NULL, FALSE) );
 #endif
          
-         /* verificar se a solucao eh viavel e armazena */
+         /* verificar se a solucao eh viavel e armazena (SCIPtrySol copia a solucao) */
          SCIP_CALL( SCIPtrySolMine(scip, *sol, TRUE, TRUE, FALSE, TRUE, &stored) );
          if( stored )
          {
+            heurdata->nsols++;
             //        printf("D");
 #ifdef DEBUG_PRIMAL
             printf("\nOK, done! Total of IS = %d", nInSolution);
@@ -247,9 +329,6 @@ int rounding(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
 #ifdef DEBUG_ROUNDING
    getchar();
 #endif
-   free(varlist);
-   free(solution);
-   free(covered);
    return found;
 }
 
@@ -258,6 +337,8 @@ static
 SCIP_DECL_HEUREXEC(heurExecRounding)
 {  /*lint --e{715}*/
    SCIP_SOL*             sol;                /**< solution to round */
+   SCIP_HEURDATA*        heurdata;
+   SCIP_Longint          memused, nsols;
    int nlpcands;
 
    assert(result != NULL);
@@ -283,6 +364,9 @@ SCIP_DECL_HEUREXEC(heurExecRounding)
      return SCIP_OKAY;
 
    /* solve rounding */
+   heurdata = SCIPheurGetData(heur);
+   memused = SCIPgetMemUsed(scip);
+   nsols = heurdata->nsols;
    if(rounding(scip, &sol, heur)){
      *result = SCIP_FOUNDSOL;
    }
@@ -291,6 +375,13 @@ SCIP_DECL_HEUREXEC(heurExecRounding)
      printf("\nRounding could not find feasible solution!");      
 #endif
    }
+   // the call works on buffers sized at initsol: unless it stored a solution, SCIP must use no more memory than before
+   // (the first call may still size the working solution)
+   if( heurdata->nsols == nsols && heurdata->ncalls > 1 && SCIPgetMemUsed(scip) > memused )
+   {
+      heurdata->nmemcalls++;
+      heurdata->memgrowth += SCIPgetMemUsed(scip) - memused;
+   }
    return SCIP_OKAY;
 }
 
@@ -308,7 +399,22 @@ SCIP_RETCODE SCIPincludeHeurMyRounding(
    SCIP_HEUR* heur;
 
    /* create rounding primal heuristic data */
-   heurdata = NULL;
+   SCIP_CALL( SCIPallocBlockMemory(scip, &heurdata) );
+   heurdata->sol = NULL;
+   heurdata->varlist = NULL;
+   heurdata->solution = NULL;
+   heurdata->covered = NULL;
+   heurdata->load = NULL;
+   heurdata->assign = NULL;
+   heurdata->LS = NULL;
+   heurdata->R = NULL;
+   heurdata->nvars = 0;
+   heurdata->nitems = 0;
+   heurdata->nknaps = 0;
+   heurdata->ncalls = 0;
+   heurdata->nsols = 0;
+   heurdata->nmemcalls = 0;
+   heurdata->memgrowth = 0;
 
    heur = NULL;
 
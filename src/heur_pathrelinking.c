@@ -0,0 +1,429 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   heur_pathrelinking.c
+ * @brief  path-relinking primal heuristic
+ * @author Edna Hoshino (based on template provided by Tobias Achterberg)
+ *
+ * The heuristics grasp and aleatoria offer their solutions through SCIPpathrelinkingAddSolution(); they wait in a
+ * small buffer until the next call, which relinks each of them with the best member and with the member farthest from
+ * it of an elite pool (pathrelinking.c) kept for the whole solve. The solutions of the paths and the offered ones go to
+ * the pool, and the best one is submitted to SCIP. The paths respect the global bounds, so the solutions are feasible
+ * at every node.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <string.h>
+#include <limits.h>
+
+#include "probdata_mochila.h"
+#include "parameters_mochila.h"
+#include "heur_pathrelinking.h"
+#include "heur_problem.h"
+#include "vardata_mochila.h"
+#include "pathrelinking.h"
+
+//#define DEBUG_PR 1
+/* configuracao da heuristica */
+#define HEUR_NAME             "pathrelinking"
+#define HEUR_DESC             "path relinking of the solutions of grasp and aleatoria with an elite pool"
+#define HEUR_DISPCHAR         'p'
+#define HEUR_PRIORITY         1 /* depois de grasp e aleatoria, que alimentam o buffer */
+#define HEUR_FREQ             1 /* a cada 1 nivel da arvore de B&B */
+#define HEUR_FREQOFS          0 /* comecando do nivel 0 */
+#define HEUR_MAXDEPTH         -1 /* nivel max para chamar a heuristica. -1 = sem limites */
+#define HEUR_TIMING           SCIP_HEURTIMING_AFTERNODE
+#define HEUR_USESSUBSCIP      FALSE  /**< does the heuristic use a secondary SCIP instance? */
+
+#define DEFAULT_POOLSIZE      10     /**< solutions in the elite pool */
+#define DEFAULT_MINDIVERSITY  0.05   /**< minimum distance to the members, as a fraction of the items */
+#define PR_MAXPENDING         8      /**< solutions offered waiting for the next call */
+
+/*
+ * Data structures
+ */
+
+/** primal heuristic data: the pool and the buffers are sized once per solve */
+struct SCIP_HeurData
+{
+   SCIP_SOL*             sol;                /**< working solution, cleared and reused by every call */
+   elitePoolT*           P;                  /**< elite pool, kept across the B&B nodes */
+   relinkT*              R;                  /**< path relinking engine */
+   int*                  pending;            /**< pending[p*n+i] = knapsack of item i in the offered solution p */
+   long long*            pendingvalue;       /**< value of each offered solution */
+   int                   npending;           /**< offered solutions waiting for the next call */
+   int*                  best;               /**< best solution of the call */
+   int                   poolsize;           /**< solutions in the elite pool */
+   SCIP_Real             mindiversity;       /**< minimum distance to the members, as a fraction of the items */
+   SCIP_Longint          ncalls;             /**< number of calls */
+   SCIP_Longint          noffered;           /**< solutions offered by the other heuristics */
+   SCIP_Longint          nrelinks;           /**< paths walked */
+   SCIP_Longint          nimproved;          /**< paths that gave a solution better than both ends */
+   SCIP_Longint          nsols;              /**< number of solutions stored */
+};
+
+/*
+ * Local methods
+ */
+
+/** offers the solution to the pool; the pending solutions are relinked with the pool before entering it */
+void SCIPpathrelinkingAddSolution(SCIP* scip, const int* assign, long long value)
+{
+   SCIP_HEUR* heur;
+   SCIP_HEURDATA* heurdata;
+   int p, slot, n;
+
+   heur = SCIPfindHeur(scip, HEUR_NAME);
+   if( heur == NULL )
+      return;
+   heurdata = SCIPheurGetData(heur);
+   if( heurdata == NULL || heurdata->pending == NULL )
+      return;
+   n = heurdata->P->n;
+   heurdata->noffered++;
+   // a full buffer keeps its best solutions
+   if( heurdata->npending < PR_MAXPENDING )
+      slot = heurdata->npending++;
+   else
+   {
+      slot = 0;
+      for( p = 1; p < PR_MAXPENDING; p++ )
+         if( heurdata->pendingvalue[p] < heurdata->pendingvalue[slot] )
+            slot = p;
+      if( heurdata->pendingvalue[slot] >= value )
+         return;
+   }
+   memcpy(heurdata->pending + (size_t) slot*n, assign, sizeof(int)*n);
+   heurdata->pendingvalue[slot] = value;
+}
+
+/*
+ * Callback methods of primal heuristic
+ */
+
+/** copy method for primal heuristic plugins (called when SCIP copies plugins) */
+static
+SCIP_DECL_HEURCOPY(heurCopyPathrelinking)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+/** destructor of primal heuristic to free user data (called when SCIP is exiting) */
+static
+SCIP_DECL_HEURFREE(heurFreePathrelinking)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   SCIPfreeBlockMemory(scip, &heurdata);
+   SCIPheurSetData(heur, NULL);
+
+   return SCIP_OKAY;
+}
+
+
+/** initialization method of primal heuristic (called after problem was transformed) */
+static
+SCIP_DECL_HEURINIT(heurInitPathrelinking)
+{  /*lint --e{715}*/
+
+
+   return SCIP_OKAY;
+}
+
+
+/** deinitialization method of primal heuristic (called before transformed problem is freed) */
+static
+SCIP_DECL_HEUREXIT(heurExitPathrelinking)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process initialization method of primal heuristic (called when branch and bound process is about to begin) */
+static
+SCIP_DECL_HEURINITSOL(heurInitsolPathrelinking)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   SCIP_PROBDATA* probdata;
+   instanceT* I;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   probdata = SCIPgetProbData(scip);
+   I = SCIPprobdataGetInstance(probdata);
+   heurdata->ncalls = 0;
+   heurdata->noffered = 0;
+   heurdata->nrelinks = 0;
+   heurdata->nimproved = 0;
+   heurdata->nsols = 0;
+   heurdata->npending = 0;
+   SCIP_CALL( SCIPcreateSol(scip, &heurdata->sol, heur) );
+   heurdata->P = createElitePool(I->n, heurdata->poolsize, (int) (heurdata->mindiversity * I->n + 0.5));
+   heurdata->R = createRelink(I, SCIPprobdataGetItems(probdata));
+   if( heurdata->P == NULL || heurdata->R == NULL )
+      return SCIP_NOMEMORY;
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->pending, PR_MAXPENDING * I->n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->pendingvalue, PR_MAXPENDING) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->best, I->n) );
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process deinitialization method of primal heuristic (called before branch and bound process data is freed) */
+static
+SCIP_DECL_HEUREXITSOL(heurExitsolPathrelinking)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   int n;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   if( heurdata->P != NULL )
+   {
+      n = heurdata->P->n;
+#ifdef DEBUG_PR
+      printf("\nHeuristic %s: %lld calls, %lld solutions offered, %lld paths (%lld improved both ends, %lld steps), "
+         "pool %d/%d (%lld added, %lld rejected, %lld purged), %lld solutions stored\n",
+         HEUR_NAME, (long long) heurdata->ncalls, (long long) heurdata->noffered, (long long) heurdata->nrelinks,
+         (long long) heurdata->nimproved, heurdata->R != NULL ? heurdata->R->nsteps : 0LL, heurdata->P->nsols,
+         heurdata->P->size, heurdata->P->nadded, heurdata->P->nrejected, heurdata->P->npurged, (long long) heurdata->nsols);
+#endif
+      if( heurdata->pending != NULL )
+         SCIPfreeBlockMemoryArray(scip, &heurdata->pending, PR_MAXPENDING * n);
+      if( heurdata->pendingvalue != NULL )
+         SCIPfreeBlockMemoryArray(scip, &heurdata->pendingvalue, PR_MAXPENDING);
+      if( heurdata->best != NULL )
+         SCIPfreeBlockMemoryArray(scip, &heurdata->best, n);
+   }
+   heurdata->pending = NULL;
+   heurdata->pendingvalue = NULL;
+   heurdata->best = NULL;
+   heurdata->npending = 0;
+   freeElitePool(heurdata->P);
+   heurdata->P = NULL;
+   freeRelink(heurdata->R);
+   heurdata->R = NULL;
+   if( heurdata->sol != NULL )
+   {
+      SCIP_CALL( SCIPfreeSol(scip, &heurdata->sol) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Core of the path-relinking heuristic: each pending solution is relinked with the best member of the pool and
+ * with the member farthest from it, then the solutions enter the pool. The best one is submitted to SCIP if it improves
+ * the incumbent.
+ *
+ * @param scip problem
+ * @param sol pointer to the solution structure where the solution wil be saved
+ * @param heur pointer to the path-relinking heuristic handle (to contabilize statistics)
+ * @return int 1 if solutions is found, 0 otherwise.
+ */
+static
+int pathrelinking(SCIP* scip, SCIP_SOL** sol, SCIP_HEUR* heur)
+{
+   int found = 0;
+   unsigned int stored;
+   int n, m, i, k, p, g, guide[2], nguides;
+   int* from;
+   long long value, bestvalue;
+   SCIP_VAR* var;
+   SCIP_PROBDATA* probdata;
+   SCIP_HEURDATA* heurdata;
+   elitePoolT* P;
+   relinkT* R;
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+   P = heurdata->P;
+   R = heurdata->R;
+   n = R->n;
+   m = R->m;
+   heurdata->ncalls++;
+
+   // restrictions of the global bounds: the paths go on being valid at every node
+   for( i = 0; i < n; i++ )
+   {
+      R->LS->fixed[i] = -1;
+      for( k = 0; k < m; k++ )
+      {
+         var = SCIPprobdataGetVar(probdata, i, k);
+         R->LS->allowed[i*m + k] = SCIPvarGetUbGlobal(var) > 1.0 - EPSILON;
+         if( SCIPvarGetLbGlobal(var) > 1.0 - EPSILON )
+            R->LS->fixed[i] = k;
+      }
+   }
+   // the global bounds may have changed since the members entered the pool
+   elitePoolPurge(P, m, R->LS->fixed, R->LS->allowed);
+
+   bestvalue = -1;
+   for( p = 0; p < heurdata->npending; p++ )
+   {
+      from = heurdata->pending + (size_t) p*n;
+      // offered at a node whose bounds are no longer valid
+      if( !relinkAllowed(R, from) )
+         continue;
+      nguides = 0;
+      if( P->nsols > 0 )
+      {
+         guide[nguides++] = elitePoolBest(P);
+         g = elitePoolFarthest(P, from, guide[0]);
+         if( g >= 0 )
+            guide[nguides++] = g;
+      }
+      for( g = 0; g < nguides; g++ )
+      {
+         value = relinkPath(R, from, P->sols + (size_t) guide[g]*n);
+         heurdata->nrelinks++;
+         if( value < 0 )
+            continue;
+         if( value > heurdata->pendingvalue[p] && value > P->values[guide[g]] )
+            heurdata->nimproved++;
+         if( value > bestvalue )
+         {
+            bestvalue = value;
+            memcpy(heurdata->best, R->best, sizeof(int)*n);
+         }
+         // the guides may change: the new solution is relinked with the pool of the next pending solutions
+         elitePoolAdd(P, R->best, value);
+      }
+      if( heurdata->pendingvalue[p] > bestvalue )
+      {
+         bestvalue = heurdata->pendingvalue[p];
+         memcpy(heurdata->best, from, sizeof(int)*n);
+      }
+      elitePoolAdd(P, from, heurdata->pendingvalue[p]);
+   }
+   heurdata->npending = 0;
+
+#ifdef DEBUG_PR
+   printf("\nPath relinking: best value = %lld, pool %d/%d\n", bestvalue, P->nsols, P->size);
+#endif
+   if( bestvalue >= 0 && bestvalue > SCIPgetPrimalboundMine(scip) + EPSILON )
+   {
+      *sol = heurdata->sol;
+      SCIP_CALL( SCIPclearSol(scip, *sol) );
+      for( i = 0; i < n; i++ )
+      {
+         if( heurdata->best[i] >= 0 )
+         {
+            SCIP_CALL( SCIPsetSolVal(scip, *sol, SCIPprobdataGetVar(probdata, i, heurdata->best[i]), 1.0) );
+         }
+      }
+      /* verificar se a solucao eh viavel e armazena (SCIPtrySol copia a solucao) */
+      SCIP_CALL( SCIPtrySolMine(scip, *sol, TRUE, TRUE, FALSE, TRUE, &stored) );
+      if( stored )
+      {
+         heurdata->nsols++;
+         found = 1;
+      }
+   }
+
+   return found;
+}
+
+/** execution method of primal heuristic */
+static
+SCIP_DECL_HEUREXEC(heurExecPathrelinking)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   SCIP_SOL* sol;
+
+   assert(result != NULL);
+
+   *result = SCIP_DIDNOTRUN;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   /* nothing offered since the last call */
+   if( heurdata->P == NULL || heurdata->npending == 0 )
+      return SCIP_OKAY;
+
+   *result = SCIP_DIDNOTFIND;
+   if( pathrelinking(scip, &sol, heur) )
+      *result = SCIP_FOUNDSOL;
+
+   return SCIP_OKAY;
+}
+
+/*
+ * primal heuristic specific interface methods
+ */
+
+/** creates the path-relinking primal heuristic and includes it in SCIP */
+SCIP_RETCODE SCIPincludeHeurPathrelinking(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_HEURDATA* heurdata;
+   SCIP_HEUR* heur;
+
+   /* create path-relinking primal heuristic data */
+   SCIP_CALL( SCIPallocBlockMemory(scip, &heurdata) );
+   heurdata->sol = NULL;
+   heurdata->P = NULL;
+   heurdata->R = NULL;
+   heurdata->pending = NULL;
+   heurdata->pendingvalue = NULL;
+   heurdata->npending = 0;
+   heurdata->best = NULL;
+   heurdata->ncalls = 0;
+   heurdata->noffered = 0;
+   heurdata->nrelinks = 0;
+   heurdata->nimproved = 0;
+   heurdata->nsols = 0;
+
+   heur = NULL;
+
+   /* include primal heuristic */
+   SCIP_CALL( SCIPincludeHeurBasic(scip, &heur,
+         HEUR_NAME, HEUR_DESC, HEUR_DISPCHAR, HEUR_PRIORITY, HEUR_FREQ, HEUR_FREQOFS,
+         HEUR_MAXDEPTH, HEUR_TIMING, HEUR_USESSUBSCIP, heurExecPathrelinking, heurdata) );
+
+   assert(heur != NULL);
+
+   /* set non fundamental callbacks via setter functions */
+   SCIP_CALL( SCIPsetHeurCopy(scip, heur, heurCopyPathrelinking) );
+   SCIP_CALL( SCIPsetHeurFree(scip, heur, heurFreePathrelinking) );
+   SCIP_CALL( SCIPsetHeurInit(scip, heur, heurInitPathrelinking) );
+   SCIP_CALL( SCIPsetHeurExit(scip, heur, heurExitPathrelinking) );
+   SCIP_CALL( SCIPsetHeurInitsol(scip, heur, heurInitsolPathrelinking) );
+   SCIP_CALL( SCIPsetHeurExitsol(scip, heur, heurExitsolPathrelinking) );
+
+   /* add path-relinking primal heuristic parameters */
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/poolsize",
+         "number of solutions in the elite pool",
+         &heurdata->poolsize, FALSE, DEFAULT_POOLSIZE, 1, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip, "heuristics/" HEUR_NAME "/mindiversity",
+         "minimum Hamming distance of a new solution to the members of the pool, as a fraction of the items",
+         &heurdata->mindiversity, FALSE, DEFAULT_MINDIVERSITY, 0.0, 1.0, NULL, NULL) );
+
+   return SCIP_OKAY;
+}
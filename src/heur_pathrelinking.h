@@ -0,0 +1,51 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   heur_pathrelinking.h
+ * @ingroup PRIMALHEURISTICS
+ * @brief  path-relinking primal heuristic
+ * @author Edna Hoshino (based on template provided by Tobias Achterberg)
+ *
+ * template file for primal heuristic plugins
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_HEUR_PATHRELINKING_H__
+#define __SCIP_HEUR_PATHRELINKING_H__
+
+
+#include "scip/scip.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  
+/** offers a solution found by another heuristic (assign[i] = knapsack of item i, -1: not packed) to be relinked in the
+ *  next call; nothing is done if the heuristic is not included */
+void SCIPpathrelinkingAddSolution(SCIP* scip, const int* assign, long long value);
+
+/** creates the path-relinking primal heuristic and includes it in SCIP */
+
+SCIP_RETCODE SCIPincludeHeurPathrelinking(
+   SCIP*                 scip                /**< SCIP data structure */
+   );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,19 +4,16 @@
  *
  **/ 
 #include <assert.h>
+#include <string.h>
 
 #include "probdata_mochila.h"
+#include "vardata_mochila.h"
 #include "parameters_mochila.h"
 #include "heur_problem.h"
 
-int randomIntegerB (int low, int high)
+int randomIntegerB (rngT* rng, int low, int high)
 {
-  int k;
-  double d;
-
-  d = (double) rand () / ((double) RAND_MAX + 1);
-  k = d * (high - low + 1);
-  return low + k;
+  return low + rngInt(rng, high - low + 1);
 }
 /**
  * @brief split lambda variables in three groups according to its LP value:
@@ -128,47 +125,43 @@ void printLPvars(SCIP* scip, SCIP_VAR** pvars, int n1, int nfrac, int n0)
  */
 int updateSolution(SCIP_VAR* var, instanceT *I, int* covered, int *nCovered, int *custo)
 {
-   int a, i;
+   int a;
 // update item covered by the current solution
-   const char* name;
-
-   name = SCIPvarGetName(var);
-   a = 0;
-   for(i=4;name[i]!='\0';i++){
-      a = a*10 + name[i]-48;
-   }
+   a = varGetItem(var);
    covered[a]=1;
    (*nCovered)++;
-   *custo += I->item[a].weight;
+   *custo += I->item[a].value;
    return 1;
 }
-// TODO: create solution based on vars in solution (specific for the problem)
-SCIP_Real createSolution(SCIP* scip, SCIP_SOL* sol, SCIP_VAR** solution, int nSolution, int *infeasible, int *covered)
+// TODO: create solution based on vars in solution (specific for the problem). load: buffer with I->m ints
+SCIP_Real createSolution(SCIP* scip, SCIP_SOL* sol, SCIP_VAR** solution, int nSolution, int *infeasible, int *covered, int *load)
 {
    int s, i;
    SCIP_VAR *var;
    SCIP_PROBDATA* probdata;
    SCIP_Real value;
-   int weight; 
-   instanceT* I;
+    instanceT* I;
+   itemArraysT* items;
 
   /* recupera os dados do problema */
   probdata=SCIPgetProbData(scip);
   assert(probdata != NULL);
 
   I = SCIPprobdataGetInstance(probdata);
+  items = SCIPprobdataGetItems(probdata);
 
   value = 0;
-  weight = 0;
   for(i=0;i<I->n;i++)
   {
      if(covered[i]){
-        value += I->item[i].value;
-        weight += I->item[i].weight;
+        value += items->value[i];
      }
   }
+  // load of each knapsack (load is a buffer of the caller)
+  memset(load, 0, I->m*sizeof(int));
   for(s=0;s<nSolution;s++){
     var = solution[s];
+    load[varGetKnapsack(var)] += items->weight[varGetItem(var)];
     SCIP_CALL( SCIPsetSolVal(scip, sol, var, 1.0) );
 
 #ifdef DEBUG_PRIMAL
@@ -177,8 +170,10 @@ SCIP_Real createSolution(SCIP* scip, SCIP_SOL* sol, SCIP_VAR** solution, int nSo
   } // for each var at solution
 
   *infeasible = 0;
-  if(weight > I->C[0]){
-     *infeasible = 1;
+  for(i=0;i<I->m;i++){
+     if(load[i] > I->C[i]){
+        *infeasible = 1;
+     }
   }
 
   if(*infeasible){
@@ -187,39 +182,91 @@ SCIP_Real createSolution(SCIP* scip, SCIP_SOL* sol, SCIP_VAR** solution, int nSo
   return value;
 }
 
+/**
+ * @brief Local search (localsearch.c) on the solution given by its vars, within the bounds of the current node: the
+ *        items fixed in 1.0 do not move and no var fixed in 0.0 is used. The solution is replaced by the local optimum.
+ *
+ * @param scip problem
+ * @param L local search engine of the instance
+ * @param solution vars of the solution (x_i_k); it gets the vars of the local optimum (buffer with I->n vars)
+ * @param nSolution number of vars in solution, updated
+ * @param covered covered[i] = 1 if item i is in the solution, updated
+ * @param assign buffer with I->n ints
+ * @return SCIP_Real the value of the local optimum, or -1 if the solution violates a capacity (then nothing changes)
+ */
+SCIP_Real improveSolution(SCIP* scip, localSearchT* L, SCIP_VAR** solution, int* nSolution, int* covered, int* assign)
+{
+   SCIP_PROBDATA* probdata;
+   SCIP_VAR* var;
+   instanceT* I;
+   long long value;
+   int i, k, s;
+
+   probdata=SCIPgetProbData(scip);
+   assert(probdata != NULL);
+   I = SCIPprobdataGetInstance(probdata);
+
+   // restrictions of the node
+   for(i=0;i<I->n;i++){
+      L->fixed[i] = -1;
+      assign[i] = -1;
+      for(k=0;k<I->m;k++){
+         var = SCIPprobdataGetVar(probdata, i, k);
+         L->allowed[i*I->m + k] = SCIPvarGetUbLocal(var) > 1.0 - EPSILON;
+         if(SCIPvarGetLbLocal(var) > 1.0 - EPSILON)
+            L->fixed[i] = k;
+      }
+   }
+   for(s=0;s<*nSolution;s++){
+      assign[varGetItem(solution[s])] = varGetKnapsack(solution[s]);
+   }
+   if(localSearchLoad(L, assign) < 0)
+      return -1;
+   value = localSearchRun(L);
+   localSearchStore(L, assign, NULL);
+
+   *nSolution = 0;
+   for(i=0;i<I->n;i++){
+      covered[i] = assign[i] >= 0;
+      if(covered[i])
+         solution[(*nSolution)++] = SCIPprobdataGetVar(probdata, i, assign[i]);
+   }
+   return value;
+}
+
 /* TODO: it depends on the problem. */
 int isFeasibleColumn(SCIP* scip, SCIP_VAR** solution, int nInSolution, int* covered, SCIP_VAR* var)
 {
   SCIP_PROBDATA* probdata;
-  int i, feasible, weight;
+  int s, feasible, weight;
   instanceT* I;
-  int a;
-// update item covered by the current solution
-  const char* name;
+  itemArraysT* items;
+  int a, k;
 
-  name = SCIPvarGetName(var);
-  a = 0;
-  for(i=4;name[i]!='\0';i++){
-     a = a*10 + name[i]-48;
-  }
+  // var = x_a_k
+  a = varGetItem(var);
+  k = varGetKnapsack(var);
   
   probdata=SCIPgetProbData(scip);
   assert(probdata != NULL);
   I = SCIPprobdataGetInstance(probdata);
+  items = SCIPprobdataGetItems(probdata);
   
+  // item a is already in some knapsack
+  if(covered[a]){
+     return 0;
+  }
   feasible = 1;
-  /* recover problem's data */
-  probdata=SCIPgetProbData(scip);
-  assert(probdata != NULL);
   // TODO: we are considering that there is one constraint for each compact variable in PMR
   // TODO: should consider specific requirements for the problem
+  // load of knapsack k in the current solution
   weight = 0;
-  for(i=0;i<I->n && weight <= I->C[0]; i++){
-     if(covered[i]){
-        weight+=I->item[i].weight;
+  for(s=0;s<nInSolution; s++){
+     if(varGetKnapsack(solution[s]) == k){
+        weight+=items->weight[varGetItem(solution[s])];
      }
   }
-  if(weight + I->item[a].weight > I->C[0]){ // Here, we just do not allow non-disjoint columns and non-relaxed columns
+  if(weight + items->weight[a] > I->C[k]){ // Here, we just do not allow non-disjoint columns and non-relaxed columns
     feasible = 0;
   }
   return feasible;
@@ -306,6 +353,23 @@ SCIP_RETCODE SCIPtrySolMine(SCIP* scip, SCIP_SOL* sol, SCIP_Bool printreason, SC
 #endif
 }
 
+/* primal bound of the items of the model: in core mode SCIP adds to the objective the value of the items fixed out of
+ * the model (SCIPaddOrigObjoffset()), which the values computed by the heuristics on the instance do not have */
+SCIP_Real SCIPgetPrimalboundMine(SCIP* scip)
+{
+   return SCIPgetPrimalbound(scip) - SCIPgetOrigObjoffset(scip);
+}
+
+/* memory (MB) left to a sub-SCIP within limits/memory of scip, as in SCIPcopyLimits(): the memory already used by scip
+ * and its estimate of external memory are discounted */
+SCIP_RETCODE SCIPgetSubscipMemlimitMine(SCIP* scip, SCIP_Real* memorylimit)
+{
+   SCIP_CALL( SCIPgetRealParam(scip, "limits/memory", memorylimit) );
+   if( !SCIPisInfinity(scip, *memorylimit) )
+      *memorylimit -= (SCIPgetMemUsed(scip) + SCIPgetMemExternEstim(scip))/1048576.0;
+   return SCIP_OKAY;
+}
+
 /* TODO: it depends on the problem */
 int isCompleteSolution(SCIP_VAR** solution, int nInSolution, int maxInSolution, int* covered, int nCovered, int n)
 {
@@ -3,6 +3,8 @@
 
 
 #include "scip/scip.h"
+#include "localsearch.h"
+#include "rng.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -13,14 +15,17 @@ typedef struct{
    SCIP_Real solval;
 } candidatoT;
 
-int randomIntegerB (int low, int high);
+int randomIntegerB (rngT* rng, int low, int high);
 int getLPsolution(SCIP* scip, SCIP_VAR** pvars, int *pn1, int *pnfrac, int *pn0, int *pnlpcands);
 void printLPvars(SCIP* scip, SCIP_VAR** pvars, int n1, int nfrac, int n0);
 int updateSolution(SCIP_VAR* var, instanceT* I, int* covered, int *nCovered, int *custo);
-SCIP_Real createSolution(SCIP* scip, SCIP_SOL* sol, SCIP_VAR** solution, int nSolution, int *infeasible, int *covered);
+SCIP_Real createSolution(SCIP* scip, SCIP_SOL* sol, SCIP_VAR** solution, int nSolution, int *infeasible, int *covered, int *load);
+SCIP_Real improveSolution(SCIP* scip, localSearchT* L, SCIP_VAR** solution, int* nSolution, int* covered, int* assign);
 int isFeasibleColumn(SCIP* scip, SCIP_VAR** solution, int nInSolution, int* covered, SCIP_VAR* var);
 SCIP_RETCODE selectCand(SCIP* scip, SCIP_VAR** solution, int nInSolution, int custo, SCIP_VAR** pvar, SCIP_VAR** varlist, int n1, int nfrac, int* covered);
 SCIP_RETCODE SCIPtrySolMine(SCIP* scip, SCIP_SOL* sol, SCIP_Bool printreason, SCIP_Bool checkbounds, SCIP_Bool checkintegrality, SCIP_Bool checklprows, SCIP_Bool *stored);
+SCIP_Real SCIPgetPrimalboundMine(SCIP* scip);
+SCIP_RETCODE SCIPgetSubscipMemlimitMine(SCIP* scip, SCIP_Real* memorylimit);
 int isCompleteSolution(SCIP_VAR** solution, int nInSolution, int maxInSolution, int* covered, int nCovered, int n);
 #ifdef __cplusplus
 }
@@ -0,0 +1,362 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   heur_tabu.c
+ * @brief  tabu search primal heuristic
+ * @author Edna Hoshino (based on template provided by Tobias Achterberg)
+ *
+ * Tabu search of tabu.c at the root node: it starts from the incumbent (or from the greedy by value/weight if there is
+ * none) and runs up to heuristics/tabu/iterations iterations within heuristics/tabu/maxtime sec, under the bounds of
+ * the node. The best solution of the run is submitted to SCIP and offered to the path relinking.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <string.h>
+#include <limits.h>
+
+#include "probdata_mochila.h"
+#include "parameters_mochila.h"
+#include "heur_tabu.h"
+#include "heur_pathrelinking.h"
+#include "heur_problem.h"
+#include "vardata_mochila.h"
+#include "tabu.h"
+
+//#define DEBUG_TABU 1
+/* configuracao da heuristica */
+#define HEUR_NAME             "tabu"
+#define HEUR_DESC             "tabu search with shift and swap moves on a candidate list"
+#define HEUR_DISPCHAR         't'
+#define HEUR_PRIORITY         2 /* depois do grasp, que pode dar o incumbente */
+#define HEUR_FREQ             1 /* a cada 1 nivel da arvore de B&B */
+#define HEUR_FREQOFS          0 /* comecando do nivel 0 */
+#define HEUR_MAXDEPTH         0 /* so na raiz */
+#define HEUR_TIMING           SCIP_HEURTIMING_AFTERNODE
+#define HEUR_USESSUBSCIP      FALSE  /**< does the heuristic use a secondary SCIP instance? */
+
+#define DEFAULT_ITERATIONS    100000 /**< iterations per call */
+#define DEFAULT_MAXTIME       1.0    /**< time budget (in sec) per call */
+#define DEFAULT_TENURE        15     /**< minimum tenure of a tabu pair (in iterations) */
+#define DEFAULT_CANDSIZE      32     /**< items of the candidate list of an iteration */
+
+/*
+ * Data structures
+ */
+
+/** primal heuristic data: the engine keeps the buffers, sized once per solve */
+struct SCIP_HeurData
+{
+   SCIP_SOL*             sol;                /**< working solution, cleared and reused by every call */
+   tabuT*                T;                  /**< tabu search engine */
+   int*                  start;              /**< incumbent as an assignment vector */
+   int                   nitems;             /**< size of start */
+   int                   iterations;         /**< iterations per call */
+   SCIP_Real             maxtime;            /**< time budget (in sec) per call */
+   int                   tenure;             /**< minimum tenure of a tabu pair */
+   int                   candsize;           /**< items of the candidate list */
+   SCIP_Longint          ncalls;             /**< number of calls */
+   SCIP_Longint          nsols;              /**< number of solutions stored */
+   SCIP_Real             time;               /**< time spent in the engine */
+};
+
+/*
+ * Local methods
+ */
+
+/**
+ * @brief Core of the tabu heuristic: tabu search restricted to the current node, from the incumbent if it respects
+ * the node.
+ *
+ * @param scip problem
+ * @param heur pointer to the tabu heuristic handle (to contabilize statistics)
+ * @param found set to 1 if a solution is stored
+ */
+static
+SCIP_RETCODE tabu(SCIP* scip, SCIP_HEUR* heur, int* found)
+{
+   SCIP_PROBDATA* probdata;
+   SCIP_HEURDATA* heurdata;
+   SCIP_SOL* bestsol;
+   SCIP_VAR* var;
+   SCIP_Real timelimit, limit, start;
+   unsigned int stored;
+   instanceT* I;
+   tabuT* T;
+   int i, k, infeasible = 0;
+   long long value = -1;
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+   T = heurdata->T;
+   assert(T != NULL);
+   I = SCIPprobdataGetInstance(probdata);
+   *found = 0;
+
+   // the budget of the call, within the time limit of SCIP
+   timelimit = heurdata->maxtime;
+   SCIP_CALL( SCIPgetRealParam(scip, "limits/time", &limit) );
+   if( !SCIPisInfinity(scip, limit) && limit - SCIPgetSolvingTime(scip) < timelimit )
+      timelimit = limit - SCIPgetSolvingTime(scip);
+   if( timelimit <= 0.0 )
+      return SCIP_OKAY;
+
+   // restrictions of the node: items fixed in 1.0 stay in their knapsacks, vars fixed in 0.0 are not used
+   bestsol = SCIPgetBestSol(scip);
+   for( i = 0; i < I->n; i++ )
+   {
+      T->fixed[i] = -1;
+      heurdata->start[i] = -1;
+      for( k = 0; k < I->m; k++ )
+      {
+         var = SCIPprobdataGetVar(probdata, i, k);
+         T->allowed[i*I->m + k] = SCIPvarGetUbLocal(var) > 1.0 - EPSILON;
+         if( SCIPvarGetLbLocal(var) > 1.0 - EPSILON )
+         {
+            infeasible = infeasible || T->fixed[i] >= 0;
+            T->fixed[i] = k;
+         }
+         if( bestsol != NULL && SCIPgetSolVal(scip, bestsol, var) > 0.5 )
+            heurdata->start[i] = k;
+      }
+   }
+   if( infeasible )
+      return SCIP_OKAY;
+
+   heurdata->ncalls++;
+   T->tenure = heurdata->tenure;
+   T->candsize = heurdata->candsize;
+   if( bestsol != NULL )
+      value = tabuLoad(T, heurdata->start);
+   if( value < 0 && tabuGreedy(T) < 0 )
+      return SCIP_OKAY;
+
+   start = SCIPgetSolvingTime(scip);
+   tabuRun(T, heurdata->iterations, timelimit);
+   heurdata->time += SCIPgetSolvingTime(scip) - start;
+   SCIPpathrelinkingAddSolution(scip, T->best, T->bestvalue);
+#ifdef DEBUG_TABU
+   printf("\ntabu: best value = %lld at iteration %lld (%lld iterations, %lld aspirations)\n", T->bestvalue,
+      T->bestiter, T->iterations, T->naspirations);
+#endif
+
+   if( T->bestvalue > SCIPgetPrimalboundMine(scip) + EPSILON )
+   {
+      SCIP_CALL( SCIPclearSol(scip, heurdata->sol) );
+      for( i = 0; i < I->n; i++ )
+      {
+         if( T->best[i] >= 0 )
+         {
+            SCIP_CALL( SCIPsetSolVal(scip, heurdata->sol, SCIPprobdataGetVar(probdata, i, T->best[i]), 1.0) );
+         }
+      }
+      /* verificar se a solucao eh viavel e armazena (SCIPtrySol copia a solucao) */
+      SCIP_CALL( SCIPtrySolMine(scip, heurdata->sol, TRUE, TRUE, FALSE, TRUE, &stored) );
+      if( stored )
+      {
+         heurdata->nsols++;
+         *found = 1;
+      }
+   }
+
+   return SCIP_OKAY;
+}
+
+/*
+ * Callback methods of primal heuristic
+ */
+
+/** copy method for primal heuristic plugins (called when SCIP copies plugins) */
+static
+SCIP_DECL_HEURCOPY(heurCopyTabu)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+/** destructor of primal heuristic to free user data (called when SCIP is exiting) */
+static
+SCIP_DECL_HEURFREE(heurFreeTabu)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   SCIPfreeBlockMemory(scip, &heurdata);
+   SCIPheurSetData(heur, NULL);
+
+   return SCIP_OKAY;
+}
+
+
+/** initialization method of primal heuristic (called after problem was transformed) */
+static
+SCIP_DECL_HEURINIT(heurInitTabu)
+{  /*lint --e{715}*/
+
+
+   return SCIP_OKAY;
+}
+
+
+/** deinitialization method of primal heuristic (called before transformed problem is freed) */
+static
+SCIP_DECL_HEUREXIT(heurExitTabu)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process initialization method of primal heuristic (called when branch and bound process is about to begin) */
+static
+SCIP_DECL_HEURINITSOL(heurInitsolTabu)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+   SCIP_PROBDATA* probdata;
+   instanceT* I;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+   probdata = SCIPgetProbData(scip);
+   I = SCIPprobdataGetInstance(probdata);
+   heurdata->ncalls = 0;
+   heurdata->nsols = 0;
+   heurdata->time = 0.0;
+   heurdata->nitems = I->n;
+   SCIP_CALL( SCIPcreateSol(scip, &heurdata->sol, heur) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &heurdata->start, I->n) );
+   heurdata->T = createTabu(I, SCIPprobdataGetItems(probdata), NULL, NULL, (unsigned long long) param.seed);
+   if( heurdata->T == NULL )
+      return SCIP_NOMEMORY;
+
+   return SCIP_OKAY;
+}
+
+
+/** solving process deinitialization method of primal heuristic (called before branch and bound process data is freed) */
+static
+SCIP_DECL_HEUREXITSOL(heurExitsolTabu)
+{  /*lint --e{715}*/
+   SCIP_HEURDATA* heurdata;
+
+   heurdata = SCIPheurGetData(heur);
+   assert(heurdata != NULL);
+
+#ifdef DEBUG_TABU
+   if( heurdata->T != NULL )
+      printf("\nHeuristic %s: %lld calls, %lld iterations (%.0lf/s), %lld moves evaluated, %lld aspirations, %lld solutions stored\n",
+         HEUR_NAME, (long long) heurdata->ncalls, heurdata->T->iterations,
+         heurdata->time > 0.0 ? heurdata->T->iterations / heurdata->time : 0.0, heurdata->T->nevals,
+         heurdata->T->naspirations, (long long) heurdata->nsols);
+#endif
+   freeTabu(heurdata->T);
+   heurdata->T = NULL;
+   SCIPfreeBlockMemoryArrayNull(scip, &heurdata->start, heurdata->nitems);
+   if( heurdata->sol != NULL )
+   {
+      SCIP_CALL( SCIPfreeSol(scip, &heurdata->sol) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** execution method of primal heuristic */
+static
+SCIP_DECL_HEUREXEC(heurExecTabu)
+{  /*lint --e{715}*/
+   int found;
+
+   assert(result != NULL);
+
+   *result = SCIP_DIDNOTRUN;
+
+   /* continue only if the LP is finished */
+   if ( SCIPgetLPSolstat(scip) != SCIP_LPSOLSTAT_OPTIMAL )
+      return SCIP_OKAY;
+
+   /* continue only of the LP value is less than the cutoff bound */
+   if( SCIPisGE(scip, SCIPgetLPObjval(scip), SCIPgetCutoffbound(scip)) )
+      return SCIP_OKAY;
+
+   *result = SCIP_DIDNOTFIND;
+   SCIP_CALL( tabu(scip, heur, &found) );
+   if( found )
+      *result = SCIP_FOUNDSOL;
+
+   return SCIP_OKAY;
+}
+
+
+/*
+ * primal heuristic specific interface methods
+ */
+
+/** creates the tabu search primal heuristic and includes it in SCIP */
+SCIP_RETCODE SCIPincludeHeurTabu(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_HEURDATA* heurdata;
+   SCIP_HEUR* heur;
+
+   /* create tabu primal heuristic data */
+   SCIP_CALL( SCIPallocBlockMemory(scip, &heurdata) );
+   heurdata->sol = NULL;
+   heurdata->T = NULL;
+   heurdata->start = NULL;
+   heurdata->nitems = 0;
+   heurdata->ncalls = 0;
+   heurdata->nsols = 0;
+   heurdata->time = 0.0;
+
+   heur = NULL;
+
+   /* include primal heuristic */
+   SCIP_CALL( SCIPincludeHeurBasic(scip, &heur,
+         HEUR_NAME, HEUR_DESC, HEUR_DISPCHAR, HEUR_PRIORITY, HEUR_FREQ, HEUR_FREQOFS,
+         HEUR_MAXDEPTH, HEUR_TIMING, HEUR_USESSUBSCIP, heurExecTabu, heurdata) );
+
+   assert(heur != NULL);
+
+   /* set non fundamental callbacks via setter functions */
+   SCIP_CALL( SCIPsetHeurCopy(scip, heur, heurCopyTabu) );
+   SCIP_CALL( SCIPsetHeurFree(scip, heur, heurFreeTabu) );
+   SCIP_CALL( SCIPsetHeurInit(scip, heur, heurInitTabu) );
+   SCIP_CALL( SCIPsetHeurExit(scip, heur, heurExitTabu) );
+   SCIP_CALL( SCIPsetHeurInitsol(scip, heur, heurInitsolTabu) );
+   SCIP_CALL( SCIPsetHeurExitsol(scip, heur, heurExitsolTabu) );
+
+   /* add tabu primal heuristic parameters */
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/iterations",
+         "iterations (moves applied) per call",
+         &heurdata->iterations, FALSE, DEFAULT_ITERATIONS, 1, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip, "heuristics/" HEUR_NAME "/maxtime",
+         "time budget (in sec) per call",
+         &heurdata->maxtime, FALSE, DEFAULT_MAXTIME, 0.0, SCIP_REAL_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/tenure",
+         "minimum tenure (in iterations) of a tabu pair (item, knapsack); the tenure is drawn up to 1.5 times it",
+         &heurdata->tenure, FALSE, DEFAULT_TENURE, 1, INT_MAX, NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip, "heuristics/" HEUR_NAME "/candsize",
+         "items of the candidate list of an iteration",
+         &heurdata->candsize, FALSE, DEFAULT_CANDSIZE, 1, INT_MAX, NULL, NULL) );
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,254 @@
+/**@file   kernels.c
+ * @brief  0-1 knapsack and subset-sum kernels over the capacity dimension (no SCIP calls)
+ *
+ * For each item, the capacities are swept in blocks from the largest to the smallest. A block only reads positions
+ * that are lower than or inside itself, and it loads all of them before storing, so it always sees the values from
+ * before the item, as the scalar loop does. The AVX2 block is 4 words of the bitset (256 sums) in the subset-sum and
+ * 4 doubles in the value DP, whose decision bits come from the comparison mask. The positions left below the last
+ * full block are done by the scalar code.
+ **/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "kernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// instruction set used by the kernels, -1 until the first call
+static atomic_int selected = -1;
+
+kernelIsaT kernelBestIsa(void)
+{
+#ifdef KERNELS_X86
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2"))
+    return KERNEL_AVX2;
+#endif
+  return KERNEL_SCALAR;
+}
+
+kernelIsaT kernelUseIsa(kernelIsaT isa)
+{
+  kernelIsaT best = kernelBestIsa();
+
+  if(isa > best)
+    isa = best;
+  atomic_store(&selected, (int) isa);
+  return isa;
+}
+
+kernelIsaT kernelCurrentIsa(void)
+{
+  int isa = atomic_load(&selected);
+
+  if(isa < 0){
+    isa = (int) kernelBestIsa();
+    atomic_store(&selected, isa);
+  }
+  return (kernelIsaT) isa;
+}
+
+const char* kernelIsaName(kernelIsaT isa)
+{
+  return isa == KERNEL_AVX2 ? "avx2" : "scalar";
+}
+
+/*
+ * subset-sum: bits |= bits << w
+ */
+
+/** words k..ws of bits |= bits << (64*ws + bs), from the last to the first */
+static void shiftOrTail(uint64_t* bits, int k, int ws, int bs)
+{
+  uint64_t v;
+
+  for(; k >= ws; k--){
+    v = bits[k-ws] << bs;
+    if(bs && k-ws-1 >= 0)
+      v |= bits[k-ws-1] >> (64-bs);
+    bits[k] |= v;
+  }
+}
+
+static void shiftOrScalar(uint64_t* bits, int nwords, int w)
+{
+  shiftOrTail(bits, nwords-1, w/64, w%64);
+}
+
+#ifdef KERNELS_X86
+__attribute__((target("avx2")))
+static void shiftOrAvx2(uint64_t* bits, int nwords, int w)
+{
+  const int ws = w/64, bs = w%64;
+  // a logical shift by 64 gives 0, so bs = 0 needs no special case
+  const __m128i left = _mm_cvtsi32_si128(bs), right = _mm_cvtsi32_si128(64-bs);
+  __m256i hi, lo, cur;
+  int k = nwords-1;
+
+  // block bits[k-3..k] reads bits[k-4-ws..k-ws]
+  for(; k-4-ws >= 0; k -= 4){
+    hi = _mm256_loadu_si256((const __m256i*) (bits + k-3-ws));
+    lo = _mm256_loadu_si256((const __m256i*) (bits + k-4-ws));
+    cur = _mm256_loadu_si256((const __m256i*) (bits + k-3));
+    hi = _mm256_or_si256(_mm256_sll_epi64(hi, left), _mm256_srl_epi64(lo, right));
+    _mm256_storeu_si256((__m256i*) (bits + k-3), _mm256_or_si256(cur, hi));
+  }
+  shiftOrTail(bits, k, ws, bs);
+}
+#endif
+
+int kernelSubsetSum(const int* weight, int n, int capacity)
+{
+  uint64_t *bits, lastmask;
+  int i, k, bs, nwords, best, avx2;
+
+  if(capacity <= 0)
+    return 0;
+  avx2 = kernelCurrentIsa() == KERNEL_AVX2;
+  nwords = capacity/64 + 1;
+  bits = (uint64_t*) calloc(nwords, sizeof(uint64_t));
+  if(!bits)
+    return -1;
+  // bits beyond the capacity are cleared after each shift
+  lastmask = (capacity % 64 == 63) ? ~(uint64_t) 0 : (((uint64_t) 1 << (capacity % 64 + 1)) - 1);
+  bits[0] = 1;
+  for(i = 0; i < n; i++){
+    if(weight[i] <= 0 || weight[i] > capacity)
+      continue;
+#ifdef KERNELS_X86
+    if(avx2)
+      shiftOrAvx2(bits, nwords, weight[i]);
+    else
+#endif
+      shiftOrScalar(bits, nwords, weight[i]);
+    bits[nwords-1] &= lastmask;
+    // the capacity itself is reachable: nothing to tighten
+    if(bits[nwords-1] >> (capacity % 64) & 1)
+      break;
+  }
+  (void) avx2;
+  best = 0;
+  for(k = nwords-1; k >= 0; k--){
+    if(bits[k]){
+      for(bs = 63; !(bits[k] >> bs & 1); bs--);
+      best = k*64 + bs;
+      break;
+    }
+  }
+  free(bits);
+  return best;
+}
+
+/*
+ * value DP: dp[c] = max(dp[c], dp[c-w] + p), keep bit c set when the item improves dp[c]
+ */
+
+/** capacities c..w of the item, from the last to the first */
+static void dpItemTail(double* dp, uint64_t* keep, int c, int w, double p)
+{
+  for(; c >= w; c--){
+    if(dp[c-w] + p > dp[c]){
+      dp[c] = dp[c-w] + p;
+      if(keep)
+        keep[c >> 6] |= (uint64_t) 1 << (c & 63);
+    }
+  }
+}
+
+static void dpItemScalar(double* dp, uint64_t* keep, int capacity, int w, double p)
+{
+  dpItemTail(dp, keep, capacity, w, p);
+}
+
+#ifdef KERNELS_X86
+__attribute__((target("avx2")))
+static void dpItemAvx2(double* dp, uint64_t* keep, int capacity, int w, double p)
+{
+  const __m256d vp = _mm256_set1_pd(p);
+  __m256d old, cand, gt;
+  uint64_t mask;
+  int c = capacity, base;
+
+  // block dp[c-3..c] reads dp[c-3-w..c-w]
+  for(; c-3 >= w; c -= 4){
+    base = c-3;
+    old = _mm256_loadu_pd(dp + base);
+    cand = _mm256_add_pd(_mm256_loadu_pd(dp + base - w), vp);
+    gt = _mm256_cmp_pd(cand, old, _CMP_GT_OQ);
+    mask = (uint64_t) _mm256_movemask_pd(gt);
+    if(mask){
+      _mm256_storeu_pd(dp + base, _mm256_blendv_pd(old, cand, gt));
+      if(keep){
+        keep[base >> 6] |= mask << (base & 63);
+        if((base & 63) > 60)
+          keep[(base >> 6) + 1] |= mask >> (64 - (base & 63));
+      }
+    }
+  }
+  dpItemTail(dp, keep, c, w, p);
+}
+#endif
+
+double kernelKnapsack(const int* weight, const double* profit, int n, int capacity, unsigned char* chosen)
+{
+  uint64_t *keep = NULL, *row;
+  double *dp, best, free0 = 0.0;
+  size_t rowwords;
+  int k, c, avx2;
+
+  if(chosen)
+    memset(chosen, 0, n);
+  if(capacity < 0 || n <= 0)
+    return 0.0;
+  avx2 = kernelCurrentIsa() == KERNEL_AVX2;
+  rowwords = (size_t) capacity/64 + 1;
+  dp = (double*) calloc((size_t) capacity+1, sizeof(double));
+  if(chosen)
+    keep = (uint64_t*) calloc((size_t) n * rowwords, sizeof(uint64_t));
+  if(!dp || (chosen && !keep)){
+    free(dp);
+    free(keep);
+    return -1.0;
+  }
+  for(k = 0; k < n; k++){
+    // items of weight 0 are out of the table
+    if(weight[k] <= 0 && profit[k] > 0.0){
+      free0 += profit[k];
+      if(chosen)
+        chosen[k] = 1;
+    }
+    if(weight[k] <= 0 || weight[k] > capacity)
+      continue;
+    row = keep ? keep + k*rowwords : NULL;
+#ifdef KERNELS_X86
+    if(avx2)
+      dpItemAvx2(dp, row, capacity, weight[k], profit[k]);
+    else
+#endif
+      dpItemScalar(dp, row, capacity, weight[k], profit[k]);
+  }
+  (void) avx2;
+  best = dp[capacity] + free0;
+  // walk back the decisions
+  if(chosen){
+    c = capacity;
+    for(k = n-1; k >= 0; k--){
+      if(weight[k] <= 0)
+        continue;
+      row = keep + k*rowwords;
+      if(row[c >> 6] >> (c & 63) & 1){
+        chosen[k] = 1;
+        c -= weight[k];
+      }
+    }
+  }
+  free(keep);
+  free(dp);
+  return best;
+}
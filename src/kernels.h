@@ -0,0 +1,34 @@
+/**@file   kernels.h
+ * @brief  0-1 knapsack and subset-sum kernels over the capacity dimension (no SCIP calls)
+ *
+ * Both kernels sweep the capacities from the largest to the smallest for each item, so every position reads only
+ * positions not yet updated for that item, and blocks of consecutive capacities can be updated together:
+ *
+ *    kernelSubsetSum(): bitset of the reachable sums, bits |= bits << w (64 capacities per word, 256 per AVX2 op)
+ *    kernelKnapsack():  value DP dp[c] = max(dp[c], dp[c-w] + p) with one decision bit per (item, capacity)
+ *
+ * The AVX2 versions are compiled with target attributes and selected at run time when the processor supports them;
+ * otherwise (or after kernelUseIsa(KERNEL_SCALAR)) the scalar versions are used. Both give the same results.
+ **/
+#ifndef __MOCHILA_KERNELS_H__
+#define __MOCHILA_KERNELS_H__
+
+typedef enum{
+  KERNEL_SCALAR = 0,
+  KERNEL_AVX2   = 1
+} kernelIsaT;
+
+// best instruction set supported by the processor
+kernelIsaT kernelBestIsa(void);
+// instruction set used by the kernels (at most the best one); returns the one selected
+kernelIsaT kernelUseIsa(kernelIsaT isa);
+kernelIsaT kernelCurrentIsa(void);
+const char* kernelIsaName(kernelIsaT isa);
+
+// largest sum <= capacity of a subset of the weights (weights <= 0 or > capacity are ignored); -1 if out of memory
+int kernelSubsetSum(const int* weight, int n, int capacity);
+// optimal value of the 0-1 knapsack; chosen[k] = 1 for the items of an optimal solution (chosen may be NULL), items
+// of weight <= 0 are taken if their profit is positive. Uses (capacity+1) doubles plus n*(capacity/64+1) words;
+// returns -1.0 if out of memory
+double kernelKnapsack(const int* weight, const double* profit, int n, int capacity, unsigned char* chosen);
+#endif
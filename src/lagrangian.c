@@ -0,0 +1,355 @@
+/**@file   lagrangian.c
+ * @brief  Lagrangian relaxation of the multiple knapsack problem (no SCIP calls)
+ *
+ * Each knapsack j is solved by the DP over capacities dp[c] = max(dp[c], dp[c-w_i] + p_i) of kernelKnapsack(),
+ * restricted to the items with positive profit p_i = v_i - lambda_i that fit C_j. One bit per (item, capacity) records
+ * the decisions, so the solution is recovered by walking back from dp[C_j]. If that table would have more than MAX_DP_CELLS cells, the
+ * knapsack is bounded by its Dantzig bound and its solution is the greedy by p_i/w_i (the bound stays valid).
+ * Knapsacks with the same capacity have the same subproblem, so only one of them is solved.
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "lagrangian.h"
+#include "kernels.h"
+
+#define MAX_DP_CELLS   200000000LL /* largest DP table (items x capacities) */
+#define LAGR_EPS       1e-9
+#define LAGR_MU        2.0         /* initial factor of the Polyak step */
+#define LAGR_MIN_MU    1e-3        /* stop when the factor gets smaller than this */
+#define LAGR_HALVE     10          /* halve the factor after this many iterations without improving the bound */
+
+static double wallclock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static int cmpRatioKey(const void* a, const void* b)
+{
+  const ratioKeyT* x = (const ratioKeyT*) a;
+  const ratioKeyT* y = (const ratioKeyT*) b;
+
+  if(x->ratio != y->ratio)
+    return x->ratio > y->ratio ? -1 : 1;
+  return x->item - y->item;
+}
+
+/** greedy by profit/weight with the Dantzig bound, for the knapsacks too large for the DP */
+static double solveKnapsackGreedy(lagrangianT* L, lagrWorkerT* W, int j, int ncand, unsigned char* x)
+{
+  const int *weight = L->A->weight;
+  ratioKeyT* keys = W->keys;
+  double bound = 0.0, profit;
+  long long capacity = L->C[j], greedycap = L->C[j];
+  int k, i, critical = 0;
+
+  for(k = 0; k < ncand; k++){
+    i = W->cand[k];
+    keys[k].item = i;
+    keys[k].ratio = weight[i] > 0 ? (L->A->value[i] - L->lambda[i]) / weight[i] : INFINITY;
+  }
+  qsort(keys, ncand, sizeof(ratioKeyT), cmpRatioKey);
+  for(k = 0; k < ncand; k++){
+    i = keys[k].item;
+    profit = L->A->value[i] - L->lambda[i];
+    if(!critical){
+      if(weight[i] <= capacity){
+        capacity -= weight[i];
+        bound += profit;
+      }
+      else{
+        bound += profit * capacity / weight[i];
+        critical = 1;
+      }
+    }
+    if(weight[i] <= greedycap){
+      greedycap -= weight[i];
+      x[i] = 1;
+    }
+  }
+  return bound;
+}
+
+/** solves knapsack j with the current multipliers in the work arrays of W; x[i] = 1 for the items of its solution */
+static double solveKnapsack(lagrangianT* L, lagrWorkerT* W, int j, unsigned char* x, unsigned char* greedy)
+{
+  const int *weight = L->A->weight, *value = L->A->value;
+  int *cand = W->cand, ncand = 0, i, k, capacity;
+  double best;
+  long long total = 0;
+
+  memset(x, 0, L->n);
+  *greedy = 0;
+  for(i = 0; i < L->n; i++){
+    if(value[i] - L->lambda[i] > LAGR_EPS && weight[i] <= L->C[j]){
+      cand[ncand++] = i;
+      total += weight[i];
+    }
+  }
+  // everything fits
+  if(total <= L->C[j]){
+    best = 0.0;
+    for(k = 0; k < ncand; k++){
+      x[cand[k]] = 1;
+      best += value[cand[k]] - L->lambda[cand[k]];
+    }
+    return best;
+  }
+  capacity = L->C[j];
+  if((long long) ncand * (capacity+1) > MAX_DP_CELLS){
+    *greedy = 1;
+    return solveKnapsackGreedy(L, W, j, ncand, x);
+  }
+
+  for(k = 0; k < ncand; k++){
+    i = cand[k];
+    W->cweight[k] = weight[i];
+    W->cprofit[k] = value[i] - L->lambda[i];
+  }
+  best = kernelKnapsack(W->cweight, W->cprofit, ncand, capacity, W->chosen);
+  if(best < 0.0)
+    return INFINITY;
+  for(k = 0; k < ncand; k++)
+    if(W->chosen[k])
+      x[cand[k]] = 1;
+  return best;
+}
+
+/** task w of the thread pool: knapsacks L->solved[t] taken from L->next */
+static void knapsackTask(void* arg, int w)
+{
+  lagrangianT* L = (lagrangianT*) arg;
+  int t, j;
+
+  while((t = atomic_fetch_add(&L->next, 1)) < L->nsolved){
+    j = L->solved[t];
+    L->subval[j] = solveKnapsack(L, &L->W[w], j, &L->x[(size_t) j*L->n], &L->greedy[j]);
+  }
+}
+
+/** builds a feasible solution from the knapsack solutions; returns its value */
+static long long repair(lagrangianT* L)
+{
+  const int *weight = L->A->weight, *value = L->A->value;
+  const unsigned char* xj;
+  long long total = 0;
+  int i, j, k, r;
+
+  for(i = 0; i < L->n; i++)
+    L->repaired[i] = -1;
+  for(j = 0; j < L->m; j++)
+    L->residual[j] = L->C[j];
+  // items of the knapsack solutions: each item stays in the first knapsack that has it
+  for(j = 0; j < L->m; j++){
+    r = L->rep[j];
+    xj = &L->x[(size_t) r*L->n];
+    for(i = 0; i < L->n; i++){
+      if(xj[i] && L->repaired[i] < 0 && weight[i] <= L->residual[j]){
+        L->repaired[i] = j;
+        L->residual[j] -= weight[i];
+        total += value[i];
+      }
+    }
+  }
+  // fill the free capacity by value/weight (first fit)
+  for(k = 0; k < L->n; k++){
+    i = L->A->byRatio[k];
+    if(L->repaired[i] >= 0)
+      continue;
+    for(j = 0; j < L->m; j++){
+      if(weight[i] <= L->residual[j]){
+        L->repaired[i] = j;
+        L->residual[j] -= weight[i];
+        total += value[i];
+        break;
+      }
+    }
+  }
+  return total;
+}
+
+lagrangianT* createLagrangian(instanceT* I, const itemArraysT* A, threadpoolT* pool)
+{
+  lagrangianT* L;
+  long long capacity = 0;
+  double ratio = 0.0;
+  int i, j, k, w, maxC = 0, ok;
+
+  L = (lagrangianT*) calloc(1, sizeof(lagrangianT));
+  if(!L)
+    return NULL;
+  L->n = I->n;
+  L->m = I->m;
+  L->A = A;
+  L->C = I->C;
+  L->pool = pool;
+  L->lambda = (double*) malloc(sizeof(double)*I->n);
+  L->bestLambda = (double*) malloc(sizeof(double)*I->n);
+  L->assign = (int*) malloc(sizeof(int)*I->n);
+  L->rep = (int*) malloc(sizeof(int)*I->m);
+  L->solved = (int*) malloc(sizeof(int)*I->m);
+  L->x = (unsigned char*) malloc((size_t) I->n*I->m);
+  L->subval = (double*) malloc(sizeof(double)*I->m);
+  L->greedy = (unsigned char*) malloc(I->m);
+  L->count = (int*) malloc(sizeof(int)*I->n);
+  L->residual = (int*) malloc(sizeof(int)*I->m);
+  L->repaired = (int*) malloc(sizeof(int)*I->n);
+  L->nworkers = threadpoolSize(pool);
+  L->W = (lagrWorkerT*) calloc(L->nworkers, sizeof(lagrWorkerT));
+  ok = L->lambda && L->bestLambda && L->assign && L->rep && L->solved && L->x && L->subval && L->greedy && L->count
+     && L->residual && L->repaired && L->W;
+  for(w = 0; ok && w < L->nworkers; w++){
+    L->W[w].cand = (int*) malloc(sizeof(int)*I->n);
+    L->W[w].cweight = (int*) malloc(sizeof(int)*I->n);
+    L->W[w].cprofit = (double*) malloc(sizeof(double)*I->n);
+    L->W[w].chosen = (unsigned char*) malloc(I->n);
+    L->W[w].keys = (ratioKeyT*) malloc(sizeof(ratioKeyT)*I->n);
+    ok = L->W[w].cand && L->W[w].cweight && L->W[w].cprofit && L->W[w].chosen && L->W[w].keys;
+  }
+  if(!ok){
+    freeLagrangian(L);
+    return NULL;
+  }
+
+  // knapsacks with the same capacity share the subproblem
+  L->nsolved = 0;
+  for(j = 0; j < I->m; j++){
+    L->rep[j] = j;
+    for(k = 0; k < L->nsolved; k++){
+      if(I->C[L->solved[k]] == I->C[j]){
+        L->rep[j] = L->solved[k];
+        break;
+      }
+    }
+    if(L->rep[j] == j)
+      L->solved[L->nsolved++] = j;
+    capacity += I->C[j];
+    maxC = I->C[j] > maxC ? I->C[j] : maxC;
+  }
+
+  // LP duals of the item rows: lambda_i = max(0, v_i - r*w_i), r = ratio of the critical item of the aggregated knapsack
+  for(k = 0; k < I->n; k++){
+    i = A->byRatio[k];
+    if(A->weight[i] > maxC)
+      continue;
+    if(A->weight[i] > capacity){
+      ratio = (double) A->value[i] / A->weight[i];
+      break;
+    }
+    capacity -= A->weight[i];
+  }
+  for(i = 0; i < I->n; i++){
+    L->lambda[i] = A->value[i] - ratio*A->weight[i];
+    if(L->lambda[i] < 0)
+      L->lambda[i] = 0;
+    L->bestLambda[i] = L->lambda[i];
+    L->assign[i] = -1;
+  }
+  L->bound = INFINITY;
+  L->primal = 0;
+  return L;
+}
+
+void freeLagrangian(lagrangianT* L)
+{
+  int w;
+
+  if(!L)
+    return;
+  for(w = 0; L->W && w < L->nworkers; w++){
+    free(L->W[w].cand);
+    free(L->W[w].cweight);
+    free(L->W[w].cprofit);
+    free(L->W[w].chosen);
+    free(L->W[w].keys);
+  }
+  free(L->W);
+  free(L->lambda);
+  free(L->bestLambda);
+  free(L->assign);
+  free(L->rep);
+  free(L->solved);
+  free(L->x);
+  free(L->subval);
+  free(L->greedy);
+  free(L->count);
+  free(L->residual);
+  free(L->repaired);
+  free(L);
+}
+
+double runLagrangian(lagrangianT* L, int maxiter, long long lowerbound, double timelimit)
+{
+  const unsigned char* xj;
+  double value, norm, step, mu = LAGR_MU, target, start = wallclock();
+  long long total;
+  int it, i, j, noimprove = 0;
+
+  L->iterations = 0;
+  L->nfallback = 0;
+  for(it = 0; it < maxiter; it++){
+    L->iterations++;
+    atomic_store(&L->next, 0);
+    threadpoolRun(L->pool, L->nworkers, knapsackTask, L);
+
+    // L(lambda) and subgradient g_i = 1 - sum_j x_i_j
+    value = 0.0;
+    for(i = 0; i < L->n; i++){
+      value += L->lambda[i];
+      L->count[i] = 0;
+    }
+    for(j = 0; j < L->nsolved; j++)
+      L->nfallback += L->greedy[L->solved[j]];
+    for(j = 0; j < L->m; j++){
+      value += L->subval[L->rep[j]];
+      xj = &L->x[(size_t) L->rep[j]*L->n];
+      for(i = 0; i < L->n; i++)
+        L->count[i] += xj[i];
+    }
+    if(value < L->bound - LAGR_EPS){
+      L->bound = value;
+      memcpy(L->bestLambda, L->lambda, sizeof(double)*L->n);
+      noimprove = 0;
+    }
+    else if(++noimprove >= LAGR_HALVE){
+      mu /= 2;
+      noimprove = 0;
+    }
+
+    total = repair(L);
+    if(total > L->primal){
+      L->primal = total;
+      memcpy(L->assign, L->repaired, sizeof(int)*L->n);
+    }
+
+    // the objective is integral: stop if the bound closes the gap
+    target = (double) (lowerbound > L->primal ? lowerbound : L->primal);
+    if(floor(L->bound + 1e-6) <= target || mu < LAGR_MIN_MU)
+      break;
+    if(timelimit > 0 && wallclock() - start > timelimit)
+      break;
+
+    norm = 0.0;
+    for(i = 0; i < L->n; i++){
+      // lambda_i = 0 and item i in no knapsack: its multiplier cannot decrease
+      if(L->count[i] == 0 && L->lambda[i] <= 0)
+        continue;
+      norm += (1.0 - L->count[i]) * (1.0 - L->count[i]);
+    }
+    if(norm < LAGR_EPS)
+      break;
+    step = mu * (value - target) / norm;
+    for(i = 0; i < L->n; i++){
+      L->lambda[i] -= step * (1.0 - L->count[i]);
+      if(L->lambda[i] < 0)
+        L->lambda[i] = 0;
+    }
+  }
+  return L->bound;
+}
@@ -0,0 +1,71 @@
+/**@file   lagrangian.h
+ * @brief  Lagrangian relaxation of the multiple knapsack problem (no SCIP calls)
+ *
+ * The item rows sum_j x_i_j <= 1 are relaxed with multipliers lambda_i >= 0, so the problem splits into m independent
+ * 0-1 knapsacks with profits v_i - lambda_i:
+ *
+ *    L(lambda) = sum_i lambda_i + sum_j max{ sum_i (v_i - lambda_i) x_i_j : sum_i w_i x_i_j <= C_j }
+ *
+ * L(lambda) is an upper bound of the problem for any lambda >= 0. runLagrangian() minimizes it by subgradient steps
+ * (Polyak step size), solving the m knapsacks by dynamic programming in parallel on a thread pool. At each iteration
+ * the knapsack solutions are repaired into a feasible solution (items in several knapsacks stay in the first one, and
+ * the free capacity is filled greedily by value/weight).
+ **/
+#ifndef __MOCHILA_LAGRANGIAN_H__
+#define __MOCHILA_LAGRANGIAN_H__
+
+#include <stdatomic.h>
+
+#include "problem.h"
+#include "threadpool.h"
+
+/** sort key for the greedy of the fallback: profit/weight, non-increasing */
+typedef struct{
+   double ratio;
+   int item;
+} ratioKeyT;
+
+/** work arrays of one thread, n entries each */
+typedef struct{
+   int* cand;              /**< items with positive profit that fit the knapsack */
+   int* cweight;           /**< weights of the candidates */
+   double* cprofit;        /**< profits of the candidates */
+   unsigned char* chosen;  /**< chosen[k] = 1 if candidate k is in the DP solution */
+   ratioKeyT* keys;        /**< candidates sorted by the greedy of the fallback */
+} lagrWorkerT;
+
+typedef struct{
+   int n;                  /**< quant de itens */
+   int m;                  /**< quant de mochilas */
+   const itemArraysT* A;   /**< items of the instance */
+   const int* C;           /**< capacities */
+   threadpoolT* pool;      /**< threads used to solve the knapsacks (NULL: sequential) */
+   double* lambda;         /**< current multipliers */
+   double* bestLambda;     /**< multipliers of the best bound */
+   double bound;           /**< best (smallest) Lagrangian bound found */
+   int* assign;            /**< best repaired solution: assign[i] = knapsack of item i (-1: not packed) */
+   long long primal;       /**< value of assign */
+   int iterations;         /**< iterations done by the last runLagrangian() */
+   int nsolved;            /**< knapsacks with distinct capacities (solved once per iteration) */
+   int nfallback;          /**< knapsacks bounded by Dantzig in the last run since their DP table was too large */
+   // work arrays
+   int* rep;               /**< rep[j] = knapsack with the same capacity as j that is solved for both */
+   int* solved;            /**< the nsolved knapsacks that are solved */
+   unsigned char* x;       /**< x[j*n+i] = 1 if item i is in the solution of knapsack j */
+   double* subval;         /**< optimal value of knapsack j */
+   unsigned char* greedy;  /**< greedy[j] = 1 if knapsack j was bounded by Dantzig instead of the DP */
+   int* count;             /**< count[i] = number of knapsacks with item i */
+   int* residual;          /**< residual capacities used by the repair */
+   int* repaired;          /**< solution built by the repair */
+   int nworkers;           /**< threads of the pool */
+   lagrWorkerT* W;
+   atomic_int next;        /**< next knapsack to be solved in the current iteration */
+} lagrangianT;
+
+// create the engine for the instance; the multipliers start at the LP duals of the item rows
+lagrangianT* createLagrangian(instanceT* I, const itemArraysT* A, threadpoolT* pool);
+void freeLagrangian(lagrangianT* L);
+// at most maxiter subgradient iterations and timelimit sec (<= 0: no limit); stops earlier if the bound proves that
+// max(lowerbound, primal) is optimal. Returns the best bound
+double runLagrangian(lagrangianT* L, int maxiter, long long lowerbound, double timelimit);
+#endif
@@ -0,0 +1,332 @@
+/**@file   localsearch.c
+ * @brief  local search on an assignment item -> knapsack of the multiple knapsack problem (no SCIP calls)
+ *
+ * Each neighbourhood is scanned once per pass and its improving moves are applied as they are found. For a free item,
+ * insert takes the tightest knapsack where it fits and exchange/2-for-1 take the move with the largest gain; shift takes
+ * the tightest knapsack that receives the item. The lists are updated by swapping with the last position, so the scans
+ * that remove an item from the free list look at the same position again.
+ **/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "localsearch.h"
+
+#define ALLOWED(L, i, k) ((L)->allowed[(size_t) (i)*(L)->m + (k)])
+
+localSearchT* createLocalSearch(instanceT* I, const itemArraysT* A, int* fixed, unsigned char* allowed)
+{
+  localSearchT* L;
+
+  L = (localSearchT*) calloc(1, sizeof(localSearchT));
+  if(!L)
+    return NULL;
+  L->n = I->n;
+  L->m = I->m;
+  L->A = A;
+  L->C = I->C;
+  L->ownsnode = !fixed || !allowed;
+  L->fixed = L->ownsnode ? (int*) malloc(sizeof(int)*I->n) : fixed;
+  L->allowed = L->ownsnode ? (unsigned char*) malloc((size_t) I->n*I->m) : allowed;
+  L->assign = (int*) malloc(sizeof(int)*I->n);
+  L->residual = (int*) malloc(sizeof(int)*I->m);
+  L->member = (int*) malloc(sizeof(int)*(size_t) I->n*I->m);
+  L->nmember = (int*) malloc(sizeof(int)*I->m);
+  L->freeitem = (int*) malloc(sizeof(int)*I->n);
+  L->pos = (int*) malloc(sizeof(int)*I->n);
+  if(!L->fixed || !L->allowed || !L->assign || !L->residual || !L->member || !L->nmember || !L->freeitem || !L->pos){
+    freeLocalSearch(L);
+    return NULL;
+  }
+  if(L->ownsnode)
+    localSearchResetNode(L);
+  return L;
+}
+
+void freeLocalSearch(localSearchT* L)
+{
+  if(!L)
+    return;
+  if(L->ownsnode){
+    free(L->fixed);
+    free(L->allowed);
+  }
+  free(L->assign);
+  free(L->residual);
+  free(L->member);
+  free(L->nmember);
+  free(L->freeitem);
+  free(L->pos);
+  free(L);
+}
+
+void localSearchResetNode(localSearchT* L)
+{
+  int i;
+
+  for(i = 0; i < L->n; i++)
+    L->fixed[i] = -1;
+  memset(L->allowed, 1, (size_t) L->n*L->m);
+}
+
+void localSearchResetStats(localSearchT* L)
+{
+  L->nevals = 0;
+  memset(L->napplied, 0, sizeof(L->napplied));
+}
+
+const char* localSearchMoveName(lsMoveT move)
+{
+  static const char* names[LS_NMOVES] = {"insert", "exchange", "2-for-1", "shift", "swap"};
+
+  return move >= 0 && move < LS_NMOVES ? names[move] : "?";
+}
+
+/** appends item i to the list of knapsack k (k < 0: free items) */
+static void attach(localSearchT* L, int i, int k)
+{
+  L->assign[i] = k;
+  if(k < 0){
+    L->pos[i] = L->nfree;
+    L->freeitem[L->nfree++] = i;
+  }
+  else{
+    L->pos[i] = L->nmember[k];
+    L->member[(size_t) k*L->n + L->nmember[k]++] = i;
+    L->residual[k] -= L->A->weight[i];
+    L->value += L->A->value[i];
+  }
+}
+
+/** takes item i out of its list; the last item of the list takes its position */
+static void detach(localSearchT* L, int i)
+{
+  int k = L->assign[i], p = L->pos[i], last;
+  int* list;
+
+  if(k < 0){
+    last = L->freeitem[--L->nfree];
+    L->freeitem[p] = last;
+  }
+  else{
+    list = L->member + (size_t) k*L->n;
+    last = list[--L->nmember[k]];
+    list[p] = last;
+    L->residual[k] += L->A->weight[i];
+    L->value -= L->A->value[i];
+  }
+  L->pos[last] = p;
+}
+
+static void moveItem(localSearchT* L, int i, int k)
+{
+  detach(L, i);
+  attach(L, i, k);
+}
+
+long long localSearchLoad(localSearchT* L, const int* assign)
+{
+  int i, k;
+
+  L->value = 0;
+  L->nfree = 0;
+  memcpy(L->residual, L->C, sizeof(int)*L->m);
+  for(k = 0; k < L->m; k++)
+    L->nmember[k] = 0;
+  for(i = 0; i < L->n; i++)
+    attach(L, i, assign[i]);
+  for(k = 0; k < L->m; k++)
+    if(L->residual[k] < 0)
+      return -1;
+  return L->value;
+}
+
+void localSearchStore(const localSearchT* L, int* assign, int* residual)
+{
+  memcpy(assign, L->assign, sizeof(int)*L->n);
+  if(residual)
+    memcpy(residual, L->residual, sizeof(int)*L->m);
+}
+
+/** insert: each free item goes to the tightest knapsack where it fits */
+static int insertMoves(localSearchT* L)
+{
+  const int* weight = L->A->weight;
+  int f = 0, u, k, best, applied = 0;
+
+  while(f < L->nfree){
+    u = L->freeitem[f];
+    best = -1;
+    for(k = 0; k < L->m; k++){
+      L->nevals++;
+      if(ALLOWED(L, u, k) && weight[u] <= L->residual[k] && (best < 0 || L->residual[k] < L->residual[best]))
+        best = k;
+    }
+    if(best >= 0){
+      moveItem(L, u, best);
+      applied++;
+    }
+    else
+      f++;
+  }
+  L->napplied[LS_INSERT] += applied;
+  return applied;
+}
+
+/** exchange: each free item takes the place of the packed item that gives the largest gain */
+static int exchangeMoves(localSearchT* L)
+{
+  const int *weight = L->A->weight, *value = L->A->value;
+  const int* list;
+  int f = 0, u, p, k, q, best, bestgain, applied = 0;
+
+  while(f < L->nfree){
+    u = L->freeitem[f];
+    best = -1;
+    bestgain = 0;
+    for(k = 0; k < L->m; k++){
+      if(!ALLOWED(L, u, k))
+        continue;
+      list = L->member + (size_t) k*L->n;
+      for(q = 0; q < L->nmember[k]; q++){
+        p = list[q];
+        L->nevals++;
+        if(L->fixed[p] < 0 && value[u] - value[p] > bestgain && L->residual[k] + weight[p] >= weight[u]){
+          best = p;
+          bestgain = value[u] - value[p];
+        }
+      }
+    }
+    if(best >= 0){
+      k = L->assign[best];
+      moveItem(L, best, -1);
+      moveItem(L, u, k);
+      applied++;
+    }
+    else
+      f++;
+  }
+  L->napplied[LS_EXCHANGE] += applied;
+  return applied;
+}
+
+/** 2-for-1: each free item takes the place of the two items of a knapsack that give the largest gain */
+static int twoForOneMoves(localSearchT* L)
+{
+  const int *weight = L->A->weight, *value = L->A->value;
+  const int* list;
+  int f = 0, u, p, q, a, b, k, bestp, bestq, bestgain, gain, applied = 0;
+
+  while(f < L->nfree){
+    u = L->freeitem[f];
+    bestp = bestq = -1;
+    bestgain = 0;
+    for(k = 0; k < L->m; k++){
+      if(!ALLOWED(L, u, k))
+        continue;
+      list = L->member + (size_t) k*L->n;
+      for(a = 0; a < L->nmember[k]; a++){
+        p = list[a];
+        if(L->fixed[p] >= 0 || value[p] >= value[u] - bestgain)
+          continue;
+        for(b = a+1; b < L->nmember[k]; b++){
+          q = list[b];
+          L->nevals++;
+          gain = value[u] - value[p] - value[q];
+          if(L->fixed[q] < 0 && gain > bestgain && L->residual[k] + weight[p] + weight[q] >= weight[u]){
+            bestp = p;
+            bestq = q;
+            bestgain = gain;
+          }
+        }
+      }
+    }
+    if(bestp >= 0){
+      k = L->assign[bestp];
+      moveItem(L, bestp, -1);
+      moveItem(L, bestq, -1);
+      moveItem(L, u, k);
+      applied++;
+    }
+    else
+      f++;
+  }
+  L->napplied[LS_TWOFORONE] += applied;
+  return applied;
+}
+
+/** shift: a packed item goes to the tightest knapsack where it fits, if that leaves more room in its own knapsack than
+ *  there was in the other one (the sum of the squared residuals increases by 2w(r_k + w - r_l))
+ */
+static int shiftMoves(localSearchT* L)
+{
+  const int* weight = L->A->weight;
+  int i, k, l, best, applied = 0;
+
+  for(i = 0; i < L->n; i++){
+    k = L->assign[i];
+    if(k < 0 || L->fixed[i] >= 0)
+      continue;
+    best = -1;
+    for(l = 0; l < L->m; l++){
+      if(l == k)
+        continue;
+      L->nevals++;
+      if(ALLOWED(L, i, l) && weight[i] <= L->residual[l] && (best < 0 || L->residual[l] < L->residual[best]))
+        best = l;
+    }
+    if(best >= 0 && L->residual[k] + weight[i] > L->residual[best]){
+      moveItem(L, i, best);
+      applied++;
+    }
+  }
+  L->napplied[LS_SHIFT] += applied;
+  return applied;
+}
+
+/** swap: items i (knapsack k) and j (knapsack l) trade places if both fit and, with d = w_i - w_j, the sum of the
+ *  squared residuals increases (by 2d(r_k - r_l + d))
+ */
+static int swapMoves(localSearchT* L)
+{
+  const int* weight = L->A->weight;
+  int i, j, k, l, d, applied = 0;
+
+  for(i = 0; i < L->n; i++){
+    if(L->assign[i] < 0 || L->fixed[i] >= 0)
+      continue;
+    for(j = i+1; j < L->n; j++){
+      k = L->assign[i];
+      l = L->assign[j];
+      if(l < 0 || l == k || L->fixed[j] >= 0)
+        continue;
+      L->nevals++;
+      d = weight[i] - weight[j];
+      if(d != 0 && L->residual[k] + d >= 0 && L->residual[l] - d >= 0
+         && (long long) d*(L->residual[k] - L->residual[l] + d) > 0 && ALLOWED(L, i, l) && ALLOWED(L, j, k)){
+        moveItem(L, i, l);
+        moveItem(L, j, k);
+        applied++;
+      }
+    }
+  }
+  L->napplied[LS_SWAP] += applied;
+  return applied;
+}
+
+long long localSearchRun(localSearchT* L)
+{
+  int improved;
+
+  do{
+    improved = insertMoves(L);
+    improved += exchangeMoves(L);
+    improved += twoForOneMoves(L);
+    // the value is a local optimum: make room for the next moves
+    if(!improved){
+      improved = shiftMoves(L);
+      improved += swapMoves(L);
+    }
+  }while(improved);
+  return L->value;
+}
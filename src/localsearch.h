@@ -0,0 +1,74 @@
+/**@file   localsearch.h
+ * @brief  local search on an assignment item -> knapsack of the multiple knapsack problem (no SCIP calls)
+ *
+ * The solution is kept as assign[i] (knapsack of item i, -1: not packed), the residual capacity of each knapsack, the
+ * list of the items of each knapsack and the list of the free items, so every move below is evaluated in O(1) from the
+ * residuals and the values of the items involved, and applied in O(1):
+ *
+ *    insert     a free item goes to a knapsack where it fits                      value + v(u)
+ *    exchange   a free item takes the place of a packed one (1-1)                 value + v(u) - v(p)
+ *    2-for-1    a free item takes the place of two items of the same knapsack    value + v(u) - v(p) - v(q)
+ *    shift      a packed item goes to another knapsack                            value unchanged
+ *    swap       two items of different knapsacks trade places                     value unchanged
+ *
+ * Shift and swap do not change the value; they are applied when they concentrate the free capacity (the sum of the
+ * squared residuals increases), which is what lets a later insert or exchange fit. Every move applied increases the pair
+ * (value, sum of the squared residuals) lexicographically, so localSearchRun() ends.
+ *
+ * Items with fixed[i] >= 0 never move, and a free item i only goes to a knapsack k with allowed[i*m+k] != 0; the caller
+ * sets both (localSearchResetNode() clears them: nothing fixed, everything allowed). Both arrays may belong to the caller
+ * and be shared by several searches (the GRASP has one search per thread), which only read them.
+ **/
+#ifndef __MOCHILA_LOCALSEARCH_H__
+#define __MOCHILA_LOCALSEARCH_H__
+
+#include "problem.h"
+
+typedef enum{
+  LS_INSERT    = 0,
+  LS_EXCHANGE  = 1,
+  LS_TWOFORONE = 2,
+  LS_SHIFT     = 3,
+  LS_SWAP      = 4,
+  LS_NMOVES    = 5
+} lsMoveT;
+
+typedef struct{
+   int n;                  /**< quant de itens */
+   int m;                  /**< quant de mochilas */
+   const itemArraysT* A;   /**< items of the instance */
+   const int* C;           /**< capacities */
+   // restrictions of the current node, set by the caller
+   int* fixed;             /**< fixed[i] >= 0: the item i does not move */
+   unsigned char* allowed; /**< allowed[i*m+k] = 1 if the item i may go to knapsack k */
+   int ownsnode;           /**< fixed and allowed were allocated by createLocalSearch() */
+   // current solution
+   int* assign;            /**< assign[i] = knapsack of item i (-1: not packed) */
+   int* residual;          /**< residual capacity of each knapsack */
+   long long value;        /**< value of assign */
+   int* member;            /**< member[k*n..k*n+nmember[k]-1] = items of knapsack k */
+   int* nmember;           /**< number of items in each knapsack */
+   int* freeitem;          /**< freeitem[0..nfree-1] = items not packed */
+   int nfree;
+   int* pos;               /**< position of item i in the list of its knapsack or in freeitem */
+   // statistics (accumulated until localSearchResetStats())
+   long long nevals;               /**< moves evaluated */
+   long long napplied[LS_NMOVES];  /**< moves applied of each kind */
+} localSearchT;
+
+// create the engine for the instance; fixed and allowed are arrays of the caller (n and n*m) used as the restrictions,
+// or NULL to have them allocated here (and reset to the root). NULL if out of memory
+localSearchT* createLocalSearch(instanceT* I, const itemArraysT* A, int* fixed, unsigned char* allowed);
+void freeLocalSearch(localSearchT* L);
+// restrictions of the root node: nothing fixed and every item allowed in every knapsack
+void localSearchResetNode(localSearchT* L);
+void localSearchResetStats(localSearchT* L);
+// the current solution becomes assign (assign[i] = -1: not packed). Returns its value, or -1 if it violates a
+// capacity (the search must not run then)
+long long localSearchLoad(localSearchT* L, const int* assign);
+// moves from the current solution until none of them improves it; returns the value of the local optimum
+long long localSearchRun(localSearchT* L);
+// copies the current solution to assign (and the residual capacities to residual, if not NULL)
+void localSearchStore(const localSearchT* L, int* assign, int* residual);
+const char* localSearchMoveName(lsMoveT move);
+#endif
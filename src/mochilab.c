@@ -0,0 +1,41 @@
+/**@file   mochilab.c
+ * @brief  converts text instances (.mochila) into the binary format (.mochilab) read by loadInstance()
+ *
+ * Usage:
+ *    bin/mochilab <instance files...>
+ *
+ * The binary file is written next to the text file. It keeps the size and the modification time of the
+ * text file, so loadInstance() ignores it (and rebuilds it) whenever the text file changes.
+ **/
+#include <stdio.h>
+
+#include "problem.h"
+
+int main(int argc, char** argv)
+{
+   char binname[SCIP_MAXSTRLEN];
+   instanceT* I;
+   long long srcsize, srcmtime;
+   int f, nerrors = 0;
+
+   if(argc < 2){
+      printf("\nSintaxe: %s <instance files...>\n", argv[0]);
+      return 1;
+   }
+   for(f = 1; f < argc; f++){
+      if(!instanceFileStamp(argv[f], &srcsize, &srcmtime) || !loadInstanceText(argv[f], &I)){
+         printf("\n%s: not converted\n", argv[f]);
+         nerrors++;
+         continue;
+      }
+      binaryInstanceName(argv[f], binname, SCIP_MAXSTRLEN);
+      if(saveInstanceBinary(binname, I, srcsize, srcmtime))
+         printf("%s -> %s (n=%d m=%d)\n", argv[f], binname, I->n, I->m);
+      else{
+         printf("\nProblem to write %s\n", binname);
+         nerrors++;
+      }
+      freeInstance(I);
+   }
+   return nerrors > 0;
+}
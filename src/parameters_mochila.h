@@ -17,7 +17,56 @@ typedef struct{
    int heur_round_maxdepth;
    int heur_round_freqofs;
    int heur_aleatoria;
+   int heur_diving; /* fractional diving in probing mode (heur_mydiving.c). Default = 0 */
+   int heur_div_freq;
+   int heur_div_maxdepth;
+   int heur_div_freqofs;
+   double heur_div_lpquot; /* maximal fraction of the LP iterations of the B&B spent in the dives. Default = 0.05 */
+   int heur_div_score; /* score of the fractional vars: 0 = LP value, 1 = LP value times value/weight. Default = 0 */
    int heur_grasp;   // eu que add isso. n sei se eh assim que funciona
+   double grasp_alpha; /* RCL threshold of the GRASP (1: greedy by value, 0: random). Default = 0.7 */
+   int grasp_iter; /* constructions + local search per call of the GRASP. Default = 10 */
+   double grasp_time; /* time budget (in sec) per call of the GRASP. Default = 1.0 */
+   int heur_pathrelinking; /* path relinking of the solutions of grasp and aleatoria with an elite pool. Default = 0 */
+   int pr_poolsize; /* solutions in the elite pool of the path relinking. Default = 10 */
+   int heur_lns; /* LNS: sub-MIP on k knapsacks of the incumbent, the others fixed (heur_lns.c). Default = 0 */
+   int lns_freq;
+   double lns_time; /* target solving time (in sec) of a sub-MIP of the LNS. Default = 1.0 */
+   int lns_nodes; /* node limit of a sub-MIP of the LNS. Default = 500 */
+   int heur_tabu; /* tabu search at the root (heur_tabu.c). Default = 0 */
+   int tabu_iter; /* iterations of the tabu search per call. Default = 100000 */
+   double tabu_time; /* time budget (in sec) per call of the tabu search. Default = 1.0 */
+   int heur_genetic; /* memetic genetic algorithm at the root (heur_genetic.c). Default = 0 */
+   int ga_popsize; /* members of the population of the genetic algorithm. Default = 30 */
+   int ga_gen; /* generations of the genetic algorithm per call. Default = 200 */
+   double ga_time; /* time budget (in sec) per call of the genetic algorithm. Default = 1.0 */
+   int heur_kernelsearch; /* kernel search on the root LP (heur_kernelsearch.c). Default = 0 */
+   int ks_buckets; /* buckets of the vars out of the initial kernel. Default = 10 */
+   double ks_time; /* time limit (in sec) of each sub-MIP of the kernel search. Default = 10.0 */
+   int local_search; /* local search (localsearch.c) on the solutions of myrounding and aleatoria before they are submitted. Default = 1 */
+   int seed; /* seed of the random streams of the heuristics (rng.h). Default = 1 */
+
+   // instance loading
+   int instance_cache; /* use (and create) the binary cache <instance>b of the instance file. Default = 1 */
+   int write_lp; /* name vars and constraints and write the model in knapsack.lp. Default = 0 */
+   int model_cons; /* 1: capacity rows as knapsack and item rows as set-packing constraints; 0: linear constraints. Default = 1 */
+
+   // presolver
+   int presol_mochila; /* item elimination, capacity tightening and dominance constraints (opt-in). Default = 0 */
+
+   // relaxator
+   int relax_dantzig; /* Dantzig bound at each node. 0: off, 1: with the LP, 2: alone (LP turned off). Default = 0 */
+   int relax_lagrangian; /* Lagrangian bound of the item rows at the root node. Default = 0 */
+   int lagr_iter; /* maximum number of subgradient iterations of the Lagrangian relaxation. Default = 100 */
+
+   // formulation
+   int formulation; /* 0: assignment (x_i_j); 1: Dantzig-Wolfe (packings of each knapsack, branch-and-price). Default = 0 */
+   int core; /* model only a core of items around the break item (core.c), grown while its fixings are not proven. Default = 0 */
+   int core_size; /* items in the first core (doubled at each growth). Default = 1000 */
+   int core_stream; /* core read by the streaming reader (core.c), without loading the whole instance; implies core. Default = 0 */
+
+   // parallelism
+   int threads; /* threads used by the parallel algorithms (0: one per processor). Default = 0 */
 } parametersT;
 
 int setParameters(int argc, char** argv, parametersT* Param);
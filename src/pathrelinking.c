@@ -0,0 +1,277 @@
+/**@file   pathrelinking.c
+ * @brief  elite pool and path relinking for the multiple knapsack problem (no SCIP calls)
+ *
+ * The path keeps the list of the items placed differently in the guide; an item leaves the list when it takes its
+ * place in the guide, by swapping with the last one. An item that left its knapsack is free and can only go back to
+ * the list by taking its place in the guide, so the packed items of the list may always leave and the path never gets
+ * stuck: a knapsack of the guide whose items do not fit has some item of the list, which may leave. If both ends meet
+ * the restrictions, every place in the guide is allowed; the checks of the steps only keep the path valid otherwise.
+ **/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pathrelinking.h"
+
+#define ALLOWED(L, i, k) ((L)->allowed[(size_t) (i)*(L)->m + (k)])
+
+elitePoolT* createElitePool(int n, int size, int mindist)
+{
+  elitePoolT* P;
+
+  P = (elitePoolT*) calloc(1, sizeof(elitePoolT));
+  if(!P)
+    return NULL;
+  P->n = n;
+  P->size = size < 1 ? 1 : size;
+  P->mindist = mindist;
+  P->sols = (short*) malloc(sizeof(short)*(size_t) n*P->size);
+  P->values = (long long*) malloc(sizeof(long long)*P->size);
+  P->dist = (int*) malloc(sizeof(int)*P->size);
+  if(!P->sols || !P->values || !P->dist){
+    freeElitePool(P);
+    return NULL;
+  }
+  return P;
+}
+
+void freeElitePool(elitePoolT* P)
+{
+  if(!P)
+    return;
+  free(P->sols);
+  free(P->values);
+  free(P->dist);
+  free(P);
+}
+
+int eliteDistance(const elitePoolT* P, int s, const int* assign)
+{
+  const short* sol = P->sols + (size_t) s*P->n;
+  int i, d = 0;
+
+  for(i = 0; i < P->n; i++)
+    d += sol[i] != assign[i];
+  return d;
+}
+
+int elitePoolBest(const elitePoolT* P)
+{
+  int s, best = -1;
+
+  for(s = 0; s < P->nsols; s++)
+    if(best < 0 || P->values[s] > P->values[best])
+      best = s;
+  return best;
+}
+
+int elitePoolFarthest(const elitePoolT* P, const int* assign, int skip)
+{
+  int s, d, far = -1, fardist = -1;
+
+  for(s = 0; s < P->nsols; s++){
+    if(s == skip)
+      continue;
+    d = eliteDistance(P, s, assign);
+    if(d > fardist){
+      far = s;
+      fardist = d;
+    }
+  }
+  return far;
+}
+
+int elitePoolAdd(elitePoolT* P, const int* assign, long long value)
+{
+  short* sol;
+  int s, i, best, target, mindist = P->n + 1;
+
+  for(s = 0; s < P->nsols; s++){
+    P->dist[s] = eliteDistance(P, s, assign);
+    if(P->dist[s] < mindist)
+      mindist = P->dist[s];
+  }
+  best = elitePoolBest(P);
+  // already in the pool, or too close to a member and not the best
+  if(mindist == 0 || (best >= 0 && value <= P->values[best] && mindist < P->mindist)){
+    P->nrejected++;
+    return 0;
+  }
+  if(P->nsols < P->size)
+    target = P->nsols++;
+  else{
+    // the member closest to the solution among the worse ones
+    target = -1;
+    for(s = 0; s < P->nsols; s++)
+      if(P->values[s] < value && (target < 0 || P->dist[s] < P->dist[target]
+                                  || (P->dist[s] == P->dist[target] && P->values[s] < P->values[target])))
+        target = s;
+    if(target < 0){
+      P->nrejected++;
+      return 0;
+    }
+  }
+  sol = P->sols + (size_t) target*P->n;
+  for(i = 0; i < P->n; i++)
+    sol[i] = (short) assign[i];
+  P->values[target] = value;
+  P->nadded++;
+  return 1;
+}
+
+int elitePoolPurge(elitePoolT* P, int m, const int* fixed, const unsigned char* allowed)
+{
+  const short* sol;
+  int s, i, npurged = 0;
+
+  for(s = 0; s < P->nsols; ){
+    sol = P->sols + (size_t) s*P->n;
+    for(i = 0; i < P->n; i++)
+      if((fixed[i] >= 0 && sol[i] != fixed[i]) || (sol[i] >= 0 && !allowed[(size_t) i*m + sol[i]]))
+        break;
+    if(i == P->n){
+      s++;
+      continue;
+    }
+    // the last member takes its place
+    P->nsols--;
+    if(s < P->nsols){
+      memcpy(P->sols + (size_t) s*P->n, P->sols + (size_t) P->nsols*P->n, sizeof(short)*P->n);
+      P->values[s] = P->values[P->nsols];
+    }
+    npurged++;
+  }
+  P->npurged += npurged;
+  return npurged;
+}
+
+relinkT* createRelink(instanceT* I, const itemArraysT* A)
+{
+  relinkT* R;
+
+  R = (relinkT*) calloc(1, sizeof(relinkT));
+  if(!R)
+    return NULL;
+  R->n = I->n;
+  R->m = I->m;
+  R->A = A;
+  R->C = I->C;
+  R->cur = (int*) malloc(sizeof(int)*I->n);
+  R->residual = (int*) malloc(sizeof(int)*I->m);
+  R->diff = (int*) malloc(sizeof(int)*I->n);
+  R->left = (unsigned char*) malloc(I->n);
+  R->best = (int*) malloc(sizeof(int)*I->n);
+  R->LS = createLocalSearch(I, A, NULL, NULL);
+  if(!R->cur || !R->residual || !R->diff || !R->left || !R->best || !R->LS){
+    freeRelink(R);
+    return NULL;
+  }
+  R->bestvalue = -1;
+  return R;
+}
+
+void freeRelink(relinkT* R)
+{
+  if(!R)
+    return;
+  free(R->cur);
+  free(R->residual);
+  free(R->diff);
+  free(R->left);
+  free(R->best);
+  freeLocalSearch(R->LS);
+  free(R);
+}
+
+int relinkAllowed(const relinkT* R, const int* assign)
+{
+  const localSearchT* L = R->LS;
+  int i;
+
+  for(i = 0; i < R->n; i++)
+    if((L->fixed[i] >= 0 && assign[i] != L->fixed[i]) || (assign[i] >= 0 && !ALLOWED(L, i, assign[i])))
+      return 0;
+  return 1;
+}
+
+long long relinkPath(relinkT* R, const int* from, const short* guide)
+{
+  const int *weight = R->A->weight, *val = R->A->value;
+  int *cur = R->cur, *residual = R->residual;
+  int i, g, k, d, ndiff, step, stepleave, leave;
+  long long value = 0, delta, stepdelta;
+
+  memcpy(cur, from, sizeof(int)*R->n);
+  memcpy(residual, R->C, sizeof(int)*R->m);
+  memset(R->left, 0, R->n);
+  ndiff = 0;
+  for(i = 0; i < R->n; i++){
+    if(cur[i] >= 0){
+      residual[cur[i]] -= weight[i];
+      value += val[i];
+    }
+    if(cur[i] != guide[i])
+      R->diff[ndiff++] = i;
+  }
+  R->bestvalue = -1;
+  while(ndiff > 0){
+    // the step of largest value; ties to the steps that take an item to its place in the guide
+    step = -1;
+    stepleave = 0;
+    stepdelta = 0;
+    for(d = 0; d < ndiff; d++){
+      i = R->diff[d];
+      g = guide[i];
+      k = cur[i];
+      // a fixed item does not move
+      if(R->LS->fixed[i] >= 0)
+        continue;
+      if(g < 0 || (weight[i] <= residual[g] && ALLOWED(R->LS, i, g))){
+        delta = (g < 0 ? -val[i] : 0) + (k < 0 && g >= 0 ? val[i] : 0);
+        leave = 0;
+      }
+      else if(k >= 0 && !R->left[i]){
+        delta = -val[i];
+        leave = 1;
+      }
+      else
+        continue;
+      if(step < 0 || delta > stepdelta || (delta == stepdelta && stepleave && !leave)){
+        step = d;
+        stepdelta = delta;
+        stepleave = leave;
+      }
+    }
+    if(step < 0)
+      break;
+    i = R->diff[step];
+    k = cur[i];
+    if(k >= 0){
+      residual[k] += weight[i];
+      value -= val[i];
+    }
+    if(stepleave){
+      cur[i] = -1;
+      R->left[i] = 1;
+    }
+    else{
+      cur[i] = guide[i];
+      if(cur[i] >= 0){
+        residual[cur[i]] -= weight[i];
+        value += val[i];
+      }
+      R->diff[step] = R->diff[--ndiff];
+    }
+    R->nsteps++;
+    // the guide itself is not a new solution
+    if(ndiff > 0 && value > R->bestvalue){
+      R->bestvalue = value;
+      memcpy(R->best, cur, sizeof(int)*R->n);
+    }
+  }
+  if(R->bestvalue >= 0 && localSearchLoad(R->LS, R->best) >= 0){
+    R->bestvalue = localSearchRun(R->LS);
+    localSearchStore(R->LS, R->best, NULL);
+  }
+  return R->bestvalue;
+}
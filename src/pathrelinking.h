@@ -0,0 +1,79 @@
+/**@file   pathrelinking.h
+ * @brief  elite pool and path relinking for the multiple knapsack problem (no SCIP calls)
+ *
+ * The elite pool keeps up to size solutions as compact assignment vectors (one short per item: its knapsack, -1 if not
+ * packed). The distance between two solutions is the Hamming distance of their vectors, the number of items placed
+ * differently. A solution enters the pool if it is not already there and
+ *
+ *    - the pool is not full and the solution is the best one or at distance >= mindist from every member, or
+ *    - the pool is full, the solution is better than the worst member and it is the best one or at distance >= mindist
+ *      from every member; it replaces the member closest to it among those worse than it.
+ *
+ * relinkPath() walks from a solution (the initial one) to a pool member (the guide). At each step one of the items
+ * placed differently takes its place in the guide, if it fits there, or leaves its knapsack (once), choosing the step of
+ * largest value; so every step costs O(number of items still different) and the path ends at the guide after at most
+ * two steps per item. The best solution of the path, other than its ends, is improved by the local search of
+ * localsearch.c.
+ *
+ * The restrictions of the local search (R->LS->fixed and R->LS->allowed, set by the caller) also hold on the path: a
+ * fixed item never moves and an item only takes its place in the guide if it is allowed there. The caller drops the
+ * members that violate them (elitePoolPurge()) and only relinks from solutions that meet them (relinkAllowed()).
+ **/
+#ifndef __MOCHILA_PATHRELINKING_H__
+#define __MOCHILA_PATHRELINKING_H__
+
+#include "problem.h"
+#include "localsearch.h"
+
+typedef struct{
+   int n;                  /**< quant de itens */
+   int size;               /**< maximum number of solutions */
+   int mindist;            /**< minimum Hamming distance between a new solution and the members (if not the best) */
+   int nsols;              /**< solutions in the pool */
+   short* sols;            /**< sols[s*n+i] = knapsack of the item i in the solution s (-1: not packed) */
+   long long* values;      /**< value of each solution */
+   int* dist;              /**< work array: distance of each member to the solution offered */
+   long long nadded;       /**< solutions stored */
+   long long nrejected;    /**< solutions rejected */
+   long long npurged;      /**< members dropped by elitePoolPurge() */
+} elitePoolT;
+
+typedef struct{
+   int n;                  /**< quant de itens */
+   int m;                  /**< quant de mochilas */
+   const itemArraysT* A;   /**< items of the instance */
+   const int* C;           /**< capacities */
+   int* cur;               /**< current solution of the path */
+   int* residual;          /**< residual capacities of cur */
+   int* diff;              /**< items of cur placed differently in the guide */
+   unsigned char* left;    /**< left[i] = 1 if the item i already left its knapsack in this path */
+   int* best;              /**< best solution of the last path (after the local search) */
+   long long bestvalue;    /**< value of best (-1: none) */
+   localSearchT* LS;       /**< improvement of the best solution of the path (its restrictions are set by the caller) */
+   long long nsteps;       /**< steps walked by all paths */
+} relinkT;
+
+// create a pool for size solutions of n items; NULL if out of memory
+elitePoolT* createElitePool(int n, int size, int mindist);
+void freeElitePool(elitePoolT* P);
+// Hamming distance between the member s and assign
+int eliteDistance(const elitePoolT* P, int s, const int* assign);
+// offer the solution assign of the given value to the pool; returns 1 if it was stored
+int elitePoolAdd(elitePoolT* P, const int* assign, long long value);
+// index of the best member (-1: empty pool)
+int elitePoolBest(const elitePoolT* P);
+// index of the member farthest from assign, other than skip (-1: none)
+int elitePoolFarthest(const elitePoolT* P, const int* assign, int skip);
+// drops the members that move an item with fixed[i] >= 0 or put an item i in a knapsack k with allowed[i*m+k] == 0;
+// returns the number of members dropped
+int elitePoolPurge(elitePoolT* P, int m, const int* fixed, const unsigned char* allowed);
+
+// create the relinking engine for the instance; NULL if out of memory
+relinkT* createRelink(instanceT* I, const itemArraysT* A);
+void freeRelink(relinkT* R);
+// path from the feasible solution from to the guide (a member of a pool); the best solution of the path, improved by
+// the local search, is kept in R->best. Returns its value, or -1 if the path has no solution besides its ends
+long long relinkPath(relinkT* R, const int* from, const short* guide);
+// 1 if the solution assign meets the restrictions of R->LS
+int relinkAllowed(const relinkT* R, const int* assign);
+#endif
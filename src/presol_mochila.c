@@ -0,0 +1,325 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   presol_mochila.c
+ * @brief  presolver for the multiple knapsack problem
+ *
+ * Works on the instance (instanceT) held in the problem data:
+ *  - x_i_j is fixed to 0 if item i does not fit knapsack j (w_i > C_j); items that fit no knapsack end up with all
+ *    their variables fixed to 0;
+ *  - each capacity C_j is tightened to the largest subset sum of the items that fit knapsack j, since no feasible
+ *    load can be larger than that. The instance is updated too, so the heuristics see the tightened capacities;
+ *  - item a is dominated by item b if w_b <= w_a and v_b >= v_a (b comes before a in the order by weight). Then some
+ *    optimal solution packs b whenever it packs a, so sum_j x_a_j - sum_j x_b_j <= 0 is added for one dominator b
+ *    of each dominated item a (the one with the largest value among the lighter items). These rows only keep an
+ *    optimal solution, they are not valid for every feasible one, so they are not checked (check = FALSE): they cut
+ *    the LP and the tree, but the solutions of the heuristics and of the sub-MIPs, that ignore them, are accepted.
+ *
+ * The presolver runs once, before the root LP (configScip() turns the other presolvers off).
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <string.h>
+
+#include "probdata_mochila.h"
+#include "parameters_mochila.h"
+#include "presol_mochila.h"
+
+/* configuracao do presolver */
+#define PRESOL_NAME            "mochila"
+#define PRESOL_DESC            "multiple knapsack presolver: item elimination, capacity tightening and dominance"
+#define PRESOL_PRIORITY        9000000 /**< priority of the presolver (>= 0: before, < 0: after constraint handlers) */
+#define PRESOL_MAXROUNDS       1       /**< maximal number of presolving rounds the presolver participates in (-1: no limit) */
+#define PRESOL_TIMING          SCIP_PRESOLTIMING_FAST /* timing of the presolver (fast, medium, or exhaustive) */
+
+#define DEFAULT_DOMINANCE      TRUE    /**< add the dominance constraints? */
+
+/*
+ * Data structures
+ */
+
+/** presolver data */
+struct SCIP_PresolData
+{
+   SCIP_Bool             dominance;          /**< add the dominance constraints? */
+   int                   nelimvars;          /**< number of x_i_j fixed to 0 since w_i > C_j */
+   int                   nnowhere;           /**< number of items that fit no knapsack */
+   int                   ntightened;         /**< number of tightened capacities */
+   int                   ndominance;         /**< number of dominance constraints added */
+};
+
+/*
+ * Local methods
+ */
+
+/** changes the capacity of knapsack j; a knapsack constraint cannot change its capacity after the problem stage,
+ *  so it is replaced by a copy with the new capacity */
+static
+SCIP_RETCODE changeCapacity(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_PROBDATA*        probdata,           /**< problem data */
+   int                   j,                  /**< knapsack */
+   int                   capacity,           /**< new capacity */
+   int*                  naddconss,          /**< pointer to count the added constraints */
+   int*                  ndelconss,          /**< pointer to count the deleted constraints */
+   int*                  nchgsides           /**< pointer to count the changed sides */
+   )
+{
+   SCIP_CONS* cons;
+   SCIP_CONS* newcons;
+   const char* hdlrname;
+
+   // conss[0..m-1] are the capacity rows
+   cons = SCIPprobdataGetConss(probdata)[j];
+   hdlrname = SCIPconshdlrGetName(SCIPconsGetHdlr(cons));
+
+   if( strcmp(hdlrname, "knapsack") == 0 )
+   {
+      SCIP_CALL( SCIPcreateConsBasicKnapsack(scip, &newcons, SCIPconsGetName(cons), SCIPgetNVarsKnapsack(scip, cons),
+            SCIPgetVarsKnapsack(scip, cons), SCIPgetWeightsKnapsack(scip, cons), (SCIP_Longint) capacity) );
+      SCIP_CALL( SCIPaddCons(scip, newcons) );
+      SCIP_CALL( SCIPdelCons(scip, cons) );
+      SCIP_CALL( SCIPprobdataSetCons(scip, probdata, j, newcons) );
+      SCIP_CALL( SCIPreleaseCons(scip, &newcons) );
+      (*naddconss)++;
+      (*ndelconss)++;
+   }
+   else
+   {
+      assert(strcmp(hdlrname, "linear") == 0);
+      SCIP_CALL( SCIPchgRhsLinear(scip, cons, (SCIP_Real) capacity) );
+      (*nchgsides)++;
+   }
+
+   return SCIP_OKAY;
+}
+
+/*
+ * Callback methods of presolver
+ */
+
+/** copy method for presolver plugins (called when SCIP copies plugins) */
+static
+SCIP_DECL_PRESOLCOPY(presolCopyMochila)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+/** destructor of presolver to free user data (called when SCIP is exiting) */
+static
+SCIP_DECL_PRESOLFREE(presolFreeMochila)
+{  /*lint --e{715}*/
+   SCIP_PRESOLDATA* presoldata;
+
+   presoldata = SCIPpresolGetData(presol);
+   assert(presoldata != NULL);
+
+   SCIPfreeBlockMemory(scip, &presoldata);
+   SCIPpresolSetData(presol, NULL);
+
+   return SCIP_OKAY;
+}
+
+/** initialization method of presolver (called after problem was transformed) */
+static
+SCIP_DECL_PRESOLINIT(presolInitMochila)
+{  /*lint --e{715}*/
+   SCIP_PRESOLDATA* presoldata;
+
+   presoldata = SCIPpresolGetData(presol);
+   assert(presoldata != NULL);
+
+   presoldata->nelimvars = 0;
+   presoldata->nnowhere = 0;
+   presoldata->ntightened = 0;
+   presoldata->ndominance = 0;
+
+   return SCIP_OKAY;
+}
+
+/** execution method of presolver */
+static
+SCIP_DECL_PRESOLEXEC(presolExecMochila)
+{  /*lint --e{715}*/
+   SCIP_PRESOLDATA* presoldata;
+   SCIP_PROBDATA* probdata;
+   SCIP_VAR* var;
+   SCIP_VAR** domvars;
+   SCIP_Real* domvals;
+   SCIP_CONS* cons;
+   SCIP_Bool infeasible;
+   SCIP_Bool fixed;
+   instanceT* I;
+   itemArraysT* items;
+   int* fitweights;
+   char name[SCIP_MAXSTRLEN];
+   int i, j, k, a, best, nfit, capacity, maxC;
+
+   assert(result != NULL);
+   *result = SCIP_DIDNOTRUN;
+
+   presoldata = SCIPpresolGetData(presol);
+   assert(presoldata != NULL);
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+   I = SCIPprobdataGetInstance(probdata);
+   items = SCIPprobdataGetItems(probdata);
+
+   *result = SCIP_DIDNOTFIND;
+
+   // 1. x_i_j = 0 if item i does not fit knapsack j
+   maxC = 0;
+   for( j = 0; j < I->m; j++ )
+   {
+      maxC = MAX(maxC, I->C[j]);
+      for( i = 0; i < I->n; i++ )
+      {
+         if( items->weight[i] <= I->C[j] )
+            continue;
+         var = SCIPprobdataGetVar(probdata, i, j);
+         if( SCIPvarGetUbGlobal(var) < 0.5 )
+            continue;
+         SCIP_CALL( SCIPfixVar(scip, var, 0.0, &infeasible, &fixed) );
+         if( infeasible )
+         {
+            *result = SCIP_CUTOFF;
+            return SCIP_OKAY;
+         }
+         if( fixed )
+         {
+            (*nfixedvars)++;
+            presoldata->nelimvars++;
+            *result = SCIP_SUCCESS;
+         }
+      }
+   }
+   // items that fit no knapsack: all their variables were fixed above
+   for( i = 0; i < I->n; i++ )
+   {
+      if( items->weight[i] > maxC )
+         presoldata->nnowhere++;
+   }
+
+   // 2. C_j = largest subset sum of the items that fit knapsack j
+   SCIP_CALL( SCIPallocBufferArray(scip, &fitweights, I->n) );
+   for( j = 0; j < I->m; j++ )
+   {
+      nfit = 0;
+      for( i = 0; i < I->n; i++ )
+      {
+         if( items->weight[i] <= I->C[j] )
+            fitweights[nfit++] = items->weight[i];
+      }
+      capacity = maxSubsetSum(fitweights, nfit, I->C[j]);
+      if( capacity < 0 || capacity >= I->C[j] )
+         continue;
+      SCIP_CALL( changeCapacity(scip, probdata, j, capacity, naddconss, ndelconss, nchgsides) );
+      // valid for every feasible solution, so the instance (shared with the original problem) can keep it
+      I->C[j] = capacity;
+      presoldata->ntightened++;
+      *result = SCIP_SUCCESS;
+   }
+   SCIPfreeBufferArray(scip, &fitweights);
+
+   // 3. dominance: best = item with the largest value among the items before a in the order by weight
+   if( presoldata->dominance )
+   {
+      SCIP_CALL( SCIPallocBufferArray(scip, &domvars, 2*I->m) );
+      SCIP_CALL( SCIPallocBufferArray(scip, &domvals, 2*I->m) );
+      name[0] = '\0';
+      best = -1;
+      for( k = 0; k < I->n; k++ )
+      {
+         a = items->byWeight[k];
+         if( best >= 0 && items->value[best] >= items->value[a] && items->weight[a] <= maxC )
+         {
+            // sum_j x_a_j - sum_j x_best_j <= 0
+            for( j = 0; j < I->m; j++ )
+            {
+               domvars[j] = SCIPprobdataGetVar(probdata, a, j);
+               domvals[j] = 1.0;
+               domvars[I->m+j] = SCIPprobdataGetVar(probdata, best, j);
+               domvals[I->m+j] = -1.0;
+            }
+#ifdef DEBUG_PRESOL
+            (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "dominance_%d_%d", a, best);
+#endif
+            // optimality cut: separated, enforced and propagated, but not checked on the solutions
+            SCIP_CALL( SCIPcreateConsLinear(scip, &cons, name, 2*I->m, domvars, domvals, -SCIPinfinity(scip), 0.0,
+                  TRUE, TRUE, TRUE, FALSE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE) );
+            SCIP_CALL( SCIPaddCons(scip, cons) );
+            SCIP_CALL( SCIPreleaseCons(scip, &cons) );
+            (*naddconss)++;
+            presoldata->ndominance++;
+            *result = SCIP_SUCCESS;
+         }
+         if( best < 0 || items->value[a] > items->value[best] )
+            best = a;
+      }
+      SCIPfreeBufferArray(scip, &domvals);
+      SCIPfreeBufferArray(scip, &domvars);
+   }
+
+#ifdef DEBUG_PRESOL
+   printf("\nPresolver %s: %d vars fixed (item does not fit), %d items fit no knapsack, %d capacities tightened, %d dominance constraints\n",
+      PRESOL_NAME, presoldata->nelimvars, presoldata->nnowhere, presoldata->ntightened, presoldata->ndominance);
+#endif
+
+   return SCIP_OKAY;
+}
+
+
+/*
+ * presolver specific interface methods
+ */
+
+/** creates the mochila presolver and includes it in SCIP */
+SCIP_RETCODE SCIPincludePresolMochila(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_PRESOLDATA* presoldata;
+   SCIP_PRESOL* presol;
+
+   /* create mochila presolver data */
+   SCIP_CALL( SCIPallocBlockMemory(scip, &presoldata) );
+   presoldata->dominance = DEFAULT_DOMINANCE;
+
+   presol = NULL;
+
+   /* use SCIPincludePresolBasic() plus setter functions if you want to set callbacks one-by-one and your code should
+    * compile independent of new callbacks being added in future SCIP versions
+    */
+   SCIP_CALL( SCIPincludePresolBasic(scip, &presol, PRESOL_NAME, PRESOL_DESC, PRESOL_PRIORITY, PRESOL_MAXROUNDS,
+         PRESOL_TIMING, presolExecMochila, presoldata) );
+
+   assert(presol != NULL);
+
+   /* set non fundamental callbacks via setter functions */
+   SCIP_CALL( SCIPsetPresolCopy(scip, presol, presolCopyMochila) );
+   SCIP_CALL( SCIPsetPresolFree(scip, presol, presolFreeMochila) );
+   SCIP_CALL( SCIPsetPresolInit(scip, presol, presolInitMochila) );
+
+   /* add mochila presolver parameters */
+   SCIP_CALL( SCIPaddBoolParam(scip, "presolving/" PRESOL_NAME "/dominance",
+         "add the constraints sum_j x_a_j <= sum_j x_b_j for items a dominated by b?",
+         &presoldata->dominance, FALSE, DEFAULT_DOMINANCE, NULL, NULL) );
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,770 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   pricer_mochila.c
+ * @brief  pricer of the packings of the Dantzig-Wolfe formulation (one 0-1 knapsack per knapsack)
+ *
+ * With the duals pi of the rows of the items and mu_j of the row of knapsack j, the reduced cost of a packing p of
+ * knapsack j in the transformed (minimization) problem is -(sum_{i in p} (v_i + pi_i) + mu_j). So the best packing of
+ * each knapsack is a 0-1 knapsack with profits v_i + pi_i, and it is added if its value plus mu_j is positive. In the
+ * Farkas pricing, the profits are the Farkas multipliers of the rows.
+ *
+ * The samediff constraints of the current node (see cons_samediff.c) change the knapsack of j:
+ *  - SAME on two items: they are merged in a single item;
+ *  - SAME on knapsack j and item i: item i is forced in the packing; SAME on other knapsack and item i: item i is out;
+ *  - DIFFER on knapsack j and item i: item i is out;
+ *  - DIFFER on two items: they are in conflict.
+ * Without conflicts, the knapsack is solved by dynamic programming over the capacity (O(items*capacity)); otherwise
+ * (or if the table would be too large) by a depth-first branch-and-bound with the Dantzig bound that skips items in
+ * conflict with the chosen ones. If the branch-and-bound hits its node limit and no packing was found, the pricer
+ * returns SCIP_DIDNOTRUN, since the LP value is not a valid bound.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <string.h>
+#include <limits.h>
+
+#include "scip/cons_linear.h"
+#include "scip/cons_setppc.h"
+
+#include "cons_samediff.h"
+#include "kernels.h"
+#include "probdata_mochila.h"
+#include "vardata_mochila.h"
+#include "pricer_mochila.h"
+
+//#define DEBUG_PRICER 1
+
+/**@name Pricer properties
+ *
+ * @{
+ */
+
+#define PRICER_NAME            "mochila"
+#define PRICER_DESC            "pricer of the packings of each knapsack"
+#define PRICER_PRIORITY        0
+#define PRICER_DELAY           TRUE     /* only call pricer if all problem variables have non-negative reduced costs */
+
+#define MAX_DP_CELLS           200000000LL /**< larger dynamic programming tables (items * capacity) use branch-and-bound */
+#define MAX_BB_NODES           1000000LL   /**< node limit of the branch-and-bound of a knapsack */
+
+#define ITEM_FORCED            1
+#define ITEM_EXCLUDED          2
+
+/**@} */
+
+
+/*
+ * Data structures
+ */
+
+/** variable pricer data */
+struct SCIP_PricerData
+{
+   SCIP_CONSHDLR*        conshdlr;           /**< samediff constraint handler */
+   int                   nitems;             /**< size of the arrays */
+   SCIP_Real*            profit;             /**< profit of each item in the knapsack being priced */
+   int*                  parent;             /**< union-find of the items merged by SAME constraints */
+   unsigned char*        flag;               /**< ITEM_FORCED/ITEM_EXCLUDED of each item (of the group, for its root) */
+   SCIP_Longint*         gweight;            /**< weight of the group of each root */
+   SCIP_Real*            gprofit;            /**< profit of the group of each root */
+   int*                  candpos;            /**< index of a root among the candidates (-1: not a candidate) */
+   int*                  cand;               /**< roots of the candidate groups */
+   unsigned char*        chosen;             /**< chosen[k] = 1 if candidate k is in the best packing */
+   int*                  packing;            /**< items of the new packing */
+   SCIP_Longint          nrounds;            /**< number of pricing rounds */
+   SCIP_Longint          npackings;          /**< number of packings added */
+   SCIP_Longint          ndp;                /**< knapsacks solved by dynamic programming */
+   SCIP_Longint          nbb;                /**< knapsacks solved by branch-and-bound */
+   SCIP_Longint          ninexact;           /**< knapsacks whose branch-and-bound hit the node limit */
+};
+
+/** state of the branch-and-bound of a knapsack with conflicts */
+typedef struct{
+   int                   ncand;              /**< number of candidates */
+   const int*            order;              /**< candidates by profit/weight, non-increasing */
+   const SCIP_Longint*   weight;             /**< weight of each candidate */
+   const SCIP_Real*      profit;             /**< profit of each candidate */
+   const int*            adjbeg;             /**< conflicts of candidate k: adj[adjbeg[k]..adjbeg[k+1]-1] */
+   const int*            adj;
+   SCIP_Longint          capacity;
+   int*                  blocked;            /**< number of chosen candidates in conflict with each candidate */
+   unsigned char*        current;            /**< candidates chosen in the current path */
+   unsigned char*        best;               /**< candidates of the best packing */
+   SCIP_Real             bestprofit;
+   SCIP_Longint          nodes;
+   SCIP_Bool             aborted;            /**< node limit reached */
+} bbT;
+
+
+/**@name Local methods
+ *
+ * @{
+ */
+
+/** returns the dual value (or the Farkas multiplier) of a row of the formulation (linear or setppc) */
+static
+SCIP_Real consGetDual(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONS*            cons,               /**< row */
+   SCIP_Bool             farkas              /**< Farkas multiplier? */
+   )
+{
+   if( strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(cons)), "setppc") == 0 )
+      return farkas ? SCIPgetDualfarkasSetppc(scip, cons) : SCIPgetDualsolSetppc(scip, cons);
+   return farkas ? SCIPgetDualfarkasLinear(scip, cons) : SCIPgetDualsolLinear(scip, cons);
+}
+
+/** root of the group of item i (with path halving) */
+static
+int findRoot(
+   int*                  parent,             /**< union-find */
+   int                   i                   /**< item */
+   )
+{
+   while( parent[i] != i )
+   {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+   }
+   return i;
+}
+
+/** 0-1 knapsack without conflicts by dynamic programming (kernelKnapsack()); returns the best profit and the chosen
+ *  candidates
+ */
+static
+SCIP_RETCODE solveKnapsackDP(
+   SCIP*                 scip,               /**< SCIP data structure */
+   int                   ncand,              /**< number of candidates */
+   const SCIP_Longint*   weight,             /**< weight of each candidate */
+   const SCIP_Real*      profit,             /**< profit of each candidate */
+   SCIP_Longint          capacity,           /**< capacity */
+   unsigned char*        chosen,             /**< chosen[k] = 1 if candidate k is in the best packing */
+   SCIP_Real*            bestprofit          /**< pointer to store the best profit */
+   )
+{
+   int* intweight;
+   int k;
+
+   assert(capacity <= INT_MAX);
+
+   SCIP_CALL( SCIPallocBufferArray(scip, &intweight, ncand) );
+   for( k = 0; k < ncand; k++ )
+      intweight[k] = (int) weight[k];
+   *bestprofit = kernelKnapsack(intweight, profit, ncand, (int) capacity, chosen);
+   SCIPfreeBufferArray(scip, &intweight);
+   if( *bestprofit < 0.0 )
+      return SCIP_NOMEMORY;
+
+   return SCIP_OKAY;
+}
+
+/** depth-first branch-and-bound from the k-th candidate of the order */
+static
+void bbSearch(
+   bbT*                  bb,                 /**< state of the search */
+   int                   k,                  /**< position in the order */
+   SCIP_Longint          weight,             /**< weight of the current path */
+   SCIP_Real             profit              /**< profit of the current path */
+   )
+{
+   SCIP_Longint residual;
+   SCIP_Real bound;
+   int t, o, a;
+
+   if( ++bb->nodes > MAX_BB_NODES )
+   {
+      bb->aborted = TRUE;
+      return;
+   }
+   if( profit > bb->bestprofit + 1e-9 )
+   {
+      bb->bestprofit = profit;
+      memcpy(bb->best, bb->current, bb->ncand);
+   }
+   if( k == bb->ncand )
+      return;
+
+   // Dantzig bound of the remaining candidates (ignoring their conflicts)
+   bound = profit;
+   residual = bb->capacity - weight;
+   for( t = k; t < bb->ncand; t++ )
+   {
+      o = bb->order[t];
+      if( bb->blocked[o] )
+         continue;
+      if( bb->weight[o] <= residual )
+      {
+         residual -= bb->weight[o];
+         bound += bb->profit[o];
+      }
+      else
+      {
+         bound += bb->profit[o] * residual / bb->weight[o];
+         break;
+      }
+   }
+   if( bound <= bb->bestprofit + 1e-9 )
+      return;
+
+   o = bb->order[k];
+   if( !bb->blocked[o] && bb->weight[o] <= bb->capacity - weight )
+   {
+      bb->current[o] = 1;
+      for( a = bb->adjbeg[o]; a < bb->adjbeg[o+1]; a++ )
+         bb->blocked[bb->adj[a]]++;
+      bbSearch(bb, k + 1, weight + bb->weight[o], profit + bb->profit[o]);
+      for( a = bb->adjbeg[o]; a < bb->adjbeg[o+1]; a++ )
+         bb->blocked[bb->adj[a]]--;
+      bb->current[o] = 0;
+      if( bb->aborted )
+         return;
+   }
+   bbSearch(bb, k + 1, weight, profit);
+}
+
+/** 0-1 knapsack with conflicts by branch-and-bound; returns the best profit and the chosen candidates */
+static
+SCIP_RETCODE solveKnapsackBB(
+   SCIP*                 scip,               /**< SCIP data structure */
+   int                   ncand,              /**< number of candidates */
+   const SCIP_Longint*   weight,             /**< weight of each candidate */
+   const SCIP_Real*      profit,             /**< profit of each candidate */
+   SCIP_Longint          capacity,           /**< capacity */
+   const int*            confl,              /**< conflicts: candidates confl[2c] and confl[2c+1] */
+   int                   nconfl,             /**< number of conflicts */
+   unsigned char*        chosen,             /**< chosen[k] = 1 if candidate k is in the best packing */
+   SCIP_Real*            bestprofit,         /**< pointer to store the best profit */
+   SCIP_Bool*            exact               /**< pointer to store whether the packing is optimal */
+   )
+{
+   bbT bb;
+   SCIP_Real* ratio;
+   int* order;
+   int* adjbeg;
+   int* adj;
+   int* blocked;
+   unsigned char* current;
+   int k, c;
+
+   SCIP_CALL( SCIPallocBufferArray(scip, &order, ncand) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &ratio, ncand) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &adjbeg, ncand + 1) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &adj, 2 * nconfl + 1) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &blocked, ncand) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &current, ncand) );
+   BMSclearMemoryArray(blocked, ncand);
+   BMSclearMemoryArray(current, ncand);
+
+   // order by profit/weight, non-increasing
+   for( k = 0; k < ncand; k++ )
+   {
+      order[k] = k;
+      ratio[k] = -profit[k] / weight[k];
+   }
+   SCIPsortRealInt(ratio, order, ncand);
+
+   // adjacency lists of the conflicts
+   for( k = 0; k <= ncand; k++ )
+      adjbeg[k] = 0;
+   for( c = 0; c < 2 * nconfl; c++ )
+      adjbeg[confl[c] + 1]++;
+   for( k = 0; k < ncand; k++ )
+      adjbeg[k + 1] += adjbeg[k];
+   for( c = 0; c < nconfl; c++ )
+   {
+      adj[adjbeg[confl[2*c]]++] = confl[2*c+1];
+      adj[adjbeg[confl[2*c+1]]++] = confl[2*c];
+   }
+   for( k = ncand; k > 0; k-- )
+      adjbeg[k] = adjbeg[k - 1];
+   adjbeg[0] = 0;
+
+   bb.ncand = ncand;
+   bb.order = order;
+   bb.weight = weight;
+   bb.profit = profit;
+   bb.adjbeg = adjbeg;
+   bb.adj = adj;
+   bb.capacity = capacity;
+   bb.blocked = blocked;
+   bb.current = current;
+   bb.best = chosen;
+   bb.bestprofit = 0.0;
+   bb.nodes = 0;
+   bb.aborted = FALSE;
+   memset(chosen, 0, ncand);
+   bbSearch(&bb, 0, 0, 0.0);
+
+   *bestprofit = bb.bestprofit;
+   *exact = !bb.aborted;
+
+   SCIPfreeBufferArray(scip, &current);
+   SCIPfreeBufferArray(scip, &blocked);
+   SCIPfreeBufferArray(scip, &adj);
+   SCIPfreeBufferArray(scip, &adjbeg);
+   SCIPfreeBufferArray(scip, &ratio);
+   SCIPfreeBufferArray(scip, &order);
+
+   return SCIP_OKAY;
+}
+
+/** finds the best packing of knapsack j respecting the samediff constraints and adds it if it improves the LP */
+static
+SCIP_RETCODE pricePacking(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_PRICERDATA*      pricerdata,         /**< pricer data */
+   SCIP_PROBDATA*        probdata,           /**< problem data */
+   int                   j,                  /**< knapsack */
+   SCIP_Real             dual,               /**< dual of the row of the knapsack */
+   int                   nbranch,            /**< number of active samediff constraints */
+   const int*            row1,               /**< first row of each samediff constraint */
+   const int*            row2,               /**< second row of each samediff constraint */
+   const CONSTYPE*       type,               /**< type of each samediff constraint */
+   SCIP_Real*            value,              /**< pointer to store the value of the best packing plus the dual */
+   SCIP_Bool*            exact               /**< pointer to store whether the best packing is optimal */
+   )
+{
+   instanceT* I;
+   itemArraysT* items;
+   SCIP_Longint* candweight;
+   SCIP_Real* candprofit;
+   int* confl;
+   SCIP_Longint forcedweight, capacity;
+   SCIP_Real forcedprofit, bestprofit;
+   int* parent;
+   unsigned char* flag;
+   int i, a, b, c, k, m, ncand, nconfl, npacking;
+
+   I = SCIPprobdataGetInstance(probdata);
+   items = SCIPprobdataGetItems(probdata);
+   m = I->m;
+   parent = pricerdata->parent;
+   flag = pricerdata->flag;
+   *value = -SCIPinfinity(scip);
+   *exact = TRUE;
+
+   for( i = 0; i < I->n; i++ )
+   {
+      parent[i] = i;
+      flag[i] = 0;
+      pricerdata->gweight[i] = 0;
+      pricerdata->gprofit[i] = 0.0;
+   }
+   // merge the items of SAME constraints and mark the items forced in or out of the knapsack
+   for( c = 0; c < nbranch; c++ )
+   {
+      if( row1[c] < m )
+      {
+         i = row2[c] - m;
+         if( row1[c] == j )
+            flag[i] |= (type[c] == SAME ? ITEM_FORCED : ITEM_EXCLUDED);
+         else if( type[c] == SAME )
+            flag[i] |= ITEM_EXCLUDED;
+      }
+      else if( type[c] == SAME )
+      {
+         a = findRoot(parent, row1[c] - m);
+         b = findRoot(parent, row2[c] - m);
+         if( a != b )
+            parent[a] = b;
+      }
+   }
+   for( i = 0; i < I->n; i++ )
+   {
+      a = findRoot(parent, i);
+      pricerdata->gweight[a] += items->weight[i];
+      pricerdata->gprofit[a] += pricerdata->profit[i];
+      flag[a] |= flag[i];
+   }
+   // an item in conflict with its own group is out
+   for( c = 0; c < nbranch; c++ )
+   {
+      if( row1[c] >= m && type[c] == DIFFER )
+      {
+         a = findRoot(parent, row1[c] - m);
+         b = findRoot(parent, row2[c] - m);
+         if( a == b )
+            flag[a] |= ITEM_EXCLUDED;
+      }
+   }
+
+   forcedweight = 0;
+   forcedprofit = 0.0;
+   for( i = 0; i < I->n; i++ )
+   {
+      if( parent[i] != i || !(flag[i] & ITEM_FORCED) )
+         continue;
+      if( flag[i] & ITEM_EXCLUDED )
+         return SCIP_OKAY;
+      forcedweight += pricerdata->gweight[i];
+      forcedprofit += pricerdata->gprofit[i];
+   }
+   capacity = I->C[j] - forcedweight;
+   if( capacity < 0 )
+      return SCIP_OKAY;
+
+   // conflicts with a forced group exclude the other group
+   nconfl = 0;
+   for( c = 0; c < nbranch; c++ )
+   {
+      if( row1[c] < m || type[c] != DIFFER )
+         continue;
+      a = findRoot(parent, row1[c] - m);
+      b = findRoot(parent, row2[c] - m);
+      if( (flag[a] & ITEM_FORCED) && (flag[b] & ITEM_FORCED) )
+         return SCIP_OKAY;
+      if( flag[a] & ITEM_FORCED )
+         flag[b] |= ITEM_EXCLUDED;
+      else if( flag[b] & ITEM_FORCED )
+         flag[a] |= ITEM_EXCLUDED;
+      else
+         nconfl++;
+   }
+
+   // candidates: free groups with positive profit that fit the residual capacity
+   ncand = 0;
+   for( i = 0; i < I->n; i++ )
+   {
+      pricerdata->candpos[i] = -1;
+      if( parent[i] == i && flag[i] == 0 && pricerdata->gweight[i] <= capacity
+         && SCIPisDualfeasPositive(scip, pricerdata->gprofit[i]) )
+      {
+         pricerdata->candpos[i] = ncand;
+         pricerdata->cand[ncand++] = i;
+      }
+   }
+
+   bestprofit = 0.0;
+   if( ncand > 0 )
+   {
+      SCIP_CALL( SCIPallocBufferArray(scip, &candweight, ncand) );
+      SCIP_CALL( SCIPallocBufferArray(scip, &candprofit, ncand) );
+      SCIP_CALL( SCIPallocBufferArray(scip, &confl, 2 * nconfl + 1) );
+      for( k = 0; k < ncand; k++ )
+      {
+         candweight[k] = pricerdata->gweight[pricerdata->cand[k]];
+         candprofit[k] = pricerdata->gprofit[pricerdata->cand[k]];
+      }
+      // conflicts between two candidates
+      nconfl = 0;
+      for( c = 0; c < nbranch; c++ )
+      {
+         if( row1[c] < m || type[c] != DIFFER )
+            continue;
+         a = pricerdata->candpos[findRoot(parent, row1[c] - m)];
+         b = pricerdata->candpos[findRoot(parent, row2[c] - m)];
+         if( a >= 0 && b >= 0 )
+         {
+            confl[2*nconfl] = a;
+            confl[2*nconfl+1] = b;
+            nconfl++;
+         }
+      }
+
+      if( nconfl == 0 && (SCIP_Longint) ncand * (capacity + 1) <= MAX_DP_CELLS )
+      {
+         SCIP_CALL( solveKnapsackDP(scip, ncand, candweight, candprofit, capacity, pricerdata->chosen, &bestprofit) );
+         pricerdata->ndp++;
+      }
+      else
+      {
+         SCIP_CALL( solveKnapsackBB(scip, ncand, candweight, candprofit, capacity, confl, nconfl, pricerdata->chosen,
+               &bestprofit, exact) );
+         pricerdata->nbb++;
+         if( !*exact )
+            pricerdata->ninexact++;
+      }
+      SCIPfreeBufferArray(scip, &confl);
+      SCIPfreeBufferArray(scip, &candprofit);
+      SCIPfreeBufferArray(scip, &candweight);
+   }
+
+   *value = forcedprofit + bestprofit + dual;
+   if( !SCIPisDualfeasPositive(scip, *value) )
+      return SCIP_OKAY;
+
+   // the items of the forced and of the chosen groups, in increasing order
+   npacking = 0;
+   for( i = 0; i < I->n; i++ )
+   {
+      a = findRoot(parent, i);
+      if( (flag[a] & ITEM_FORCED) || (pricerdata->candpos[a] >= 0 && pricerdata->chosen[pricerdata->candpos[a]]) )
+         pricerdata->packing[npacking++] = i;
+   }
+   if( npacking == 0 )
+      return SCIP_OKAY;
+
+   SCIPdebugMessage("knapsack %d: packing of %d items, value %g\n", j, npacking, *value);
+   SCIP_CALL( SCIPprobdataAddPacking(scip, probdata, j, pricerdata->packing, npacking, *value) );
+   pricerdata->npackings++;
+
+   return SCIP_OKAY;
+}
+
+/** pricing of all knapsacks with the duals (or the Farkas multipliers) of the current LP */
+static
+SCIP_RETCODE pricePackings(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_PRICER*          pricer,             /**< the pricer */
+   SCIP_Bool             farkas,             /**< Farkas pricing? */
+   SCIP_Real*            lowerbound,         /**< pointer to store the Lagrangian bound (NULL in the Farkas pricing) */
+   SCIP_RESULT*          result              /**< pointer to store the result of the pricing */
+   )
+{
+   SCIP_PRICERDATA* pricerdata;
+   SCIP_PROBDATA* probdata;
+   SCIP_CONS** conss;
+   SCIP_CONS** branchconss;
+   instanceT* I;
+   itemArraysT* items;
+   CONSTYPE* type;
+   SCIP_Real value, sumvalue;
+   SCIP_Bool exact, allexact;
+   int* row1;
+   int* row2;
+   int i, j, c, nbranch, nbranchconss;
+
+   pricerdata = SCIPpricerGetData(pricer);
+   assert(pricerdata != NULL);
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+   I = SCIPprobdataGetInstance(probdata);
+   items = SCIPprobdataGetItems(probdata);
+   conss = SCIPprobdataGetConss(probdata);
+
+   pricerdata->nrounds++;
+
+   // profits of the items: value plus dual in the pricing of the reduced costs, only the multiplier in the Farkas one
+   for( i = 0; i < I->n; i++ )
+      pricerdata->profit[i] = (farkas ? 0.0 : (SCIP_Real) items->value[i]) + consGetDual(scip, conss[I->m + i], farkas);
+
+   // branching decisions of the current node
+   nbranchconss = SCIPconshdlrGetNConss(pricerdata->conshdlr);
+   branchconss = SCIPconshdlrGetConss(pricerdata->conshdlr);
+   SCIP_CALL( SCIPallocBufferArray(scip, &row1, nbranchconss + 1) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &row2, nbranchconss + 1) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &type, nbranchconss + 1) );
+   nbranch = 0;
+   for( c = 0; c < nbranchconss; c++ )
+   {
+      if( !SCIPconsIsActive(branchconss[c]) )
+         continue;
+      row1[nbranch] = SCIPgetRow1Samediff(scip, branchconss[c]);
+      row2[nbranch] = SCIPgetRow2Samediff(scip, branchconss[c]);
+      type[nbranch] = SCIPgetTypeSamediff(scip, branchconss[c]);
+      nbranch++;
+   }
+
+   allexact = TRUE;
+   sumvalue = 0.0;
+   for( j = 0; j < I->m; j++ )
+   {
+      SCIP_CALL( pricePacking(scip, pricerdata, probdata, j, consGetDual(scip, conss[j], farkas), nbranch, row1, row2,
+            type, &value, &exact) );
+      allexact = allexact && exact;
+      if( value > 0.0 )
+         sumvalue += value;
+   }
+
+   SCIPfreeBufferArray(scip, &type);
+   SCIPfreeBufferArray(scip, &row2);
+   SCIPfreeBufferArray(scip, &row1);
+
+   if( !allexact && SCIPgetNPricevars(scip) == 0 )
+   {
+      *result = SCIP_DIDNOTRUN;
+      return SCIP_OKAY;
+   }
+   // Lagrangian bound: each knapsack takes at most one packing, whose reduced cost is at least -value
+   if( lowerbound != NULL && allexact )
+      *lowerbound = SCIPgetLPObjval(scip) - sumvalue;
+   *result = SCIP_SUCCESS;
+
+   return SCIP_OKAY;
+}
+
+/**@} */
+
+/**name Callback methods
+ *
+ * @{
+ */
+
+/** destructor of variable pricer to free user data (called when SCIP is exiting) */
+static
+SCIP_DECL_PRICERFREE(pricerFreeMochila)
+{
+   SCIP_PRICERDATA* pricerdata;
+
+   assert(scip != NULL);
+   assert(pricer != NULL);
+
+   pricerdata = SCIPpricerGetData(pricer);
+
+   if( pricerdata != NULL)
+   {
+      /* free memory */
+      SCIPfreeBlockMemory(scip, &pricerdata);
+   }
+
+   return SCIP_OKAY;
+}
+
+/** solving process initialization method of variable pricer (called when branch and bound process is about to begin) */
+static
+SCIP_DECL_PRICERINITSOL(pricerInitsolMochila)
+{
+   SCIP_PRICERDATA* pricerdata;
+   int n;
+
+   assert(scip != NULL);
+   assert(pricer != NULL);
+
+   pricerdata = SCIPpricerGetData(pricer);
+   assert(pricerdata != NULL);
+
+   n = SCIPprobdataGetInstance(SCIPgetProbData(scip))->n;
+   pricerdata->nitems = n;
+   pricerdata->nrounds = 0;
+   pricerdata->npackings = 0;
+   pricerdata->ndp = 0;
+   pricerdata->nbb = 0;
+   pricerdata->ninexact = 0;
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &pricerdata->profit, n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &pricerdata->parent, n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &pricerdata->flag, n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &pricerdata->gweight, n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &pricerdata->gprofit, n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &pricerdata->candpos, n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &pricerdata->cand, n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &pricerdata->chosen, n) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &pricerdata->packing, n) );
+
+   return SCIP_OKAY;
+}
+
+/** solving process deinitialization method of variable pricer (called before branch and bound process data is freed) */
+static
+SCIP_DECL_PRICEREXITSOL(pricerExitsolMochila)
+{
+   SCIP_PRICERDATA* pricerdata;
+   int n;
+
+   assert(scip != NULL);
+   assert(pricer != NULL);
+
+   pricerdata = SCIPpricerGetData(pricer);
+   assert(pricerdata != NULL);
+
+#ifdef DEBUG_PRICER
+   printf("\nPricer %s: %lld rounds, %lld packings added, %lld knapsacks by DP, %lld by B&B (%lld at the node limit)\n",
+      PRICER_NAME, (long long) pricerdata->nrounds, (long long) pricerdata->npackings, (long long) pricerdata->ndp,
+      (long long) pricerdata->nbb, (long long) pricerdata->ninexact);
+#endif
+
+   n = pricerdata->nitems;
+   SCIPfreeBlockMemoryArrayNull(scip, &pricerdata->packing, n);
+   SCIPfreeBlockMemoryArrayNull(scip, &pricerdata->chosen, n);
+   SCIPfreeBlockMemoryArrayNull(scip, &pricerdata->cand, n);
+   SCIPfreeBlockMemoryArrayNull(scip, &pricerdata->candpos, n);
+   SCIPfreeBlockMemoryArrayNull(scip, &pricerdata->gprofit, n);
+   SCIPfreeBlockMemoryArrayNull(scip, &pricerdata->gweight, n);
+   SCIPfreeBlockMemoryArrayNull(scip, &pricerdata->flag, n);
+   SCIPfreeBlockMemoryArrayNull(scip, &pricerdata->parent, n);
+   SCIPfreeBlockMemoryArrayNull(scip, &pricerdata->profit, n);
+
+   return SCIP_OKAY;
+}
+
+/** reduced cost pricing method of variable pricer for feasible LPs */
+static
+SCIP_DECL_PRICERREDCOST(pricerRedcostMochila)
+{  /*lint --e{715}*/
+   assert(scip != NULL);
+   assert(pricer != NULL);
+
+   SCIP_CALL( pricePackings(scip, pricer, FALSE, lowerbound, result) );
+
+   return SCIP_OKAY;
+}
+
+/** Farkas pricing method of variable pricer for infeasible LPs (the slacks of the rows were fixed by the branching) */
+static
+SCIP_DECL_PRICERFARKAS(pricerFarkasMochila)
+{  /*lint --e{715}*/
+   assert(scip != NULL);
+   assert(pricer != NULL);
+
+   SCIP_CALL( pricePackings(scip, pricer, TRUE, NULL, result) );
+
+   return SCIP_OKAY;
+}
+
+/**@} */
+
+
+/**@name Interface methods
+ *
+ * @{
+ */
+
+/** creates the mochila pricer and includes it in SCIP */
+SCIP_RETCODE SCIPincludePricerMochila(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_PRICERDATA* pricerdata;
+   SCIP_PRICER* pricer;
+
+   SCIP_CALL( SCIPallocBlockMemory(scip, &pricerdata) );
+   pricerdata->conshdlr = SCIPfindConshdlr(scip, "samediff");
+   if( pricerdata->conshdlr == NULL )
+   {
+      SCIPerrorMessage("the pricer <%s> needs the samediff constraint handler\n", PRICER_NAME);
+      SCIPfreeBlockMemory(scip, &pricerdata);
+      return SCIP_PLUGINNOTFOUND;
+   }
+   pricerdata->nitems = 0;
+   pricerdata->profit = NULL;
+   pricerdata->parent = NULL;
+   pricerdata->flag = NULL;
+   pricerdata->gweight = NULL;
+   pricerdata->gprofit = NULL;
+   pricerdata->candpos = NULL;
+   pricerdata->cand = NULL;
+   pricerdata->chosen = NULL;
+   pricerdata->packing = NULL;
+   pricerdata->nrounds = 0;
+   pricerdata->npackings = 0;
+   pricerdata->ndp = 0;
+   pricerdata->nbb = 0;
+   pricerdata->ninexact = 0;
+
+   /* include variable pricer */
+   SCIP_CALL( SCIPincludePricerBasic(scip, &pricer, PRICER_NAME, PRICER_DESC, PRICER_PRIORITY, PRICER_DELAY,
+         pricerRedcostMochila, pricerFarkasMochila, pricerdata) );
+
+   SCIP_CALL( SCIPsetPricerFree(scip, pricer, pricerFreeMochila) );
+   SCIP_CALL( SCIPsetPricerInitsol(scip, pricer, pricerInitsolMochila) );
+   SCIP_CALL( SCIPsetPricerExitsol(scip, pricer, pricerExitsolMochila) );
+
+   return SCIP_OKAY;
+}
+
+/**@} */
@@ -37,9 +37,12 @@
  *    const_char*           probname;     **< problem name *
  *    SCIP_VAR**            vars;         **< all variables of the problem *
  *    SCIP_CONS**           conss;        **< all constraints  *
- *    int                   nvars;        **< size of vars *
+ *    int                   nvars;        **< number of vars *
+ *    int                   varssize;     **< size of vars *
  *    int                   ncons;        **< number of constraints *
+ *    int                   formulation;  **< FORMULATION_ASSIGNMENT or FORMULATION_PACKING *
  *    instanceT*            I;            **< instance of knapsack *
+ *    itemArraysT*          items;        **< items of I as arrays, with orderings by ratio, value and weight *
  * };
  * \endcode
  *
@@ -62,6 +65,21 @@
  *
  * where \f$ x_i \f$ for \f$i\in I\f$ are binary variables and \f$w_i\f$ and \f$v_i\f$ are the weight and value of item \f$ i\f$, respectively.
  *
+ * In the Dantzig-Wolfe formulation (FORMULATION_PACKING), each variable \f$ \lambda_p \f$ is a packing \f$ p \f$ of
+ * one knapsack \f$ j(p) \f$ (a subset of items that fits \f$ C_{j(p)} \f$) and the rows are set partitioning rows
+ * with explicit slack variables \f$ e_j \f$ (knapsack j unused) and \f$ s_i \f$ (item i not packed):
+ *
+ *  \f[
+ *  \begin{array}[t]{rll}
+ *       \max & \displaystyle \sum_{p} v(p) \lambda_p \\
+ *        subject \ to & \displaystyle \sum_{p: j(p) = j} \lambda_p + e_j = 1 & \quad \forall j \\
+ *        & \displaystyle \sum_{p: i \in p} \lambda_p + s_i = 1 & \quad \forall i \\
+ *  \end{array}
+ * \f]
+ *
+ * It starts with the slacks and a first-fit packing of each knapsack; the other packings are generated by the pricer
+ * (pricer_mochila.c) and the branching is done on pairs of rows (branch_ryanfoster.c and cons_samediff.c).
+ *
  * A list of all interface methods can be found in probdata_mochila.h.
  **/
 /*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
@@ -75,6 +93,9 @@
 #include "scip/scipdefplugins.h"
 
 #include "probdata_mochila.h"
+#include "vardata_mochila.h"
+
+#define PRICER_NAME "mochila"   /* pricer of the Dantzig-Wolfe formulation, see pricer_mochila.c */
 
 /**@name Local methods
  *
@@ -91,7 +112,9 @@ SCIP_RETCODE probdataCreate(
    SCIP_CONS**           conss,              /**< all constraints */
    int                   nvars,              /**< size of vars */
    int                   ncons,              /**< number of constraints */
-   instanceT*            I                   /**< pointer to the instance data */
+   int                   formulation,        /**< FORMULATION_ASSIGNMENT or FORMULATION_PACKING */
+   instanceT*            I,                  /**< pointer to the instance data */
+   itemArraysT*          items               /**< items of I as arrays (shared by original and transformed data) */
    )
 {
    assert(scip != NULL);
@@ -112,8 +135,11 @@ SCIP_RETCODE probdataCreate(
    SCIP_CALL( SCIPduplicateMemoryArray(scip, &(*probdata)->conss, conss, ncons) ); /* NEEDED for transformed problem */
 
    (*probdata)->I=I;
+   (*probdata)->items=items;
    (*probdata)->nvars = nvars;
+   (*probdata)->varssize = nvars;
    (*probdata)->ncons = ncons;
+   (*probdata)->formulation = formulation;
    (*probdata)->probname = probname;
 
    return SCIP_OKAY;
@@ -146,8 +172,9 @@ SCIP_RETCODE probdataFree(
 
    /* free memory of arrays */
    SCIPfreeMemoryArray(scip, &(*probdata)->conss);
+   SCIPfreeMemoryArrayNull(scip, &(*probdata)->vars);
    if(!transformed){
-     //SCIPfreeMemoryArray(scip, &(*probdata)->vars);
+     freeItemArrays((*probdata)->items);
      freeInstance((*probdata)->I);
    }
    /* free probdata */
@@ -181,7 +208,7 @@ static
 SCIP_DECL_PROBTRANS(probtransMochila)
 {
    /* create transform probdata */
-   SCIP_CALL( probdataCreate(scip, targetdata, sourcedata->probname, sourcedata->vars, sourcedata->conss, sourcedata->nvars, sourcedata->ncons, sourcedata->I) );
+   SCIP_CALL( probdataCreate(scip, targetdata, sourcedata->probname, sourcedata->vars, sourcedata->conss, sourcedata->nvars, sourcedata->ncons, sourcedata->formulation, sourcedata->I, sourcedata->items) );
 
    /* transform all constraints */
    SCIP_CALL( SCIPtransformConss(scip, (*targetdata)->ncons, (sourcedata)->conss, (*targetdata)->conss) );
@@ -220,6 +247,146 @@ SCIP_DECL_PROBEXITSOL(probexitsolMochila)
    return SCIP_OKAY;
 }
 
+/** adds var to the set partitioning row cons (linear or setppc) */
+static
+SCIP_RETCODE consAddCoef(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_CONS*            cons,               /**< row */
+   SCIP_VAR*             var                 /**< variable */
+   )
+{
+   if( strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(cons)), "setppc") == 0 )
+   {
+      SCIP_CALL( SCIPaddCoefSetppc(scip, cons, var) );
+   }
+   else
+   {
+      SCIP_CALL( SCIPaddCoefLinear(scip, cons, var, 1.0) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** creates the Dantzig-Wolfe formulation: rows of the knapsacks and of the items with their slacks, and a first-fit
+ *  packing of each knapsack in the order by value/weight */
+static
+SCIP_RETCODE createPackingModel(
+   SCIP*                 scip,               /**< SCIP data structure */
+   const char*           probname,           /**< problem name */
+   instanceT*            I,                  /**< instance of knapsack */
+   itemArraysT*          items,              /**< items of I as arrays */
+   SCIP_Bool             usenames,           /**< create names for vars and constraints? */
+   SCIP_Bool             nativecons          /**< set partitioning constraints instead of linear ones? */
+   )
+{
+   SCIP_PROBDATA* probdata;
+   SCIP_PRICER* pricer;
+   SCIP_CONS** conss;
+   SCIP_VAR** vars;
+   SCIP_VARDATA* vardata;
+   SCIP_Real one;
+   char name[SCIP_MAXSTRLEN];
+   int* knapsack;
+   int* packing;
+   int i, j, k, r, residual, npacking;
+
+   pricer = SCIPfindPricer(scip, PRICER_NAME);
+   if( pricer == NULL )
+   {
+      SCIPerrorMessage("the Dantzig-Wolfe formulation needs the pricer <%s>\n", PRICER_NAME);
+      return SCIP_PLUGINNOTFOUND;
+   }
+
+   SCIP_CALL( SCIPallocBufferArray(scip, &conss, I->m + I->n) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &vars, I->m + I->n) );
+   name[0] = '\0';
+   one = 1.0;
+
+   // one slack and one row per knapsack (conss[j]) and per item (conss[m+i]); the rows get the packings later
+   for( r = 0; r < I->m + I->n; r++ )
+   {
+      if( r < I->m )
+      {
+         j = r;
+         if( usenames )
+            (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "e_%d", j);
+         SCIP_CALL( SCIPvardataCreatePacking(scip, &vardata, j, NULL, 0) );
+      }
+      else
+      {
+         i = r - I->m;
+         if( usenames )
+            (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "s_%d", i);
+         SCIP_CALL( SCIPvardataCreatePacking(scip, &vardata, -1, &i, 1) );
+      }
+      SCIP_CALL( SCIPcreateVarMochila(scip, &vars[r], name, 0.0, vardata) );
+      SCIP_CALL( SCIPaddVar(scip, vars[r]) );
+
+      if( usenames )
+      {
+         if( r < I->m )
+            (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "knapsack_%d", r);
+         else
+            (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "item_%d", r - I->m);
+      }
+      if( nativecons )
+      {
+         SCIP_CALL( SCIPcreateConsBasicSetpart(scip, &conss[r], name, 1, &vars[r]) );
+      }
+      else
+      {
+         SCIP_CALL( SCIPcreateConsBasicLinear(scip, &conss[r], name, 1, &vars[r], &one, 1.0, 1.0) );
+      }
+      // the pricer adds variables to the rows
+      SCIP_CALL( SCIPsetConsModifiable(scip, conss[r], TRUE) );
+      SCIP_CALL( SCIPaddCons(scip, conss[r]) );
+   }
+
+   SCIP_CALL( probdataCreate(scip, &probdata, probname, vars, conss, I->m + I->n, I->m + I->n, FORMULATION_PACKING, I, items) );
+   SCIP_CALL( SCIPsetProbData(scip, probdata) );
+
+   // first-fit by value/weight: knapsack[i] = knapsack of item i (-1: not packed)
+   SCIP_CALL( SCIPallocBufferArray(scip, &knapsack, I->n) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &packing, I->n) );
+   for( i = 0; i < I->n; i++ )
+      knapsack[i] = -1;
+   for( j = 0; j < I->m; j++ )
+   {
+      residual = I->C[j];
+      for( k = 0; k < I->n; k++ )
+      {
+         i = items->byRatio[k];
+         if( knapsack[i] < 0 && items->weight[i] <= residual )
+         {
+            knapsack[i] = j;
+            residual -= items->weight[i];
+         }
+      }
+      npacking = 0;
+      for( i = 0; i < I->n; i++ )
+         if( knapsack[i] == j )
+            packing[npacking++] = i;
+      if( npacking > 0 )
+      {
+         SCIP_CALL( SCIPprobdataAddPacking(scip, probdata, j, packing, npacking, 0.0) );
+      }
+   }
+   SCIPfreeBufferArray(scip, &packing);
+   SCIPfreeBufferArray(scip, &knapsack);
+
+   SCIP_CALL( SCIPactivatePricer(scip, pricer) );
+
+   for( r = 0; r < I->m + I->n; r++ )
+   {
+      SCIP_CALL( SCIPreleaseVar(scip, &vars[r]) );
+      SCIP_CALL( SCIPreleaseCons(scip, &conss[r]) );
+   }
+   SCIPfreeBufferArray(scip, &vars);
+   SCIPfreeBufferArray(scip, &conss);
+
+   return SCIP_OKAY;
+}
+
 /**@} */
 
 
@@ -229,17 +396,33 @@ SCIP_DECL_PROBEXITSOL(probexitsolMochila)
  */
 
 /** sets up the problem data 
+ *
+ *  All variables are created first and then each capacity and item row is created in one shot from its coefficient
+ *  arrays. Variable and constraint names (x_i_j, capacity_j and item_i) are only generated if usenames is TRUE (or
+ *  DEBUG_PROBDATA is defined); otherwise all names are empty and SCIP does not keep the name hash tables.
+ *  If nativecons is TRUE, the capacity rows are knapsack constraints and the item rows are set-packing constraints,
+ *  so SCIP uses their specialized propagation, clique table and cover separation; otherwise both are linear constraints.
+ *  With FORMULATION_PACKING, the Dantzig-Wolfe formulation is created instead (see createPackingModel()); the pricer
+ *  must be included in SCIP.
  * TODO: specific for the problem
 */
 SCIP_RETCODE SCIPprobdataCreate(
    SCIP*                 scip,               /**< SCIP data structure */
    const char*           probname,           /**< problem name */
-   instanceT*            I                   /**< instance of knapsack */
+   instanceT*            I,                  /**< instance of knapsack */
+   SCIP_Bool             usenames,           /**< create names for vars and constraints (needed to write the LP file)? */
+   SCIP_Bool             nativecons,         /**< use knapsack and set-packing constraints instead of linear ones? */
+   int                   formulation         /**< FORMULATION_ASSIGNMENT or FORMULATION_PACKING */
    )
 {
    SCIP_PROBDATA* probdata;
    SCIP_CONS** conss;   // esse cara aqui é um vetor de restricoes
    SCIP_VAR** vars, * var;
+   SCIP_VAR** rowvars;
+   SCIP_Real* rowvals;
+   SCIP_Longint* rowweights;
+   SCIP_VARDATA* vardata;
+   itemArraysT* items;
 
    char name[SCIP_MAXSTRLEN];
    int i, j;   // i itens e j mochilas
@@ -248,6 +431,14 @@ SCIP_RETCODE SCIPprobdataCreate(
    
    assert(scip != NULL);
 
+#ifdef DEBUG_PROBDATA
+   usenames = TRUE;
+#endif
+   name[0] = '\0';
+   /* without names, the hash tables of vars and constraints by name are useless (they must be set before the problem is created) */
+   SCIP_CALL( SCIPsetBoolParam(scip, "misc/usevartable", usenames) );
+   SCIP_CALL( SCIPsetBoolParam(scip, "misc/useconstable", usenames) );
+
    /* create problem in SCIP and add non-NULL callbacks via setter functions */
    SCIP_CALL( SCIPcreateProbBasic(scip, probname) );
 
@@ -271,40 +462,31 @@ SCIP_RETCODE SCIPprobdataCreate(
    nvars=0;  // inicializando o numero de variaveis do modelo
    // TODO: configure vars and constraints ....   CONFIGURANDO AS VARIAVEIS E AS RESTRICOES
 
-   // criando as restricoes de capacidade para cada uma das j mochilas (mochila multipla)
-   for( j = 0; j < I->m; j++){
-      // name = nome da restricao
-      (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "capacity_%d", j);
-      
-      // essa funcao que cria a restricao                                             // esse trecho aqui eh equivalente a <=
-      SCIP_CALL( SCIPcreateConsBasicLinear (scip, &conss[ncons], name, 0, NULL, NULL, -SCIPinfinity(scip), (double) I->C[j]) );
-      SCIP_CALL( SCIPaddCons(scip, conss[ncons]) );
-      ncons++; // eai o numero de restricoes aumenta para cada iteracao desse for
-   }
+   // vetores de pesos/valores e ordenacoes dos itens, calculados uma unica vez para todas as heuristicas
+   items = createItemArrays(I);
+   if( items == NULL )
+      return SCIP_NOMEMORY;
 
-     // criando a restrição de que cada item so pode ser colocado em uma unica mochila
-   for( i = 0; i < I->n; i++){
-      // name = nome da restricao
-      (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "item_%d", i);
-      //                                                                              // x_i_j <= 1
-      SCIP_CALL( SCIPcreateConsBasicLinear (scip, &conss[ncons], name, 0, NULL, NULL, -SCIPinfinity(scip), 1.0) );
-      SCIP_CALL( SCIPaddCons(scip, conss[ncons]) );
-      ncons++;  
+   if( formulation == FORMULATION_PACKING )
+   {
+      SCIPfreeBufferArray(scip, &vars);
+      SCIPfreeBufferArray(scip, &conss);
+      return createPackingModel(scip, probname, I, items, usenames, nativecons);
    }
-   
-   /* create one variable for each item i */
+
+   /* create one variable for each item i and knapsack j: vars[i*m+j] = x_i_j */
    // criando n*m variaveis, pq agr eu tenho j variaveis para cada item i
    for( i = 0; i < I->n; ++i )
    {
-      // com esse segundo for aqui eu consigo tanto fazer a variavel ter dois indices
-      // quanto colocar cada variavel i na restricao de capacidade da mochila j
       for(j = 0; j < I->m; j++){
 
-         (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "x_%d_%d", i, j);
+         if( usenames )
+            (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "x_%d_%d", i, j);
 
-         /* create a basic variable object */
-         // criando uma variavel do tipo basica
-         SCIP_CALL( SCIPcreateVarBasic(scip, &var, name, 0.0, 1.0, (double) I->item[i].value, SCIP_VARTYPE_BINARY));
+         /* create a binary variable object that knows its item i and knapsack j */
+         // a variavel guarda o item e a mochila (vardata), assim ninguem precisa ler o nome dela
+         SCIP_CALL( SCIPvardataCreateMochila(scip, &vardata, i, j) );
+         SCIP_CALL( SCIPcreateVarMochila(scip, &var, name, (double) items->value[i], vardata) );
 
          assert(var != NULL);
          /* save the pointer to the created var */
@@ -312,24 +494,59 @@ SCIP_RETCODE SCIPprobdataCreate(
 
          /* add variable to the problem */
          SCIP_CALL( SCIPaddVar(scip, var) );
-      
-         // colocando a variavel com aquele coeficiente (peso do item i) nas restriçoes (mochila multipla)
-         // adicionando a variaval a restricao de capacidade j (mochila multipla)
-         SCIP_CALL( SCIPaddCoefLinear(scip, conss[j], var, (double) I->item[i].weight) );
+      }
+   }
+
+   // buffers com as variaveis e os coeficientes de uma linha (no maximo n elementos)
+   SCIP_CALL( SCIPallocBufferArray(scip, &rowvars, MAX(I->n, I->m)) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &rowvals, MAX(I->n, I->m)) );
+   SCIP_CALL( SCIPallocBufferArray(scip, &rowweights, I->n) );
 
-         // adicionando a variaval a restricao do item i (mochila multipla).
-         SCIP_CALL( SCIPaddCoefLinear(scip, conss[I->m+i], var, 1.0 ));  // item i so pode ser colocado em uma mochila
-         // pulando m restricoes para assim chegar na restricao correta
+   // criando as restricoes de capacidade para cada uma das j mochilas (mochila multipla): sum_i w_i x_i_j <= C_j
+   for( i = 0; i < I->n; i++ ){
+      rowvals[i] = (SCIP_Real) items->weight[i];
+      rowweights[i] = (SCIP_Longint) items->weight[i];
+   }
+   for( j = 0; j < I->m; j++){
+      if( usenames )
+         (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "capacity_%d", j);
+      for( i = 0; i < I->n; i++ )
+         rowvars[i] = vars[i*I->m+j];
+      if( nativecons ){
+         // os pesos e a capacidade sao inteiros: restricao de mochila
+         SCIP_CALL( SCIPcreateConsBasicKnapsack(scip, &conss[ncons], name, I->n, rowvars, rowweights, (SCIP_Longint) I->C[j]) );
+      }
+      else{
+         SCIP_CALL( SCIPcreateConsBasicLinear(scip, &conss[ncons], name, I->n, rowvars, rowvals, -SCIPinfinity(scip), (double) I->C[j]) );
+      }
+      SCIP_CALL( SCIPaddCons(scip, conss[ncons]) );
+      ncons++;
+   }
 
-         //nvars++;
+   // criando a restrição de que cada item so pode ser colocado em uma unica mochila: sum_j x_i_j <= 1
+   // (as variaveis do item i sao contiguas em vars)
+   for( j = 0; j < I->m; j++ )
+      rowvals[j] = 1.0;
+   for( i = 0; i < I->n; i++){
+      if( usenames )
+         (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "item_%d", i);
+      if( nativecons ){
+         SCIP_CALL( SCIPcreateConsBasicSetpack(scip, &conss[ncons], name, I->m, &vars[i*I->m]) );
+      }
+      else{
+         SCIP_CALL( SCIPcreateConsBasicLinear(scip, &conss[ncons], name, I->m, &vars[i*I->m], rowvals, -SCIPinfinity(scip), 1.0) );
       }
-      //nvars++;
-      
-   }   
-      
+      SCIP_CALL( SCIPaddCons(scip, conss[ncons]) );
+      ncons++;  
+   }
+
+   SCIPfreeBufferArray(scip, &rowweights);
+   SCIPfreeBufferArray(scip, &rowvals);
+   SCIPfreeBufferArray(scip, &rowvars);
+
    // TODO: ... after vars and constraints have been created, nothing more is necessary. Just do exactly as follows:
    /* create problem data */
-   SCIP_CALL( probdataCreate(scip, &probdata, probname, vars, conss, nvars, ncons, I) );
+   SCIP_CALL( probdataCreate(scip, &probdata, probname, vars, conss, nvars, ncons, FORMULATION_ASSIGNMENT, I, items) );
 
 #ifdef DEBUG_PROBDATA
    SCIP_CALL( SCIPwriteOrigProblem(scip, "mochila.lp", "lp", FALSE) ); /* save the problem in a file */
@@ -356,6 +573,14 @@ instanceT* SCIPprobdataGetInstance(
    return probdata->I;
 }
 
+/** returns the items of the instance as arrays (weight, value, label) and their precomputed orderings */
+itemArraysT* SCIPprobdataGetItems(
+   SCIP_PROBDATA*        probdata            /**< problem data */
+   )
+{
+   return probdata->items;
+}
+
 /** returns array of all variables itemed in the way they got generated */
 SCIP_VAR** SCIPprobdataGetVars(
    SCIP_PROBDATA*        probdata            /**< problem data */
@@ -364,6 +589,18 @@ SCIP_VAR** SCIPprobdataGetVars(
    return probdata->vars;
 }
 
+/** returns the variable x_i_j of item i and knapsack j */
+SCIP_VAR* SCIPprobdataGetVar(
+   SCIP_PROBDATA*        probdata,           /**< problem data */
+   int                   i,                  /**< item */
+   int                   j                   /**< knapsack */
+   )
+{
+   assert(probdata->formulation == FORMULATION_ASSIGNMENT);
+
+   return probdata->vars[i * probdata->I->m + j];
+}
+
 /** returns number of variables */
 int SCIPprobdataGetNVars(
    SCIP_PROBDATA*        probdata            /**< problem data */
@@ -386,6 +623,107 @@ int SCIPprobdataGetNcons(
 {
    return probdata->ncons;
 }
+
+/** replaces the constraint c of the problem data (e.g., by a presolver); the old one is released and the new one captured */
+SCIP_RETCODE SCIPprobdataSetCons(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_PROBDATA*        probdata,           /**< problem data */
+   int                   c,                  /**< index of the constraint */
+   SCIP_CONS*            cons                /**< new constraint */
+   )
+{
+   assert(c >= 0 && c < probdata->ncons);
+
+   SCIP_CALL( SCIPcaptureCons(scip, cons) );
+   SCIP_CALL( SCIPreleaseCons(scip, &probdata->conss[c]) );
+   probdata->conss[c] = cons;
+
+   return SCIP_OKAY;
+}
+/** adds given variable to the problem data */
+SCIP_RETCODE SCIPprobdataAddVar(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_PROBDATA*        probdata,           /**< problem data */
+   SCIP_VAR*             var                 /**< variables to add */
+   )
+{
+   int newsize;
+
+   if( probdata->nvars == probdata->varssize )
+   {
+      newsize = MAX(100, 2 * probdata->varssize);
+      SCIP_CALL( SCIPreallocMemoryArray(scip, &probdata->vars, newsize) );
+      probdata->varssize = newsize;
+   }
+   SCIP_CALL( SCIPcaptureVar(scip, var) );
+   probdata->vars[probdata->nvars++] = var;
+
+   return SCIP_OKAY;
+}
+
+/** creates the variable of a packing of a knapsack in the Dantzig-Wolfe formulation, adds it to its rows and to the
+ *  problem data (during the solving process, as a priced variable with the given score) */
+SCIP_RETCODE SCIPprobdataAddPacking(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_PROBDATA*        probdata,           /**< problem data */
+   int                   knapsack,           /**< knapsack of the packing */
+   const int*            items,              /**< items of the packing, sorted */
+   int                   nitems,             /**< number of items */
+   SCIP_Real             score               /**< score of a priced variable (e.g., minus its reduced cost) */
+   )
+{
+   SCIP_VARDATA* vardata;
+   SCIP_VAR* var;
+   SCIP_Bool usenames;
+   char name[SCIP_MAXSTRLEN];
+   int k, value;
+
+   assert(probdata->formulation == FORMULATION_PACKING);
+   assert(knapsack >= 0 && knapsack < probdata->I->m);
+
+   value = 0;
+   for( k = 0; k < nitems; k++ )
+      value += probdata->items->value[items[k]];
+
+   SCIP_CALL( SCIPgetBoolParam(scip, "misc/usevartable", &usenames) );
+   name[0] = '\0';
+   if( usenames )
+      (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "p_%d_%d", knapsack, probdata->nvars);
+
+   SCIP_CALL( SCIPvardataCreatePacking(scip, &vardata, knapsack, items, nitems) );
+   if( SCIPgetStage(scip) == SCIP_STAGE_PROBLEM )
+   {
+      SCIP_CALL( SCIPcreateVarMochila(scip, &var, name, (double) value, vardata) );
+      SCIP_CALL( SCIPaddVar(scip, var) );
+   }
+   else
+   {
+      // a variable created during the solving process is a variable of the transformed problem, which is minimized
+      SCIP_CALL( SCIPcreateVarPriced(scip, &var, name, -(double) value, vardata) );
+      SCIP_CALL( SCIPaddPricedVar(scip, var, score) );
+   }
+   // the rows already bound the variable by 1
+   SCIP_CALL( SCIPchgVarUbLazy(scip, var, 1.0) );
+
+   SCIP_CALL( consAddCoef(scip, probdata->conss[knapsack], var) );
+   for( k = 0; k < nitems; k++ )
+   {
+      SCIP_CALL( consAddCoef(scip, probdata->conss[probdata->I->m + items[k]], var) );
+   }
+   SCIP_CALL( SCIPprobdataAddVar(scip, probdata, var) );
+   SCIP_CALL( SCIPreleaseVar(scip, &var) );
+
+   return SCIP_OKAY;
+}
+
+/** returns the formulation of the problem (FORMULATION_ASSIGNMENT or FORMULATION_PACKING) */
+int SCIPprobdataGetFormulation(
+   SCIP_PROBDATA*        probdata            /**< problem data */
+   )
+{
+   return probdata->formulation;
+}
+
 /** returns Probname of the instance */
 const char* SCIPprobdataGetProbname(
    SCIP_PROBDATA*        probdata            /**< problem data */
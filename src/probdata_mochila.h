@@ -30,6 +30,8 @@
 #include "problem.h"
 
 /* constants */
+#define FORMULATION_ASSIGNMENT 0             /**< variables x_i_j: item i in knapsack j */
+#define FORMULATION_PACKING    1             /**< Dantzig-Wolfe: one variable per packing of a knapsack (branch-and-price) */
 
 /* macros */
 #define EPSILON 0.000001
@@ -49,8 +51,11 @@ struct SCIP_ProbData
    SCIP_VAR**            vars;               /**< array of variables */
    SCIP_CONS**           conss;              /**< all constraints */
    int                   nvars;              /**< total of vars */
+   int                   varssize;           /**< size of the array vars */
    int                   ncons;              /**< number of constraints */
+   int                   formulation;        /**< FORMULATION_ASSIGNMENT or FORMULATION_PACKING */
    instanceT*            I;                  /**< instance of knapsack */
+   itemArraysT*          items;              /**< items of I as arrays, with orderings by ratio, value and weight */
 };
 
 /** sets up the problem data */
@@ -58,7 +63,10 @@ extern
 SCIP_RETCODE SCIPprobdataCreate(
    SCIP*                 scip,               /**< SCIP data structure */
    const char*           probname,           /**< problem name */
-   instanceT*            I                   /**< instance of K-coloring */
+   instanceT*            I,                  /**< instance of knapsack */
+   SCIP_Bool             usenames,           /**< create names for vars and constraints (needed to write the LP file)? */
+   SCIP_Bool             nativecons,         /**< use knapsack and set-packing constraints instead of linear ones? */
+   int                   formulation         /**< FORMULATION_ASSIGNMENT or FORMULATION_PACKING */
    );
 
 /** adds given variable to the problem data */
@@ -69,6 +77,24 @@ SCIP_RETCODE SCIPprobdataAddVar(
    SCIP_VAR*             var                 /**< variables to add */
    );
 
+/** creates the variable of a packing of a knapsack in the Dantzig-Wolfe formulation, adds it to its rows and to the
+ *  problem data (during the solving process, as a priced variable with the given score) */
+extern
+SCIP_RETCODE SCIPprobdataAddPacking(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_PROBDATA*        probdata,           /**< problem data */
+   int                   knapsack,           /**< knapsack of the packing */
+   const int*            items,              /**< items of the packing, sorted */
+   int                   nitems,             /**< number of items */
+   SCIP_Real             score               /**< score of a priced variable (e.g., minus its reduced cost) */
+   );
+
+/** returns the formulation of the problem (FORMULATION_ASSIGNMENT or FORMULATION_PACKING) */
+extern
+int SCIPprobdataGetFormulation(
+   SCIP_PROBDATA*        probdata            /**< problem data */
+   );
+
 /** returns Probname of the instance */
 extern
 const char* SCIPprobdataGetProbname(
@@ -80,6 +106,15 @@ SCIP_VAR** SCIPprobdataGetVars(
    SCIP_PROBDATA*        probdata            /**< problem data */
    );
 
+/** returns the variable x_i_j of item i and knapsack j (vars are stored in the order x_0_0, x_0_1, ..., x_n-1_m-1);
+ *  only in the assignment formulation */
+extern
+SCIP_VAR* SCIPprobdataGetVar(
+   SCIP_PROBDATA*        probdata,           /**< problem data */
+   int                   i,                  /**< item */
+   int                   j                   /**< knapsack */
+   );
+
 /** returns number of variables */
 extern
 int SCIPprobdataGetNVars(
@@ -98,9 +133,24 @@ int SCIPprobdataGetNcons(
    SCIP_PROBDATA*        probdata            /**< problem data */
 			 );
 
+/** replaces the constraint c of the problem data (e.g., by a presolver); the old one is released and the new one captured */
+extern
+SCIP_RETCODE SCIPprobdataSetCons(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_PROBDATA*        probdata,           /**< problem data */
+   int                   c,                  /**< index of the constraint */
+   SCIP_CONS*            cons                /**< new constraint */
+   );
+
 /** returns instance I */
 extern
 instanceT* SCIPprobdataGetInstance(
    SCIP_PROBDATA*        probdata            /**< problem data */
    );
+
+/** returns the items of the instance as arrays (weight, value, label) and their precomputed orderings */
+extern
+itemArraysT* SCIPprobdataGetItems(
+   SCIP_PROBDATA*        probdata            /**< problem data */
+   );
 #endif
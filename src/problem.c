@@ -1,38 +1,76 @@
 /**@file   problem.c
- * @brief  This file contains routines specific for the problem and the functions loadInstance(), freeInstance, 
- * printInstance, and loadProblem must be implemented 
+ * @brief  This file contains routines specific for the problem and the functions loadInstance(), freeInstance,
+ * printInstance, and loadProblem must be implemented
  *
- **/ 
+ **/
+#define _POSIX_C_SOURCE 200809L
 #include<stdio.h>
+#include<stdlib.h>
 #include<math.h>
+#include<string.h>
+#include<limits.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
 #include "scip/scip.h"
 #include "problem.h"
+#include "kernels.h"
 #include "probdata_mochila.h"
 
+/* alignment (in bytes) of each array stored in the single block of an instance */
+#define INSTANCE_ALIGN 64
+#define ALIGN_UP(x) (((x) + INSTANCE_ALIGN - 1) & ~((size_t) INSTANCE_ALIGN - 1))
+
+/** state of the tokenizer used by loadInstance() */
+typedef struct{
+  const char* p;    // current position in the buffer
+  const char* end;  // end of the buffer
+  int line;         // current line (1-based), used in the error messages
+  const char* filename;
+} parserT;
+
 void freeInstance(instanceT* I)
 {
-  if(I){
-    free(I->item);
-    free(I->C);
-    free(I);
-    I = NULL;
-  }
+  // the instance, the capacities and the items live in the same block (see createInstance())
+  free(I);
 }
 
-// criando a instancia = alocando as estruturas
+// criando a instancia = alocando as estruturas em um unico bloco: [instanceT | item[0..n-1] | C[0..m-1]]
 void createInstance(instanceT** I, int n, int m)
 {
-  *I = (instanceT*) malloc(sizeof(instanceT));
-  (*I)->item = (itemType*) malloc(sizeof(itemType)*n);
-  (*I)->C = (int*) malloc(sizeof(int)*m);
+  size_t offItem, offC, size;
+  char* block;
+
+  offItem = ALIGN_UP(sizeof(instanceT));
+  offC = ALIGN_UP(offItem + sizeof(itemType)*(size_t)n);
+  size = offC + sizeof(int)*(size_t)m;
+
+  block = (char*) malloc(size);
+  if(!block){
+    *I = NULL;
+    return;
+  }
+  *I = (instanceT*) block;
+  (*I)->item = (itemType*) (block + offItem);
+  (*I)->C = (int*) (block + offC);
   (*I)->n = n;
   (*I)->m = m;
 }
+// copia da instancia em um novo bloco (e.g., para o problema de um sub-SCIP, que libera a sua instancia); NULL se faltar memoria
+void copyInstance(instanceT** dst, instanceT* src)
+{
+  createInstance(dst, src->n, src->m);
+  if(!*dst)
+    return;
+  memcpy((*dst)->item, src->item, sizeof(itemType)*(size_t)src->n);
+  memcpy((*dst)->C, src->C, sizeof(int)*(size_t)src->m);
+}
 void printInstance(instanceT* I)
 {
   int i;
   printf("\nInstance with n=%d items, m=%d knapsacks", I->n, I->m);
-  for(i=0;i<I->n;i++){
+  for(i=0;i<I->m;i++){
      printf("\nKnapsack %d Capacity=%d", i+1, I->C[i]);
   }
   printf("\nItems= \n");
@@ -40,38 +78,637 @@ void printInstance(instanceT* I)
      printf("%d value=%d weight=%d\n", I->item[i].label, I->item[i].value, I->item[i].weight);
   }
 }
-int loadInstance(char* filename, instanceT** I)
+
+/** key used to sort the items */
+typedef struct{
+  int value;
+  int weight;
+  int idx;
+} sortKeyT;
+
+static int cmpRatio(const void* a, const void* b)
 {
-  FILE* fin;
-  int n, m, i;
-  fin = fopen(filename, "r");
-  if(!fin){
-    printf("\nProblem to open file %s\n", filename);
+  const sortKeyT* x = (const sortKeyT*) a;
+  const sortKeyT* y = (const sortKeyT*) b;
+  long long lhs, rhs;
+
+  // x->value/x->weight > y->value/y->weight, without divisions (items with null weight come first)
+  lhs = (long long) x->value * y->weight;
+  rhs = (long long) y->value * x->weight;
+  if(x->weight == 0 && y->weight == 0){
+    lhs = x->value;
+    rhs = y->value;
+  }
+  if(lhs != rhs)
+    return lhs > rhs ? -1 : 1;
+  return x->idx - y->idx;
+}
+
+static int cmpValue(const void* a, const void* b)
+{
+  const sortKeyT* x = (const sortKeyT*) a;
+  const sortKeyT* y = (const sortKeyT*) b;
+
+  if(x->value != y->value)
+    return x->value > y->value ? -1 : 1;
+  return x->idx - y->idx;
+}
+
+static int cmpWeight(const void* a, const void* b)
+{
+  const sortKeyT* x = (const sortKeyT*) a;
+  const sortKeyT* y = (const sortKeyT*) b;
+
+  if(x->weight != y->weight)
+    return x->weight < y->weight ? -1 : 1;
+  return x->idx - y->idx;
+}
+
+static void sortItems(sortKeyT* keys, int n, int (*cmp)(const void*, const void*), int* order)
+{
+  int i;
+
+  qsort(keys, n, sizeof(sortKeyT), cmp);
+  for(i = 0; i < n; i++)
+    order[i] = keys[i].idx;
+}
+
+itemArraysT* createItemArrays(instanceT* I)
+{
+  itemArraysT* A;
+  sortKeyT* keys;
+  size_t stride, size;
+  char* block;
+  int i, n;
+
+  n = I->n;
+  // six arrays of n ints in one block, each starting in a new cache line
+  stride = ALIGN_UP(sizeof(int)*(size_t)n);
+  size = ALIGN_UP(sizeof(itemArraysT)) + 6*stride;
+  block = (char*) aligned_alloc(INSTANCE_ALIGN, size);
+  keys = (sortKeyT*) malloc(sizeof(sortKeyT)*(size_t)n);
+  if(!block || !keys){
+    free(block);
+    free(keys);
+    return NULL;
+  }
+  A = (itemArraysT*) block;
+  block += ALIGN_UP(sizeof(itemArraysT));
+  A->n = n;
+  A->weight = (int*) block;
+  A->value = (int*) (block + stride);
+  A->label = (int*) (block + 2*stride);
+  A->byRatio = (int*) (block + 3*stride);
+  A->byValue = (int*) (block + 4*stride);
+  A->byWeight = (int*) (block + 5*stride);
+
+  for(i = 0; i < n; i++){
+    A->weight[i] = I->item[i].weight;
+    A->value[i] = I->item[i].value;
+    A->label[i] = I->item[i].label;
+  }
+  for(i = 0; i < n; i++){
+    keys[i].value = A->value[i];
+    keys[i].weight = A->weight[i];
+    keys[i].idx = i;
+  }
+  sortItems(keys, n, cmpRatio, A->byRatio);
+  sortItems(keys, n, cmpValue, A->byValue);
+  sortItems(keys, n, cmpWeight, A->byWeight);
+  free(keys);
+  return A;
+}
+
+void freeItemArrays(itemArraysT* A)
+{
+  free(A);
+}
+
+/**
+ * @brief largest sum <= capacity of a subset of the weights. The reachable sums are kept in a bitset (bit s is set if
+ * some subset weighs s) that is shifted and or-ed for each weight, i.e., O(n*capacity/64) word operations (see
+ * kernelSubsetSum(), which uses AVX2 when available).
+ *
+ * @param weight weights of the items (weights <= 0 or > capacity are ignored)
+ * @param n number of items
+ * @param capacity capacity of the knapsack
+ * @return the largest reachable sum, or -1 if the bitset could not be allocated
+ */
+int maxSubsetSum(const int* weight, int n, int capacity)
+{
+  return kernelSubsetSum(weight, n, capacity);
+}
+
+/**
+ * @brief Dantzig bound of a single knapsack: optimal value of its LP relaxation, i.e., the greedy by value/weight with
+ * the critical item taken fractionally. O(n) since the order by ratio is precomputed in A.
+ *
+ * @param A items as arrays, with the order by value/weight
+ * @param available available[i] != 0 if item i can be packed
+ * @param capacity capacity of the knapsack
+ * @return the bound
+ */
+double dantzigBound(const itemArraysT* A, const unsigned char* available, long long capacity)
+{
+  const int *weight = A->weight, *value = A->value, *order = A->byRatio;
+  double bound = 0.0;
+  int k, i;
+
+  for(k = 0; k < A->n; k++){
+    i = order[k];
+    if(!available[i])
+      continue;
+    if(weight[i] <= capacity){
+      capacity -= weight[i];
+      bound += value[i];
+    }
+    else{
+      // critical item
+      bound += (double) value[i] * capacity / weight[i];
+      break;
+    }
+  }
+  return bound;
+}
+
+/**
+ * @brief read the next non-empty line of the buffer, which must contain exactly nvals integers
+ *
+ * @param ps parser state (position is moved to the beginning of the next line)
+ * @param vals where the integers are saved
+ * @param nvals number of integers expected in the line
+ * @param what description of the line, used in the error message
+ * @return int 1 if the line is well formed, 0 otherwise (the error is printed with the line number)
+ */
+static int parseLine(parserT* ps, int* vals, int nvals, const char* what)
+{
+  const char* p = ps->p;
+  const char* end = ps->end;
+  int k, neg;
+  long long v;
+
+  // skip blank lines
+  for(;;){
+    while(p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+      p++;
+    if(p < end && *p == '\n'){
+      p++;
+      ps->line++;
+      continue;
+    }
+    break;
+  }
+  if(p >= end){
+    printf("\n%s:%d: unexpected end of file, expected %s\n", ps->filename, ps->line, what);
+    return 0;
+  }
+  for(k = 0; k < nvals; k++){
+    while(p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+      p++;
+    neg = 0;
+    if(p < end && (*p == '-' || *p == '+')){
+      neg = *p == '-';
+      p++;
+    }
+    if(p >= end || (unsigned)(*p - '0') > 9u){
+      printf("\n%s:%d: expected %s (%d integers), found only %d\n", ps->filename, ps->line, what, nvals, k);
+      return 0;
+    }
+    v = 0;
+    while(p < end && (unsigned)(*p - '0') <= 9u){
+      v = v*10 + (*p - '0');
+      if(v > INT_MAX){
+        printf("\n%s:%d: integer out of range in %s\n", ps->filename, ps->line, what);
+        return 0;
+      }
+      p++;
+    }
+    vals[k] = neg ? (int) -v : (int) v;
+  }
+  // only blanks are allowed until the end of the line
+  while(p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    p++;
+  if(p < end && *p != '\n'){
+    printf("\n%s:%d: unexpected character '%c' after %s\n", ps->filename, ps->line, *p, what);
+    return 0;
+  }
+  if(p < end){
+    p++;
+    ps->line++;
+  }
+  ps->p = p;
+  return 1;
+}
+
+/**
+ * @brief parse an instance already mapped in memory
+ *
+ * @param buf contents of the file
+ * @param len size of buf
+ * @param filename name of the file (for the error messages)
+ * @param I pointer to the instance to be created
+ * @return int 1 if the instance is read, 0 otherwise
+ */
+static int parseInstance(const char* buf, size_t len, const char* filename, instanceT** I)
+{
+  parserT ps;
+  int vals[3], n, m, i;
+
+  ps.p = buf;
+  ps.end = buf + len;
+  ps.line = 1;
+  ps.filename = filename;
+
+  if(!parseLine(&ps, vals, 2, "header <n> <m>"))
+    return 0;
+  n = vals[0];
+  m = vals[1];
+  if(n <= 0 || m <= 0){
+    printf("\n%s:%d: invalid header n=%d m=%d\n", filename, ps.line-1, n, m);
     return 0;
   }
-  fscanf(fin,"%d %d\n", &n, &m);
 
   createInstance(I, n, m);  // criando a instancia
+  if(*I == NULL){
+    printf("\nProblem to allocate instance with n=%d m=%d\n", n, m);
+    return 0;
+  }
 
   for(i=0; i<m; i++){
     // lendo as capacidades de cada mochila
-     fscanf(fin, "%d\n", &((*I)->C[i]));
+    if(!parseLine(&ps, &((*I)->C[i]), 1, "knapsack capacity"))
+      goto FREEINSTANCE;
   }
 
   for(i=0; i<n; i++){
-    // lendo o nome, o valor e o peso de cada item
-     fscanf(fin, "%d %d %d\n", &((*I)->item[i].label), &((*I)->item[i].weight), &((*I)->item[i].value));
+    // lendo o nome, o peso e o valor de cada item
+    if(!parseLine(&ps, vals, 3, "item <label> <weight> <value>"))
+      goto FREEINSTANCE;
+    (*I)->item[i].label = vals[0];
+    (*I)->item[i].weight = vals[1];
+    (*I)->item[i].value = vals[2];
+  }
+  return 1;
+
+FREEINSTANCE:
+  freeInstance(*I);
+  *I = NULL;
+  return 0;
+}
+
+/** maps a whole file in memory (read only). Returns NULL if the file can not be mapped */
+static char* mapFile(const char* filename, struct stat* st, int verbose)
+{
+  char* buf;
+  int fd;
+
+  fd = open(filename, O_RDONLY);
+  if(fd < 0){
+    if(verbose)
+      printf("\nProblem to open file %s\n", filename);
+    return NULL;
+  }
+  if(fstat(fd, st) < 0 || st->st_size == 0){
+    if(verbose)
+      printf("\nProblem to read file %s (empty or not a regular file)\n", filename);
+    close(fd);
+    return NULL;
+  }
+  buf = (char*) mmap(NULL, (size_t) st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(buf == MAP_FAILED){
+    if(verbose)
+      printf("\nProblem to map file %s\n", filename);
+    return NULL;
+  }
+  (void) posix_madvise(buf, (size_t) st->st_size, POSIX_MADV_SEQUENTIAL);
+  return buf;
+}
+
+int loadInstanceText(char* filename, instanceT** I)
+{
+  struct stat st;
+  char* buf;
+  int ok;
+
+  *I = NULL;
+  // the whole file is mapped and parsed in a single pass, without copying it
+  buf = mapFile(filename, &st, 1);
+  if(!buf)
+    return 0;
+
+  ok = parseInstance(buf, (size_t) st.st_size, filename, I);
+
+  munmap(buf, (size_t) st.st_size);
+  return ok;
+}
+
+/** skips the blank lines; returns 1 if the end of the buffer is reached */
+static int skipBlankLines(parserT* ps)
+{
+  const char* p = ps->p;
+
+  for(;;){
+    while(p < ps->end && (*p == ' ' || *p == '\t' || *p == '\r'))
+      p++;
+    if(p < ps->end && *p == '\n'){
+      p++;
+      ps->line++;
+      ps->p = p;
+      continue;
+    }
+    break;
   }
-  fclose(fin);
+  return p >= ps->end;
+}
+
+int streamInstance(char* filename, streamHeaderFn header, streamItemFn item, void* ctx)
+{
+  FILE* f;
+  parserT ps;
+  char *buf, *last;
+  size_t len, nread, complete;
+  int vals[3], *C = NULL, n = 0, m = 0, i = 0, k = 0, ok = 0, eof = 0, state = 0;
+
+  f = fopen(filename, "rb");
+  if(!f){
+    printf("\nProblem to open file %s\n", filename);
+    return 0;
+  }
+  buf = (char*) malloc(STREAM_CHUNK);
+  if(!buf){
+    fclose(f);
+    return 0;
+  }
+  ps.line = 1;
+  ps.filename = filename;
+  len = 0;
+  // state 0: header, 1: capacities, 2: items, 3: done
+  while(state < 3){
+    nread = fread(buf + len, 1, STREAM_CHUNK - len, f);
+    len += nread;
+    eof = nread == 0;
+    // only the complete lines of the chunk are parsed, the rest is carried to the next one
+    if(eof)
+      complete = len;
+    else{
+      for(last = buf + len - 1; last >= buf && *last != '\n'; last--)
+        ;
+      if(last < buf){
+        if(len < STREAM_CHUNK)
+          continue;
+        printf("\n%s:%d: line longer than %d bytes\n", filename, ps.line, STREAM_CHUNK);
+        goto TERMINATE;
+      }
+      complete = (size_t) (last - buf) + 1;
+    }
+    ps.p = buf;
+    ps.end = buf + complete;
+    while(state < 3 && !skipBlankLines(&ps)){
+      if(state == 0){
+        if(!parseLine(&ps, vals, 2, "header <n> <m>"))
+          goto TERMINATE;
+        n = vals[0];
+        m = vals[1];
+        if(n <= 0 || m <= 0){
+          printf("\n%s:%d: invalid header n=%d m=%d\n", filename, ps.line-1, n, m);
+          goto TERMINATE;
+        }
+        C = (int*) malloc(sizeof(int)*m);
+        if(!C)
+          goto TERMINATE;
+        state = 1;
+      }
+      else if(state == 1){
+        if(!parseLine(&ps, &C[k], 1, "knapsack capacity"))
+          goto TERMINATE;
+        if(++k == m){
+          if(!header(ctx, n, m, C))
+            goto TERMINATE;
+          state = 2;
+        }
+      }
+      else{
+        if(!parseLine(&ps, vals, 3, "item <label> <weight> <value>"))
+          goto TERMINATE;
+        item(ctx, i, vals[0], vals[1], vals[2]);
+        if(++i == n)
+          state = 3;
+      }
+    }
+    if(eof)
+      break;
+    len -= complete;
+    memmove(buf, buf + complete, len);
+  }
+  if(state < 3)
+    printf("\n%s:%d: unexpected end of file, expected %s\n", filename, ps.line,
+           state == 0 ? "header <n> <m>" : state == 1 ? "knapsack capacity" : "item <label> <weight> <value>");
+  ok = state == 3;
+
+TERMINATE:
+  free(C);
+  free(buf);
+  fclose(f);
+  return ok;
+}
+
+/*
+ * binary cache (.mochilab)
+ *
+ * layout (native endianness, every section starts at a multiple of INSTANCE_ALIGN):
+ *    binaryHeaderT | C[0..m-1] | weight[0..n-1] | value[0..n-1] | label[0..n-1]
+ * the checksum covers everything after the header.
+ */
+#define BINARY_MAGIC "MOCHILAB"
+#define BINARY_VERSION 1
+
+typedef struct{
+  char magic[8];           // BINARY_MAGIC
+  int version;             // BINARY_VERSION
+  int n;                   // quant de itens
+  int m;                   // quant de mochilas
+  int pad;
+  long long srcsize;       // size of the text file used to create the cache (-1 if unknown)
+  long long srcmtime;      // modification time of the text file, in ns (-1 if unknown)
+  unsigned long long checksum; // checksum of the payload
+} binaryHeaderT;
+
+/** offsets of each section of a binary instance */
+static void binaryLayout(int n, int m, size_t* offC, size_t* offWeight, size_t* offValue, size_t* offLabel, size_t* size)
+{
+  *offC = ALIGN_UP(sizeof(binaryHeaderT));
+  *offWeight = ALIGN_UP(*offC + sizeof(int)*(size_t)m);
+  *offValue = ALIGN_UP(*offWeight + sizeof(int)*(size_t)n);
+  *offLabel = ALIGN_UP(*offValue + sizeof(int)*(size_t)n);
+  *size = *offLabel + sizeof(int)*(size_t)n;
+}
+
+/** FNV-1a like hash computed over 64-bit words (the tail is hashed byte by byte) */
+static unsigned long long binaryChecksum(const char* buf, size_t len)
+{
+  unsigned long long h = 1469598103934665603ULL, w;
+  size_t k;
+
+  for(k = 0; k + 8 <= len; k += 8){
+    memcpy(&w, buf + k, 8);
+    h = (h ^ w) * 1099511628211ULL;
+  }
+  for(; k < len; k++)
+    h = (h ^ (unsigned char) buf[k]) * 1099511628211ULL;
+  return h;
+}
+
+int instanceFileStamp(const char* filename, long long* size, long long* mtime)
+{
+  struct stat st;
+
+  if(stat(filename, &st) < 0)
+    return 0;
+  *size = (long long) st.st_size;
+  *mtime = (long long) st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+  return 1;
+}
+
+void binaryInstanceName(const char* filename, char* binname, int size)
+{
+  (void) snprintf(binname, size, "%sb", filename);
+}
+
+int saveInstanceBinary(char* filename, instanceT* I, long long srcsize, long long srcmtime)
+{
+  binaryHeaderT* header;
+  size_t offC, offWeight, offValue, offLabel, size;
+  char tmpname[SCIP_MAXSTRLEN];
+  char* buf;
+  int *weight, *value, *label;
+  FILE* fout;
+  int i, ok;
+
+  binaryLayout(I->n, I->m, &offC, &offWeight, &offValue, &offLabel, &size);
+  buf = (char*) calloc(size, 1);
+  if(!buf)
+    return 0;
+
+  memcpy((int*) (buf + offC), I->C, sizeof(int)*(size_t)I->m);
+  weight = (int*) (buf + offWeight);
+  value = (int*) (buf + offValue);
+  label = (int*) (buf + offLabel);
+  for(i = 0; i < I->n; i++){
+    weight[i] = I->item[i].weight;
+    value[i] = I->item[i].value;
+    label[i] = I->item[i].label;
+  }
+  header = (binaryHeaderT*) buf;
+  memcpy(header->magic, BINARY_MAGIC, 8);
+  header->version = BINARY_VERSION;
+  header->n = I->n;
+  header->m = I->m;
+  header->srcsize = srcsize;
+  header->srcmtime = srcmtime;
+  header->checksum = binaryChecksum(buf + offC, size - offC);
+
+  // write in a temporary file and rename it, so concurrent runs never read a partial cache
+  (void) snprintf(tmpname, SCIP_MAXSTRLEN, "%s.tmp%ld", filename, (long) getpid());
+  fout = fopen(tmpname, "wb");
+  if(!fout){
+    free(buf);
+    return 0;
+  }
+  ok = fwrite(buf, 1, size, fout) == size;
+  ok = (fclose(fout) == 0) && ok;
+  free(buf);
+  if(ok)
+    ok = rename(tmpname, filename) == 0;
+  if(!ok)
+    remove(tmpname);
+  return ok;
+}
+
+int loadInstanceBinary(char* filename, instanceT** I, long long srcsize, long long srcmtime)
+{
+  const binaryHeaderT* header;
+  size_t offC, offWeight, offValue, offLabel, size;
+  const int *weight, *value, *label;
+  struct stat st;
+  char* buf;
+  int i, ok;
+
+  *I = NULL;
+  buf = mapFile(filename, &st, 0);
+  if(!buf)
+    return 0;
+
+  ok = 0;
+  header = (const binaryHeaderT*) buf;
+  if((size_t) st.st_size < sizeof(binaryHeaderT) || memcmp(header->magic, BINARY_MAGIC, 8) || header->version != BINARY_VERSION
+     || header->n <= 0 || header->m <= 0)
+    goto UNMAP;
+  // stale cache: the text file changed after the cache was written
+  if(srcsize >= 0 && (header->srcsize != srcsize || header->srcmtime != srcmtime))
+    goto UNMAP;
+  binaryLayout(header->n, header->m, &offC, &offWeight, &offValue, &offLabel, &size);
+  if((size_t) st.st_size != size || binaryChecksum(buf + offC, size - offC) != header->checksum){
+    printf("\nCorrupted instance cache %s (ignored)\n", filename);
+    goto UNMAP;
+  }
+
+  createInstance(I, header->n, header->m);
+  if(*I == NULL)
+    goto UNMAP;
+  memcpy((*I)->C, buf + offC, sizeof(int)*(size_t)header->m);
+  weight = (const int*) (buf + offWeight);
+  value = (const int*) (buf + offValue);
+  label = (const int*) (buf + offLabel);
+  for(i = 0; i < header->n; i++){
+    (*I)->item[i].label = label[i];
+    (*I)->item[i].weight = weight[i];
+    (*I)->item[i].value = value[i];
+  }
+  ok = 1;
+
+UNMAP:
+  munmap(buf, (size_t) st.st_size);
+  return ok;
+}
+
+int loadInstance(char* filename, instanceT** I)
+{
+  char binname[SCIP_MAXSTRLEN];
+  long long srcsize, srcmtime;
+  size_t len;
+
+  len = strlen(filename);
+  // the given file is already a binary instance
+  if(len > 9 && !strcmp(filename + len - 9, ".mochilab")){
+    if(!loadInstanceBinary(filename, I, -1, -1)){
+      printf("\nProblem to read binary instance %s\n", filename);
+      return 0;
+    }
+    return 1;
+  }
+  if(!instanceFileStamp(filename, &srcsize, &srcmtime)){
+    printf("\nProblem to open file %s\n", filename);
+    return 0;
+  }
+  // use the cache next to the text file, if it is up to date
+  binaryInstanceName(filename, binname, SCIP_MAXSTRLEN);
+  if(loadInstanceBinary(binname, I, srcsize, srcmtime))
+    return 1;
+
+  if(!loadInstanceText(filename, I))
+    return 0;
+  // best effort: a read-only data folder only means that the next run parses the text again
+  (void) saveInstanceBinary(binname, *I, srcsize, srcmtime);
   return 1;
 }
 
 // load instance problem into SCIP
-int loadProblem(SCIP* scip, char* probname, instanceT* I)
+int loadProblem(SCIP* scip, char* probname, instanceT* I, int usenames, int nativecons, int formulation)
 {
   SCIP_RETCODE ret_code;
 
-  ret_code = SCIPprobdataCreate(scip, probname, I);
+  ret_code = SCIPprobdataCreate(scip, probname, I, usenames ? TRUE : FALSE, nativecons ? TRUE : FALSE, formulation);
   if(ret_code!=SCIP_OKAY)
     return 0;
   return 1;
@@ -10,6 +10,7 @@ typedef struct{
   int weight;  // peso do item
 }itemType;
 
+/** instance of the problem. The structure, C and item are allocated in a single block by createInstance() */
 typedef struct{
    int n;   // quant de itens
    int m;   // quant de mochilas
@@ -17,11 +18,51 @@ typedef struct{
    itemType *item; /**< data for each item in 0..n-1 */
 } instanceT;
 
+/** structure of arrays view of the items (each array is 64-byte aligned), plus orderings computed once per instance */
+typedef struct{
+   int n;          /**< quant de itens */
+   int *weight;    /**< weight[i] = peso do item i */
+   int *value;     /**< value[i] = valor do item i */
+   int *label;     /**< label[i] = rotulo do item i */
+   int *byRatio;   /**< items sorted by value/weight, non-increasing (ties by index) */
+   int *byValue;   /**< items sorted by value, non-increasing (ties by index) */
+   int *byWeight;  /**< items sorted by weight, non-decreasing (ties by index) */
+} itemArraysT;
+
 void freeInstance(instanceT* I);
 void createInstance(instanceT** I, int n, int m);
+void copyInstance(instanceT** dst, instanceT* src);
 void printInstance(instanceT* I);
-// load instance from a file
+// create the structure of arrays view of the items of I and their orderings
+itemArraysT* createItemArrays(instanceT* I);
+void freeItemArrays(itemArraysT* A);
+// largest sum <= capacity of a subset of weight[0..n-1] (bitset subset-sum). Returns -1 if there is no memory
+int maxSubsetSum(const int* weight, int n, int capacity);
+// Dantzig bound: the items with available[i] != 0 are packed in the order by value/weight (A->byRatio) while they fit
+// the capacity, and the first one that does not fit is taken fractionally (LP bound of a single knapsack)
+double dantzigBound(const itemArraysT* A, const unsigned char* available, long long capacity);
+// load instance from a file. A fresh binary cache (<filename>b) is used when available, otherwise the text
+// is parsed and the cache is (re)written
 int loadInstance(char* filename, instanceT** I);
-// load instance problem into SCIP
-int loadProblem(SCIP* scip, char* probname, instanceT* in);
+// load instance from a text file (the file is memory-mapped; malformed lines are reported with their line number)
+int loadInstanceText(char* filename, instanceT** I);
+// load instance from a binary file. If srcsize >= 0, the cache must have been created from a text file with that size and mtime
+int loadInstanceBinary(char* filename, instanceT** I, long long srcsize, long long srcmtime);
+// streaming reader: the text file is read in chunks of STREAM_CHUNK bytes and never kept whole in memory. header() gets
+// n, m and the capacities (returning 0 stops the reading) and item() gets each item in the order of the file. Returns 1
+// if the whole file is read
+#define STREAM_CHUNK (1 << 20)
+typedef int (*streamHeaderFn)(void* ctx, int n, int m, const int* C);
+typedef void (*streamItemFn)(void* ctx, int i, int label, int weight, int value);
+int streamInstance(char* filename, streamHeaderFn header, streamItemFn item, void* ctx);
+// save instance in a binary file
+int saveInstanceBinary(char* filename, instanceT* I, long long srcsize, long long srcmtime);
+// size and modification time (in ns) of a file, used to detect stale binary caches
+int instanceFileStamp(const char* filename, long long* size, long long* mtime);
+// name of the binary cache of a text instance file
+void binaryInstanceName(const char* filename, char* binname, int size);
+// load instance problem into SCIP (usenames: name vars and constraints, needed to write the model in a LP file;
+// nativecons: knapsack and set-packing constraints instead of linear constraints; formulation: FORMULATION_ASSIGNMENT
+// or FORMULATION_PACKING, see probdata_mochila.h)
+int loadProblem(SCIP* scip, char* probname, instanceT* in, int usenames, int nativecons, int formulation);
 #endif
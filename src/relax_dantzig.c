@@ -0,0 +1,265 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   relax_dantzig.c
+ * @brief  relaxator with the Dantzig bound of the multiple knapsack over the aggregated residual capacity
+ *
+ * At each node, the items fixed in 1.0 (some x_i_j with local lower bound 1.0) are taken, the residual capacities of
+ * the knapsacks are computed and all of them are merged in a single knapsack. The free items that still fit the
+ * residual of some knapsack they can go to are packed in it by the Dantzig bound (greedy by value/weight with a
+ * fractional critical item), using the order by ratio computed once in the problem data (see dantzigBound()).
+ * This is a relaxation of the LP of the node, computed in O(n*m) to read the local bounds plus O(n) for the bound,
+ * instead of a simplex over n*m columns.
+ *
+ * The relaxator can be used together with the LP (the best of both bounds is used) or alone, with the LP turned off
+ * (lp/solvefreq = -1), see the parameter --relax_dantzig.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <math.h>
+
+#include "probdata_mochila.h"
+#include "parameters_mochila.h"
+#include "relax_dantzig.h"
+
+//#define DEBUG_DANTZIG 1
+/* configuracao do relaxador */
+#define RELAX_NAME             "dantzig"
+#define RELAX_DESC             "Dantzig bound of the multiple knapsack over the aggregated residual capacity"
+#define RELAX_PRIORITY         1000 /**< priority of the relaxator (>= 0: before, < 0: after the LP) */
+#define RELAX_FREQ             1    /**< frequency for calling relaxator (-1: never, 0: only in root node) */
+
+/*
+ * Data structures
+ */
+
+/** relaxator data */
+struct SCIP_RelaxData
+{
+   SCIP_Longint*         residual;           /**< residual capacity of each knapsack at the current node */
+   unsigned char*        available;          /**< available[i] = 1 if item i can still be packed at the current node */
+   int                   nknaps;             /**< size of residual */
+   int                   nitems;             /**< size of available */
+   SCIP_Longint          ncutoffs;           /**< number of nodes cut off since some knapsack is overloaded */
+};
+
+/*
+ * Callback methods of relaxator
+ */
+
+/** copy method for relaxator plugins (called when SCIP copies plugins) */
+static
+SCIP_DECL_RELAXCOPY(relaxCopyDantzig)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+/** destructor of relaxator to free user data (called when SCIP is exiting) */
+static
+SCIP_DECL_RELAXFREE(relaxFreeDantzig)
+{  /*lint --e{715}*/
+   SCIP_RELAXDATA* relaxdata;
+
+   relaxdata = SCIPrelaxGetData(relax);
+   assert(relaxdata != NULL);
+
+   SCIPfreeBlockMemory(scip, &relaxdata);
+   SCIPrelaxSetData(relax, NULL);
+
+   return SCIP_OKAY;
+}
+
+/** solving process initialization method of relaxator (called when branch and bound process is about to begin) */
+static
+SCIP_DECL_RELAXINITSOL(relaxInitsolDantzig)
+{  /*lint --e{715}*/
+   SCIP_RELAXDATA* relaxdata;
+   instanceT* I;
+
+   relaxdata = SCIPrelaxGetData(relax);
+   assert(relaxdata != NULL);
+
+   I = SCIPprobdataGetInstance(SCIPgetProbData(scip));
+   relaxdata->nknaps = I->m;
+   relaxdata->nitems = I->n;
+   relaxdata->ncutoffs = 0;
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &relaxdata->residual, I->m) );
+   SCIP_CALL( SCIPallocBlockMemoryArray(scip, &relaxdata->available, I->n) );
+
+   return SCIP_OKAY;
+}
+
+/** solving process deinitialization method of relaxator (called before branch and bound process data is freed) */
+static
+SCIP_DECL_RELAXEXITSOL(relaxExitsolDantzig)
+{  /*lint --e{715}*/
+   SCIP_RELAXDATA* relaxdata;
+
+   relaxdata = SCIPrelaxGetData(relax);
+   assert(relaxdata != NULL);
+
+#ifdef DEBUG_DANTZIG
+   printf("\nRelaxator %s: %lld nodes cut off by overloaded knapsacks\n", RELAX_NAME, (long long) relaxdata->ncutoffs);
+#endif
+   SCIPfreeBlockMemoryArrayNull(scip, &relaxdata->available, relaxdata->nitems);
+   SCIPfreeBlockMemoryArrayNull(scip, &relaxdata->residual, relaxdata->nknaps);
+
+   return SCIP_OKAY;
+}
+
+/** execution method of relaxator */
+static
+SCIP_DECL_RELAXEXEC(relaxExecDantzig)
+{  /*lint --e{715}*/
+   SCIP_RELAXDATA* relaxdata;
+   SCIP_PROBDATA* probdata;
+   SCIP_VAR* var;
+   SCIP_Longint* residual;
+   SCIP_Longint capacity;
+   unsigned char* available;
+   instanceT* I;
+   itemArraysT* items;
+   double bound;
+   int i, j, assigned, anyfree;
+
+   assert(result != NULL);
+   *result = SCIP_DIDNOTRUN;
+
+   relaxdata = SCIPrelaxGetData(relax);
+   assert(relaxdata != NULL);
+   residual = relaxdata->residual;
+   available = relaxdata->available;
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+   I = SCIPprobdataGetInstance(probdata);
+   items = SCIPprobdataGetItems(probdata);
+
+   // items fixed in 1.0 use their knapsack; the others are available if some x_i_j is free
+   for( j = 0; j < I->m; j++ )
+      residual[j] = I->C[j];
+   bound = 0.0;
+   for( i = 0; i < I->n; i++ )
+   {
+      assigned = -1;
+      anyfree = 0;
+      for( j = 0; j < I->m; j++ )
+      {
+         var = SCIPprobdataGetVar(probdata, i, j);
+         if( SCIPvarGetLbLocal(var) > 0.5 )
+         {
+            // item i in two knapsacks
+            if( assigned >= 0 )
+            {
+               relaxdata->ncutoffs++;
+               *result = SCIP_CUTOFF;
+               return SCIP_OKAY;
+            }
+            assigned = j;
+         }
+         else if( SCIPvarGetUbLocal(var) > 0.5 )
+            anyfree = 1;
+      }
+      if( assigned >= 0 )
+      {
+         residual[assigned] -= items->weight[i];
+         bound += items->value[i];
+         available[i] = 0;
+      }
+      else
+         available[i] = (unsigned char) anyfree;
+   }
+
+   capacity = 0;
+   for( j = 0; j < I->m; j++ )
+   {
+      if( residual[j] < 0 )
+      {
+         relaxdata->ncutoffs++;
+         *result = SCIP_CUTOFF;
+         return SCIP_OKAY;
+      }
+      capacity += residual[j];
+   }
+
+   // a free item is only available if it fits the residual of some knapsack it can still go to
+   for( i = 0; i < I->n; i++ )
+   {
+      if( !available[i] )
+         continue;
+      available[i] = 0;
+      for( j = 0; j < I->m; j++ )
+      {
+         if( items->weight[i] <= residual[j] && SCIPvarGetUbLocal(SCIPprobdataGetVar(probdata, i, j)) > 0.5 )
+         {
+            available[i] = 1;
+            break;
+         }
+      }
+   }
+
+   bound += dantzigBound(items, available, capacity);
+   // the objective is integral
+   bound = floor(bound + 1e-6);
+
+   // SCIP minimizes the transformed problem, whose offset has the value of the items fixed out of the model (core mode)
+   *lowerbound = SCIPtransformObj(scip, bound + SCIPgetOrigObjoffset(scip));
+   *result = SCIP_SUCCESS;
+
+   return SCIP_OKAY;
+}
+
+
+/*
+ * relaxator specific interface methods
+ */
+
+/** creates the dantzig relaxator and includes it in SCIP */
+SCIP_RETCODE SCIPincludeRelaxDantzig(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_RELAXDATA* relaxdata;
+   SCIP_RELAX* relax;
+
+   /* create dantzig relaxator data */
+   SCIP_CALL( SCIPallocBlockMemory(scip, &relaxdata) );
+   relaxdata->residual = NULL;
+   relaxdata->available = NULL;
+   relaxdata->nknaps = 0;
+   relaxdata->nitems = 0;
+   relaxdata->ncutoffs = 0;
+
+   relax = NULL;
+
+   /* use SCIPincludeRelaxBasic() plus setter functions if you want to set callbacks one-by-one and your code should
+    * compile independent of new callbacks being added in future SCIP versions
+    */
+   SCIP_CALL( SCIPincludeRelaxBasic(scip, &relax, RELAX_NAME, RELAX_DESC, RELAX_PRIORITY, RELAX_FREQ,
+         relaxExecDantzig, relaxdata) );
+
+   assert(relax != NULL);
+
+   /* set non fundamental callbacks via setter functions */
+   SCIP_CALL( SCIPsetRelaxCopy(scip, relax, relaxCopyDantzig) );
+   SCIP_CALL( SCIPsetRelaxFree(scip, relax, relaxFreeDantzig) );
+   SCIP_CALL( SCIPsetRelaxInitsol(scip, relax, relaxInitsolDantzig) );
+   SCIP_CALL( SCIPsetRelaxExitsol(scip, relax, relaxExitsolDantzig) );
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,254 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2016 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   relax_lagrangian.c
+ * @brief  relaxator with the Lagrangian bound of the item rows, solved as m independent knapsacks
+ *
+ * At the root node, the engine of lagrangian.c relaxes the rows sum_j x_i_j <= 1 and optimizes the multipliers by
+ * subgradient steps, solving the m knapsacks of each iteration in parallel on a thread pool (parameter --threads).
+ * The best Lagrangian bound is given to SCIP as the lower bound of the root, and the best repaired solution of the
+ * iterations (see runLagrangian()) is submitted with SCIPtrySolMine().
+ *
+ * The bound does not depend on the local bounds of the node, so the relaxator only runs once (RELAX_FREQ = 0); the
+ * number of iterations is set by --lagr_iter.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+#include <math.h>
+
+#include "probdata_mochila.h"
+#include "parameters_mochila.h"
+#include "heur_problem.h"
+#include "lagrangian.h"
+#include "relax_lagrangian.h"
+
+//#define DEBUG_LAGRANGIAN 1
+/* configuracao do relaxador */
+#define RELAX_NAME             "lagrangian"
+#define RELAX_DESC             "Lagrangian bound of the item rows, solved as m independent knapsacks"
+#define RELAX_PRIORITY         2000 /**< priority of the relaxator (>= 0: before, < 0: after the LP) */
+#define RELAX_FREQ             0    /**< frequency for calling relaxator (-1: never, 0: only in root node) */
+
+/*
+ * Data structures
+ */
+
+/** relaxator data */
+struct SCIP_RelaxData
+{
+   threadpoolT*          pool;               /**< threads used to solve the knapsacks */
+   lagrangianT*          lagr;               /**< Lagrangian engine */
+   SCIP_Bool             done;               /**< the bound was already computed */
+};
+
+/*
+ * Local methods
+ */
+
+/** builds the best repaired solution of the engine and tries to add it to SCIP */
+static
+SCIP_RETCODE trySolLagrangian(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_RELAX*           relax,              /**< the relaxator */
+   lagrangianT*          lagr                /**< Lagrangian engine after runLagrangian() */
+   )
+{
+   SCIP_PROBDATA* probdata;
+   SCIP_SOL* sol;
+   SCIP_Bool stored;
+   int i;
+
+   probdata = SCIPgetProbData(scip);
+   assert(probdata != NULL);
+
+   SCIP_CALL( SCIPcreateSol(scip, &sol, NULL) );
+   for( i = 0; i < lagr->n; i++ )
+   {
+      if( lagr->assign[i] >= 0 )
+      {
+         SCIP_CALL( SCIPsetSolVal(scip, sol, SCIPprobdataGetVar(probdata, i, lagr->assign[i]), 1.0) );
+      }
+   }
+   SCIP_CALL( SCIPtrySolMine(scip, sol, TRUE, TRUE, FALSE, TRUE, &stored) );
+   SCIP_CALL( SCIPfreeSol(scip, &sol) );
+
+#ifdef DEBUG_LAGRANGIAN
+   printf("\nRelaxator %s: repaired solution %lld %s\n", SCIPrelaxGetName(relax), lagr->primal, stored ? "stored" : "rejected");
+#endif
+
+   return SCIP_OKAY;
+}
+
+/*
+ * Callback methods of relaxator
+ */
+
+/** copy method for relaxator plugins (called when SCIP copies plugins) */
+static
+SCIP_DECL_RELAXCOPY(relaxCopyLagrangian)
+{  /*lint --e{715}*/
+
+   return SCIP_OKAY;
+}
+
+/** destructor of relaxator to free user data (called when SCIP is exiting) */
+static
+SCIP_DECL_RELAXFREE(relaxFreeLagrangian)
+{  /*lint --e{715}*/
+   SCIP_RELAXDATA* relaxdata;
+
+   relaxdata = SCIPrelaxGetData(relax);
+   assert(relaxdata != NULL);
+
+   SCIPfreeBlockMemory(scip, &relaxdata);
+   SCIPrelaxSetData(relax, NULL);
+
+   return SCIP_OKAY;
+}
+
+/** solving process initialization method of relaxator (called when branch and bound process is about to begin) */
+static
+SCIP_DECL_RELAXINITSOL(relaxInitsolLagrangian)
+{  /*lint --e{715}*/
+   SCIP_RELAXDATA* relaxdata;
+   SCIP_PROBDATA* probdata;
+
+   relaxdata = SCIPrelaxGetData(relax);
+   assert(relaxdata != NULL);
+
+   probdata = SCIPgetProbData(scip);
+   relaxdata->done = FALSE;
+   relaxdata->pool = createThreadpool(param.threads);
+   relaxdata->lagr = createLagrangian(SCIPprobdataGetInstance(probdata), SCIPprobdataGetItems(probdata), relaxdata->pool);
+   if( relaxdata->lagr == NULL )
+   {
+      SCIPerrorMessage("not enough memory for the Lagrangian relaxation\n");
+      return SCIP_NOMEMORY;
+   }
+
+   return SCIP_OKAY;
+}
+
+/** solving process deinitialization method of relaxator (called before branch and bound process data is freed) */
+static
+SCIP_DECL_RELAXEXITSOL(relaxExitsolLagrangian)
+{  /*lint --e{715}*/
+   SCIP_RELAXDATA* relaxdata;
+
+   relaxdata = SCIPrelaxGetData(relax);
+   assert(relaxdata != NULL);
+
+   if( relaxdata->lagr != NULL )
+   {
+#ifdef DEBUG_LAGRANGIAN
+      printf("\nRelaxator %s: bound %.1lf, repaired solution %lld, %d iterations, %d distinct knapsacks, %d by Dantzig, %d threads\n",
+         RELAX_NAME, relaxdata->lagr->bound, relaxdata->lagr->primal, relaxdata->lagr->iterations, relaxdata->lagr->nsolved,
+         relaxdata->lagr->nfallback, threadpoolSize(relaxdata->pool));
+#endif
+      freeLagrangian(relaxdata->lagr);
+      relaxdata->lagr = NULL;
+   }
+   freeThreadpool(relaxdata->pool);
+   relaxdata->pool = NULL;
+
+   return SCIP_OKAY;
+}
+
+/** execution method of relaxator */
+static
+SCIP_DECL_RELAXEXEC(relaxExecLagrangian)
+{  /*lint --e{715}*/
+   SCIP_RELAXDATA* relaxdata;
+   SCIP_Real timelimit;
+   long long lowerbound_primal;
+   double bound;
+
+   assert(result != NULL);
+   *result = SCIP_DIDNOTRUN;
+
+   relaxdata = SCIPrelaxGetData(relax);
+   assert(relaxdata != NULL);
+
+   if( relaxdata->done || relaxdata->lagr == NULL )
+      return SCIP_OKAY;
+   relaxdata->done = TRUE;
+
+   // the best known solution lets the subgradient stop as soon as it is proved optimal
+   lowerbound_primal = 0;
+   if( SCIPgetNSols(scip) > 0 )
+      lowerbound_primal = (long long) floor(SCIPgetPrimalboundMine(scip) + 1e-6);
+
+   // the subgradient stops at the time limit of SCIP (-1: none)
+   SCIP_CALL( SCIPgetRealParam(scip, "limits/time", &timelimit) );
+   if( SCIPisInfinity(scip, timelimit) )
+      timelimit = -1.0;
+   else
+   {
+      timelimit -= SCIPgetSolvingTime(scip);
+      if( timelimit <= 0.0 )
+         return SCIP_OKAY;
+   }
+
+   bound = runLagrangian(relaxdata->lagr, param.lagr_iter, lowerbound_primal, timelimit);
+
+   SCIP_CALL( trySolLagrangian(scip, relax, relaxdata->lagr) );
+
+   // the objective is integral; SCIP minimizes the transformed problem, whose offset has the value of the items fixed
+   // out of the model (core mode)
+   *lowerbound = SCIPtransformObj(scip, floor(bound + 1e-6) + SCIPgetOrigObjoffset(scip));
+   *result = SCIP_SUCCESS;
+
+   return SCIP_OKAY;
+}
+
+
+/*
+ * relaxator specific interface methods
+ */
+
+/** creates the lagrangian relaxator and includes it in SCIP */
+SCIP_RETCODE SCIPincludeRelaxLagrangian(
+   SCIP*                 scip                /**< SCIP data structure */
+   )
+{
+   SCIP_RELAXDATA* relaxdata;
+   SCIP_RELAX* relax;
+
+   /* create lagrangian relaxator data */
+   SCIP_CALL( SCIPallocBlockMemory(scip, &relaxdata) );
+   relaxdata->pool = NULL;
+   relaxdata->lagr = NULL;
+   relaxdata->done = FALSE;
+
+   relax = NULL;
+
+   /* use SCIPincludeRelaxBasic() plus setter functions if you want to set callbacks one-by-one and your code should
+    * compile independent of new callbacks being added in future SCIP versions
+    */
+   SCIP_CALL( SCIPincludeRelaxBasic(scip, &relax, RELAX_NAME, RELAX_DESC, RELAX_PRIORITY, RELAX_FREQ,
+         relaxExecLagrangian, relaxdata) );
+
+   assert(relax != NULL);
+
+   /* set non fundamental callbacks via setter functions */
+   SCIP_CALL( SCIPsetRelaxCopy(scip, relax, relaxCopyLagrangian) );
+   SCIP_CALL( SCIPsetRelaxFree(scip, relax, relaxFreeLagrangian) );
+   SCIP_CALL( SCIPsetRelaxInitsol(scip, relax, relaxInitsolLagrangian) );
+   SCIP_CALL( SCIPsetRelaxExitsol(scip, relax, relaxExitsolLagrangian) );
+
+   return SCIP_OKAY;
+}
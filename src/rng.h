@@ -0,0 +1,51 @@
+/**@file   rng.h
+ * @brief  counter-based random number streams (no SCIP calls, no global state)
+ *
+ * The k-th number of a stream is a function of (key, k) only: the SplitMix64 finalizer applied to key + k*GAMMA, where
+ * the key is derived from the user seed and the stream number. So a stream costs two words, any number of threads can
+ * draw from their own streams without locks, and a stream gives the same numbers whatever thread draws them. The GRASP
+ * uses one stream per construction, so its result does not depend on the number of threads.
+ **/
+#ifndef __MOCHILA_RNG_H__
+#define __MOCHILA_RNG_H__
+
+#include <stdint.h>
+
+#define RNG_GAMMA 0x9e3779b97f4a7c15ULL
+
+typedef struct{
+  uint64_t key;      // derived from the seed and the stream number
+  uint64_t counter;  // numbers drawn from the stream
+} rngT;
+
+static inline uint64_t rngMix(uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// stream number stream of the seed
+static inline void rngInit(rngT* r, uint64_t seed, uint64_t stream)
+{
+  r->key = rngMix(rngMix(seed + RNG_GAMMA) + stream*RNG_GAMMA);
+  r->counter = 0;
+}
+
+static inline uint64_t rngNext(rngT* r)
+{
+  return rngMix(r->key + (++r->counter)*RNG_GAMMA);
+}
+
+// uniform integer in 0..n-1 (n > 0), by the multiply-shift of the high 32 bits
+static inline int rngInt(rngT* r, int n)
+{
+  return (int) (((rngNext(r) >> 32) * (uint64_t) n) >> 32);
+}
+
+// uniform double in [0,1)
+static inline double rngDouble(rngT* r)
+{
+  return (rngNext(r) >> 11) * (1.0/9007199254740992.0);
+}
+#endif
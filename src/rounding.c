@@ -0,0 +1,134 @@
+/**@file   rounding.c
+ * @brief  greedy rounding of an LP solution of the multiple knapsack problem (no SCIP calls)
+ **/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rounding.h"
+
+roundingT* createRounding(instanceT* I, const itemArraysT* A, int maxcands)
+{
+  roundingT* R;
+
+  R = (roundingT*) calloc(1, sizeof(roundingT));
+  if(!R)
+    return NULL;
+  R->n = I->n;
+  R->m = I->m;
+  R->A = A;
+  R->C = I->C;
+  R->maxcands = maxcands;
+  R->assign = (int*) malloc(sizeof(int)*I->n);
+  R->residual = (int*) malloc(sizeof(int)*I->m);
+  R->cand = (roundCandT*) malloc(sizeof(roundCandT)*(maxcands > 0 ? maxcands : 1));
+  R->tmp = (roundCandT*) malloc(sizeof(roundCandT)*(maxcands > 0 ? maxcands : 1));
+  if(!R->assign || !R->residual || !R->cand || !R->tmp){
+    freeRounding(R);
+    return NULL;
+  }
+  roundingReset(R);
+  return R;
+}
+
+void freeRounding(roundingT* R)
+{
+  if(!R)
+    return;
+  free(R->assign);
+  free(R->residual);
+  free(R->cand);
+  free(R->tmp);
+  free(R);
+}
+
+void roundingReset(roundingT* R)
+{
+  int i;
+
+  for(i = 0; i < R->n; i++)
+    R->assign[i] = -1;
+  memcpy(R->residual, R->C, sizeof(int)*R->m);
+  R->value = 0;
+  R->infeasible = 0;
+  R->ncands = 0;
+}
+
+int roundingFix(roundingT* R, int item, int k)
+{
+  if(R->assign[item] >= 0 || R->A->weight[item] > R->residual[k]){
+    R->infeasible = 1;
+    return 0;
+  }
+  R->assign[item] = k;
+  R->residual[k] -= R->A->weight[item];
+  R->value += R->A->value[item];
+  return 1;
+}
+
+void roundingAddCand(roundingT* R, int item, int k, double solval)
+{
+  roundCandT* c;
+
+  if(R->ncands >= R->maxcands)
+    return;
+  c = R->cand + R->ncands++;
+  c->item = item;
+  c->knapsack = k;
+  c->solval = solval;
+  c->value = R->A->value[item];
+}
+
+/** decreasing LP value, then decreasing item value, then increasing item and knapsack */
+static int cmpCand(const void* a, const void* b)
+{
+  const roundCandT *x = (const roundCandT*) a, *y = (const roundCandT*) b;
+
+  if(x->solval != y->solval)
+    return x->solval > y->solval ? -1 : 1;
+  if(x->value != y->value)
+    return x->value > y->value ? -1 : 1;
+  if(x->item != y->item)
+    return x->item < y->item ? -1 : 1;
+  return x->knapsack - y->knapsack;
+}
+
+/** bottom-up merge sort of the candidates by cmpCand(), with R->tmp as buffer (no allocation) */
+static void sortCands(roundingT* R)
+{
+  roundCandT *from = R->cand, *to = R->tmp, *swap;
+  int n = R->ncands, width, lo, mid, hi, i, j, k;
+
+  for(width = 1; width < n; width *= 2){
+    for(lo = 0; lo < n; lo += 2*width){
+      mid = lo + width < n ? lo + width : n;
+      hi = lo + 2*width < n ? lo + 2*width : n;
+      for(i = lo, j = mid, k = lo; k < hi; k++)
+        to[k] = j >= hi || (i < mid && cmpCand(from + i, from + j) <= 0) ? from[i++] : from[j++];
+    }
+    swap = from;
+    from = to;
+    to = swap;
+  }
+  if(from != R->cand)
+    memcpy(R->cand, from, sizeof(roundCandT)*n);
+}
+
+int roundingRun(roundingT* R)
+{
+  const int* weight = R->A->weight;
+  const roundCandT* c;
+  int j, nrounded = 0;
+
+  sortCands(R);
+  for(j = 0; j < R->ncands; j++){
+    c = R->cand + j;
+    if(R->assign[c->item] < 0 && weight[c->item] <= R->residual[c->knapsack]){
+      R->assign[c->item] = c->knapsack;
+      R->residual[c->knapsack] -= weight[c->item];
+      R->value += R->A->value[c->item];
+      nrounded++;
+    }
+  }
+  return nrounded;
+}
@@ -0,0 +1,49 @@
+/**@file   rounding.h
+ * @brief  greedy rounding of an LP solution of the multiple knapsack problem (no SCIP calls)
+ *
+ * The vars x_i_k with LP value 1.0 are placed first (roundingFix()); the fractional ones are given as candidates
+ * (roundingAddCand()) and roundingRun() sorts them once by LP value (ties: larger item value, then lower item and
+ * knapsack) and takes them in one pass: a candidate x_i_k is rounded up if the item i is still free and fits the
+ * residual capacity of the knapsack k. So a call costs O(nfrac log nfrac) plus O(n + m) to reset the work arrays,
+ * instead of a scan of the candidates and of the solution for each var selected. The sort is a merge sort on a buffer
+ * allocated with the engine (qsort() of glibc allocates its own buffer at each call).
+ **/
+#ifndef __MOCHILA_ROUNDING_H__
+#define __MOCHILA_ROUNDING_H__
+
+#include "problem.h"
+
+typedef struct{
+   int item;
+   int knapsack;
+   double solval;          /**< LP value of x_item_knapsack */
+   int value;              /**< value of the item (ties of the sort) */
+} roundCandT;
+
+typedef struct{
+   int n;                  /**< quant de itens */
+   int m;                  /**< quant de mochilas */
+   const itemArraysT* A;   /**< items of the instance */
+   const int* C;           /**< capacities */
+   int* assign;            /**< assign[i] = knapsack of item i (-1: not packed) */
+   int* residual;          /**< residual capacity of each knapsack */
+   long long value;        /**< value of assign */
+   int infeasible;         /**< 1 if a var fixed by roundingFix() violated the solution */
+   roundCandT* cand;       /**< fractional vars */
+   roundCandT* tmp;        /**< buffer of the merge sort */
+   int ncands;
+   int maxcands;           /**< size of cand */
+} roundingT;
+
+// create the rounding engine for at most maxcands fractional vars; NULL if out of memory
+roundingT* createRounding(instanceT* I, const itemArraysT* A, int maxcands);
+void freeRounding(roundingT* R);
+// empty solution and no candidate
+void roundingReset(roundingT* R);
+// item goes to knapsack k (LP value 1.0); returns 0, and sets R->infeasible, if it is already packed or does not fit
+int roundingFix(roundingT* R, int item, int k);
+// x_item_k is fractional with the given LP value
+void roundingAddCand(roundingT* R, int item, int k, double solval);
+// rounds the candidates up in one pass by decreasing LP value; returns the number of vars rounded up
+int roundingRun(roundingT* R);
+#endif
@@ -0,0 +1,251 @@
+/**@file   tabu.c
+ * @brief  tabu search for the multiple knapsack problem (no SCIP calls)
+ *
+ * The candidate list of an iteration is a partial Fisher-Yates shuffle of movable[]: its first candsize positions get
+ * random items, in O(candsize). Knapsack -1 (out) is the slot 0 of the rows of tabuuntil[], so a move to or from it is
+ * handled as any other.
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tabu.h"
+
+#define ALLOWED(T, i, k) ((T)->allowed[(size_t) (i)*(T)->m + (k)])
+#define TABU(T, i, k) ((T)->tabuuntil[(size_t) (i)*((T)->m + 1) + (k) + 1])
+#define DEFAULT_TENURE   15
+#define DEFAULT_CANDSIZE 32
+
+static double wallclock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+tabuT* createTabu(instanceT* I, const itemArraysT* A, int* fixed, unsigned char* allowed, unsigned long long seed)
+{
+  tabuT* T;
+
+  T = (tabuT*) calloc(1, sizeof(tabuT));
+  if(!T)
+    return NULL;
+  T->n = I->n;
+  T->m = I->m;
+  T->A = A;
+  T->C = I->C;
+  T->tenure = DEFAULT_TENURE;
+  T->candsize = DEFAULT_CANDSIZE;
+  T->seed = seed;
+  T->ownsnode = !fixed || !allowed;
+  T->fixed = T->ownsnode ? (int*) malloc(sizeof(int)*I->n) : fixed;
+  T->allowed = T->ownsnode ? (unsigned char*) malloc((size_t) I->n*I->m) : allowed;
+  T->assign = (int*) malloc(sizeof(int)*I->n);
+  T->residual = (int*) malloc(sizeof(int)*I->m);
+  T->tabuuntil = (long long*) malloc(sizeof(long long)*(size_t) I->n*(I->m + 1));
+  T->movable = (int*) malloc(sizeof(int)*I->n);
+  T->best = (int*) malloc(sizeof(int)*I->n);
+  if(!T->fixed || !T->allowed || !T->assign || !T->residual || !T->tabuuntil || !T->movable || !T->best){
+    freeTabu(T);
+    return NULL;
+  }
+  if(T->ownsnode)
+    tabuResetNode(T);
+  T->bestvalue = -1;
+  return T;
+}
+
+void freeTabu(tabuT* T)
+{
+  if(!T)
+    return;
+  if(T->ownsnode){
+    free(T->fixed);
+    free(T->allowed);
+  }
+  free(T->assign);
+  free(T->residual);
+  free(T->tabuuntil);
+  free(T->movable);
+  free(T->best);
+  free(T);
+}
+
+void tabuResetNode(tabuT* T)
+{
+  int i;
+
+  for(i = 0; i < T->n; i++)
+    T->fixed[i] = -1;
+  memset(T->allowed, 1, (size_t) T->n*T->m);
+}
+
+long long tabuLoad(tabuT* T, const int* assign)
+{
+  int i, k;
+
+  memcpy(T->residual, T->C, sizeof(int)*T->m);
+  T->value = 0;
+  for(i = 0; i < T->n; i++){
+    k = T->assign[i] = assign[i];
+    if(T->fixed[i] >= 0 && k != T->fixed[i])
+      return -1;
+    if(k < 0)
+      continue;
+    if(!ALLOWED(T, i, k) || (T->residual[k] -= T->A->weight[i]) < 0)
+      return -1;
+    T->value += T->A->value[i];
+  }
+  return T->value;
+}
+
+long long tabuGreedy(tabuT* T)
+{
+  const int *weight = T->A->weight;
+  int i, k, p, tight;
+
+  memcpy(T->residual, T->C, sizeof(int)*T->m);
+  T->value = 0;
+  for(i = 0; i < T->n; i++){
+    T->assign[i] = T->fixed[i];
+    if(T->fixed[i] >= 0){
+      if((T->residual[T->fixed[i]] -= weight[i]) < 0)
+        return -1;
+      T->value += T->A->value[i];
+    }
+  }
+  for(p = 0; p < T->n; p++){
+    i = T->A->byRatio[p];
+    if(T->fixed[i] >= 0)
+      continue;
+    tight = -1;
+    for(k = 0; k < T->m; k++)
+      if(ALLOWED(T, i, k) && weight[i] <= T->residual[k] && (tight < 0 || T->residual[k] < T->residual[tight]))
+        tight = k;
+    if(tight >= 0){
+      T->assign[i] = tight;
+      T->residual[tight] -= weight[i];
+      T->value += T->A->value[i];
+    }
+  }
+  return T->value;
+}
+
+/** change of the sum of the squared residuals when the residual of k changes by d (k < 0: no change) */
+static long long sqdelta(const tabuT* T, int k, long long d)
+{
+  return k < 0 ? 0 : 2*d*T->residual[k] + d*d;
+}
+
+/** the item i goes to the knapsack k (-1: out), tabu to go back for tenure to 1.5*tenure iterations */
+static void moveItem(tabuT* T, int i, int k, long long iter)
+{
+  int from = T->assign[i];
+
+  if(from >= 0){
+    T->residual[from] += T->A->weight[i];
+    T->value -= T->A->value[i];
+  }
+  if(k >= 0){
+    T->residual[k] -= T->A->weight[i];
+    T->value += T->A->value[i];
+  }
+  T->assign[i] = k;
+  TABU(T, i, from) = iter + T->tenure + rngInt(&T->rng, T->tenure/2 + 1);
+}
+
+long long tabuRun(tabuT* T, long long maxiter, double timelimit)
+{
+  const int *weight = T->A->weight, *val = T->A->value;
+  int *assign = T->assign, *residual = T->residual;
+  int c, d, i, j, k, l, t, ncand, movei, movej, movek, tabu;
+  long long iter, delta, sq, bestdelta, bestsq;
+  double start = wallclock();
+
+  rngInit(&T->rng, T->seed, T->nstreams++);
+  memset(T->tabuuntil, 0, sizeof(long long)*(size_t) T->n*(T->m + 1));
+  T->nmovable = 0;
+  for(i = 0; i < T->n; i++)
+    if(T->fixed[i] < 0)
+      T->movable[T->nmovable++] = i;
+  ncand = T->candsize < T->nmovable ? T->candsize : T->nmovable;
+  memcpy(T->best, assign, sizeof(int)*T->n);
+  T->bestvalue = T->value;
+  T->bestiter = 0;
+  for(iter = 1; iter <= maxiter && ncand > 0; iter++){
+    if(timelimit > 0 && (iter & 63) == 0 && wallclock() - start >= timelimit)
+      break;
+    // candidate list: the first ncand positions of movable[]
+    for(c = 0; c < ncand; c++){
+      d = c + rngInt(&T->rng, T->nmovable - c);
+      t = T->movable[c];
+      T->movable[c] = T->movable[d];
+      T->movable[d] = t;
+    }
+    movei = -1;
+    movej = movek = -1;
+    bestdelta = bestsq = 0;
+    tabu = 0;
+    for(c = 0; c < ncand; c++){
+      i = T->movable[c];
+      k = assign[i];
+      // shifts of i (l = -1: out)
+      for(l = -1; l < T->m; l++){
+        if(l == k || (l >= 0 && (!ALLOWED(T, i, l) || weight[i] > residual[l])))
+          continue;
+        T->nevals++;
+        delta = (l >= 0 ? val[i] : 0) - (k >= 0 ? val[i] : 0);
+        if(TABU(T, i, l) > iter && T->value + delta <= T->bestvalue)
+          continue;
+        sq = sqdelta(T, k, weight[i]) + sqdelta(T, l, -weight[i]);
+        if(movei < 0 || delta > bestdelta || (delta == bestdelta && sq > bestsq)){
+          movei = i;
+          movej = -1;
+          movek = l;
+          bestdelta = delta;
+          bestsq = sq;
+          tabu = TABU(T, i, l) > iter;
+        }
+      }
+      // swaps of i with the candidates after it: i goes to l = assign[j], j goes to k
+      for(d = c + 1; d < ncand; d++){
+        j = T->movable[d];
+        l = assign[j];
+        if(l == k)
+          continue;
+        if(l >= 0 && (!ALLOWED(T, i, l) || residual[l] + weight[j] < weight[i]))
+          continue;
+        if(k >= 0 && (!ALLOWED(T, j, k) || residual[k] + weight[i] < weight[j]))
+          continue;
+        T->nevals++;
+        delta = (l >= 0 ? val[i] - val[j] : 0) + (k >= 0 ? val[j] - val[i] : 0);
+        if((TABU(T, i, l) > iter || TABU(T, j, k) > iter) && T->value + delta <= T->bestvalue)
+          continue;
+        sq = sqdelta(T, k, weight[i] - weight[j]) + sqdelta(T, l, weight[j] - weight[i]);
+        if(movei < 0 || delta > bestdelta || (delta == bestdelta && sq > bestsq)){
+          movei = i;
+          movej = j;
+          movek = l;
+          bestdelta = delta;
+          bestsq = sq;
+          tabu = TABU(T, i, l) > iter || TABU(T, j, k) > iter;
+        }
+      }
+    }
+    if(movei < 0)
+      continue;
+    T->naspirations += tabu;
+    if(movej >= 0)
+      moveItem(T, movej, assign[movei], iter);
+    moveItem(T, movei, movek, iter);
+    T->iterations++;
+    if(T->value > T->bestvalue){
+      T->bestvalue = T->value;
+      T->bestiter = iter;
+      memcpy(T->best, assign, sizeof(int)*T->n);
+    }
+  }
+  return T->bestvalue;
+}
@@ -0,0 +1,78 @@
+/**@file   tabu.h
+ * @brief  tabu search for the multiple knapsack problem (no SCIP calls)
+ *
+ * The solution is an assignment vector assign[i] (knapsack of item i, -1: not packed) with the residual capacity of
+ * each knapsack. Not packed counts as one more knapsack, so two neighbourhoods cover every move:
+ *
+ *    shift   an item goes to another knapsack or out of the knapsacks (insert, drop and shift)
+ *    swap    two items of different knapsacks trade places (a free item with a packed one: exchange)
+ *
+ * Every iteration applies the best admissible move, even if it makes the solution worse: largest change of value,
+ * ties to the largest increase of the sum of the squared residuals (the free capacity is concentrated). The
+ * neighbourhood is never scanned in full: the moves are those of a candidate list of candsize items drawn at random
+ * from the items that may move, i.e. the shifts of the candidates and the swaps between them, O(candsize*(m+1) +
+ * candsize^2) per iteration.
+ *
+ * The tabu memory is an aspiration-time array over the pairs (item, knapsack): when the item i leaves the knapsack k
+ * (or leaves the free items), going back there is tabu until the iteration tabuuntil[i*(m+1)+k+1], tenure to 1.5*tenure
+ * iterations later (random). A tabu move is still admissible if it gives a solution better than the best one of the
+ * run (aspiration by objective).
+ *
+ * The restrictions of a node of the B&B are fixed[] and allowed[], as in localsearch.h (createTabu() with NULL arrays
+ * allocates them and resets them to the root). The s-th call of tabuRun() draws from the stream number s of the seed,
+ * so the runs do not repeat themselves and a sequence of runs is reproducible.
+ **/
+#ifndef __MOCHILA_TABU_H__
+#define __MOCHILA_TABU_H__
+
+#include "problem.h"
+#include "rng.h"
+
+typedef struct{
+   int n;                  /**< quant de itens */
+   int m;                  /**< quant de mochilas */
+   const itemArraysT* A;   /**< items of the instance */
+   const int* C;           /**< capacities */
+   // restrictions of the current node, set by the caller
+   int* fixed;             /**< fixed[i] >= 0: the item i does not move */
+   unsigned char* allowed; /**< allowed[i*m+k] = 1 if the item i may go to knapsack k */
+   int ownsnode;           /**< fixed and allowed were allocated by createTabu() */
+   // settings
+   int tenure;             /**< minimum tenure of a tabu pair (in iterations) */
+   int candsize;           /**< items of the candidate list of an iteration */
+   // current solution
+   int* assign;            /**< assign[i] = knapsack of item i (-1: not packed) */
+   int* residual;          /**< residual capacity of each knapsack */
+   long long value;        /**< value of assign */
+   // search
+   long long* tabuuntil;   /**< tabuuntil[i*(m+1)+k+1] = first iteration where the item i may go back to k (-1: out) */
+   int* movable;           /**< items not fixed (the candidate lists are drawn from its first positions) */
+   int nmovable;
+   rngT rng;               /**< stream of the current run */
+   unsigned long long seed;     /**< seed of the streams */
+   unsigned long long nstreams; /**< streams used by the previous runs */
+   // result of the last tabuRun()
+   int* best;              /**< best solution of the run */
+   long long bestvalue;    /**< value of best */
+   long long bestiter;     /**< iteration where best was found */
+   // statistics (accumulated)
+   long long iterations;   /**< moves applied */
+   long long nevals;       /**< moves evaluated */
+   long long naspirations; /**< tabu moves applied by aspiration */
+} tabuT;
+
+// create the engine for the instance; fixed and allowed are arrays of the caller (n and n*m) used as the restrictions,
+// or NULL to have them allocated here (and reset to the root). NULL if out of memory
+tabuT* createTabu(instanceT* I, const itemArraysT* A, int* fixed, unsigned char* allowed, unsigned long long seed);
+void freeTabu(tabuT* T);
+// restrictions of the root node: nothing fixed and every item allowed in every knapsack
+void tabuResetNode(tabuT* T);
+// the current solution becomes assign. Returns its value, or -1 if it violates a capacity or a restriction of the node
+long long tabuLoad(tabuT* T, const int* assign);
+// the current solution becomes the fixed items plus the others by value/weight, each one in the tightest allowed knapsack
+// where it fits. Returns its value, or -1 if the fixed items violate a capacity
+long long tabuGreedy(tabuT* T);
+// at most maxiter iterations and timelimit sec (<= 0: no limit) from the current solution. Returns the best value,
+// also kept with its solution in T->bestvalue and T->best
+long long tabuRun(tabuT* T, long long maxiter, double timelimit);
+#endif
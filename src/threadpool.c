@@ -0,0 +1,150 @@
+/**@file   threadpool.c
+ * @brief  fixed-size pool of POSIX threads running "parallel for" jobs
+ *
+ * The workers sleep on a condition variable until a new job is posted (the job counter changes). Each thread,
+ * including the caller of threadpoolRun(), takes the next task index under the mutex until all tasks were taken; the
+ * caller then waits until the workers finished the tasks they took.
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "threadpool.h"
+
+struct threadpoolT{
+  int nthreads;           // threads of the pool, counting the caller of threadpoolRun()
+  pthread_t* threads;     // the nthreads-1 workers
+  pthread_mutex_t mutex;
+  pthread_cond_t work;    // signaled when a job is posted or the pool is freed
+  pthread_cond_t done;    // signaled when the last task of a job finishes
+  // current job
+  threadTaskT task;
+  void* arg;
+  int ntasks;
+  int next;               // next task to be taken
+  int running;            // tasks taken and not finished yet
+  long job;               // number of jobs posted, used by the workers to detect a new job
+  int stop;
+};
+
+/** takes and runs tasks of the current job until all were taken; called with the mutex locked */
+static void runTasks(threadpoolT* pool)
+{
+  threadTaskT task;
+  void* arg;
+  int t;
+
+  while(pool->next < pool->ntasks){
+    t = pool->next++;
+    pool->running++;
+    task = pool->task;
+    arg = pool->arg;
+    pthread_mutex_unlock(&pool->mutex);
+    task(arg, t);
+    pthread_mutex_lock(&pool->mutex);
+    pool->running--;
+  }
+  if(pool->running == 0)
+    pthread_cond_broadcast(&pool->done);
+}
+
+static void* worker(void* p)
+{
+  threadpoolT* pool = (threadpoolT*) p;
+  long seen = 0;
+
+  pthread_mutex_lock(&pool->mutex);
+  for(;;){
+    while(!pool->stop && pool->job == seen)
+      pthread_cond_wait(&pool->work, &pool->mutex);
+    if(pool->stop)
+      break;
+    seen = pool->job;
+    runTasks(pool);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  return NULL;
+}
+
+threadpoolT* createThreadpool(int nthreads)
+{
+  threadpoolT* pool;
+  int t;
+
+  if(nthreads <= 0){
+    nthreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if(nthreads <= 0)
+      nthreads = 1;
+  }
+  pool = (threadpoolT*) calloc(1, sizeof(threadpoolT));
+  if(!pool)
+    return NULL;
+  pool->threads = (pthread_t*) malloc(sizeof(pthread_t)*nthreads);
+  if(!pool->threads){
+    free(pool);
+    return NULL;
+  }
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->work, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  // the caller is the first thread
+  pool->nthreads = 1;
+  for(t = 1; t < nthreads; t++){
+    if(pthread_create(&pool->threads[t], NULL, worker, pool) != 0){
+      printf("\nWarning: thread pool created with %d of %d threads\n", pool->nthreads, nthreads);
+      break;
+    }
+    pool->nthreads++;
+  }
+  return pool;
+}
+
+void freeThreadpool(threadpoolT* pool)
+{
+  int t;
+
+  if(!pool)
+    return;
+  pthread_mutex_lock(&pool->mutex);
+  pool->stop = 1;
+  pthread_cond_broadcast(&pool->work);
+  pthread_mutex_unlock(&pool->mutex);
+  for(t = 1; t < pool->nthreads; t++)
+    pthread_join(pool->threads[t], NULL);
+  pthread_cond_destroy(&pool->done);
+  pthread_cond_destroy(&pool->work);
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool->threads);
+  free(pool);
+}
+
+int threadpoolSize(threadpoolT* pool)
+{
+  return pool ? pool->nthreads : 1;
+}
+
+void threadpoolRun(threadpoolT* pool, int ntasks, threadTaskT task, void* arg)
+{
+  int t;
+
+  // no workers: run in the caller
+  if(!pool || pool->nthreads == 1 || ntasks <= 1){
+    for(t = 0; t < ntasks; t++)
+      task(arg, t);
+    return;
+  }
+  pthread_mutex_lock(&pool->mutex);
+  pool->task = task;
+  pool->arg = arg;
+  pool->ntasks = ntasks;
+  pool->next = 0;
+  pool->running = 0;
+  pool->job++;
+  pthread_cond_broadcast(&pool->work);
+  runTasks(pool);
+  while(pool->running > 0 || pool->next < pool->ntasks)
+    pthread_cond_wait(&pool->done, &pool->mutex);
+  pthread_mutex_unlock(&pool->mutex);
+}
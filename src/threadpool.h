@@ -0,0 +1,23 @@
+/**@file   threadpool.h
+ * @brief  fixed-size pool of POSIX threads running "parallel for" jobs
+ *
+ * threadpoolRun(pool, ntasks, task, arg) calls task(arg, t) for t = 0..ntasks-1, distributing the tasks among the
+ * threads of the pool (the calling thread also runs tasks), and returns when all of them are done. A pool with a
+ * single thread runs everything in the caller, without creating threads.
+ **/
+#ifndef __MOCHILA_THREADPOOL_H__
+#define __MOCHILA_THREADPOOL_H__
+
+typedef void (*threadTaskT)(void* arg, int t);
+
+typedef struct threadpoolT threadpoolT;
+
+// create a pool with nthreads threads, counting the calling one (nthreads <= 0: one per online processor)
+threadpoolT* createThreadpool(int nthreads);
+// wait for the threads and free the pool
+void freeThreadpool(threadpoolT* pool);
+// number of threads of the pool (counting the calling one)
+int threadpoolSize(threadpoolT* pool);
+// run task(arg, t) for t = 0..ntasks-1 in the pool and wait for all of them
+void threadpoolRun(threadpoolT* pool, int ntasks, threadTaskT task, void* arg);
+#endif
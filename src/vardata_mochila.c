@@ -0,0 +1,269 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2014 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   vardata_mochila.c
+ * @brief  Variable data containing the item and the knapsack of each variable x_i_j
+ * @author Edna Hoshino (based on template codified by Timo Berthold and Stefan Heinz)
+ *
+ * This file implements the handling of the variable data which is attached to each variable x_i_j of the model.
+ * The variable data is created with the original variable and the transformed variable points to the same data,
+ * since the original problem is always freed after the transformed one. It is freed when the original variable is
+ * released. The variables created by the pricer only exist in the transformed problem and free their own data.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#include <assert.h>
+
+#include "vardata_mochila.h"
+
+/** Variable data which is attached to all variables.
+ *
+ *  This variable data is used to know the item and the knapsack of a variable x_i_j.
+ */
+struct SCIP_VarData
+{
+   int                   item;               /**< item i of x_i_j (first item of a packing, -1 if empty) */
+   int                   knapsack;           /**< knapsack j of x_i_j (-1: slack of the row of item) */
+   int                   nitems;             /**< number of items of a packing (1 for x_i_j) */
+   int*                  items;              /**< sorted items of a packing (NULL for x_i_j: the single item is item) */
+};
+
+/** frees the variable data */
+static
+void vardataFree(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_VARDATA**        vardata             /**< pointer to vardata */
+   )
+{
+   if( (*vardata)->items != NULL )
+      SCIPfreeBlockMemoryArray(scip, &(*vardata)->items, (*vardata)->nitems);
+   SCIPfreeBlockMemory(scip, vardata);
+}
+
+/**@name Callback methods
+ *
+ * @{
+ */
+
+/** frees user data of original variable (called when the original variable is freed) */
+static
+SCIP_DECL_VARDELORIG(vardataDelOrig)
+{
+   vardataFree(scip, vardata);
+
+   return SCIP_OKAY;
+}
+
+/** creates user data of transformed variable by transforming the original user variable data
+ *  (the data is shared, so nothing is copied) */
+static
+SCIP_DECL_VARTRANS(vardataTrans)
+{
+   assert(sourcedata != NULL);
+
+   *targetdata = sourcedata;
+
+   return SCIP_OKAY;
+}
+
+/** frees user data of transformed variable (the data is owned by the original variable) */
+static
+SCIP_DECL_VARDELTRANS(vardataDelTrans)
+{
+   *vardata = NULL;
+
+   return SCIP_OKAY;
+}
+
+/** frees user data of a variable created during the solving process (it has no original variable) */
+static
+SCIP_DECL_VARDELTRANS(vardataDelTransPriced)
+{
+   vardataFree(scip, vardata);
+
+   return SCIP_OKAY;
+}
+
+/**@} */
+
+
+/**@name Interface methods
+ *
+ * @{
+ */
+
+/** create variable data */
+SCIP_RETCODE SCIPvardataCreateMochila(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_VARDATA**        vardata,            /**< pointer to vardata */
+   int                   item,               /**< item i of x_i_j */
+   int                   knapsack            /**< knapsack j of x_i_j */
+   )
+{
+   SCIP_CALL( SCIPallocBlockMemory(scip, vardata) );
+
+   (*vardata)->item = item;
+   (*vardata)->knapsack = knapsack;
+   (*vardata)->nitems = 1;
+   (*vardata)->items = NULL;
+
+   return SCIP_OKAY;
+}
+
+/** create variable data of a packing of a knapsack (knapsack -1: slack of the row of items[0]) */
+SCIP_RETCODE SCIPvardataCreatePacking(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_VARDATA**        vardata,            /**< pointer to vardata */
+   int                   knapsack,           /**< knapsack of the packing */
+   const int*            items,              /**< items of the packing, sorted */
+   int                   nitems              /**< number of items */
+   )
+{
+   SCIP_CALL( SCIPallocBlockMemory(scip, vardata) );
+
+   (*vardata)->item = nitems > 0 ? items[0] : -1;
+   (*vardata)->knapsack = knapsack;
+   (*vardata)->nitems = nitems;
+   (*vardata)->items = NULL;
+   // a single item does not need the list
+   if( nitems > 1 )
+   {
+      SCIP_CALL( SCIPduplicateBlockMemoryArray(scip, &(*vardata)->items, items, nitems) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/** creates a binary variable x_i_j with the given variable data */
+SCIP_RETCODE SCIPcreateVarMochila(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_VAR**            var,                /**< pointer to variable object */
+   const char*           name,               /**< name of variable, or NULL for automatic name creation */
+   SCIP_Real             obj,                /**< objective function value */
+   SCIP_VARDATA*         vardata             /**< user data for this specific variable */
+   )
+{
+   assert(scip != NULL);
+   assert(var != NULL);
+
+   /* create a basic variable object */
+   SCIP_CALL( SCIPcreateVar(scip, var, name, 0.0, 1.0, obj, SCIP_VARTYPE_BINARY, TRUE, FALSE,
+         vardataDelOrig, vardataTrans, vardataDelTrans, NULL, vardata) );
+
+   assert(*var != NULL);
+
+   return SCIP_OKAY;
+}
+
+/** creates a binary variable during the solving process (by a pricer); the variable owns its data */
+SCIP_RETCODE SCIPcreateVarPriced(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_VAR**            var,                /**< pointer to variable object */
+   const char*           name,               /**< name of variable, or NULL for automatic name creation */
+   SCIP_Real             obj,                /**< objective function value (of the transformed problem) */
+   SCIP_VARDATA*         vardata             /**< user data for this specific variable */
+   )
+{
+   assert(scip != NULL);
+   assert(var != NULL);
+
+   /* not in the initial LP and removable from it */
+   SCIP_CALL( SCIPcreateVar(scip, var, name, 0.0, 1.0, obj, SCIP_VARTYPE_BINARY, FALSE, TRUE,
+         NULL, NULL, vardataDelTransPriced, NULL, vardata) );
+
+   assert(*var != NULL);
+
+   return SCIP_OKAY;
+}
+
+/** returns the item of the variable data */
+int SCIPvardataGetItem(
+   SCIP_VARDATA*         vardata             /**< variable data */
+   )
+{
+   return vardata->item;
+}
+
+/** returns the knapsack of the variable data */
+int SCIPvardataGetKnapsack(
+   SCIP_VARDATA*         vardata             /**< variable data */
+   )
+{
+   return vardata->knapsack;
+}
+
+/** returns the item i of the (original or transformed) variable x_i_j */
+int varGetItem(
+   SCIP_VAR*             var                 /**< variable x_i_j */
+   )
+{
+   assert(SCIPvarGetData(var) != NULL);
+
+   return SCIPvarGetData(var)->item;
+}
+
+/** returns the knapsack j of the (original or transformed) variable x_i_j */
+int varGetKnapsack(
+   SCIP_VAR*             var                 /**< variable x_i_j */
+   )
+{
+   assert(SCIPvarGetData(var) != NULL);
+
+   return SCIPvarGetData(var)->knapsack;
+}
+
+/** returns the sorted items of the (original or transformed) variable and their number in nitems */
+const int* varGetItems(
+   SCIP_VAR*             var,                /**< variable */
+   int*                  nitems              /**< pointer to store the number of items */
+   )
+{
+   SCIP_VARDATA* vardata;
+
+   vardata = SCIPvarGetData(var);
+   assert(vardata != NULL);
+
+   *nitems = vardata->nitems;
+   return vardata->items != NULL ? vardata->items : &vardata->item;
+}
+
+/** returns TRUE if the item is one of the items of the (original or transformed) variable */
+SCIP_Bool varContainsItem(
+   SCIP_VAR*             var,                /**< variable */
+   int                   item                /**< item */
+   )
+{
+   const int* items;
+   int nitems, lo, hi, mid;
+
+   items = varGetItems(var, &nitems);
+   // binary search in the sorted items
+   lo = 0;
+   hi = nitems - 1;
+   while( lo <= hi )
+   {
+      mid = (lo + hi) / 2;
+      if( items[mid] == item )
+         return TRUE;
+      if( items[mid] < item )
+         lo = mid + 1;
+      else
+         hi = mid - 1;
+   }
+   return FALSE;
+}
+
+/**@} */
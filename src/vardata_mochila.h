@@ -0,0 +1,111 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*                  This file is part of the program and library             */
+/*         SCIP --- Solving Constraint Integer Programs                      */
+/*                                                                           */
+/*    Copyright (C) 2002-2014 Konrad-Zuse-Zentrum                            */
+/*                            fuer Informationstechnik Berlin                */
+/*                                                                           */
+/*  SCIP is distributed under the terms of the ZIB Academic License.         */
+/*                                                                           */
+/*  You should have received a copy of the ZIB Academic License              */
+/*  along with SCIP; see the file COPYING. If not email to scip@zib.de.      */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**@file   vardata_mochila.h
+ * @brief  Variable data containing the item and the knapsack of each variable x_i_j
+ *
+ * Each variable x_i_j of the model keeps the item i and the knapsack j it refers to, so the plugins recover them in
+ * O(1) instead of parsing the name of the variable. The transformed variable shares the data of its original variable.
+ *
+ * In the Dantzig-Wolfe formulation (see SCIPprobdataCreate()), a variable is a packing of one knapsack and keeps the
+ * knapsack and the sorted list of its items. The slack of the row of item i has knapsack -1 and the single item i;
+ * the slack of the row of knapsack j has knapsack j and no item. A variable x_i_j is a packing of the single item i.
+ */
+
+/*---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+
+#ifndef __SCIP_VARDATA_MOCHILA__
+#define __SCIP_VARDATA_MOCHILA__
+
+#include "scip/scip.h"
+
+/** create variable data */
+extern
+SCIP_RETCODE SCIPvardataCreateMochila(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_VARDATA**        vardata,            /**< pointer to vardata */
+   int                   item,               /**< item i of x_i_j */
+   int                   knapsack            /**< knapsack j of x_i_j */
+   );
+
+/** create variable data of a packing of a knapsack (knapsack -1: slack of the row of items[0]) */
+extern
+SCIP_RETCODE SCIPvardataCreatePacking(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_VARDATA**        vardata,            /**< pointer to vardata */
+   int                   knapsack,           /**< knapsack of the packing */
+   const int*            items,              /**< items of the packing, sorted */
+   int                   nitems              /**< number of items */
+   );
+
+/** creates a binary variable x_i_j with the given variable data */
+extern
+SCIP_RETCODE SCIPcreateVarMochila(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_VAR**            var,                /**< pointer to variable object */
+   const char*           name,               /**< name of variable, or NULL for automatic name creation */
+   SCIP_Real             obj,                /**< objective function value */
+   SCIP_VARDATA*         vardata             /**< user data for this specific variable */
+   );
+
+/** creates a binary variable during the solving process (by a pricer); the variable owns its data */
+extern
+SCIP_RETCODE SCIPcreateVarPriced(
+   SCIP*                 scip,               /**< SCIP data structure */
+   SCIP_VAR**            var,                /**< pointer to variable object */
+   const char*           name,               /**< name of variable, or NULL for automatic name creation */
+   SCIP_Real             obj,                /**< objective function value (of the transformed problem) */
+   SCIP_VARDATA*         vardata             /**< user data for this specific variable */
+   );
+
+/** returns the item of the variable data */
+extern
+int SCIPvardataGetItem(
+   SCIP_VARDATA*         vardata             /**< variable data */
+   );
+
+/** returns the knapsack of the variable data */
+extern
+int SCIPvardataGetKnapsack(
+   SCIP_VARDATA*         vardata             /**< variable data */
+   );
+
+/** returns the item i of the (original or transformed) variable x_i_j */
+extern
+int varGetItem(
+   SCIP_VAR*             var                 /**< variable x_i_j */
+   );
+
+/** returns the knapsack j of the (original or transformed) variable x_i_j */
+extern
+int varGetKnapsack(
+   SCIP_VAR*             var                 /**< variable x_i_j */
+   );
+
+/** returns the sorted items of the (original or transformed) variable and their number in nitems */
+extern
+const int* varGetItems(
+   SCIP_VAR*             var,                /**< variable */
+   int*                  nitems              /**< pointer to store the number of items */
+   );
+
+/** returns TRUE if the item is one of the items of the (original or transformed) variable */
+extern
+SCIP_Bool varContainsItem(
+   SCIP_VAR*             var,                /**< variable */
+   int                   item                /**< item */
+   );
+
+#endif